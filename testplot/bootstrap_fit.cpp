@@ -0,0 +1,175 @@
+#include "bootstrap_fit.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// SplitMix64：第 r 次重抽样用 (seed, r) 派生一条独立的流
+uint64_t nextRandom(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 已排序数组的分位数，相邻两点间线性插值
+double quantile(const std::vector<double>& sorted, double q)
+{
+    double position = q * static_cast<double>(sorted.size() - 1);
+    size_t lower = static_cast<size_t>(position);
+    if (lower + 1 >= sorted.size()) return sorted.back();
+    return sorted[lower] + (position - lower) * (sorted[lower + 1] - sorted[lower]);
+}
+
+// 第 column 列在各次成功重拟合中的取值（跳过非有限值）的区间和标准差
+void summarize(const std::vector<double>& samples, size_t stride, size_t column, const std::vector<size_t>& succeeded,
+               double alpha, double& lower, double& upper, double* stdDev)
+{
+    std::vector<double> values;
+    values.reserve(succeeded.size());
+    for (size_t r : succeeded) {
+        double v = samples[r * stride + column];
+        if (std::isfinite(v)) values.push_back(v);
+    }
+    if (values.size() < 2) {
+        lower = upper = std::numeric_limits<double>::quiet_NaN();
+        if (stdDev) *stdDev = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    lower = quantile(values, alpha / 2.0);
+    upper = quantile(values, 1.0 - alpha / 2.0);
+    if (stdDev) {
+        double mean = 0.0;
+        for (double v : values) mean += v;
+        mean /= values.size();
+        double squares = 0.0;
+        for (double v : values) squares += (v - mean) * (v - mean);
+        *stdDev = std::sqrt(squares / (values.size() - 1));
+    }
+}
+
+} // namespace
+
+BootstrapResult Bootstrap::run(const std::vector<double>& x, const std::vector<double>& y, const FitModel& fitted,
+                               const BootstrapRefit& refit, const BootstrapOptions& options)
+{
+    BootstrapResult result;
+    FitProgress* progress = options.progress;
+    size_t n = std::min(x.size(), y.size());
+    if (n < 3 || !fitted.isValid() || options.replicates < 2) return result;
+
+    // 残差重抽样的基础：拟合值和中心化残差
+    std::vector<double> fittedValues, residuals;
+    if (options.method == BootstrapMethod::Residuals) {
+        fittedValues = fitted.evaluate(x);
+        residuals.resize(n);
+        double mean = 0.0;
+        size_t finite = 0;
+        for (size_t i = 0; i < n; ++i) {
+            residuals[i] = y[i] - fittedValues[i];
+            if (std::isfinite(residuals[i])) {
+                mean += residuals[i];
+                ++finite;
+            }
+        }
+        if (finite == 0) return result;
+        mean /= finite;
+        for (double& r : residuals) r -= mean;
+    }
+
+    double xMin = std::numeric_limits<double>::infinity(), xMax = -xMin;
+    for (size_t i = 0; i < n; ++i) {
+        if (!std::isfinite(x[i])) continue;
+        xMin = std::min(xMin, x[i]);
+        xMax = std::max(xMax, x[i]);
+    }
+    if (!(xMax >= xMin)) return result;
+    size_t bandPoints = std::max<size_t>(2, options.bandPoints);
+    result.bandX.resize(bandPoints);
+    for (size_t j = 0; j < bandPoints; ++j) {
+        result.bandX[j] = xMin + (xMax - xMin) * static_cast<double>(j) / (bandPoints - 1);
+    }
+
+    size_t replicates = static_cast<size_t>(options.replicates);
+    size_t parameterCount = fitted.coefficients().size();
+    std::vector<double> curves(replicates * bandPoints);
+    std::vector<double> parameters(replicates * parameterCount);
+    std::vector<char> ok(replicates, 0);
+
+    size_t chunks = std::min<size_t>(replicates, workerThreadCount());
+    parallelForChunks(replicates, chunks, [&](size_t, size_t begin, size_t end) {
+        std::vector<double> sampleX(n), sampleY(n);
+        for (size_t r = begin; r < end; ++r) {
+            if (progress && progress->isCancelled()) return;
+            uint64_t state = options.seed ^ ((r + 1) * 0xD1B54A32D192ED03ULL);
+            if (options.method == BootstrapMethod::Residuals) {
+                for (size_t i = 0; i < n; ++i) {
+                    sampleX[i] = x[i];
+                    sampleY[i] = fittedValues[i] + residuals[nextRandom(state) % n];
+                }
+            } else {
+                for (size_t i = 0; i < n; ++i) {
+                    size_t index = static_cast<size_t>(nextRandom(state) % n);
+                    sampleX[i] = x[index];
+                    sampleY[i] = y[index];
+                }
+            }
+
+            FitModel model = refit(sampleX, sampleY);
+            if (model.isValid() && model.coefficients().size() == parameterCount) {
+                model.evaluate(result.bandX.data(), bandPoints, curves.data() + r * bandPoints);
+                std::copy(model.coefficients().begin(), model.coefficients().end(),
+                          parameters.begin() + r * parameterCount);
+                ok[r] = 1;
+            }
+            if (progress) ++progress->completedTasks;
+        }
+    });
+    if (progress && progress->isCancelled()) return result;
+
+    std::vector<size_t> succeeded;
+    for (size_t r = 0; r < replicates; ++r) {
+        if (ok[r]) succeeded.push_back(r);
+    }
+    result.replicates = static_cast<int>(succeeded.size());
+    result.failures = static_cast<int>(replicates - succeeded.size());
+    if (succeeded.size() < 2) return result;
+
+    double alpha = 1.0 - std::max(0.0, std::min(1.0, options.confidence));
+    result.bandLower.resize(bandPoints);
+    result.bandUpper.resize(bandPoints);
+    parallelForEach(bandPoints, [&](size_t j) {
+        summarize(curves, bandPoints, j, succeeded, alpha, result.bandLower[j], result.bandUpper[j], nullptr);
+    });
+    result.parameterLower.resize(parameterCount);
+    result.parameterUpper.resize(parameterCount);
+    result.parameterStdDev.resize(parameterCount);
+    for (size_t k = 0; k < parameterCount; ++k) {
+        summarize(parameters, parameterCount, k, succeeded, alpha, result.parameterLower[k], result.parameterUpper[k],
+                  &result.parameterStdDev[k]);
+    }
+    result.valid = true;
+    return result;
+}
+
+const char* Bootstrap::methodName(BootstrapMethod method)
+{
+    switch (method) {
+    case BootstrapMethod::Residuals: return "残差重抽样";
+    case BootstrapMethod::Pairs: return "成对重抽样";
+    }
+    return "";
+}
+
+double nearestEquivalentAngle(double angle, double reference)
+{
+    return reference + std::remainder(angle - reference, 2.0 * M_PI);
+}
@@ -0,0 +1,57 @@
+#ifndef BOOTSTRAP_FIT_H
+#define BOOTSTRAP_FIT_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "fit_model.h"
+#include "fit_progress.h"
+
+enum class BootstrapMethod {
+    Residuals,   // 残差重抽样：x 不变，y* = 拟合值 + 有放回抽取的（中心化）残差；假设误差同分布
+    Pairs        // 成对重抽样：有放回抽取 (x, y) 对；不依赖模型正确，对异方差更稳健
+};
+
+struct BootstrapOptions {
+    BootstrapMethod method = BootstrapMethod::Residuals;
+    int replicates = 1000;
+    double confidence = 0.95;
+    size_t bandPoints = 200;        // 置信带在 [xmin, xmax] 上等距求值的点数
+    uint64_t seed = 20240601;
+    FitProgress* progress = nullptr; // completedTasks 按完成的重抽样次数递增
+};
+
+struct BootstrapResult {
+    bool valid = false;
+    int replicates = 0;                   // 重拟合成功的次数
+    int failures = 0;
+    // 各系数的百分位区间和标准差，顺序同 FitModel::coefficients()
+    std::vector<double> parameterLower;
+    std::vector<double> parameterUpper;
+    std::vector<double> parameterStdDev;
+    // 逐点置信带
+    std::vector<double> bandX;
+    std::vector<double> bandLower;
+    std::vector<double> bandUpper;
+};
+
+// 对一组重抽样数据重新拟合，返回无效模型表示这次拟合失败；会被多个线程同时调用
+using BootstrapRefit = std::function<FitModel(const std::vector<double>& x, const std::vector<double>& y)>;
+
+// Bootstrap：重抽样数据反复重拟合，由重拟合结果的经验分布给出系数的百分位区间和曲线的逐点置信带
+// 重抽样次数在线程间静态分块，每个线程复用自己的抽样缓冲；第 r 次重抽样用 (seed, r) 派生的独立随机流，
+// 结果与线程数无关
+class Bootstrap
+{
+public:
+    static BootstrapResult run(const std::vector<double>& x, const std::vector<double>& y, const FitModel& fitted,
+                               const BootstrapRefit& refit, const BootstrapOptions& options = BootstrapOptions());
+    static const char* methodName(BootstrapMethod method);
+};
+
+// 角度换到离 reference 最近的 2π 等价值。正弦拟合的相位被归到 (-π, π]，原相位靠近 ±π 时
+// 重拟合的相位会跳到另一端，重拟合结果先与原相位对齐，分位数才不会被拉成整个圆周
+double nearestEquivalentAngle(double angle, double reference);
+
+#endif // BOOTSTRAP_FIT_H
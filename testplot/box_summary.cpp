@@ -0,0 +1,81 @@
+#include "box_summary.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 在 [first, last) 中取秩为 h 的插值分位数（h 以整个数组为基准）
+// 调用前 [first, last) 必须恰好包含排序后落在该区间的元素，且 last 之后的元素都不小于它们
+double selectQuantile(std::vector<double>& values, size_t first, size_t last, double h)
+{
+    size_t lo = static_cast<size_t>(std::floor(h));
+    double frac = h - lo;
+    std::nth_element(values.begin() + first, values.begin() + lo, values.begin() + last);
+    double low = values[lo];
+    if (frac <= 0.0 || lo + 1 >= values.size()) return low;
+
+    // nth_element 之后 lo 右侧都不小于它，下一个秩即右侧最小值
+    // 若 lo 已是区间末尾，则下一个秩落在 last 之后（之前的划分保证那里都更大）
+    double high = (lo + 1 < last)
+        ? *std::min_element(values.begin() + lo + 1, values.begin() + last)
+        : *std::min_element(values.begin() + last, values.end());
+    return low + frac * (high - low);
+}
+
+} // namespace
+
+BoxSummary BoxSummaryEngine::compute(const std::vector<double>& data)
+{
+    BoxSummary summary;
+    if (data.empty()) return summary;
+
+    std::vector<double> values = data;
+    size_t n = values.size();
+    summary.count = n;
+
+    // 先选中位数，再分别在左右两半里选 Q1、Q3，每次选择的范围减半
+    double hMedian = (n - 1) * 0.5;
+    double hQ1 = (n - 1) * 0.25;
+    double hQ3 = (n - 1) * 0.75;
+    size_t mid = static_cast<size_t>(std::floor(hMedian));
+
+    summary.median = selectQuantile(values, 0, n, hMedian);
+    summary.q1 = selectQuantile(values, 0, mid + 1, hQ1);
+    summary.q3 = selectQuantile(values, mid, n, hQ3);
+
+    double lowerFence = summary.q1 - WhiskerFactor * summary.iqr();
+    double upperFence = summary.q3 + WhiskerFactor * summary.iqr();
+
+    summary.minValue = data[0];
+    summary.maxValue = data[0];
+    summary.lowerWhisker = summary.q1;
+    summary.upperWhisker = summary.q3;
+    for (double v : data) {
+        summary.minValue = std::min(summary.minValue, v);
+        summary.maxValue = std::max(summary.maxValue, v);
+        if (v < lowerFence || v > upperFence) {
+            summary.outliers.push_back(v);
+        } else {
+            summary.lowerWhisker = std::min(summary.lowerWhisker, v);
+            summary.upperWhisker = std::max(summary.upperWhisker, v);
+        }
+    }
+    return summary;
+}
+
+const std::vector<BoxSummary>& BoxSummaryEngine::summaries(uint64_t version,
+                                                           const std::vector<const std::vector<double>*>& series)
+{
+    if (hasCache && cachedVersion == version && cachedSummaries.size() == series.size()) {
+        return cachedSummaries;
+    }
+
+    cachedSummaries.assign(series.size(), BoxSummary());
+    parallelForEach(series.size(), [&](size_t i) {
+        cachedSummaries[i] = compute(*series[i]);
+    });
+    cachedVersion = version;
+    hasCache = true;
+    return cachedSummaries;
+}
@@ -0,0 +1,43 @@
+#ifndef BOX_SUMMARY_H
+#define BOX_SUMMARY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 箱线图的五数概括（四分位数采用线性插值，与 StatisticsAccumulator 一致）
+struct BoxSummary {
+    size_t count = 0;
+    double minValue = 0.0;
+    double q1 = 0.0;
+    double median = 0.0;
+    double q3 = 0.0;
+    double maxValue = 0.0;
+    double lowerWhisker = 0.0;      // >= Q1 - 1.5 IQR 的最小样本
+    double upperWhisker = 0.0;      // <= Q3 + 1.5 IQR 的最大样本
+    std::vector<double> outliers;   // 须线之外的样本
+
+    double iqr() const { return q3 - q1; }
+    bool isEmpty() const { return count == 0; }
+};
+
+// 五数概括引擎：用 nth_element 选择代替全排序，单列 O(n)
+// 多列时各列并行计算，结果按数据版本整体缓存
+class BoxSummaryEngine
+{
+public:
+    static constexpr double WhiskerFactor = 1.5;
+
+    static BoxSummary compute(const std::vector<double>& data);
+
+    const std::vector<BoxSummary>& summaries(uint64_t version,
+                                             const std::vector<const std::vector<double>*>& series);
+    void clear() { cachedSummaries.clear(); hasCache = false; }
+
+private:
+    uint64_t cachedVersion = 0;
+    bool hasCache = false;
+    std::vector<BoxSummary> cachedSummaries;
+};
+
+#endif // BOX_SUMMARY_H
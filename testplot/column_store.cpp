@@ -0,0 +1,52 @@
+#include "column_store.h"
+#include <algorithm>
+
+void ColumnStore::clear()
+{
+    columns.clear();
+    rows = 0;
+}
+
+void ColumnStore::ensureColumns(size_t count)
+{
+    // 新出现的列在之前的行中补 0，与文件加载时的补齐规则一致
+    while (columns.size() < count) {
+        Column col;
+        col.values.assign(rows, 0.0);
+        col.stats.append(col.values);
+        columns.push_back(std::move(col));
+    }
+}
+
+void ColumnStore::appendRows(const std::vector<std::vector<double>>& newRows)
+{
+    if (newRows.empty()) return;
+
+    size_t width = columns.size();
+    for (const auto& row : newRows) {
+        width = std::max(width, row.size());
+    }
+    ensureColumns(width);
+
+    size_t first = rows;
+    for (Column& col : columns) {
+        col.values.reserve(first + newRows.size());
+    }
+    for (const auto& row : newRows) {
+        for (size_t c = 0; c < columns.size(); ++c) {
+            columns[c].values.push_back(c < row.size() ? row[c] : 0.0);
+        }
+    }
+    rows += newRows.size();
+
+    // 只累加新追加的部分
+    for (Column& col : columns) {
+        col.stats.append(col.values.data() + first, newRows.size());
+        col.version = nextVersion++;
+    }
+}
+
+void ColumnStore::appendRow(const std::vector<double>& row)
+{
+    appendRows(std::vector<std::vector<double>>(1, row));
+}
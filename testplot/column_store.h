@@ -0,0 +1,40 @@
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "statistics_accumulator.h"
+
+// 按列存储的数据表，每列附带增量统计和版本号
+// 追加 k 行只更新新增部分的统计量（O(k)），版本号供各类缓存判断数据是否变化
+class ColumnStore
+{
+public:
+    void clear();
+    void appendRows(const std::vector<std::vector<double>>& rows);
+    void appendRow(const std::vector<double>& row);
+
+    size_t rowCount() const { return rows; }
+    size_t columnCount() const { return columns.size(); }
+    bool isEmpty() const { return rows == 0; }
+
+    const std::vector<double>& column(size_t index) const { return columns[index].values; }
+    const StatisticsAccumulator& statistics(size_t index) const { return columns[index].stats; }
+    uint64_t version(size_t index) const { return columns[index].version; }
+
+private:
+    struct Column {
+        std::vector<double> values;
+        StatisticsAccumulator stats;
+        uint64_t version = 0;
+    };
+
+    void ensureColumns(size_t count);
+
+    std::vector<Column> columns;
+    size_t rows = 0;
+    uint64_t nextVersion = 1;
+};
+
+#endif // COLUMN_STORE_H
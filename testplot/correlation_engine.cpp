@@ -0,0 +1,149 @@
+#include "correlation_engine.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const size_t TileColumns = 32;   // 每个列块的列数
+const size_t TileRows = 512;     // 每次累加的行数；两个列块约 256KB，可留在 L2
+
+// 四路独立累加，便于编译器向量化，且求和顺序固定
+double dotProduct(const double* a, const double* b, size_t n)
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += a[i] * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+} // namespace
+
+std::vector<double> CorrelationEngine::rankTransform(const std::vector<double>& data, size_t count)
+{
+    count = std::min(count, data.size());
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&data](size_t a, size_t b) { return data[a] < data[b]; });
+
+    // 秩从 1 开始，并列的值取平均秩
+    std::vector<double> ranks(count);
+    for (size_t i = 0; i < count;) {
+        size_t j = i + 1;
+        while (j < count && data[order[j]] == data[order[i]]) ++j;
+        double rank = (i + j + 1) * 0.5;
+        for (size_t k = i; k < j; ++k) {
+            ranks[order[k]] = rank;
+        }
+        i = j;
+    }
+    return ranks;
+}
+
+CorrelationMatrix CorrelationEngine::compute(const std::vector<const std::vector<double>*>& columns,
+                                             CorrelationMethod method)
+{
+    CorrelationMatrix result;
+    result.method = method;
+    size_t m = columns.size();
+    if (m == 0) return result;
+
+    size_t n = columns[0]->size();
+    for (const std::vector<double>* column : columns) {
+        n = std::min(n, column->size());
+    }
+
+    result.size = m;
+    result.sampleCount = n;
+    result.covariance.assign(m * m, 0.0);
+    result.correlation.assign(m * m, std::numeric_limits<double>::quiet_NaN());
+    if (n < 2) return result;
+
+    // 各列（秩变换后）中心化，连续存放以便分块读取
+    std::vector<std::vector<double>> centered(m);
+    parallelForEach(m, [&](size_t i) {
+        if (method == CorrelationMethod::Spearman) {
+            centered[i] = rankTransform(*columns[i], n);
+        } else {
+            centered[i].assign(columns[i]->begin(), columns[i]->begin() + n);
+        }
+        double mean = std::accumulate(centered[i].begin(), centered[i].end(), 0.0) / n;
+        for (double& v : centered[i]) {
+            v -= mean;
+        }
+    });
+
+    // 只计算上三角的列块对
+    size_t blocks = (m + TileColumns - 1) / TileColumns;
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t bi = 0; bi < blocks; ++bi) {
+        for (size_t bj = bi; bj < blocks; ++bj) {
+            tasks.emplace_back(bi, bj);
+        }
+    }
+
+    double scale = 1.0 / (n - 1);
+    parallelForEach(tasks.size(), [&](size_t t) {
+        size_t iBegin = tasks[t].first * TileColumns;
+        size_t iEnd = std::min(m, iBegin + TileColumns);
+        size_t jBegin = tasks[t].second * TileColumns;
+        size_t jEnd = std::min(m, jBegin + TileColumns);
+
+        std::vector<double> acc((iEnd - iBegin) * (jEnd - jBegin), 0.0);
+        for (size_t r = 0; r < n; r += TileRows) {
+            size_t rows = std::min(TileRows, n - r);
+            for (size_t i = iBegin; i < iEnd; ++i) {
+                const double* zi = centered[i].data() + r;
+                for (size_t j = std::max(i, jBegin); j < jEnd; ++j) {
+                    acc[(i - iBegin) * (jEnd - jBegin) + (j - jBegin)] +=
+                        dotProduct(zi, centered[j].data() + r, rows);
+                }
+            }
+        }
+
+        for (size_t i = iBegin; i < iEnd; ++i) {
+            for (size_t j = std::max(i, jBegin); j < jEnd; ++j) {
+                double cov = acc[(i - iBegin) * (jEnd - jBegin) + (j - jBegin)] * scale;
+                result.covariance[i * m + j] = cov;
+                result.covariance[j * m + i] = cov;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = i; j < m; ++j) {
+            double vi = result.covariance[i * m + i];
+            double vj = result.covariance[j * m + j];
+            if (vi <= 0.0 || vj <= 0.0) continue;
+            double r = (i == j) ? 1.0 : result.covariance[i * m + j] / std::sqrt(vi * vj);
+            r = std::max(-1.0, std::min(1.0, r));
+            result.correlation[i * m + j] = r;
+            result.correlation[j * m + i] = r;
+        }
+    }
+    return result;
+}
+
+const CorrelationMatrix& CorrelationEngine::matrix(const std::vector<uint64_t>& versions,
+                                                   const std::vector<const std::vector<double>*>& columns,
+                                                   CorrelationMethod method)
+{
+    if (!cachedMatrix.isEmpty() && cachedMatrix.method == method && cachedVersions == versions) {
+        return cachedMatrix;
+    }
+
+    cachedMatrix = compute(columns, method);
+    cachedVersions = versions;
+    return cachedMatrix;
+}
@@ -0,0 +1,45 @@
+#ifndef CORRELATION_ENGINE_H
+#define CORRELATION_ENGINE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+enum class CorrelationMethod {
+    Pearson,    // 线性相关
+    Spearman    // 秩相关：先做秩变换（并列取平均秩），再算 Pearson
+};
+
+struct CorrelationMatrix {
+    CorrelationMethod method = CorrelationMethod::Pearson;
+    size_t size = 0;                    // 列数，矩阵为 size x size，按行存储
+    size_t sampleCount = 0;             // 参与计算的行数
+    std::vector<double> covariance;     // Spearman 时为秩的协方差
+    std::vector<double> correlation;    // 方差为 0 的列对应位置为 NaN
+
+    double at(size_t row, size_t column) const { return correlation[row * size + column]; }
+    bool isEmpty() const { return size == 0; }
+};
+
+// 相关/协方差矩阵引擎
+// 列先中心化，再按 GEMM 的方式分块计算 Z * Z^T：列块 x 列块 的每个任务
+// 在固定行块上累加，使两组列的数据同时留在缓存里；各任务写入互不重叠，结果确定
+class CorrelationEngine
+{
+public:
+    static std::vector<double> rankTransform(const std::vector<double>& data, size_t count);
+    static CorrelationMatrix compute(const std::vector<const std::vector<double>*>& columns,
+                                     CorrelationMethod method);
+
+    // versions 与 columns 一一对应（如 ColumnStore::version），用作缓存键
+    const CorrelationMatrix& matrix(const std::vector<uint64_t>& versions,
+                                    const std::vector<const std::vector<double>*>& columns,
+                                    CorrelationMethod method);
+    void clear() { cachedVersions.clear(); cachedMatrix = CorrelationMatrix(); }
+
+private:
+    std::vector<uint64_t> cachedVersions;
+    CorrelationMatrix cachedMatrix;
+};
+
+#endif // CORRELATION_ENGINE_H
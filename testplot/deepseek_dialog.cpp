@@ -228,6 +228,8 @@ void DeepSeekDialog::loadSystemPrompt()
 - 小提琴图 → "violin"
 - 密度图 → "density"
 - 面积图 → "area"
+- 相关热力图/相关矩阵 → "heatmap"
+- 频谱图/功率谱 → "spectrum"
 
 颜色映射：
 - 蓝色 → "#007bff"
@@ -0,0 +1,166 @@
+#include "density_raster.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const size_t MinPointsPerChunk = 1 << 18;
+const size_t MaxBufferBytes = size_t(256) << 20;   // 各线程计数缓冲的总内存上限
+const int EqualizationBins = 65536;                 // 直方图均衡先按 log(c) 细分箱，再取累积分布
+
+struct Range {
+    double xMin = std::numeric_limits<double>::infinity();
+    double xMax = -std::numeric_limits<double>::infinity();
+    double yMin = std::numeric_limits<double>::infinity();
+    double yMax = -std::numeric_limits<double>::infinity();
+};
+
+} // namespace
+
+bool DensityRasterizer::dataRange(const std::vector<double>& x, const std::vector<const std::vector<double>*>& ySeries,
+                                  double& xMin, double& xMax, double& yMin, double& yMax)
+{
+    Range total;
+    for (const std::vector<double>* series : ySeries) {
+        const std::vector<double>& y = *series;
+        size_t n = std::min(x.size(), y.size());
+        size_t chunks = parallelChunkCount(n);
+        std::vector<Range> ranges(chunks);
+        parallelForChunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+            Range& range = ranges[chunk];
+            for (size_t i = begin; i < end; ++i) {
+                if (!std::isfinite(x[i]) || !std::isfinite(y[i])) continue;
+                range.xMin = std::min(range.xMin, x[i]);
+                range.xMax = std::max(range.xMax, x[i]);
+                range.yMin = std::min(range.yMin, y[i]);
+                range.yMax = std::max(range.yMax, y[i]);
+            }
+        });
+        for (const Range& range : ranges) {
+            total.xMin = std::min(total.xMin, range.xMin);
+            total.xMax = std::max(total.xMax, range.xMax);
+            total.yMin = std::min(total.yMin, range.yMin);
+            total.yMax = std::max(total.yMax, range.yMax);
+        }
+    }
+    if (!(total.xMax >= total.xMin)) return false;
+    xMin = total.xMin;
+    xMax = total.xMax;
+    yMin = total.yMin;
+    yMax = total.yMax;
+    return true;
+}
+
+DensityGrid DensityRasterizer::accumulate(const std::vector<double>& x, const std::vector<double>& y, int width,
+                                          int height, double xMin, double xMax, double yMin, double yMax)
+{
+    DensityGrid grid;
+    if (width <= 0 || height <= 0 || !(xMax > xMin) || !(yMax > yMin)) return grid;
+    grid.width = width;
+    grid.height = height;
+    size_t pixels = static_cast<size_t>(width) * height;
+    size_t n = std::min(x.size(), y.size());
+
+    // 每块一个完整的计数缓冲；缓冲数受内存上限约束
+    size_t maxBuffers = std::max<size_t>(1, MaxBufferBytes / (pixels * sizeof(uint32_t)));
+    size_t chunks = std::min(parallelChunkCount(n, MinPointsPerChunk), maxBuffers);
+    std::vector<std::vector<uint32_t>> buffers(std::max<size_t>(1, chunks));
+    const double scaleX = width / (xMax - xMin);
+    const double scaleY = height / (yMax - yMin);
+    parallelForChunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<uint32_t>& counts = buffers[chunk];
+        counts.assign(pixels, 0);
+        for (size_t i = begin; i < end; ++i) {
+            double column = (x[i] - xMin) * scaleX;
+            double row = (yMax - y[i]) * scaleY;
+            // NaN 使比较为假，自然被跳过
+            if (!(column >= 0.0 && column < width && row >= 0.0 && row < height)) continue;
+            ++counts[static_cast<size_t>(row) * width + static_cast<size_t>(column)];
+        }
+    });
+    if (buffers[0].empty()) buffers[0].assign(pixels, 0);
+
+    // 按像素区间并行合并到第 0 个缓冲
+    size_t mergeChunks = parallelChunkCount(pixels);
+    std::vector<uint32_t> maxima(mergeChunks, 0);
+    std::vector<size_t> totals(mergeChunks, 0);
+    parallelForChunks(pixels, mergeChunks, [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<uint32_t>& counts = buffers[0];
+        for (size_t b = 1; b < buffers.size(); ++b) {
+            const std::vector<uint32_t>& other = buffers[b];
+            for (size_t p = begin; p < end; ++p) counts[p] += other[p];
+        }
+        for (size_t p = begin; p < end; ++p) {
+            maxima[chunk] = std::max(maxima[chunk], counts[p]);
+            totals[chunk] += counts[p];
+        }
+    });
+    grid.counts = std::move(buffers[0]);
+    for (size_t c = 0; c < mergeChunks; ++c) {
+        grid.maxCount = std::max(grid.maxCount, maxima[c]);
+        grid.inside += totals[c];
+    }
+    return grid;
+}
+
+std::vector<uint8_t> DensityRasterizer::shade(const std::vector<uint32_t>& counts, uint32_t maxCount, DensityScale scale)
+{
+    std::vector<uint8_t> levels(counts.size(), 0);
+    if (maxCount == 0) return levels;
+    if (maxCount == 1) {
+        for (size_t p = 0; p < counts.size(); ++p) {
+            if (counts[p] > 0) levels[p] = 255;
+        }
+        return levels;
+    }
+
+    double logMax = std::log(static_cast<double>(maxCount));
+    if (scale == DensityScale::Log) {
+        // 同一计数的色阶相同，小计数查表避免逐像素取对数
+        std::vector<uint8_t> table(std::min<uint32_t>(maxCount, 4096) + 1, 0);
+        auto level = [logMax](uint32_t c) {
+            return static_cast<uint8_t>(1 + std::lround(254.0 * std::log(static_cast<double>(c)) / logMax));
+        };
+        for (uint32_t c = 1; c < table.size(); ++c) table[c] = level(c);
+        parallelForChunks(counts.size(), parallelChunkCount(counts.size()), [&](size_t, size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                uint32_t c = counts[p];
+                if (c > 0) levels[p] = c < table.size() ? table[c] : level(c);
+            }
+        });
+        return levels;
+    }
+
+    // 直方图均衡：log(c) 等分成细箱（单调映射，保持计数的秩），按累积分布分配色阶，
+    // 最小计数对应色阶 1，最大计数对应 255
+    std::vector<int> bins(counts.size(), -1);
+    std::vector<size_t> histogram(EqualizationBins, 0);
+    for (size_t p = 0; p < counts.size(); ++p) {
+        if (counts[p] == 0) continue;
+        int bin = static_cast<int>(std::log(static_cast<double>(counts[p])) / logMax * (EqualizationBins - 1));
+        bins[p] = bin;
+        ++histogram[bin];
+    }
+    std::vector<double> cdf(EqualizationBins);
+    size_t running = 0;
+    for (int b = 0; b < EqualizationBins; ++b) {
+        running += histogram[b];
+        cdf[b] = static_cast<double>(running);
+    }
+    double lowest = 0.0;
+    for (int b = 0; b < EqualizationBins; ++b) {
+        if (histogram[b] > 0) {
+            lowest = cdf[b];
+            break;
+        }
+    }
+    double span = static_cast<double>(running) - lowest;
+    for (size_t p = 0; p < counts.size(); ++p) {
+        if (bins[p] < 0) continue;
+        double t = span > 0.0 ? (cdf[bins[p]] - lowest) / span : 1.0;
+        levels[p] = static_cast<uint8_t>(1 + std::lround(254.0 * t));
+    }
+    return levels;
+}
@@ -0,0 +1,59 @@
+#ifndef DENSITY_RASTER_H
+#define DENSITY_RASTER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 计数到色阶的映射
+enum class DensityScale {
+    Log,             // log(c) / log(max)：计数跨越多个数量级时仍能看出结构
+    EqualHistogram   // 直方图均衡：按非空像素计数的经验分布（秩）分配色阶，各色阶的像素数大致相同
+};
+
+enum class ScatterRenderMode {
+    Auto,      // 点数超过 autoThreshold 时改用密度图
+    Points,    // 逐点绘制
+    Density    // 总是绘制密度图
+};
+
+struct ScatterDensitySpec {
+    ScatterRenderMode mode = ScatterRenderMode::Auto;
+    DensityScale scale = DensityScale::Log;
+    size_t autoThreshold = 50000;
+
+    bool operator==(const ScatterDensitySpec& other) const {
+        return mode == other.mode && scale == other.scale && autoThreshold == other.autoThreshold;
+    }
+    bool operator!=(const ScatterDensitySpec& other) const { return !(*this == other); }
+};
+
+// 每个像素的点数，行优先，第 0 行对应 y 的上界
+struct DensityGrid {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> counts;
+    uint32_t maxCount = 0;
+    size_t inside = 0;   // 落在范围内的点数
+
+    bool isEmpty() const { return maxCount == 0; }
+};
+
+// 数据着色（datashader 式）：点先按像素计数，再经色阶查找表上色，绘制代价只与像素数有关
+// 计数时各线程写自己的缓冲，最后按像素区间并行合并，结果与线程数无关
+class DensityRasterizer
+{
+public:
+    // 所有系列中 x、y 都有限的点的范围；没有这样的点时返回 false
+    static bool dataRange(const std::vector<double>& x, const std::vector<const std::vector<double>*>& ySeries,
+                          double& xMin, double& xMax, double& yMin, double& yMax);
+
+    // x ∈ [xMin, xMax)、y ∈ (yMin, yMax] 的点落入 width × height 的像素网格
+    static DensityGrid accumulate(const std::vector<double>& x, const std::vector<double>& y, int width, int height,
+                                  double xMin, double xMax, double yMin, double yMax);
+
+    // 计数映射为色阶：空像素为 0，非空像素为 1..255
+    static std::vector<uint8_t> shade(const std::vector<uint32_t>& counts, uint32_t maxCount, DensityScale scale);
+};
+
+#endif // DENSITY_RASTER_H
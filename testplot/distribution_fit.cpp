@@ -0,0 +1,271 @@
+#include "distribution_fit.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+const double Sqrt2 = 1.41421356237309504880;
+
+// 一次遍历同时得到 KS 的 D 和 AD 的 A^2，每个点只算一次 CDF
+// A^2 = -n - (1/n) * sum_i [(2i-1) ln F_i + (2n-2i+1) ln(1-F_i)]，与按首尾配对的原始公式等价
+void goodnessOfFit(const std::vector<double>& sorted, const DistributionFit& fit, double* ks, double* ad)
+{
+    size_t n = sorted.size();
+    double d = 0.0;
+    double sum = 0.0;
+    const double tiny = 1e-300;
+    for (size_t i = 0; i < n; ++i) {
+        double f = fit.cdf(sorted[i]);
+        d = std::max(d, std::max(static_cast<double>(i + 1) / n - f, f - static_cast<double>(i) / n));
+        double lower = std::max(f, tiny);
+        double upper = std::max(1.0 - f, tiny);
+        sum += (2.0 * i + 1.0) * std::log(lower) + (2.0 * (n - i) - 1.0) * std::log(upper);
+    }
+    if (ks) *ks = d;
+    if (ad) *ad = -static_cast<double>(n) - sum / n;
+}
+
+// 方差为 0 或非有限时视为无法拟合
+bool usableScale(double sigma)
+{
+    return std::isfinite(sigma) && sigma > 0.0;
+}
+
+void fitNormal(const std::vector<double>& x, DistributionFit& fit)
+{
+    size_t n = x.size();
+    double mean = 0.0;
+    for (double v : x) mean += v;
+    mean /= n;
+    double ss = 0.0;
+    for (double v : x) ss += (v - mean) * (v - mean);
+    double sigma = std::sqrt(ss / n);
+    if (!usableScale(sigma)) return;
+
+    fit.parameters = {mean, sigma};
+    fit.logLikelihood = -0.5 * n * std::log(2.0 * M_PI * sigma * sigma) - 0.5 * n;
+    fit.valid = true;
+}
+
+void fitLogNormal(const std::vector<double>& x, DistributionFit& fit)
+{
+    // 有序数据：首元素不为正即不在支撑集内
+    if (x.front() <= 0.0) return;
+    size_t n = x.size();
+    double mean = 0.0;
+    for (double v : x) mean += std::log(v);
+    mean /= n;
+    double ss = 0.0;
+    for (double v : x) {
+        double d = std::log(v) - mean;
+        ss += d * d;
+    }
+    double sigma = std::sqrt(ss / n);
+    if (!usableScale(sigma)) return;
+
+    fit.parameters = {mean, sigma};
+    fit.logLikelihood = -mean * n - n * std::log(sigma) - 0.5 * n * std::log(2.0 * M_PI) - 0.5 * n;
+    fit.valid = true;
+}
+
+void fitExponential(const std::vector<double>& x, DistributionFit& fit)
+{
+    if (x.front() < 0.0) return;
+    size_t n = x.size();
+    double mean = 0.0;
+    for (double v : x) mean += v;
+    mean /= n;
+    if (!(mean > 0.0)) return;
+
+    double lambda = 1.0 / mean;
+    fit.parameters = {lambda};
+    fit.logLikelihood = n * std::log(lambda) - n;
+    fit.valid = true;
+}
+
+// 形状参数 k 满足 g(k) = S1/S0 - 1/k - mean(ln x) = 0，其中 S0 = sum x^k, S1 = sum x^k ln x
+// 先把 x 除以最大值避免 x^k 溢出（g 与尺度无关），Newton 迭代，步长过大时减半保持 k > 0
+void fitWeibull(const std::vector<double>& x, DistributionFit& fit)
+{
+    if (x.front() <= 0.0) return;
+    size_t n = x.size();
+    double scale = x.back();
+
+    std::vector<double> logs(n);
+    double meanLog = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        logs[i] = std::log(x[i] / scale);
+        meanLog += logs[i];
+    }
+    meanLog /= n;
+    double varLog = 0.0;
+    for (double l : logs) varLog += (l - meanLog) * (l - meanLog);
+    varLog /= n;
+    if (!usableScale(varLog)) return;
+
+    // 初值：Gumbel 近似下 ln x 的标准差约为 pi / (sqrt(6) k)
+    double k = M_PI / std::sqrt(6.0 * varLog);
+    for (int iter = 0; iter < 100; ++iter) {
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0;
+        for (double l : logs) {
+            double w = std::exp(k * l);
+            s0 += w;
+            s1 += w * l;
+            s2 += w * l * l;
+        }
+        double g = s1 / s0 - 1.0 / k - meanLog;
+        double dg = (s2 * s0 - s1 * s1) / (s0 * s0) + 1.0 / (k * k);
+        double step = g / dg;
+        while (k - step <= 0.0) step *= 0.5;
+        k -= step;
+        if (std::abs(step) <= 1e-12 * k) break;
+    }
+    if (!std::isfinite(k) || k <= 0.0) return;
+
+    double s0 = 0.0;
+    for (double l : logs) s0 += std::exp(k * l);
+    double lambda = scale * std::pow(s0 / n, 1.0 / k);
+
+    double sumLogX = (meanLog + std::log(scale)) * n;
+    fit.parameters = {k, lambda};
+    fit.logLikelihood = n * std::log(k) - n * k * std::log(lambda) + (k - 1.0) * sumLogX - n;
+    fit.valid = true;
+}
+
+} // namespace
+
+double DistributionFit::pdf(double x) const
+{
+    if (!valid) return 0.0;
+    switch (type) {
+    case DistributionType::Normal: {
+        double z = (x - parameters[0]) / parameters[1];
+        return std::exp(-0.5 * z * z) / (parameters[1] * std::sqrt(2.0 * M_PI));
+    }
+    case DistributionType::LogNormal: {
+        if (x <= 0.0) return 0.0;
+        double z = (std::log(x) - parameters[0]) / parameters[1];
+        return std::exp(-0.5 * z * z) / (x * parameters[1] * std::sqrt(2.0 * M_PI));
+    }
+    case DistributionType::Exponential:
+        return x < 0.0 ? 0.0 : parameters[0] * std::exp(-parameters[0] * x);
+    case DistributionType::Weibull: {
+        if (x < 0.0) return 0.0;
+        double k = parameters[0], lambda = parameters[1];
+        double t = x / lambda;
+        if (t == 0.0) return k == 1.0 ? 1.0 / lambda : (k < 1.0 ? std::numeric_limits<double>::infinity() : 0.0);
+        return k / lambda * std::pow(t, k - 1.0) * std::exp(-std::pow(t, k));
+    }
+    }
+    return 0.0;
+}
+
+double DistributionFit::cdf(double x) const
+{
+    if (!valid) return 0.0;
+    switch (type) {
+    case DistributionType::Normal:
+        return 0.5 * std::erfc(-(x - parameters[0]) / (parameters[1] * Sqrt2));
+    case DistributionType::LogNormal:
+        if (x <= 0.0) return 0.0;
+        return 0.5 * std::erfc(-(std::log(x) - parameters[0]) / (parameters[1] * Sqrt2));
+    case DistributionType::Exponential:
+        return x <= 0.0 ? 0.0 : -std::expm1(-parameters[0] * x);
+    case DistributionType::Weibull:
+        return x <= 0.0 ? 0.0 : -std::expm1(-std::pow(x / parameters[1], parameters[0]));
+    }
+    return 0.0;
+}
+
+const char* DistributionFitter::name(DistributionType type)
+{
+    switch (type) {
+    case DistributionType::Normal:
+        return "正态";
+    case DistributionType::LogNormal:
+        return "对数正态";
+    case DistributionType::Exponential:
+        return "指数";
+    case DistributionType::Weibull:
+        return "威布尔";
+    }
+    return "";
+}
+
+DistributionFit DistributionFitter::fit(const std::vector<double>& sorted, DistributionType type)
+{
+    DistributionFit result;
+    result.type = type;
+    result.sampleCount = sorted.size();
+    if (sorted.size() < 2) return result;
+
+    switch (type) {
+    case DistributionType::Normal:
+        fitNormal(sorted, result);
+        break;
+    case DistributionType::LogNormal:
+        fitLogNormal(sorted, result);
+        break;
+    case DistributionType::Exponential:
+        fitExponential(sorted, result);
+        break;
+    case DistributionType::Weibull:
+        fitWeibull(sorted, result);
+        break;
+    }
+    if (!result.valid) return result;
+
+    goodnessOfFit(sorted, result, &result.ksStatistic, &result.adStatistic);
+    result.ksPValue = kolmogorovPValue(result.ksStatistic, static_cast<double>(sorted.size()));
+    return result;
+}
+
+std::vector<DistributionFit> DistributionFitter::fitAll(const std::vector<double>& sorted)
+{
+    const DistributionType types[] = {DistributionType::Normal, DistributionType::LogNormal,
+                                      DistributionType::Exponential, DistributionType::Weibull};
+    std::vector<DistributionFit> fits(4);
+    parallelForEach(fits.size(), [&](size_t i) {
+        fits[i] = fit(sorted, types[i]);
+    });
+    return fits;
+}
+
+double DistributionFitter::kolmogorovSmirnov(const std::vector<double>& sorted, const DistributionFit& fit)
+{
+    double d = 0.0;
+    goodnessOfFit(sorted, fit, &d, nullptr);
+    return d;
+}
+
+double DistributionFitter::andersonDarling(const std::vector<double>& sorted, const DistributionFit& fit)
+{
+    double a2 = 0.0;
+    goodnessOfFit(sorted, fit, nullptr, &a2);
+    return a2;
+}
+
+double DistributionFitter::kolmogorovPValue(double d, double effectiveCount)
+{
+    if (effectiveCount <= 0.0) return 1.0;
+    double root = std::sqrt(effectiveCount);
+    double lambda = (root + 0.12 + 0.11 / root) * d;
+    if (lambda < 0.2) return 1.0;
+
+    // Q(lambda) = 2 * sum_{j>=1} (-1)^(j-1) exp(-2 j^2 lambda^2)
+    double sum = 0.0;
+    double sign = 1.0;
+    for (int j = 1; j <= 100; ++j) {
+        double term = sign * 2.0 * std::exp(-2.0 * j * j * lambda * lambda);
+        sum += term;
+        if (std::abs(term) < 1e-12 * std::abs(sum)) break;
+        sign = -sign;
+    }
+    return std::max(0.0, std::min(1.0, sum));
+}
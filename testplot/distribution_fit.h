@@ -0,0 +1,44 @@
+#ifndef DISTRIBUTION_FIT_H
+#define DISTRIBUTION_FIT_H
+
+#include <vector>
+#include <cstddef>
+
+enum class DistributionType {
+    Normal,        // 参数: mu, sigma
+    LogNormal,     // 参数: mu, sigma（ln x 的均值和标准差）
+    Exponential,   // 参数: lambda
+    Weibull        // 参数: k（形状）, lambda（尺度）
+};
+
+struct DistributionFit {
+    DistributionType type = DistributionType::Normal;
+    bool valid = false;              // 数据不满足支撑集（如非正数做对数正态）时为 false
+    std::vector<double> parameters;
+    double logLikelihood = 0.0;
+    double ksStatistic = 0.0;        // Kolmogorov–Smirnov D
+    double ksPValue = 0.0;           // 渐近 p 值；参数由同一数据估计，偏保守
+    double adStatistic = 0.0;        // Anderson–Darling A^2
+    size_t sampleCount = 0;
+
+    double pdf(double x) const;
+    double cdf(double x) const;
+};
+
+// 极大似然分布拟合与拟合优度检验，输入必须是升序数据（见 SortedColumnCache）
+class DistributionFitter
+{
+public:
+    static const char* name(DistributionType type);
+
+    static DistributionFit fit(const std::vector<double>& sorted, DistributionType type);
+    // 四种分布并行拟合，按 DistributionType 的顺序返回
+    static std::vector<DistributionFit> fitAll(const std::vector<double>& sorted);
+
+    static double kolmogorovSmirnov(const std::vector<double>& sorted, const DistributionFit& fit);
+    static double andersonDarling(const std::vector<double>& sorted, const DistributionFit& fit);
+    // Kolmogorov 分布的上尾概率 P(D > d)，带 Stephens 小样本修正
+    static double kolmogorovPValue(double d, double effectiveCount);
+};
+
+#endif // DISTRIBUTION_FIT_H
@@ -0,0 +1,189 @@
+#include "fft.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FFT_USE_SSE2
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// 显式展开的复数乘法；std::complex 的 operator* 为处理 inf/NaN 会走慢路径
+inline std::complex<double> multiply(const std::complex<double>& a, const std::complex<double>& b)
+{
+    return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(),
+                                a.real() * b.imag() + a.imag() * b.real());
+}
+
+// 一对蝶形：t = w * b; a' = a + t; b' = a - t
+// std::complex<double> 的内存布局保证为 double[2]，SSE2 下一条寄存器装一个复数
+inline void butterfly(std::complex<double>* a, std::complex<double>* b, const std::complex<double>& w)
+{
+#ifdef FFT_USE_SSE2
+    double* pa = reinterpret_cast<double*>(a);
+    double* pb = reinterpret_cast<double*>(b);
+    const __m128d negateLow = _mm_set_pd(0.0, -0.0);
+    __m128d va = _mm_loadu_pd(pa);
+    __m128d vb = _mm_loadu_pd(pb);
+    __m128d swapped = _mm_shuffle_pd(vb, vb, 1);  // [bi, br]
+    __m128d t = _mm_add_pd(_mm_mul_pd(vb, _mm_set1_pd(w.real())),
+                           _mm_xor_pd(_mm_mul_pd(swapped, _mm_set1_pd(w.imag())), negateLow));
+    _mm_storeu_pd(pa, _mm_add_pd(va, t));
+    _mm_storeu_pd(pb, _mm_sub_pd(va, t));
+#else
+    std::complex<double> t = multiply(*b, w);
+    *b = *a - t;
+    *a += t;
+#endif
+}
+
+void fftBluestein(std::vector<std::complex<double>>& data, bool inverse)
+{
+    size_t n = data.size();
+    size_t m = nextPowerOfTwo(2 * n - 1);
+    double sign = inverse ? 1.0 : -1.0;
+
+    // chirp w_k = exp(sign * i*pi*k^2/n)；k^2 先对 2n 取模，避免大 k 时相位失去精度
+    std::vector<std::complex<double>> chirp(n);
+    for (size_t k = 0; k < n; ++k) {
+        unsigned long long k2 = (static_cast<unsigned long long>(k) * k) % (2ULL * n);
+        chirp[k] = std::polar(1.0, sign * M_PI * static_cast<double>(k2) / n);
+    }
+
+    // X_k = w_k * sum_j (x_j w_j) conj(w_{k-j})，即一次长度为 m 的循环卷积
+    std::vector<std::complex<double>> a(m), b(m);
+    for (size_t k = 0; k < n; ++k) {
+        a[k] = multiply(data[k], chirp[k]);
+    }
+    b[0] = std::conj(chirp[0]);
+    for (size_t k = 1; k < n; ++k) {
+        b[k] = b[m - k] = std::conj(chirp[k]);
+    }
+
+    fftRadix2(a);
+    fftRadix2(b);
+    for (size_t i = 0; i < m; ++i) {
+        a[i] = multiply(a[i], b[i]);
+    }
+    fftRadix2(a, true);
+
+    double scale = inverse ? 1.0 / n : 1.0;
+    for (size_t k = 0; k < n; ++k) {
+        data[k] = multiply(a[k], chirp[k]) * scale;
+    }
+}
+
+} // namespace
+
+size_t nextPowerOfTwo(size_t n)
+{
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+bool isPowerOfTwo(size_t n)
+{
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+void fftRadix2(std::vector<std::complex<double>>& data, bool inverse)
+{
+    size_t n = data.size();
+    if (n <= 1 || !isPowerOfTwo(n)) return;
+
+    // 位反转重排
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+
+    // 旋转因子只按最大级算一次，各级按步长取用并拷贝成连续数组，
+    // 避免在内层循环里累乘带来的误差
+    double sign = inverse ? 1.0 : -1.0;
+    std::vector<std::complex<double>> table(n / 2);
+    for (size_t k = 0; k < n / 2; ++k) {
+        table[k] = std::polar(1.0, sign * 2.0 * M_PI * k / n);
+    }
+
+    std::vector<std::complex<double>> twiddles(n / 2);
+    std::complex<double>* values = data.data();
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        size_t stride = n / len;
+        for (size_t k = 0; k < half; ++k) {
+            twiddles[k] = table[k * stride];
+        }
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t k = 0; k < half; ++k) {
+                butterfly(values + i + k, values + i + k + half, twiddles[k]);
+            }
+        }
+    }
+
+    if (inverse) {
+        double scale = 1.0 / n;
+        for (auto& value : data) {
+            value *= scale;
+        }
+    }
+}
+
+void fft(std::vector<std::complex<double>>& data, bool inverse)
+{
+    size_t n = data.size();
+    if (n <= 1) return;
+    if (isPowerOfTwo(n)) {
+        fftRadix2(data, inverse);
+    } else {
+        fftBluestein(data, inverse);
+    }
+}
+
+std::vector<double> fftConvolve(const std::vector<double>& a, const std::vector<double>& b)
+{
+    if (a.empty() || b.empty()) return std::vector<double>();
+
+    size_t resultSize = a.size() + b.size() - 1;
+    size_t n = nextPowerOfTwo(resultSize);
+
+    // 两个实序列装进一个复序列的实部和虚部，只做一次正变换
+    // 拆分时一方的频谱带有另一方量级的舍入误差，因此先把 b 按 2 的幂缩放到与 a 同量级（缩放是精确的），最后再除回
+    double maxA = 0.0, maxB = 0.0;
+    for (double v : a) maxA = std::max(maxA, std::abs(v));
+    for (double v : b) maxB = std::max(maxB, std::abs(v));
+    int exponentA = 0, exponentB = 0;
+    std::frexp(maxA, &exponentA);
+    std::frexp(maxB, &exponentB);
+    int shift = (maxA > 0.0 && maxB > 0.0) ? exponentA - exponentB : 0;
+    std::vector<std::complex<double>> packed(n);
+    for (size_t i = 0; i < a.size(); ++i) packed[i].real(a[i]);
+    for (size_t i = 0; i < b.size(); ++i) packed[i].imag(std::ldexp(b[i], shift));
+    fftRadix2(packed);
+
+    // A(k) = (P(k) + conj(P(n-k))) / 2, B(k) = (P(k) - conj(P(n-k))) / 2i
+    std::vector<std::complex<double>> product(n);
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> p = packed[k];
+        std::complex<double> q = std::conj(packed[(n - k) & (n - 1)]);
+        std::complex<double> fa = (p + q) * 0.5;
+        std::complex<double> fb = (p - q) * std::complex<double>(0.0, -0.5);
+        product[k] = multiply(fa, fb);
+    }
+    fftRadix2(product, true);
+
+    std::vector<double> result(resultSize);
+    for (size_t i = 0; i < resultSize; ++i) {
+        result[i] = std::ldexp(product[i].real(), -shift);
+    }
+    return result;
+}
@@ -0,0 +1,22 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+// 基础 FFT 工具：迭代式基 2 Cooley-Tukey，任意长度用 Bluestein 转成 2 的幂长度的卷积
+
+size_t nextPowerOfTwo(size_t n);
+bool isPowerOfTwo(size_t n);
+
+// 原地复数 FFT，长度必须是 2 的幂；inverse 为 true 时做逆变换并除以 N
+void fftRadix2(std::vector<std::complex<double>>& data, bool inverse = false);
+
+// 原地复数 FFT，任意长度；2 的幂直接走基 2，其他长度走 Bluestein（chirp-z）
+void fft(std::vector<std::complex<double>>& data, bool inverse = false);
+
+// 两个实序列的线性卷积，结果长度为 a.size() + b.size() - 1
+std::vector<double> fftConvolve(const std::vector<double>& a, const std::vector<double>& b);
+
+#endif // FFT_H
@@ -0,0 +1,98 @@
+#ifndef FIT_CACHE_H
+#define FIT_CACHE_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// 一次拟合的身份：X/Y 列号、两列的数据版本、模型及其设置（序列化成字符串）
+// 数据版本在列被替换或重算后改变，旧结果自然不再命中
+struct FitCacheKey {
+    int xColumn = -1;
+    int yColumn = -1;
+    uint64_t xVersion = 0;
+    uint64_t yVersion = 0;
+    std::string model;
+
+    bool sameData(int x, int y, uint64_t xv, uint64_t yv) const
+    {
+        return xColumn == x && yColumn == y && xVersion == xv && yVersion == yv;
+    }
+    bool operator<(const FitCacheKey& other) const
+    {
+        return std::tie(xColumn, yColumn, xVersion, yVersion, model)
+             < std::tie(other.xColumn, other.yColumn, other.xVersion, other.yVersion, other.model);
+    }
+};
+
+// 拟合结果缓存：按最近使用排序的链表 + 键索引，超出容量时淘汰最久未用的结果
+// 只在界面线程使用，不加锁
+template <typename Value>
+class FitResultCache
+{
+public:
+    struct Entry {
+        FitCacheKey key;
+        Value value;
+    };
+
+    explicit FitResultCache(size_t capacity = 32) : maxEntries(capacity) {}
+
+    // 命中时把条目移到最前（最近使用），未命中返回空指针
+    const Entry* find(const FitCacheKey& key)
+    {
+        auto it = index.find(key);
+        if (it == index.end()) return nullptr;
+        entryList.splice(entryList.begin(), entryList, it->second);
+        return &*it->second;
+    }
+
+    // 某对列在给定数据版本下最近使用的结果（不限模型），同样移到最前
+    const Entry* latest(int xColumn, int yColumn, uint64_t xVersion, uint64_t yVersion)
+    {
+        for (auto it = entryList.begin(); it != entryList.end(); ++it) {
+            if (it->key.sameData(xColumn, yColumn, xVersion, yVersion)) {
+                entryList.splice(entryList.begin(), entryList, it);
+                return &entryList.front();
+            }
+        }
+        return nullptr;
+    }
+
+    // 同键的旧结果被替换
+    void insert(const FitCacheKey& key, Value value)
+    {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entryList.erase(it->second);
+            index.erase(it);
+        }
+        entryList.push_front(Entry{key, std::move(value)});
+        index[key] = entryList.begin();
+        while (entryList.size() > maxEntries) {
+            index.erase(entryList.back().key);
+            entryList.pop_back();
+        }
+    }
+
+    void clear()
+    {
+        entryList.clear();
+        index.clear();
+    }
+
+    // 按最近使用排序，列出缓存内容用
+    const std::list<Entry>& entries() const { return entryList; }
+    size_t size() const { return entryList.size(); }
+
+private:
+    size_t maxEntries;
+    std::list<Entry> entryList;
+    std::map<FitCacheKey, typename std::list<Entry>::iterator> index;
+};
+
+#endif // FIT_CACHE_H
@@ -0,0 +1,267 @@
+#include "fit_model.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const size_t BlockSize = 256;
+const int MaxRefinePasses = 12;
+
+// 按系数外层、点内层的 Horner：values = c[n-1]，再逐个 values = values * t + c[k]
+void hornerBlock(const double* t, size_t count, const double* c, size_t n, double* values)
+{
+    std::fill(values, values + count, c[n - 1]);
+    for (size_t k = n - 1; k-- > 0;) {
+        double ck = c[k];
+        for (size_t i = 0; i < count; ++i) values[i] = values[i] * t[i] + ck;
+    }
+}
+
+} // namespace
+
+double sineModel(double x, const double* p, double* gradient)
+{
+    double angle = p[1] * x + p[2];
+    double s = std::sin(angle);
+    if (gradient) {
+        double c = std::cos(angle);
+        gradient[0] = s;                 // ∂f/∂A
+        gradient[1] = p[0] * x * c;      // ∂f/∂B
+        gradient[2] = p[0] * c;          // ∂f/∂C
+        gradient[3] = 1.0;               // ∂f/∂D
+    }
+    return p[0] * s + p[3];
+}
+
+double gaussianModel(double x, const double* p, double* gradient)
+{
+    double arg = (x - p[1]) / p[2];
+    double expValue = std::exp(-arg * arg);
+    if (gradient) {
+        gradient[0] = expValue;                                  // ∂f/∂A
+        gradient[1] = p[0] * expValue * 2.0 * arg / p[2];        // ∂f/∂B
+        gradient[2] = p[0] * expValue * 2.0 * arg * arg / p[2];  // ∂f/∂C
+    }
+    return p[0] * expValue;
+}
+
+FitModel::FitModel(int type, std::vector<double> coefficients, std::shared_ptr<const ModelExpression> expression,
+                   std::shared_ptr<const SmoothCurve> curve)
+    : modelType(type), parameters(std::move(coefficients)), formula(std::move(expression)), smoothCurve(std::move(curve))
+{
+}
+
+bool FitModel::isValid() const
+{
+    switch (modelType) {
+    case 1:
+    case 2:
+        return !parameters.empty();
+    case 3:
+        return parameters.size() >= 4;
+    case 4:
+        return parameters.size() >= 3;
+    case 5:
+        return parameters.size() >= 3 && parameters[1] != 0.0;
+    case 6:
+        return formula && parameters.size() == formula->parameterCount();
+    case 7:
+    case 8:
+        return smoothCurve && smoothCurve->knots.size() >= 2;
+    case 9: {
+        if (parameters.size() < 4 || parameters[1] == 0.0) return false;
+        double degree = parameters[2];
+        if (!(degree >= 0.0 && degree <= 3.0) || degree != std::floor(degree)) return false;
+        size_t perSegment = static_cast<size_t>(degree) + 1;
+        size_t rest = parameters.size() - 3;
+        return rest >= perSegment && (rest - perSegment) % (perSegment + 1) == 0;
+    }
+    default:
+        return false;
+    }
+}
+
+void FitModel::evaluateBlock(const double* x, size_t count, double* values) const
+{
+    const double* p = parameters.data();
+    switch (modelType) {
+    case 1:
+    case 2:
+        hornerBlock(x, count, p, parameters.size(), values);
+        break;
+    case 5: {
+        double t[BlockSize];
+        double inverseHalfRange = 1.0 / p[1];
+        for (size_t i = 0; i < count; ++i) t[i] = (x[i] - p[0]) * inverseHalfRange;
+        hornerBlock(t, count, p + 2, parameters.size() - 2, values);
+        break;
+    }
+    case 3:
+        for (size_t i = 0; i < count; ++i) values[i] = p[0] * std::sin(p[1] * x[i] + p[2]) + p[3];
+        break;
+    case 4: {
+        double inverseWidth = 1.0 / p[2];
+        for (size_t i = 0; i < count; ++i) {
+            double arg = (x[i] - p[1]) * inverseWidth;
+            values[i] = p[0] * std::exp(-arg * arg);
+        }
+        break;
+    }
+    case 6:
+        formula->evaluate(x, count, p, values);
+        break;
+    case 7:
+    case 8:
+        smoothCurve->evaluate(x, count, values);
+        break;
+    case 9: {
+        size_t perSegment = static_cast<size_t>(p[2]) + 1;
+        size_t breaks = breakpointCount();
+        const double* bounds = p + 3;
+        const double* segments = bounds + breaks;
+        double inverseHalfRange = 1.0 / p[1];
+        for (size_t i = 0; i < count; ++i) {
+            size_t segment = static_cast<size_t>(std::upper_bound(bounds, bounds + breaks, x[i]) - bounds);
+            const double* c = segments + segment * perSegment;
+            double t = (x[i] - p[0]) * inverseHalfRange;
+            double value = c[perSegment - 1];
+            for (size_t k = perSegment - 1; k-- > 0;) value = value * t + c[k];
+            values[i] = value;
+        }
+        break;
+    }
+    }
+}
+
+size_t FitModel::breakpointCount() const
+{
+    size_t perSegment = static_cast<size_t>(parameters[2]) + 1;
+    return (parameters.size() - 3 - perSegment) / (perSegment + 1);
+}
+
+std::vector<double> FitModel::breakpoints() const
+{
+    if (modelType != 9 || !isValid()) return std::vector<double>();
+    return std::vector<double>(parameters.begin() + 3, parameters.begin() + 3 + breakpointCount());
+}
+
+void FitModel::evaluate(const double* x, size_t count, double* values) const
+{
+    if (!isValid()) {
+        std::fill(values, values + count, std::numeric_limits<double>::quiet_NaN());
+        return;
+    }
+    parallelForChunks(count, parallelChunkCount(count), [&](size_t, size_t begin, size_t end) {
+        for (size_t start = begin; start < end; start += BlockSize) {
+            evaluateBlock(x + start, std::min(BlockSize, end - start), values + start);
+        }
+    });
+}
+
+std::vector<double> FitModel::evaluate(const std::vector<double>& x) const
+{
+    std::vector<double> values(x.size());
+    evaluate(x.data(), x.size(), values.data());
+    return values;
+}
+
+std::vector<double> FitModel::residuals(const std::vector<double>& x, const std::vector<double>& y) const
+{
+    size_t count = std::min(x.size(), y.size());
+    std::vector<double> result(count);
+    evaluate(x.data(), count, result.data());
+    for (size_t i = 0; i < count; ++i) result[i] = y[i] - result[i];
+    return result;
+}
+
+void FitModel::sampleCurve(double xMin, double xMax, double pixelWidth, double pixelsPerY,
+                           std::vector<double>& xs, std::vector<double>& ys, double tolerance) const
+{
+    xs.clear();
+    ys.clear();
+    if (!isValid() || !(xMax > xMin) || !(pixelWidth > 0.0)) return;
+
+    size_t initial = std::max<size_t>(16, static_cast<size_t>(pixelWidth / 8.0));
+    size_t maxPoints = std::max<size_t>(initial + 1, static_cast<size_t>(pixelWidth * 4.0));
+    double minSpacing = 0.5 * (xMax - xMin) / pixelWidth;
+
+    xs.resize(initial + 1);
+    for (size_t i = 0; i <= initial; ++i) {
+        xs[i] = xMin + (xMax - xMin) * static_cast<double>(i) / static_cast<double>(initial);
+    }
+    ys = evaluate(xs);
+
+    // active[i] 表示区间 [xs[i], xs[i+1]] 还需要检查；每轮把所有待查区间的中点一次求值
+    std::vector<char> active(initial, 1);
+    std::vector<double> midX, midY, nextX, nextY;
+    std::vector<char> nextActive;
+    for (int pass = 0; pass < MaxRefinePasses && xs.size() < maxPoints; ++pass) {
+        midX.clear();
+        for (size_t i = 0; i + 1 < xs.size(); ++i) {
+            if (active[i] && xs[i + 1] - xs[i] > minSpacing) midX.push_back(0.5 * (xs[i] + xs[i + 1]));
+        }
+        if (midX.empty()) break;
+        midY = evaluate(midX);
+
+        nextX.clear();
+        nextY.clear();
+        nextActive.clear();
+        size_t m = 0;
+        bool refined = false;
+        for (size_t i = 0; i + 1 < xs.size(); ++i) {
+            nextX.push_back(xs[i]);
+            nextY.push_back(ys[i]);
+            if (!(active[i] && xs[i + 1] - xs[i] > minSpacing)) {
+                nextActive.push_back(0);
+                continue;
+            }
+            double ym = midY[m];
+            double xm = midX[m++];
+            bool finiteA = std::isfinite(ys[i]), finiteB = std::isfinite(ys[i + 1]), finiteM = std::isfinite(ym);
+            bool split;
+            if (finiteA && finiteB && finiteM) {
+                split = std::abs(ym - 0.5 * (ys[i] + ys[i + 1])) * pixelsPerY > tolerance;
+            } else {
+                // 定义域边界附近继续二分，使断开处尽量贴近边界
+                split = finiteA || finiteB || finiteM;
+            }
+            if (split && nextX.size() + (xs.size() - i) < maxPoints) {
+                nextX.push_back(xm);
+                nextY.push_back(ym);
+                nextActive.push_back(1);
+                nextActive.push_back(1);
+                refined = true;
+            } else {
+                nextActive.push_back(0);
+            }
+        }
+        nextX.push_back(xs.back());
+        nextY.push_back(ys.back());
+        xs.swap(nextX);
+        ys.swap(nextY);
+        active.swap(nextActive);
+        if (!refined) break;
+    }
+
+    // 分段模型在断点处不连续：跨过断点的相邻采样之间插入 NaN，使曲线在此断开而不画出竖线
+    std::vector<double> breaks = breakpoints();
+    if (breaks.empty()) return;
+    nextX.clear();
+    nextY.clear();
+    size_t next = 0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        while (next < breaks.size() && breaks[next] <= xs[i]) {
+            if (i > 0 && xs[i - 1] < breaks[next]) {
+                nextX.push_back(breaks[next]);
+                nextY.push_back(std::numeric_limits<double>::quiet_NaN());
+            }
+            ++next;
+        }
+        nextX.push_back(xs[i]);
+        nextY.push_back(ys[i]);
+    }
+    xs.swap(nextX);
+    ys.swap(nextY);
+}
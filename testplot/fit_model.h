@@ -0,0 +1,61 @@
+#ifndef FIT_MODEL_H
+#define FIT_MODEL_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include "model_expression.h"
+#include "smoothing_fit.h"
+
+// 拟合得到的模型：类型码（同拟合类型下拉框）和系数，自定义公式另带编译后的表达式
+//   1, 2  多项式，关于 x 的幂次系数 a0, a1, ...
+//   3     正弦 y = A*sin(B*x + C) + D
+//   4     高斯 y = A*exp(-((x-B)/C)^2)
+//   5     高次多项式 [中心, 半宽, a0, a1, ...]，关于 t = (x - 中心) / 半宽 的幂次系数
+//   6     自定义公式，系数为各参数的值
+//   7, 8  平滑样条、LOESS，曲线由节点表示，系数只是摘要（样条 [λ, 等效自由度, GCV]，LOESS [窗口比例, 邻域点数]）
+//   9     分段多项式 [中心, 半宽, 次数 d, 断点 b1..bk, 各段关于 t 的系数 (d + 1) × (k + 1)]
+// 残差、曲线绘制和导出共用这里的求值：一次对一段 x 求值，多项式按系数外层、点内层做 Horner，
+// 内层是对连续数组的紧凑循环，便于编译器向量化；数据量大时分块并行
+class FitModel
+{
+public:
+    FitModel() = default;
+    FitModel(int type, std::vector<double> coefficients, std::shared_ptr<const ModelExpression> expression = nullptr,
+             std::shared_ptr<const SmoothCurve> curve = nullptr);
+
+    bool isValid() const;
+    int type() const { return modelType; }
+    const std::vector<double>& coefficients() const { return parameters; }
+    const std::shared_ptr<const ModelExpression>& expression() const { return formula; }
+    const std::shared_ptr<const SmoothCurve>& curve() const { return smoothCurve; }
+    // 分段模型的断点，其他模型为空
+    std::vector<double> breakpoints() const;
+
+    void evaluate(const double* x, size_t count, double* values) const;
+    std::vector<double> evaluate(const std::vector<double>& x) const;
+    // y - f(x)
+    std::vector<double> residuals(const std::vector<double>& x, const std::vector<double>& y) const;
+
+    // 自适应采样 [xMin, xMax] 用于绘制：先按约每 8 像素一个点均匀采样，再在区间中点偏离弦超过 tolerance 像素
+    // （或两端一侧有定义一侧无定义）处二分，直到区间不足半个像素或点数达到宽度的 4 倍
+    // pixelsPerY 为纵向每单位对应的像素数；无定义处 ys 为 NaN，绘制时据此断开曲线
+    void sampleCurve(double xMin, double xMax, double pixelWidth, double pixelsPerY,
+                     std::vector<double>& xs, std::vector<double>& ys, double tolerance = 0.5) const;
+
+private:
+    void evaluateBlock(const double* x, size_t count, double* values) const;
+    size_t breakpointCount() const;
+
+    int modelType = 0;
+    std::vector<double> parameters;
+    std::shared_ptr<const ModelExpression> formula;
+    std::shared_ptr<const SmoothCurve> smoothCurve;
+};
+
+// 正弦（类型 3）、高斯（类型 4）模型的逐点求值及解析 Jacobian，参数顺序同上；gradient 非空时写入 ∂f/∂p
+// 界面的拟合和拟合基准共用，可直接包装成 Levenberg–Marquardt 的 NonlinearModel
+double sineModel(double x, const double* p, double* gradient);
+double gaussianModel(double x, const double* p, double* gradient);
+
+#endif // FIT_MODEL_H
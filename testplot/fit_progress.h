@@ -0,0 +1,22 @@
+#ifndef FIT_PROGRESS_H
+#define FIT_PROGRESS_H
+
+#include <atomic>
+#include <limits>
+
+// 拟合任务与界面之间共享的进度和取消标志：拟合线程写入，界面线程定时读取
+// 迭代算法更新 iteration / objective，单遍算法更新 fraction（0..1）
+// 批量拟合时多个任务共用一个实例：取消标志对所有任务生效，进度看 completedTasks / totalTasks
+struct FitProgress {
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> iteration{0};
+    std::atomic<double> objective{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<double> fraction{0.0};
+    std::atomic<int> completedTasks{0};
+    int totalTasks = 0;              // 0 表示单个拟合
+
+    void cancel() { cancelled.store(true); }
+    bool isCancelled() const { return cancelled.load(); }
+};
+
+#endif // FIT_PROGRESS_H
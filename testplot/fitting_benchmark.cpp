@@ -0,0 +1,93 @@
+#include "fitting_benchmark.h"
+#include "fit_model.h"
+#include "levenberg_marquardt.h"
+#include "model_expression.h"
+#include "polynomial_fit.h"
+#include "parallel_utils.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace {
+
+struct Workload {
+    const char* name;
+    std::function<std::vector<double>()> run;   // 返回用于比对的结果（参数或系数）
+};
+
+std::vector<unsigned int> threadCounts()
+{
+    unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> counts;
+    for (unsigned int t = 1; t < hardware; t *= 2) counts.push_back(t);
+    counts.push_back(hardware);
+    return counts;
+}
+
+} // namespace
+
+void FittingBenchmark::run(const std::vector<size_t>& sizes, std::ostream& out)
+{
+    std::string error;
+    std::shared_ptr<const ModelExpression> expression = ModelExpression::compile("a*exp(-((x-b)/c)^2)", &error);
+    NonlinearBlockModel expressionModel = [&expression](const double* xs, size_t count, const double* p,
+                                                        double* values, double* jacobian) {
+        if (jacobian) {
+            expression->evaluateWithJacobian(xs, count, p, values, jacobian);
+        } else {
+            expression->evaluate(xs, count, p, values);
+        }
+    };
+
+    unsigned int previousLimit = workerThreadLimit().load();
+    out << "线程数 x 拟合耗时（硬件线程 " << std::thread::hardware_concurrency() << "）" << std::endl;
+
+    for (size_t n : sizes) {
+        // 高斯峰加噪声，x 均匀分布在 [0, 10)
+        std::vector<double> x(n), y(n);
+        std::mt19937_64 generator(42);
+        std::normal_distribution<double> noise(0.0, 0.05);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = 10.0 * static_cast<double>(i) / static_cast<double>(n);
+            y[i] = 3.0 * std::exp(-std::pow((x[i] - 4.0) / 1.5, 2.0)) + noise(generator);
+        }
+
+        const std::vector<double> initial = {2.0, 4.5, 1.0};
+        std::vector<Workload> workloads = {
+            {"高斯 LM", [&]() {
+                 return LevenbergMarquardt::fit(x, y, NonlinearModel(gaussianModel), initial).parameters;
+             }},
+            {"公式 LM", [&]() {
+                 return LevenbergMarquardt::fit(x, y, expressionModel, initial).parameters;
+             }},
+            {"10次多项式", [&]() {
+                 return PolynomialFitter::fit(x, y, 10).coefficients;
+             }},
+        };
+
+        out << std::endl << "n = " << n << std::endl;
+        out << "任务\t线程\t耗时(s)\t加速比\t与单线程一致" << std::endl;
+        for (const Workload& workload : workloads) {
+            double baseline = 0.0;
+            std::vector<double> reference;
+            for (unsigned int threads : threadCounts()) {
+                workerThreadLimit().store(threads);
+                auto start = std::chrono::steady_clock::now();
+                std::vector<double> result = workload.run();
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (threads == 1) {
+                    baseline = seconds;
+                    reference = result;
+                }
+                char line[128];
+                std::snprintf(line, sizeof(line), "%s\t%u\t%.3f\t%.2f\t%s", workload.name, threads, seconds,
+                              baseline / seconds, result == reference ? "是" : "否");
+                out << line << std::endl;
+            }
+        }
+    }
+    workerThreadLimit().store(previousLimit);
+}
@@ -0,0 +1,17 @@
+#ifndef FITTING_BENCHMARK_H
+#define FITTING_BENCHMARK_H
+
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+// 拟合的线程扩展性基准：对每个数据规模，分别用 1, 2, 4, ... 个线程运行
+// 高斯 Levenberg–Marquardt（解析 Jacobian）、自定义公式 Levenberg–Marquardt（自动微分）和 10 次多项式 QR，
+// 输出耗时、相对单线程的加速比，并检查结果与单线程逐位一致（归约顺序确定）
+class FittingBenchmark
+{
+public:
+    static void run(const std::vector<size_t>& sizes, std::ostream& out);
+};
+
+#endif // FITTING_BENCHMARK_H
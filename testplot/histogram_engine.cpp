@@ -0,0 +1,115 @@
+#include "histogram_engine.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+
+int HistogramEngine::binCountFor(const BinSpec& spec, const StatisticsAccumulator& stats)
+{
+    size_t n = stats.count();
+    if (n == 0) return 1;
+    double range = stats.range();
+
+    // 由箱宽换算箱数，箱宽无效时返回 0 让调用者回退
+    auto binsFromWidth = [range](double width) -> int {
+        if (!(width > 0.0) || !(range > 0.0)) return 0;
+        return static_cast<int>(std::ceil(range / width));
+    };
+
+    int bins = 0;
+    switch (spec.rule) {
+    case BinRule::SquareRoot:
+        bins = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+        break;
+    case BinRule::Sturges:
+        bins = static_cast<int>(std::ceil(std::log2(static_cast<double>(n)))) + 1;
+        break;
+    case BinRule::Scott:
+        bins = binsFromWidth(3.49 * std::sqrt(stats.sampleVariance()) * std::cbrt(1.0 / n));
+        break;
+    case BinRule::FreedmanDiaconis: {
+        double iqr = stats.quantile(0.75) - stats.quantile(0.25);
+        bins = binsFromWidth(2.0 * iqr * std::cbrt(1.0 / n));
+        if (bins == 0) {
+            // IQR 为 0（大量重复值）时退回 Scott 规则
+            bins = binsFromWidth(3.49 * std::sqrt(stats.sampleVariance()) * std::cbrt(1.0 / n));
+        }
+        break;
+    }
+    case BinRule::Fixed:
+        bins = spec.binCount;
+        break;
+    }
+
+    if (bins <= 0) {
+        bins = static_cast<int>(std::ceil(std::log2(static_cast<double>(n)))) + 1;
+    }
+    return std::max(1, std::min(bins, MaxBins));
+}
+
+HistogramResult HistogramEngine::compute(const std::vector<double>& data, const BinSpec& spec,
+                                         const StatisticsAccumulator* stats)
+{
+    HistogramResult result;
+    if (data.empty()) return result;
+
+    // 没有现成的统计量时在这里补算（Scott/FD 规则需要标准差和分位数）
+    StatisticsAccumulator localStats;
+    if (!stats || stats->count() != data.size()) {
+        localStats.append(data);
+        stats = &localStats;
+    }
+
+    int bins = binCountFor(spec, *stats);
+    double minVal = stats->min();
+    double maxVal = stats->max();
+    if (!(maxVal > minVal)) {
+        // 所有值相同：单箱，宽度取 1 以便绘制
+        bins = 1;
+        minVal -= 0.5;
+        maxVal = minVal + 1.0;
+    }
+
+    double binWidth = (maxVal - minVal) / bins;
+    double invWidth = 1.0 / binWidth;
+
+    // 每个线程使用独立计数器，避免原子操作和伪共享
+    size_t chunks = parallelChunkCount(data.size());
+    std::vector<std::vector<size_t>> localCounts(chunks, std::vector<size_t>(bins, 0));
+    parallelForChunks(data.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<size_t>& counts = localCounts[chunk];
+        for (size_t i = begin; i < end; ++i) {
+            double v = data[i];
+            if (!(v >= minVal && v <= maxVal)) continue;
+            size_t bin = static_cast<size_t>((v - minVal) * invWidth);
+            if (bin >= static_cast<size_t>(bins)) bin = bins - 1;
+            counts[bin]++;
+        }
+    });
+
+    result.minValue = minVal;
+    result.maxValue = maxVal;
+    result.binWidth = binWidth;
+    result.counts.assign(bins, 0);
+    for (const auto& counts : localCounts) {
+        for (int b = 0; b < bins; ++b) {
+            result.counts[b] += counts[b];
+        }
+    }
+    for (size_t c : result.counts) {
+        result.maxCount = std::max(result.maxCount, c);
+        result.total += c;
+    }
+    return result;
+}
+
+const HistogramResult& HistogramEngine::histogram(uint64_t version, const std::vector<double>& data,
+                                                  const BinSpec& spec, const StatisticsAccumulator* stats)
+{
+    if (!hasCache || cachedVersion != version || cachedSpec != spec) {
+        cached = compute(data, spec, stats);
+        cachedVersion = version;
+        cachedSpec = spec;
+        hasCache = true;
+    }
+    return cached;
+}
@@ -0,0 +1,61 @@
+#ifndef HISTOGRAM_ENGINE_H
+#define HISTOGRAM_ENGINE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "statistics_accumulator.h"
+
+// 直方图分箱规则
+enum class BinRule {
+    SquareRoot,         // ceil(sqrt(n))
+    Sturges,            // ceil(log2(n)) + 1
+    Scott,              // h = 3.49 * sigma * n^(-1/3)
+    FreedmanDiaconis,   // h = 2 * IQR * n^(-1/3)
+    Fixed               // 使用 binCount 指定的箱数
+};
+
+struct BinSpec {
+    BinRule rule = BinRule::Sturges;
+    int binCount = 20;   // 仅 Fixed 规则使用
+
+    bool operator==(const BinSpec& other) const {
+        return rule == other.rule && (rule != BinRule::Fixed || binCount == other.binCount);
+    }
+    bool operator!=(const BinSpec& other) const { return !(*this == other); }
+};
+
+struct HistogramResult {
+    double minValue = 0.0;
+    double maxValue = 0.0;
+    double binWidth = 0.0;
+    std::vector<size_t> counts;
+    size_t maxCount = 0;
+    size_t total = 0;
+
+    bool isEmpty() const { return counts.empty(); }
+};
+
+// 直方图引擎：多线程分箱（每个线程独立计数再合并），缓存最近一次结果
+// 缓存键为 (数据版本, 分箱规格)，平移/缩放重绘时直接复用
+class HistogramEngine
+{
+public:
+    static constexpr int MaxBins = 2000;
+
+    static int binCountFor(const BinSpec& spec, const StatisticsAccumulator& stats);
+    static HistogramResult compute(const std::vector<double>& data, const BinSpec& spec,
+                                   const StatisticsAccumulator* stats = nullptr);
+
+    const HistogramResult& histogram(uint64_t version, const std::vector<double>& data, const BinSpec& spec,
+                                     const StatisticsAccumulator* stats = nullptr);
+    void clear() { hasCache = false; cached = HistogramResult(); }
+
+private:
+    bool hasCache = false;
+    uint64_t cachedVersion = 0;
+    BinSpec cachedSpec;
+    HistogramResult cached;
+};
+
+#endif // HISTOGRAM_ENGINE_H
@@ -0,0 +1,56 @@
+#ifndef KDE_ENGINE_H
+#define KDE_ENGINE_H
+
+#include <vector>
+#include <map>
+#include <cstddef>
+#include <cstdint>
+#include "statistics_accumulator.h"
+
+// 带宽选择规则
+enum class BandwidthRule {
+    Silverman,  // 0.9 * min(sigma, IQR/1.34) * n^(-1/5)
+    Scott       // 1.06 * sigma * n^(-1/5)
+};
+
+struct KdeSpec {
+    BandwidthRule rule = BandwidthRule::Silverman;
+    int gridSize = 512;   // 网格点数，内部取 2 的幂
+
+    bool operator==(const KdeSpec& other) const {
+        return rule == other.rule && gridSize == other.gridSize;
+    }
+};
+
+struct KdeResult {
+    std::vector<double> grid;     // 网格坐标
+    std::vector<double> density;  // 对应的概率密度
+    double bandwidth = 0.0;
+    double maxDensity = 0.0;
+
+    bool isEmpty() const { return grid.empty(); }
+};
+
+// 高斯核密度估计：线性分箱 + FFT 卷积，复杂度 O(n + m log m)
+// 结果按 (列号, 数据版本, 规格) 缓存
+class KdeEngine
+{
+public:
+    static double bandwidthFor(BandwidthRule rule, const StatisticsAccumulator& stats);
+    static KdeResult compute(const std::vector<double>& data, const KdeSpec& spec,
+                             const StatisticsAccumulator* stats = nullptr);
+
+    const KdeResult& density(int column, uint64_t version, const std::vector<double>& data,
+                             const KdeSpec& spec, const StatisticsAccumulator* stats = nullptr);
+    void clear() { cache.clear(); }
+
+private:
+    struct CacheEntry {
+        uint64_t version = 0;
+        KdeSpec spec;
+        KdeResult result;
+    };
+    std::map<int, CacheEntry> cache;
+};
+
+#endif // KDE_ENGINE_H
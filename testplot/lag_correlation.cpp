@@ -0,0 +1,124 @@
+#include "lag_correlation.h"
+#include "fft.h"
+#include <algorithm>
+#include <complex>
+#include <cmath>
+
+namespace {
+
+LagCorrelationResult correlate(const std::vector<double>& x, const std::vector<double>& y,
+                               const LagCorrelationSpec& spec, bool isAuto)
+{
+    LagCorrelationResult result;
+    size_t n = std::min(x.size(), y.size());
+    if (n < 2) return result;
+
+    size_t maxLag = (spec.maxLag > 0) ? std::min<size_t>(spec.maxLag, n - 1) : n - 1;
+    size_t m = spec.zeroPad ? nextPowerOfTwo(n + maxLag) : n;
+
+    double meanX = 0.0, meanY = 0.0;
+    for (size_t t = 0; t < n; ++t) {
+        meanX += x[t];
+        meanY += y[t];
+    }
+    meanX /= n;
+    meanY /= n;
+
+    // 中心化后的 x 放实部、y 放虚部
+    double energyX = 0.0, energyY = 0.0, largestX = 0.0, largestY = 0.0;
+    std::vector<std::complex<double>> buffer(m);
+    for (size_t t = 0; t < n; ++t) {
+        double cx = x[t] - meanX;
+        double cy = y[t] - meanY;
+        buffer[t] = std::complex<double>(cx, cy);
+        energyX += cx * cx;
+        energyY += cy * cy;
+        largestX = std::max(largestX, std::abs(cx));
+        largestY = std::max(largestY, std::abs(cy));
+    }
+
+    // 拆分频谱时 X、Y 各带有对方量级的舍入误差，两列量级相差很大时先把 y 按 2 的幂缩放到与 x 同量级，结果再除回
+    int exponentX = 0, exponentY = 0;
+    std::frexp(largestX, &exponentX);
+    std::frexp(largestY, &exponentY);
+    int shift = (largestX > 0.0 && largestY > 0.0) ? exponentX - exponentY : 0;
+    if (shift != 0) {
+        for (size_t t = 0; t < n; ++t) buffer[t].imag(std::ldexp(buffer[t].imag(), shift));
+    }
+    fft(buffer);
+
+    // X_k = (P_k + conj P_{m-k}) / 2, Y_k = (P_k - conj P_{m-k}) / 2i, 互谱 S_k = conj(X_k) Y_k
+    // k 与 m-k 成对处理，结果写回原缓冲区
+    for (size_t k = 0; k <= m / 2; ++k) {
+        size_t j = (m - k) % m;
+        std::complex<double> pk = buffer[k];
+        std::complex<double> pj = buffer[j];
+        std::complex<double> xk = (pk + std::conj(pj)) * 0.5;
+        std::complex<double> yk = (pk - std::conj(pj)) * std::complex<double>(0.0, -0.5);
+        std::complex<double> xj = (pj + std::conj(pk)) * 0.5;
+        std::complex<double> yj = (pj - std::conj(pk)) * std::complex<double>(0.0, -0.5);
+        buffer[k] = std::conj(xk) * yk;
+        buffer[j] = std::conj(xj) * yj;
+    }
+    fft(buffer, true);
+
+    double coefficientScale = (energyX > 0.0 && energyY > 0.0) ? 1.0 / std::sqrt(energyX * energyY) : 0.0;
+
+    size_t count = 2 * maxLag + 1;
+    result.lags.resize(count);
+    result.values.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        long long lag = static_cast<long long>(i) - static_cast<long long>(maxLag);
+        size_t index = static_cast<size_t>((lag % static_cast<long long>(m) + m) % m);
+        double r = std::ldexp(buffer[index].real(), -shift);
+
+        switch (spec.normalization) {
+        case LagNormalization::None:
+            break;
+        case LagNormalization::Biased:
+            r /= n;
+            break;
+        case LagNormalization::Unbiased:
+            r /= (spec.zeroPad ? n - static_cast<size_t>(std::llabs(lag)) : n);
+            break;
+        case LagNormalization::Coefficient:
+            r *= coefficientScale;
+            break;
+        }
+
+        result.lags[i] = static_cast<double>(lag);
+        result.values[i] = r;
+    }
+
+    // 互相关取 |r| 最大的滞后；自相关的零滞后恒为最大，改取越过第一个谷之后的最高峰（即主周期）
+    size_t peak = 0;
+    if (isAuto) {
+        size_t i = maxLag + 1;
+        while (i + 1 < count && result.values[i + 1] < result.values[i]) ++i;
+        peak = i;
+        for (; i < count; ++i) {
+            if (result.values[i] > result.values[peak]) peak = i;
+        }
+        if (peak >= count) peak = maxLag;
+    } else {
+        for (size_t i = 1; i < count; ++i) {
+            if (std::abs(result.values[i]) > std::abs(result.values[peak])) peak = i;
+        }
+    }
+    result.peakLag = result.lags[peak];
+    result.peakValue = result.values[peak];
+    return result;
+}
+
+} // namespace
+
+LagCorrelationResult LagCorrelation::crossCorrelation(const std::vector<double>& x, const std::vector<double>& y,
+                                                      const LagCorrelationSpec& spec)
+{
+    return correlate(x, y, spec, false);
+}
+
+LagCorrelationResult LagCorrelation::autoCorrelation(const std::vector<double>& x, const LagCorrelationSpec& spec)
+{
+    return correlate(x, x, spec, true);
+}
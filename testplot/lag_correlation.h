@@ -0,0 +1,40 @@
+#ifndef LAG_CORRELATION_H
+#define LAG_CORRELATION_H
+
+#include <vector>
+#include <cstddef>
+
+// 滞后相关的归一化方式
+enum class LagNormalization {
+    None,         // 原始乘积和
+    Biased,       // 除以 n
+    Unbiased,     // 除以 n - |k|
+    Coefficient   // 除以 sqrt(sum x^2 * sum y^2)，零滞后自相关为 1
+};
+
+struct LagCorrelationSpec {
+    int maxLag = 0;          // 输出 [-maxLag, maxLag]；0 表示 n - 1
+    bool zeroPad = true;     // true: 补零到 >= n + maxLag 的 2 的幂，得到线性相关；false: 长度 n 的循环相关
+    LagNormalization normalization = LagNormalization::Coefficient;
+};
+
+struct LagCorrelationResult {
+    std::vector<double> lags;
+    std::vector<double> values;
+    double peakLag = 0.0;      // |值| 最大的滞后（自相关时跳过零滞后）
+    double peakValue = 0.0;
+
+    bool isEmpty() const { return lags.empty(); }
+};
+
+// 基于 FFT 的互相关 r[k] = sum_t (x_t - mean x) (y_{t+k} - mean y)，复杂度 O(m log m)
+// 两个实序列装进一个复序列只做一次正变换，互谱原地计算，峰值内存约为 16m 字节
+class LagCorrelation
+{
+public:
+    static LagCorrelationResult crossCorrelation(const std::vector<double>& x, const std::vector<double>& y,
+                                                 const LagCorrelationSpec& spec);
+    static LagCorrelationResult autoCorrelation(const std::vector<double>& x, const LagCorrelationSpec& spec);
+};
+
+#endif // LAG_CORRELATION_H
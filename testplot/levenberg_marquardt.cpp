@@ -0,0 +1,313 @@
+#include "levenberg_marquardt.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 对称正定矩阵的 Cholesky 分解（按行存储，原地写入下三角），失败返回 false
+bool choleskyDecompose(std::vector<double>& a, size_t m)
+{
+    for (size_t j = 0; j < m; ++j) {
+        double d = a[j * m + j];
+        for (size_t k = 0; k < j; ++k) d -= a[j * m + k] * a[j * m + k];
+        if (!(d > 0.0)) return false;
+        d = std::sqrt(d);
+        a[j * m + j] = d;
+        for (size_t i = j + 1; i < m; ++i) {
+            double s = a[i * m + j];
+            for (size_t k = 0; k < j; ++k) s -= a[i * m + k] * a[j * m + k];
+            a[i * m + j] = s / d;
+        }
+    }
+    return true;
+}
+
+std::vector<double> choleskySolve(const std::vector<double>& l, size_t m, std::vector<double> b)
+{
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t k = 0; k < i; ++k) b[i] -= l[i * m + k] * b[k];
+        b[i] /= l[i * m + i];
+    }
+    for (size_t i = m; i-- > 0;) {
+        for (size_t k = i + 1; k < m; ++k) b[i] -= l[k * m + i] * b[k];
+        b[i] /= l[i * m + i];
+    }
+    return b;
+}
+
+const size_t BlockSize = 256;
+// 归约块：每块的部分和独立计算，再按块序号累加，结果与线程数无关
+const size_t ReductionBlock = 1 << 14;
+
+size_t reductionBlockCount(size_t n)
+{
+    return (n + ReductionBlock - 1) / ReductionBlock;
+}
+
+double sumOfSquares(const std::vector<double>& x, const std::vector<double>& y,
+                    const NonlinearBlockModel& model, const std::vector<double>& p)
+{
+    size_t n = std::min(x.size(), y.size());
+    std::vector<double> partials(reductionBlockCount(n), 0.0);
+    parallelForEach(partials.size(), [&](size_t block) {
+        size_t begin = block * ReductionBlock;
+        size_t end = std::min(n, begin + ReductionBlock);
+        std::vector<double> values(BlockSize);
+        double sum = 0.0;
+        for (size_t start = begin; start < end; start += BlockSize) {
+            size_t rows = std::min(BlockSize, end - start);
+            model(x.data() + start, rows, p.data(), values.data(), nullptr);
+            for (size_t i = 0; i < rows; ++i) {
+                double r = y[start + i] - values[i];
+                sum += r * r;
+            }
+        }
+        partials[block] = sum;
+    });
+    double sum = 0.0;
+    for (double partial : partials) sum += partial;
+    return sum;
+}
+
+// 一次遍历累积 J^T J（上三角）、J^T r 和残差平方和
+double normalEquations(const std::vector<double>& x, const std::vector<double>& y,
+                       const NonlinearBlockModel& model, const std::vector<double>& p,
+                       std::vector<double>& jtj, std::vector<double>& jtr)
+{
+    size_t m = p.size();
+    size_t n = std::min(x.size(), y.size());
+
+    // 每个归约块的部分和布局：[J^T J (m*m) | J^T r (m) | SSR]
+    size_t stride = m * m + m + 1;
+    std::vector<double> partials(reductionBlockCount(n) * stride, 0.0);
+    parallelForEach(reductionBlockCount(n), [&](size_t block) {
+        size_t begin = block * ReductionBlock;
+        size_t end = std::min(n, begin + ReductionBlock);
+        double* partialJtj = partials.data() + block * stride;
+        double* partialJtr = partialJtj + m * m;
+        std::vector<double> values(BlockSize), jacobian(BlockSize * m), residuals(BlockSize);
+        double sum = 0.0;
+        for (size_t start = begin; start < end; start += BlockSize) {
+            size_t rows = std::min(BlockSize, end - start);
+            model(x.data() + start, rows, p.data(), values.data(), jacobian.data());
+            for (size_t i = 0; i < rows; ++i) {
+                residuals[i] = y[start + i] - values[i];
+                sum += residuals[i] * residuals[i];
+            }
+            // Jacobian 按列存放，内积沿数据方向连续
+            for (size_t a = 0; a < m; ++a) {
+                const double* ja = jacobian.data() + a * rows;
+                double g = 0.0;
+                for (size_t i = 0; i < rows; ++i) g += ja[i] * residuals[i];
+                partialJtr[a] += g;
+                for (size_t b = a; b < m; ++b) {
+                    const double* jb = jacobian.data() + b * rows;
+                    double h = 0.0;
+                    for (size_t i = 0; i < rows; ++i) h += ja[i] * jb[i];
+                    partialJtj[a * m + b] += h;
+                }
+            }
+        }
+        partialJtr[m] = sum;
+    });
+
+    std::fill(jtj.begin(), jtj.end(), 0.0);
+    std::fill(jtr.begin(), jtr.end(), 0.0);
+    double sum = 0.0;
+    for (size_t block = 0; block < reductionBlockCount(n); ++block) {
+        const double* partial = partials.data() + block * stride;
+        for (size_t k = 0; k < m * m; ++k) jtj[k] += partial[k];
+        for (size_t a = 0; a < m; ++a) jtr[a] += partial[m * m + a];
+        sum += partial[m * m + m];
+    }
+    for (size_t a = 0; a < m; ++a) {
+        for (size_t b = 0; b < a; ++b) jtj[a * m + b] = jtj[b * m + a];
+    }
+    return sum;
+}
+
+NonlinearBlockModel blockModel(const NonlinearModel& model, size_t m)
+{
+    return [&model, m](const double* xs, size_t count, const double* p, double* values, double* jacobian) {
+        std::vector<double> gradient(m);
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = model(xs[i], p, jacobian ? gradient.data() : nullptr);
+            if (jacobian) {
+                for (size_t a = 0; a < m; ++a) jacobian[a * count + i] = gradient[a];
+            }
+        }
+    };
+}
+
+} // namespace
+
+LevenbergMarquardtResult LevenbergMarquardt::fit(const std::vector<double>& x, const std::vector<double>& y,
+                                                 const NonlinearModel& model, const std::vector<double>& initial,
+                                                 const LevenbergMarquardtOptions& options)
+{
+    return fit(x, y, blockModel(model, initial.size()), initial, options);
+}
+
+LevenbergMarquardtResult LevenbergMarquardt::fit(const std::vector<double>& x, const std::vector<double>& y,
+                                                 const NonlinearBlockModel& model, const std::vector<double>& initial,
+                                                 const LevenbergMarquardtOptions& options)
+{
+    LevenbergMarquardtResult result;
+    result.parameters = initial;
+    size_t m = initial.size();
+    size_t n = std::min(x.size(), y.size());
+    if (m == 0 || n < m) {
+        result.status = LevenbergMarquardtStatus::Failed;
+        return result;
+    }
+
+    std::vector<double> jtj(m * m), jtr(m), scaled(m * m);
+    double ssr = normalEquations(x, y, model, result.parameters, jtj, jtr);
+    result.evaluations = 1;
+    if (!std::isfinite(ssr)) {
+        result.status = LevenbergMarquardtStatus::Failed;
+        return result;
+    }
+
+    double lambda = options.initialDamping;
+    FitProgress* progress = options.progress;
+    if (progress) progress->objective.store(ssr);
+    result.status = LevenbergMarquardtStatus::MaxIterations;
+    while (result.iterations < options.maxIterations) {
+        if (progress && progress->isCancelled()) {
+            result.status = LevenbergMarquardtStatus::Cancelled;
+            break;
+        }
+
+        // 梯度收敛：J^T r 的每个分量相对 |J_a| |r| 足够小
+        double gradientScale = 0.0;
+        for (size_t a = 0; a < m; ++a) {
+            double norm = std::sqrt(jtj[a * m + a] * ssr);
+            if (norm > 0.0) gradientScale = std::max(gradientScale, std::abs(jtr[a]) / norm);
+        }
+        if (gradientScale <= options.gradientTolerance) {
+            result.status = LevenbergMarquardtStatus::GradientConverged;
+            break;
+        }
+
+        // 增大阻尼直到找到使残差平方和下降的步
+        bool accepted = false;
+        std::vector<double> trial(m), step;
+        double trialSsr = ssr;
+        while (lambda < 1e16 && !(progress && progress->isCancelled())) {
+            scaled = jtj;
+            for (size_t a = 0; a < m; ++a) {
+                double d = std::max(jtj[a * m + a], 1e-300);
+                scaled[a * m + a] += lambda * d;
+            }
+            if (choleskyDecompose(scaled, m)) {
+                step = choleskySolve(scaled, m, jtr);
+                for (size_t a = 0; a < m; ++a) trial[a] = result.parameters[a] + step[a];
+                trialSsr = sumOfSquares(x, y, model, trial);
+                ++result.evaluations;
+                if (std::isfinite(trialSsr) && trialSsr < ssr) {
+                    accepted = true;
+                    break;
+                }
+            }
+            lambda *= 10.0;
+        }
+        if (!accepted && progress && progress->isCancelled()) {
+            result.status = LevenbergMarquardtStatus::Cancelled;
+            break;
+        }
+        if (!accepted) {
+            // 任何阻尼都无法下降：当前点已是数值上的极小值
+            result.status = result.iterations > 0 ? LevenbergMarquardtStatus::FunctionConverged
+                                                  : LevenbergMarquardtStatus::Failed;
+            break;
+        }
+
+        ++result.iterations;
+        lambda = std::max(lambda / 10.0, 1e-12);
+        double reduction = (ssr - trialSsr) / std::max(ssr, 1e-300);
+
+        double stepNorm = 0.0, parameterNorm = 0.0;
+        for (size_t a = 0; a < m; ++a) {
+            stepNorm += step[a] * step[a];
+            parameterNorm += trial[a] * trial[a];
+        }
+        result.parameters = trial;
+        ssr = normalEquations(x, y, model, result.parameters, jtj, jtr);
+        ++result.evaluations;
+        if (progress) {
+            progress->iteration.store(result.iterations);
+            progress->objective.store(ssr);
+        }
+
+        if (std::sqrt(stepNorm) <= options.stepTolerance * (std::sqrt(parameterNorm) + options.stepTolerance)) {
+            result.status = LevenbergMarquardtStatus::StepConverged;
+            break;
+        }
+        if (reduction <= options.functionTolerance) {
+            result.status = LevenbergMarquardtStatus::FunctionConverged;
+            break;
+        }
+    }
+    result.sumOfSquares = ssr;
+
+    // 参数标准误：协方差 (J^T J)^-1 * s^2，s^2 = SSR / (n - m)
+    if (n > m) {
+        std::vector<double> l = jtj;
+        if (choleskyDecompose(l, m)) {
+            double variance = ssr / static_cast<double>(n - m);
+            result.standardErrors.resize(m);
+            for (size_t a = 0; a < m; ++a) {
+                std::vector<double> unit(m, 0.0);
+                unit[a] = 1.0;
+                result.standardErrors[a] = std::sqrt(choleskySolve(l, m, unit)[a] * variance);
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<double> LevenbergMarquardt::residuals(const std::vector<double>& x, const std::vector<double>& y,
+                                                  const NonlinearBlockModel& model, const std::vector<double>& parameters)
+{
+    size_t n = std::min(x.size(), y.size());
+    std::vector<double> result(n);
+    parallelForEach(reductionBlockCount(n), [&](size_t block) {
+        size_t begin = block * ReductionBlock;
+        size_t end = std::min(n, begin + ReductionBlock);
+        for (size_t start = begin; start < end; start += BlockSize) {
+            size_t rows = std::min(BlockSize, end - start);
+            model(x.data() + start, rows, parameters.data(), result.data() + start, nullptr);
+            for (size_t i = 0; i < rows; ++i) result[start + i] = y[start + i] - result[start + i];
+        }
+    });
+    return result;
+}
+
+std::vector<double> LevenbergMarquardt::residuals(const std::vector<double>& x, const std::vector<double>& y,
+                                                  const NonlinearModel& model, const std::vector<double>& parameters)
+{
+    return residuals(x, y, blockModel(model, parameters.size()), parameters);
+}
+
+const char* LevenbergMarquardt::statusText(LevenbergMarquardtStatus status)
+{
+    switch (status) {
+    case LevenbergMarquardtStatus::NotStarted:
+        return "未开始";
+    case LevenbergMarquardtStatus::GradientConverged:
+        return "梯度收敛";
+    case LevenbergMarquardtStatus::StepConverged:
+        return "步长收敛";
+    case LevenbergMarquardtStatus::FunctionConverged:
+        return "残差收敛";
+    case LevenbergMarquardtStatus::MaxIterations:
+        return "达到最大迭代次数";
+    case LevenbergMarquardtStatus::Cancelled:
+        return "已取消";
+    case LevenbergMarquardtStatus::Failed:
+        return "失败";
+    }
+    return "";
+}
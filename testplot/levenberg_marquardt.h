@@ -0,0 +1,74 @@
+#ifndef LEVENBERG_MARQUARDT_H
+#define LEVENBERG_MARQUARDT_H
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include "fit_progress.h"
+
+// 模型 y = f(x; p)：返回函数值，gradient 非空时写入 df/dp（长度为参数个数）
+typedef std::function<double(double x, const double* parameters, double* gradient)> NonlinearModel;
+
+// 按块求值的模型：对 x[0..count) 写入函数值，jacobian 非空时按列写入偏导数 jacobian[k * count + i]
+typedef std::function<void(const double* x, size_t count, const double* parameters,
+                           double* values, double* jacobian)> NonlinearBlockModel;
+
+struct LevenbergMarquardtOptions {
+    int maxIterations = 200;
+    double initialDamping = 1e-3;      // 相对 J^T J 对角元的阻尼系数
+    double gradientTolerance = 1e-10;  // max |J^T r| / (|J| |r|) 小于此值即收敛
+    double stepTolerance = 1e-10;      // 相对步长
+    double functionTolerance = 1e-12;  // 残差平方和的相对下降量
+    FitProgress* progress = nullptr;   // 非空时每步更新迭代次数和残差平方和，并检查取消
+};
+
+enum class LevenbergMarquardtStatus {
+    NotStarted,
+    GradientConverged,
+    StepConverged,
+    FunctionConverged,
+    MaxIterations,
+    Cancelled,
+    Failed                              // 初值处残差非有限，或阻尼增大到上限仍无法下降
+};
+
+struct LevenbergMarquardtResult {
+    std::vector<double> parameters;
+    std::vector<double> standardErrors; // sqrt(diag((J^T J)^-1) * SSR / (n - m))，无法计算时为空
+    double sumOfSquares = 0.0;
+    int iterations = 0;                 // 接受的步数
+    int evaluations = 0;                // 残差平方和的求值次数
+    LevenbergMarquardtStatus status = LevenbergMarquardtStatus::NotStarted;
+
+    bool converged() const
+    {
+        return status == LevenbergMarquardtStatus::GradientConverged
+            || status == LevenbergMarquardtStatus::StepConverged
+            || status == LevenbergMarquardtStatus::FunctionConverged;
+    }
+};
+
+// Levenberg–Marquardt 非线性最小二乘：每步解 (J^T J + λ diag(J^T J)) δ = J^T r，
+// 下降则接受并减小 λ，否则增大 λ 重解（不重算 Jacobian）；参数个数很少，只累积 m×m 的 J^T J
+// 数据按块交给模型求值，逐点模型由块接口包装；残差、目标函数和 J^T J 在固定大小的归约块上并行累积，
+// 再按块序号求和，结果与线程数无关。模型会被多个线程同时调用，不能修改共享状态
+class LevenbergMarquardt
+{
+public:
+    static LevenbergMarquardtResult fit(const std::vector<double>& x, const std::vector<double>& y,
+                                        const NonlinearModel& model, const std::vector<double>& initial,
+                                        const LevenbergMarquardtOptions& options = LevenbergMarquardtOptions());
+    static LevenbergMarquardtResult fit(const std::vector<double>& x, const std::vector<double>& y,
+                                        const NonlinearBlockModel& model, const std::vector<double>& initial,
+                                        const LevenbergMarquardtOptions& options = LevenbergMarquardtOptions());
+
+    // y - f(x; p)，并行计算
+    static std::vector<double> residuals(const std::vector<double>& x, const std::vector<double>& y,
+                                         const NonlinearBlockModel& model, const std::vector<double>& parameters);
+    static std::vector<double> residuals(const std::vector<double>& x, const std::vector<double>& y,
+                                         const NonlinearModel& model, const std::vector<double>& parameters);
+
+    static const char* statusText(LevenbergMarquardtStatus status);
+};
+
+#endif // LEVENBERG_MARQUARDT_H
@@ -0,0 +1,195 @@
+#include "line_decimation.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// NaN 视为比任何数都“差”，有限值优先
+inline bool lower(const std::vector<double>& y, size_t a, size_t b)
+{
+    return y[a] < y[b] || (std::isnan(y[b]) && !std::isnan(y[a]));
+}
+
+inline bool higher(const std::vector<double>& y, size_t a, size_t b)
+{
+    return y[a] > y[b] || (std::isnan(y[b]) && !std::isnan(y[a]));
+}
+
+// 各线程的局部结果，按块序号合并
+struct ChunkSummary {
+    bool sorted = true;
+    bool hasRange = false;
+    double xMin = std::numeric_limits<double>::infinity();
+    double xMax = -std::numeric_limits<double>::infinity();
+    double yMin = std::numeric_limits<double>::infinity();
+    double yMax = -std::numeric_limits<double>::infinity();
+};
+
+} // namespace
+
+void LinePyramid::extremes(const std::vector<double>& y, size_t begin, size_t end, size_t& minAt, size_t& maxAt) const
+{
+    minAt = maxAt = begin;
+    auto take = [&](size_t lowAt, size_t highAt) {
+        if (lower(y, lowAt, minAt)) minAt = lowAt;
+        if (higher(y, highAt, maxAt)) maxAt = highAt;
+    };
+    // 两端不足一块的部分逐点比较，中间按块自底向上合并
+    size_t left = begin, right = end;
+    while (left < right && left % BlockSize != 0) {
+        take(left, left);
+        ++left;
+    }
+    while (left < right && right % BlockSize != 0) {
+        --right;
+        take(right, right);
+    }
+    size_t a = left / BlockSize, b = right / BlockSize;
+    for (size_t level = 0; a < b && level < minIndex.size(); ++level) {
+        if (a & 1) {
+            take(minIndex[level][a], maxIndex[level][a]);
+            ++a;
+        }
+        if (b & 1) {
+            --b;
+            take(minIndex[level][b], maxIndex[level][b]);
+        }
+        a >>= 1;
+        b >>= 1;
+    }
+}
+
+LinePyramid LineDecimationEngine::build(const std::vector<double>& x, const std::vector<double>& y)
+{
+    const size_t B = LinePyramid::BlockSize;
+    LinePyramid pyramid;
+    size_t n = std::min(x.size(), y.size());
+    pyramid.count = n;
+    if (n == 0) return pyramid;
+
+    // 第 0 层、x 是否有序和有限值范围一次扫描得到，按块并行
+    size_t fullBlocks = n / B;
+    size_t blocks = (n + B - 1) / B;
+    pyramid.minIndex.emplace_back(fullBlocks);
+    pyramid.maxIndex.emplace_back(fullBlocks);
+    std::vector<size_t>& minLevel = pyramid.minIndex.front();
+    std::vector<size_t>& maxLevel = pyramid.maxIndex.front();
+    size_t chunks = parallelChunkCount(blocks, 65536 / B);
+    std::vector<ChunkSummary> summaries(chunks);
+    parallelForChunks(blocks, chunks, [&](size_t chunk, size_t firstBlock, size_t lastBlock) {
+        ChunkSummary& summary = summaries[chunk];
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            size_t begin = block * B, end = std::min(n, begin + B);
+            size_t minAt = begin, maxAt = begin;
+            for (size_t i = begin; i < end; ++i) {
+                if (lower(y, i, minAt)) minAt = i;
+                if (higher(y, i, maxAt)) maxAt = i;
+                // NaN 使比较为假，也算无序
+                if (i > 0 && !(x[i] >= x[i - 1])) summary.sorted = false;
+                if (std::isfinite(x[i]) && std::isfinite(y[i])) {
+                    summary.hasRange = true;
+                    summary.xMin = std::min(summary.xMin, x[i]);
+                    summary.xMax = std::max(summary.xMax, x[i]);
+                    summary.yMin = std::min(summary.yMin, y[i]);
+                    summary.yMax = std::max(summary.yMax, y[i]);
+                }
+            }
+            if (block < fullBlocks) {
+                minLevel[block] = minAt;
+                maxLevel[block] = maxAt;
+            }
+        }
+    });
+    ChunkSummary total;
+    total.sorted = std::isfinite(x[0]);
+    for (const ChunkSummary& summary : summaries) {
+        total.sorted = total.sorted && summary.sorted;
+        if (!summary.hasRange) continue;
+        total.hasRange = true;
+        total.xMin = std::min(total.xMin, summary.xMin);
+        total.xMax = std::max(total.xMax, summary.xMax);
+        total.yMin = std::min(total.yMin, summary.yMin);
+        total.yMax = std::max(total.yMax, summary.yMax);
+    }
+    pyramid.sorted = total.sorted;
+    pyramid.hasRange = total.hasRange;
+    if (total.hasRange) {
+        pyramid.xMin = total.xMin;
+        pyramid.xMax = total.xMax;
+        pyramid.yMin = total.yMin;
+        pyramid.yMax = total.yMax;
+    }
+
+    // 上层由下层相邻两块合并，直到只剩一块
+    while (pyramid.minIndex.back().size() >= 2) {
+        const std::vector<size_t>& minBelow = pyramid.minIndex.back();
+        const std::vector<size_t>& maxBelow = pyramid.maxIndex.back();
+        size_t size = minBelow.size() / 2;
+        std::vector<size_t> minAbove(size), maxAbove(size);
+        parallelForChunks(size, parallelChunkCount(size), [&](size_t, size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                size_t a = minBelow[2 * j], b = minBelow[2 * j + 1];
+                minAbove[j] = lower(y, b, a) ? b : a;
+                a = maxBelow[2 * j];
+                b = maxBelow[2 * j + 1];
+                maxAbove[j] = higher(y, b, a) ? b : a;
+            }
+        });
+        pyramid.minIndex.push_back(std::move(minAbove));
+        pyramid.maxIndex.push_back(std::move(maxAbove));
+    }
+    return pyramid;
+}
+
+std::vector<size_t> LineDecimationEngine::decimate(const LinePyramid& pyramid, const std::vector<double>& x,
+                                                   const std::vector<double>& y, double viewMin, double viewMax,
+                                                   int columns)
+{
+    std::vector<size_t> result;
+    size_t n = pyramid.count;
+    if (!pyramid.sorted || n == 0 || columns <= 0 || !(viewMax > viewMin)) return result;
+    result.reserve(4 * static_cast<size_t>(columns) + 2);
+    auto push = [&](size_t index) {
+        if (result.empty() || index > result.back()) result.push_back(index);
+    };
+
+    size_t first = static_cast<size_t>(std::lower_bound(x.begin(), x.begin() + n, viewMin) - x.begin());
+    size_t last = static_cast<size_t>(std::upper_bound(x.begin() + first, x.begin() + n, viewMax) - x.begin());
+    if (first > 0) push(first - 1);
+
+    double width = (viewMax - viewMin) / columns;
+    size_t begin = first;
+    for (int c = 0; c < columns && begin < last; ++c) {
+        size_t end = last;
+        if (c + 1 < columns) {
+            double boundary = viewMin + (c + 1) * width;
+            end = static_cast<size_t>(std::lower_bound(x.begin() + begin, x.begin() + last, boundary) - x.begin());
+        }
+        if (end - begin <= 4) {
+            for (size_t i = begin; i < end; ++i) push(i);
+        } else if (end > begin) {
+            size_t minAt, maxAt;
+            pyramid.extremes(y, begin, end, minAt, maxAt);
+            push(begin);
+            push(std::min(minAt, maxAt));
+            push(std::max(minAt, maxAt));
+            push(end - 1);
+        }
+        begin = end;
+    }
+    if (last < n) push(last);
+    return result;
+}
+
+const LinePyramid& LineDecimationEngine::pyramid(uint64_t version, const std::vector<double>& x,
+                                                 const std::vector<double>& y)
+{
+    if (!hasCache || cachedVersion != version || cached.count != std::min(x.size(), y.size())) {
+        cached = build(x, y);
+        cachedVersion = version;
+        hasCache = true;
+    }
+    return cached;
+}
@@ -0,0 +1,49 @@
+#ifndef LINE_DECIMATION_H
+#define LINE_DECIMATION_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 折线的多分辨率 min/max 金字塔：第 k 层每块覆盖 BlockSize·2^k 个连续点，记录块内 y 最小、最大点的下标
+// 任意下标区间的最值由不足一块的两端逐点比较加上 O(log n) 个整块得到
+struct LinePyramid {
+    static constexpr size_t BlockSize = 8;
+
+    size_t count = 0;
+    bool sorted = false;          // x 非降序（且无 NaN）时才能按像素列抽取
+    bool hasRange = false;        // 有至少一个 x、y 都有限的点
+    double xMin = 0.0;            // 有限值的范围
+    double xMax = 0.0;
+    double yMin = 0.0;
+    double yMax = 0.0;
+    std::vector<std::vector<size_t>> minIndex;
+    std::vector<std::vector<size_t>> maxIndex;
+
+    // [begin, end) 内 y 最小、最大点的下标（NaN 只在全为 NaN 时被选中），要求 begin < end
+    void extremes(const std::vector<double>& y, size_t begin, size_t end, size_t& minAt, size_t& maxAt) const;
+};
+
+// M4 折线抽取：把可见的 x 范围按像素列等分，每列只保留首点、末点和 y 最小、最大的点（按下标顺序连线），
+// 以线宽 1 光栅化时与逐段绘制全部点的结果逐像素相同；每列的最值由金字塔给出，
+// 因此任意缩放下的抽取都是 O(像素列数 · log n)，与总点数无关。金字塔按数据版本缓存
+class LineDecimationEngine
+{
+public:
+    static LinePyramid build(const std::vector<double>& x, const std::vector<double>& y);
+
+    // 把 [viewMin, viewMax] 等分成 columns 列做 M4 抽取，另加视窗左右各一个相邻点使连线延伸到边界
+    // 返回升序、无重复的下标；pyramid 不是按 x 排序时返回空
+    static std::vector<size_t> decimate(const LinePyramid& pyramid, const std::vector<double>& x,
+                                        const std::vector<double>& y, double viewMin, double viewMax, int columns);
+
+    const LinePyramid& pyramid(uint64_t version, const std::vector<double>& x, const std::vector<double>& y);
+    void clear() { cached = LinePyramid(); hasCache = false; }
+
+private:
+    uint64_t cachedVersion = 0;
+    bool hasCache = false;
+    LinePyramid cached;
+};
+
+#endif // LINE_DECIMATION_H
@@ -1,7 +1,9 @@
 #include <QApplication>
 
 #include "mainwindow.h"
+#include "fitting_benchmark.h"
 #include "qcommandlineparser.h"
+#include <iostream>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -46,10 +48,16 @@ int main(int argc, char *argv[])
     
     // 添加图表类型选项
     QCommandLineOption chartTypeOption(QStringList() << "t" << "type",
-                                     "设置初始图表类型 (线图line, 柱状图bar, 饼图pie, 散点图scatter, 直方图histogram, 箱线图box, 小提琴图violin, 密度图density, 面积图area)。",
+                                     "设置初始图表类型 (线图line, 柱状图bar, 饼图pie, 散点图scatter, 直方图histogram, 箱线图box, 小提琴图violin, 密度图density, 面积图area, 相关热力图heatmap, 频谱图spectrum)。",
                                      "type", "line");
     parser.addOption(chartTypeOption);
     
+    // 拟合线程扩展性基准，不打开窗口
+    QCommandLineOption benchmarkOption(QStringList() << "benchmark-fit",
+                                       "运行拟合的线程扩展性基准后退出，参数为逗号分隔的数据点数，如 1e6,1e7,1e8。",
+                                       "sizes");
+    parser.addOption(benchmarkOption);
+    
     // 处理命令行参数
     parser.process(app);
     
@@ -57,6 +65,17 @@ int main(int argc, char *argv[])
     QString fileName = parser.value(fileOption);
     QString chartType = parser.value(chartTypeOption).toLower();
     
+    if (parser.isSet(benchmarkOption)) {
+        std::vector<size_t> sizes;
+        for (const QString& size : parser.value(benchmarkOption).split(',', Qt::SkipEmptyParts)) {
+            double points = size.trimmed().toDouble();
+            if (points >= 1.0) sizes.push_back(static_cast<size_t>(points));
+        }
+        if (sizes.empty()) sizes = {1000000, 10000000};
+        FittingBenchmark::run(sizes, std::cout);
+        return 0;
+    }
+    
     // 创建主窗口
     MainWindow window(fileName);
     
@@ -70,6 +89,8 @@ int main(int argc, char *argv[])
         else if (chartType == "violin") window.setInitialChartType(ChartType::ViolinPlot);
         else if (chartType == "density") window.setInitialChartType(ChartType::DensityPlot);
         else if (chartType == "area") window.setInitialChartType(ChartType::AreaChart);
+        else if (chartType == "heatmap") window.setInitialChartType(ChartType::Heatmap);
+        else if (chartType == "spectrum") window.setInitialChartType(ChartType::Spectrum);
     }
     
     window.show();
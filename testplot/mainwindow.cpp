@@ -64,8 +64,12 @@
 #include <QScrollBar>
 #include <QDateTime>
 #include <QFileInfo>
+#include <QHeaderView>
+#include <QSignalBlocker>
 #include "plotwidget_new.h"
 #include "deepseek_dialog.h"
+#include "parallel_utils.h"
+#include <QtConcurrent>
 MainWindow::MainWindow(const QString& initialFile , QWidget *parent) : QMainWindow(parent)
 {
     setWindowTitle("TXT数据绘图工具 - 中文增强版");
@@ -129,6 +133,8 @@ void MainWindow::applyColumnSelection()
         } else {
             // 多列模式
             applyMultiColumnSelection();
+            updateRollingOverlays();
+            updateCorrelationMatrix();
             return;
         }
     }
@@ -148,73 +154,57 @@ void MainWindow::applyColumnSelection()
         return;
     }
 
-    std::vector<double> yData;
-
-    // Handle X column selection
-    if (xCol == 0) {
-        // Virtual row index column selected
-        for (size_t i = 0; i < rawData.size(); ++i) {
-            xData.push_back(static_cast<double>(i + 1));
-        }
-    } else {
-        // Real data column selected (adjust index since virtual column is at 0)
-        int realXCol = xCol - 1;
-        if (realXCol < 0 || realXCol >= (int)rawData[0].size()) {
-            statusLabel->setText("❌ 错误：X列选择无效");
-            return;
-        }
-        for (const auto& row : rawData) {
-            if (realXCol < (int)row.size()) {
-                xData.push_back(row[realXCol]);
-            } else {
-                xData.push_back(0.0); // Default value for missing data
-            }
-        }
-    }
-
-    // Handle Y column selection
-    if (yCol == 0) {
-        // Virtual row index column selected for Y (unusual but allowed)
-        for (size_t i = 0; i < rawData.size(); ++i) {
-            yData.push_back(static_cast<double>(i + 1));
-        }
-    } else {
-        // Real data column selected (adjust index since virtual column is at 0)
-        int realYCol = yCol - 1;
-        if (realYCol < 0 || realYCol >= (int)rawData[0].size()) {
-            statusLabel->setText("❌ 错误：Y列选择无效");
-            return;
-        }
-        for (const auto& row : rawData) {
-            if (realYCol < (int)row.size()) {
-                yData.push_back(row[realYCol]);
-            } else {
-                yData.push_back(0.0); // Default value for missing data
-            }
-        }
+    // 行索引、数据列和派生列统一经 columnValues 取值
+    xData = columnValues(xCol);
+    std::vector<double> yData = columnValues(yCol);
+    QString xName = columnHeaders[xCol];
+
+    // 派生列（如滞后相关）自带横轴，长度与原数据不同，直接以其横轴作为 X
+    const DerivedColumn* derived = derivedColumn(yCol);
+    if (derived && !derived->axis.empty()) {
+        xData = derived->axis;
+        xName = QString("滞后");
+    } else if (xData.size() != yData.size()) {
+        statusLabel->setText(QString("❌ 错误：%1 与 %2 长度不一致").arg(columnHeaders[xCol]).arg(columnHeaders[yCol]));
+        return;
     }
 
     // Set the plot data
     plotWidget->setData(xData, yData);
 
-    // Update statistics for the Y column
-    updateDetailedStatistics(yData);
+    // Update statistics for the Y column (real columns use the cached accumulator)
+    if (yCol > 0 && yCol - 1 < (int)columnStore.columnCount()) {
+        updateDetailedStatistics(columnStore.statistics(yCol - 1));
+    } else {
+        updateDetailedStatistics(yData);
+    }
 
     // Update axis labels
-    xLabelEdit->setText(columnHeaders[xCol]);
+    xLabelEdit->setText(xName);
     yLabelEdit->setText(columnHeaders[yCol]);
 
     // Update status message
     statusLabel->setText(QString("✅ 正在绘制 %1 (X轴) vs %2 (Y轴)")
-                             .arg(columnHeaders[xCol])
+                             .arg(xName)
                              .arg(columnHeaders[yCol]));
 
     // Update chart title if empty or default
     if (titleEdit->text().isEmpty() || titleEdit->text().contains("数据可视化")) {
         titleEdit->setText(QString("%1 对比 %2")
-                               .arg(columnHeaders[xCol])
+                               .arg(xName)
                                .arg(columnHeaders[yCol]));
     }
+
+    // 这对列在当前数据上拟合过：立即恢复，不再重算；否则撤下属于其他列的拟合
+    if (!restoreCachedFit(xCol, yCol) && !publishedFits.empty()
+        && (publishedFitXColumn != xCol || publishedFits.size() != 1 || publishedFits.front().first != yCol)) {
+        plotWidget->clearFitting();
+        publishedFits.clear();
+    }
+
+    updateRollingOverlays();
+    updateDistributionFits();
+    updateCorrelationMatrix();
 }
 
 void MainWindow::clearPlot()
@@ -229,6 +219,9 @@ void MainWindow::onChartTypeChanged(int buttonId)
 {
     ChartType type = static_cast<ChartType>(buttonId);
     plotWidget->setChartType(type);
+    updateRollingOverlays();
+    updateDistributionFits();
+    updateCorrelationMatrix();
     updateStatistics();
 }
 
@@ -297,6 +290,18 @@ void MainWindow::setupMenuBar()
     connect(importConfigAction, &QAction::triggered, this, &MainWindow::importConfiguration);
     fileMenu->addAction(importConfigAction);
     
+    // 导出拟合数据
+    QAction *exportFitAction = new QAction("导出拟合数据(&D)", this);
+    exportFitAction->setStatusTip("把当前拟合的原始值、拟合值和残差导出为CSV文件");
+    connect(exportFitAction, &QAction::triggered, this, &MainWindow::exportFittedData);
+    fileMenu->addAction(exportFitAction);
+    
+    // 拟合结果缓存
+    QAction *fitCacheAction = new QAction("拟合结果缓存(&C)", this);
+    fitCacheAction->setStatusTip("列出缓存的拟合结果，比较不同模型或切换到其中一个");
+    connect(fitCacheAction, &QAction::triggered, this, &MainWindow::showFitCache);
+    fileMenu->addAction(fitCacheAction);
+    
     fileMenu->addSeparator();
     
     // 退出
@@ -399,6 +404,8 @@ void MainWindow::setupUI()
     chartTypeCombo->addItem("🎻 小提琴图", 6);
     chartTypeCombo->addItem("🌊 密度图", 7);
     chartTypeCombo->addItem("🏔️ 面积图", 8);
+    chartTypeCombo->addItem("🔥 相关热力图", 9);
+    chartTypeCombo->addItem("📡 频谱图", 10);
 
     chartTypeCombo->setCurrentIndex(0); // 默认选中线图
     chartTypeCombo->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
@@ -406,6 +413,88 @@ void MainWindow::setupUI()
     chartTypeCombo->setStyleSheet(QString("QComboBox { padding: 8px; border: 1px solid #ced4da; border-radius: 4px; background-color: white; font-size: %1px; } QComboBox:hover { border-color: #007bff; } QComboBox::drop-down { border: none; } QComboBox::down-arrow { image: none; border: none; }").arg(scaledSize(9)));
 
     chartLayout->addWidget(chartTypeCombo);
+
+    // 直方图分箱规则
+    QHBoxLayout *binLayout = new QHBoxLayout();
+    QLabel *binLabel = new QLabel("直方图分箱:");
+    binLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    histogramBinCombo = new QComboBox();
+    histogramBinCombo->addItem("Sturges", static_cast<int>(BinRule::Sturges));
+    histogramBinCombo->addItem("Scott", static_cast<int>(BinRule::Scott));
+    histogramBinCombo->addItem("Freedman-Diaconis", static_cast<int>(BinRule::FreedmanDiaconis));
+    histogramBinCombo->addItem("平方根", static_cast<int>(BinRule::SquareRoot));
+    histogramBinCombo->addItem("固定箱数", static_cast<int>(BinRule::Fixed));
+    histogramBinCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    histogramBinSpin = new QSpinBox();
+    histogramBinSpin->setRange(1, HistogramEngine::MaxBins);
+    histogramBinSpin->setValue(20);
+    histogramBinSpin->setEnabled(false);
+    histogramBinSpin->setToolTip("固定箱数规则下使用的箱数");
+    binLayout->addWidget(binLabel);
+    binLayout->addWidget(histogramBinCombo, 1);
+    binLayout->addWidget(histogramBinSpin);
+    chartLayout->addLayout(binLayout);
+
+    // 密度图/小提琴图的核密度带宽规则
+    QHBoxLayout *kdeLayout = new QHBoxLayout();
+    QLabel *kdeLabel = new QLabel("密度带宽:");
+    kdeLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    kdeBandwidthCombo = new QComboBox();
+    kdeBandwidthCombo->addItem("Silverman", static_cast<int>(BandwidthRule::Silverman));
+    kdeBandwidthCombo->addItem("Scott", static_cast<int>(BandwidthRule::Scott));
+    kdeBandwidthCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    kdeLayout->addWidget(kdeLabel);
+    kdeLayout->addWidget(kdeBandwidthCombo, 1);
+    chartLayout->addLayout(kdeLayout);
+
+    // 相关热力图使用的相关系数
+    QHBoxLayout *correlationLayout = new QHBoxLayout();
+    QLabel *correlationLabel = new QLabel("相关系数:");
+    correlationLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    correlationMethodCombo = new QComboBox();
+    correlationMethodCombo->addItem("Pearson", static_cast<int>(CorrelationMethod::Pearson));
+    correlationMethodCombo->addItem("Spearman", static_cast<int>(CorrelationMethod::Spearman));
+    correlationMethodCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    correlationLayout->addWidget(correlationLabel);
+    correlationLayout->addWidget(correlationMethodCombo, 1);
+    chartLayout->addLayout(correlationLayout);
+
+    // 频谱图的窗函数和 Welch 分段长度
+    QHBoxLayout *spectrumLayout = new QHBoxLayout();
+    QLabel *spectrumLabel = new QLabel("频谱窗/分段:");
+    spectrumLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    spectrumWindowCombo = new QComboBox();
+    spectrumWindowCombo->addItem("Hann", static_cast<int>(WindowFunction::Hann));
+    spectrumWindowCombo->addItem("Hamming", static_cast<int>(WindowFunction::Hamming));
+    spectrumWindowCombo->addItem("Blackman", static_cast<int>(WindowFunction::Blackman));
+    spectrumWindowCombo->addItem("矩形窗", static_cast<int>(WindowFunction::Rectangular));
+    spectrumWindowCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    spectrumSegmentCombo = new QComboBox();
+    spectrumSegmentCombo->addItem("整段周期图", 0);
+    spectrumSegmentCombo->addItem("Welch 256", 256);
+    spectrumSegmentCombo->addItem("Welch 1024", 1024);
+    spectrumSegmentCombo->addItem("Welch 4096", 4096);
+    spectrumSegmentCombo->setToolTip("Welch 方法按给定段长、50% 重叠分段平均，降低噪声方差");
+    spectrumSegmentCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    spectrumLayout->addWidget(spectrumLabel);
+    spectrumLayout->addWidget(spectrumWindowCombo, 1);
+    spectrumLayout->addWidget(spectrumSegmentCombo, 1);
+    chartLayout->addLayout(spectrumLayout);
+
+    // 散点图渲染方式：逐点或按像素计数的密度图
+    QHBoxLayout *scatterLayout = new QHBoxLayout();
+    QLabel *scatterLabel = new QLabel("散点渲染:");
+    scatterLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    scatterRenderCombo = new QComboBox();
+    scatterRenderCombo->addItem("自动", 0);
+    scatterRenderCombo->addItem("逐点", 1);
+    scatterRenderCombo->addItem("密度（对数）", 2);
+    scatterRenderCombo->addItem("密度（均衡）", 3);
+    scatterRenderCombo->setToolTip("密度图把点按屏幕像素计数后着色，绘制时间与点数基本无关；自动模式在点数超过 5 万时使用对数密度图");
+    scatterRenderCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    scatterLayout->addWidget(scatterLabel);
+    scatterLayout->addWidget(scatterRenderCombo, 1);
+    chartLayout->addLayout(scatterLayout);
     chartLayout->addStretch();
 
     // Chart customization group
@@ -440,6 +529,143 @@ void MainWindow::setupUI()
     customLayout->setHorizontalSpacing(4);
     customLayout->setContentsMargins(8, 10, 8, 8);
 
+    // Data analysis group
+    QGroupBox *analysisGroup = new QGroupBox("数据分析");
+    analysisGroup->setStyleSheet("QGroupBox { font-weight: bold; padding-top: 10px; font-size: 11px; }");
+    QGridLayout *analysisLayout = new QGridLayout(analysisGroup);
+    analysisLayout->setVerticalSpacing(6);
+    analysisLayout->setHorizontalSpacing(4);
+    analysisLayout->setContentsMargins(8, 10, 8, 8);
+
+    // 滞后相关：A 与 B 相同（或选“自相关”）时计算自相关
+    QLabel *lagLabel = new QLabel("滞后相关:");
+    lagLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    analysisLayout->addWidget(lagLabel, 0, 0);
+    lagColumnACombo = new QComboBox();
+    lagColumnACombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    lagColumnBCombo = new QComboBox();
+    lagColumnBCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    QHBoxLayout *lagColumnsLayout = new QHBoxLayout();
+    lagColumnsLayout->addWidget(lagColumnACombo, 1);
+    lagColumnsLayout->addWidget(lagColumnBCombo, 1);
+    analysisLayout->addLayout(lagColumnsLayout, 0, 1);
+
+    lagMaxSpin = new QSpinBox();
+    lagMaxSpin->setRange(0, 100000000);
+    lagMaxSpin->setValue(1000);
+    lagMaxSpin->setPrefix("最大滞后 ");
+    lagMaxSpin->setSpecialValueText("最大滞后 全部");
+    lagMaxSpin->setToolTip("输出 [-k, k] 的滞后；0 表示全部 n-1 个滞后");
+    lagNormalizationCombo = new QComboBox();
+    lagNormalizationCombo->addItem("相关系数", static_cast<int>(LagNormalization::Coefficient));
+    lagNormalizationCombo->addItem("有偏 (1/n)", static_cast<int>(LagNormalization::Biased));
+    lagNormalizationCombo->addItem("无偏 (1/(n-k))", static_cast<int>(LagNormalization::Unbiased));
+    lagNormalizationCombo->addItem("不归一化", static_cast<int>(LagNormalization::None));
+    lagNormalizationCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    QHBoxLayout *lagOptionsLayout = new QHBoxLayout();
+    lagOptionsLayout->addWidget(lagMaxSpin, 1);
+    lagOptionsLayout->addWidget(lagNormalizationCombo, 1);
+    analysisLayout->addLayout(lagOptionsLayout, 1, 1);
+
+    lagZeroPadCheckbox = new QCheckBox("补零（线性相关）");
+    lagZeroPadCheckbox->setChecked(true);
+    lagZeroPadCheckbox->setStyleSheet(QString("QCheckBox { font-size: %1px; }").arg(scaledSize(8)));
+    lagZeroPadCheckbox->setToolTip("不补零时按长度 n 的循环相关计算");
+    lagComputeButton = new QPushButton("📶 计算");
+    lagComputeButton->setStyleSheet(QString("QPushButton { padding: 4px 8px; font-size: %1px; background-color: #17a2b8; color: white; border: none; border-radius: 3px; } QPushButton:hover { background-color: #138496; } QPushButton:disabled { background-color: #adb5bd; }").arg(scaledSize(8)));
+    QHBoxLayout *lagRunLayout = new QHBoxLayout();
+    lagRunLayout->addWidget(lagZeroPadCheckbox, 1);
+    lagRunLayout->addWidget(lagComputeButton);
+    analysisLayout->addLayout(lagRunLayout, 2, 1);
+
+    // 滑动窗口统计：勾选后叠加在折线图上，并生成对应的派生列
+    QLabel *rollingLabel = new QLabel("滑动窗口:");
+    rollingLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    analysisLayout->addWidget(rollingLabel, 3, 0);
+    rollingWindowSpin = new QSpinBox();
+    rollingWindowSpin->setRange(2, 10000000);
+    rollingWindowSpin->setValue(20);
+    rollingWindowSpin->setSuffix(" 点");
+    rollingWindowSpin->setToolTip("每个点取其前面（含自身）的 N 个点计算统计量");
+    analysisLayout->addWidget(rollingWindowSpin, 3, 1);
+
+    rollingMeanCheckbox = new QCheckBox("均值");
+    rollingStdCheckbox = new QCheckBox("±标准差");
+    rollingRangeCheckbox = new QCheckBox("最小/最大");
+    QHBoxLayout *rollingOptionsLayout = new QHBoxLayout();
+    for (QCheckBox *checkbox : {rollingMeanCheckbox, rollingStdCheckbox, rollingRangeCheckbox}) {
+        checkbox->setStyleSheet(QString("QCheckBox { font-size: %1px; }").arg(scaledSize(8)));
+        rollingOptionsLayout->addWidget(checkbox);
+    }
+    analysisLayout->addLayout(rollingOptionsLayout, 4, 1);
+
+    // 寻峰：作用于当前单列图的 X/Y（含派生列），结果标在图上并列入统计面板
+    QLabel *peakLabel = new QLabel("寻峰:");
+    peakLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    analysisLayout->addWidget(peakLabel, 5, 0);
+    peakProminenceSpin = new QDoubleSpinBox();
+    peakProminenceSpin->setRange(0.0, 100.0);
+    peakProminenceSpin->setDecimals(1);
+    peakProminenceSpin->setValue(5.0);
+    peakProminenceSpin->setPrefix("突起度 ≥ ");
+    peakProminenceSpin->setSuffix(" %");
+    peakProminenceSpin->setToolTip("相对于 Y 数据范围（最大值 - 最小值）的百分比");
+    peakDistanceSpin = new QSpinBox();
+    peakDistanceSpin->setRange(1, 10000000);
+    peakDistanceSpin->setValue(1);
+    peakDistanceSpin->setPrefix("间隔 ≥ ");
+    peakDistanceSpin->setToolTip("相邻峰的最小间隔（采样点数），冲突时保留较高的峰");
+    QHBoxLayout *peakOptionsLayout = new QHBoxLayout();
+    peakOptionsLayout->addWidget(peakProminenceSpin, 1);
+    peakOptionsLayout->addWidget(peakDistanceSpin, 1);
+    analysisLayout->addLayout(peakOptionsLayout, 5, 1);
+
+    peakWidthSpin = new QDoubleSpinBox();
+    peakWidthSpin->setRange(0.0, 10000000.0);
+    peakWidthSpin->setDecimals(1);
+    peakWidthSpin->setValue(0.0);
+    peakWidthSpin->setPrefix("半高宽 ≥ ");
+    peakWidthSpin->setToolTip("最小半高宽（采样点数），0 表示不过滤");
+    peakFindButton = new QPushButton("🔺 寻峰");
+    peakFindButton->setStyleSheet(QString("QPushButton { padding: 4px 8px; font-size: %1px; background-color: #17a2b8; color: white; border: none; border-radius: 3px; } QPushButton:hover { background-color: #138496; } QPushButton:disabled { background-color: #adb5bd; }").arg(scaledSize(8)));
+    QHBoxLayout *peakRunLayout = new QHBoxLayout();
+    peakRunLayout->addWidget(peakWidthSpin, 1);
+    peakRunLayout->addWidget(peakFindButton);
+    analysisLayout->addLayout(peakRunLayout, 6, 1);
+
+    peakWatcher = new QFutureWatcher<std::vector<Peak>>(this);
+
+    // 分布拟合：直方图模式下对 Y 列做极大似然拟合并叠加曲线
+    QLabel *distributionLabel = new QLabel("分布拟合:");
+    distributionLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    analysisLayout->addWidget(distributionLabel, 7, 0);
+    distributionFitCheckbox = new QCheckBox("直方图叠加 MLE 拟合与 KS/AD 检验");
+    distributionFitCheckbox->setStyleSheet(QString("QCheckBox { font-size: %1px; }").arg(scaledSize(8)));
+    distributionFitCheckbox->setToolTip("正态、对数正态、指数、威布尔分布；不满足支撑集的分布自动跳过");
+    analysisLayout->addWidget(distributionFitCheckbox, 7, 1);
+
+    distributionWatcher = new QFutureWatcher<std::vector<DistributionFit>>(this);
+
+    // 双样本检验：多列模式下对勾选的列两两比较，否则比较下面两列
+    QLabel *testLabel = new QLabel("双样本检验:");
+    testLabel->setStyleSheet(QString("font-size: %1px;").arg(scaledSize(8)));
+    analysisLayout->addWidget(testLabel, 8, 0);
+    testColumnACombo = new QComboBox();
+    testColumnACombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    testColumnBCombo = new QComboBox();
+    testColumnBCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    testRunButton = new QPushButton("⚖️ 检验");
+    testRunButton->setToolTip("Welch t 检验、Mann–Whitney U 检验、两样本 KS 检验");
+    testRunButton->setStyleSheet(QString("QPushButton { padding: 4px 8px; font-size: %1px; background-color: #17a2b8; color: white; border: none; border-radius: 3px; } QPushButton:hover { background-color: #138496; } QPushButton:disabled { background-color: #adb5bd; }").arg(scaledSize(8)));
+    QHBoxLayout *testLayout = new QHBoxLayout();
+    testLayout->addWidget(testColumnACombo, 1);
+    testLayout->addWidget(testColumnBCombo, 1);
+    testLayout->addWidget(testRunButton);
+    analysisLayout->addLayout(testLayout, 8, 1);
+
+    testWatcher = new QFutureWatcher<std::vector<TwoSampleResult>>(this);
+
+    lagWatcher = new QFutureWatcher<LagCorrelationResult>(this);
 
     // Column selection group
     columnGroup = new QGroupBox("列选择");
@@ -530,6 +756,7 @@ void MainWindow::setupUI()
 
     rightLayout->addWidget(columnGroup);
     rightLayout->addWidget(chartGroup);
+    rightLayout->addWidget(analysisGroup);
     rightLayout->addWidget(customGroup);
     rightLayout->addWidget(aiChatPanel);
     rightLayout->addStretch();
@@ -599,18 +826,138 @@ void MainWindow::setupUI()
     fittingCombo->addItem("2次拟合 (二次)", 2);
     fittingCombo->addItem("正弦拟合", 3);
     fittingCombo->addItem("高斯拟合", 4);
+    fittingCombo->addItem("n次多项式", 5);
+    fittingCombo->addItem("自定义公式", 6);
+    fittingCombo->addItem("平滑样条 (GCV)", 7);
+    fittingCombo->addItem("LOESS", 8);
+    fittingCombo->addItem("分段回归", 9);
     fittingCombo->setMinimumHeight(scaledSize(24));
     fittingCombo->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
     fittingCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; min-width: 80px; }").arg(scaledSize(8)));
     
+    // 高次多项式的次数，仅在选中“n次多项式”时可用
+    polynomialDegreeSpin = new QSpinBox();
+    polynomialDegreeSpin->setRange(3, 30);
+    polynomialDegreeSpin->setValue(6);
+    polynomialDegreeSpin->setEnabled(false);
+    polynomialDegreeSpin->setMinimumHeight(scaledSize(24));
+    polynomialDegreeSpin->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    polynomialDegreeSpin->setToolTip("多项式次数");
+    polynomialDegreeSpin->setStyleSheet(QString("QSpinBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+
+    // 多项式拟合的稳健方法，抑制尖峰等离群点的影响
+    robustCombo = new QComboBox();
+    robustCombo->addItem("最小二乘", (int)RobustMethod::LeastSquares);
+    robustCombo->addItem("RANSAC", (int)RobustMethod::Ransac);
+    robustCombo->addItem("Huber", (int)RobustMethod::Huber);
+    robustCombo->addItem("Tukey", (int)RobustMethod::Tukey);
+    robustCombo->setMinimumHeight(scaledSize(24));
+    robustCombo->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    robustCombo->setToolTip("多项式拟合的稳健方法：\nRANSAC 并行评估随机最小样本假设，用内点重新拟合\n"
+                            "Huber / Tukey 为迭代加权最小二乘\n离群点在散点图和残差图中标出");
+    robustCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+
+    // LOESS 每个局部回归使用的点数占总点数的比例，仅在选中“LOESS”时显示
+    loessSpanSpin = new QDoubleSpinBox();
+    loessSpanSpin->setRange(0.05, 1.0);
+    loessSpanSpin->setSingleStep(0.05);
+    loessSpanSpin->setDecimals(2);
+    loessSpanSpin->setValue(0.3);
+    loessSpanSpin->setPrefix("窗口 ");
+    loessSpanSpin->setVisible(false);
+    loessSpanSpin->setMinimumHeight(scaledSize(24));
+    loessSpanSpin->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    loessSpanSpin->setToolTip("LOESS 窗口比例：越大曲线越平滑");
+    loessSpanSpin->setStyleSheet(QString("QDoubleSpinBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+
+    // 分段回归的断点数和各段多项式次数，仅在选中“分段回归”时显示
+    segmentCountSpin = new QSpinBox();
+    segmentCountSpin->setRange(1, 10);
+    segmentCountSpin->setValue(1);
+    segmentCountSpin->setPrefix("断点 ");
+    segmentCountSpin->setVisible(false);
+    segmentCountSpin->setMinimumHeight(scaledSize(24));
+    segmentCountSpin->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    segmentCountSpin->setToolTip("断点个数 k，数据分成 k + 1 段，断点位置使总残差平方和最小");
+    segmentCountSpin->setStyleSheet(QString("QSpinBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    segmentDegreeSpin = new QSpinBox();
+    segmentDegreeSpin->setRange(0, 3);
+    segmentDegreeSpin->setValue(1);
+    segmentDegreeSpin->setPrefix("次数 ");
+    segmentDegreeSpin->setVisible(false);
+    segmentDegreeSpin->setMinimumHeight(scaledSize(24));
+    segmentDegreeSpin->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    segmentDegreeSpin->setToolTip("各段多项式的次数：0 为分段常数，1 为分段线性");
+    segmentDegreeSpin->setStyleSheet(QString("QSpinBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    
+    // 自定义公式及参数初值，仅在选中“自定义公式”时显示
+    modelFormulaEdit = new QLineEdit();
+    modelFormulaEdit->setPlaceholderText("a*exp(-b*x)+c");
+    modelFormulaEdit->setToolTip("拟合公式：自变量为 x，其余名称为待拟合参数（最多 8 个）\n"
+                                 "支持 + - * / ^ 和 sin cos tan asin acos atan sinh cosh tanh exp log log10 sqrt abs pow");
+    modelFormulaEdit->setVisible(false);
+    modelFormulaEdit->setStyleSheet(QString("QLineEdit { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    modelInitialEdit = new QLineEdit();
+    modelInitialEdit->setPlaceholderText("初值: a=1, b=0.1");
+    modelInitialEdit->setToolTip("参数初值，格式 name=value，用逗号分隔；未给出的参数从 1 开始");
+    modelInitialEdit->setVisible(false);
+    modelInitialEdit->setStyleSheet(QString("QLineEdit { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+
     fittingButton = new QPushButton("数据拟合");
     fittingButton->setMinimumHeight(scaledSize(24));
     fittingButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
     fittingButton->setStyleSheet(QString("QPushButton { padding: 4px 8px; font-size: %1px; background-color: #17a2b8; color: white; border: none; border-radius: 3px; } QPushButton:hover { background-color: #138496; }").arg(scaledSize(8)));
     fittingButton->setToolTip("对当前数据进行多项式拟合并显示残差图");
     
+    // 拟合在后台线程进行，运行期间可以取消；再次点击“数据拟合”会取代正在进行的拟合
+    fittingCancelButton = new QPushButton("⏹ 取消");
+    fittingCancelButton->setEnabled(false);
+    fittingCancelButton->setMinimumHeight(scaledSize(24));
+    fittingCancelButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    fittingCancelButton->setStyleSheet(QString("QPushButton { padding: 4px 8px; font-size: %1px; background-color: #dc3545; color: white; border: none; border-radius: 3px; } QPushButton:hover { background-color: #c82333; } QPushButton:disabled { background-color: #adb5bd; }").arg(scaledSize(8)));
+    fittingCancelButton->setToolTip("取消正在进行的拟合");
+    fittingWatcher = new QFutureWatcher<FitOutcome>(this);
+    batchFitWatcher = new QFutureWatcher<std::vector<FitOutcome>>(this);
+    
+    // Bootstrap 置信带：对当前显示的单系列拟合重抽样，反复重拟合
+    bootstrapCombo = new QComboBox();
+    bootstrapCombo->addItem("残差重抽样", (int)BootstrapMethod::Residuals);
+    bootstrapCombo->addItem("成对重抽样", (int)BootstrapMethod::Pairs);
+    bootstrapCombo->setMinimumHeight(scaledSize(24));
+    bootstrapCombo->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    bootstrapCombo->setToolTip("残差重抽样：x 不变，拟合值加随机抽取的残差\n成对重抽样：有放回抽取 (x, y) 数据对，对异方差更稳健");
+    bootstrapCombo->setStyleSheet(QString("QComboBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    bootstrapCountSpin = new QSpinBox();
+    bootstrapCountSpin->setRange(100, 10000);
+    bootstrapCountSpin->setSingleStep(100);
+    bootstrapCountSpin->setValue(1000);
+    bootstrapCountSpin->setSuffix(" 次");
+    bootstrapCountSpin->setMinimumHeight(scaledSize(24));
+    bootstrapCountSpin->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    bootstrapCountSpin->setToolTip("重抽样次数");
+    bootstrapCountSpin->setStyleSheet(QString("QSpinBox { padding: 4px; border: 1px solid #ced4da; border-radius: 3px; font-size: %1px; }").arg(scaledSize(8)));
+    bootstrapButton = new QPushButton("🎲 置信带");
+    bootstrapButton->setMinimumHeight(scaledSize(24));
+    bootstrapButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    bootstrapButton->setStyleSheet(QString("QPushButton { padding: 4px 8px; font-size: %1px; background-color: #6f42c1; color: white; border: none; border-radius: 3px; } QPushButton:hover { background-color: #5a32a3; }").arg(scaledSize(8)));
+    bootstrapButton->setToolTip("对当前拟合做 bootstrap：绘制 95% 逐点置信带，给出参数的置信区间");
+    bootstrapWatcher = new QFutureWatcher<BootstrapOutcome>(this);
+    fittingProgressTimer = new QTimer(this);
+    fittingProgressTimer->setInterval(100);
+    
     fittingLayout->addWidget(fittingCombo);
+    fittingLayout->addWidget(polynomialDegreeSpin);
+    fittingLayout->addWidget(robustCombo);
+    fittingLayout->addWidget(loessSpanSpin);
+    fittingLayout->addWidget(segmentCountSpin);
+    fittingLayout->addWidget(segmentDegreeSpin);
+    fittingLayout->addWidget(modelFormulaEdit, 2);
+    fittingLayout->addWidget(modelInitialEdit, 1);
     fittingLayout->addWidget(fittingButton);
+    fittingLayout->addWidget(fittingCancelButton);
+    fittingLayout->addWidget(bootstrapCombo);
+    fittingLayout->addWidget(bootstrapCountSpin);
+    fittingLayout->addWidget(bootstrapButton);
     fittingLayout->addStretch();
     statsHeaderLayout->addLayout(fittingLayout);
     
@@ -656,6 +1003,46 @@ void MainWindow::connectSignals()
     
     // Connect fitting button
     connect(fittingButton, &QPushButton::clicked, this, &MainWindow::performDataFitting);
+    connect(modelFormulaEdit, &QLineEdit::returnPressed, this, &MainWindow::performDataFitting);
+    connect(fittingCancelButton, &QPushButton::clicked, this, &MainWindow::cancelFitting);
+    connect(fittingWatcher, &QFutureWatcher<FitOutcome>::finished, this, &MainWindow::onFittingFinished);
+    connect(batchFitWatcher, &QFutureWatcher<std::vector<FitOutcome>>::finished, this, &MainWindow::onBatchFittingFinished);
+    connect(fittingProgressTimer, &QTimer::timeout, this, &MainWindow::updateFittingProgress);
+    connect(bootstrapButton, &QPushButton::clicked, this, &MainWindow::performBootstrap);
+    connect(bootstrapWatcher, &QFutureWatcher<BootstrapOutcome>::finished, this, &MainWindow::onBootstrapFinished);
+    connect(fittingCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        int type = fittingCombo->currentData().toInt();
+        polynomialDegreeSpin->setEnabled(type == 5);
+        robustCombo->setEnabled(type <= 2 || type == 5);
+        modelFormulaEdit->setVisible(type == 6);
+        modelInitialEdit->setVisible(type == 6);
+        loessSpanSpin->setVisible(type == 8);
+        segmentCountSpin->setVisible(type == 9);
+        segmentDegreeSpin->setVisible(type == 9);
+    });
+
+    // Histogram binning
+    connect(histogramBinCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onHistogramBinningChanged);
+    connect(histogramBinSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onHistogramBinningChanged);
+    connect(kdeBandwidthCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onKdeBandwidthChanged);
+    connect(correlationMethodCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::updateCorrelationMatrix);
+    connect(spectrumWindowCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onSpectrumSettingsChanged);
+    connect(spectrumSegmentCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onSpectrumSettingsChanged);
+    connect(scatterRenderCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onScatterRenderChanged);
+
+    // Data analysis
+    connect(lagComputeButton, &QPushButton::clicked, this, &MainWindow::computeLagCorrelation);
+    connect(lagWatcher, &QFutureWatcher<LagCorrelationResult>::finished, this, &MainWindow::onLagCorrelationFinished);
+    connect(rollingWindowSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::updateRollingOverlays);
+    connect(rollingMeanCheckbox, &QCheckBox::toggled, this, &MainWindow::updateRollingOverlays);
+    connect(rollingStdCheckbox, &QCheckBox::toggled, this, &MainWindow::updateRollingOverlays);
+    connect(rollingRangeCheckbox, &QCheckBox::toggled, this, &MainWindow::updateRollingOverlays);
+    connect(peakFindButton, &QPushButton::clicked, this, &MainWindow::findPeaks);
+    connect(peakWatcher, &QFutureWatcher<std::vector<Peak>>::finished, this, &MainWindow::onPeaksFound);
+    connect(distributionFitCheckbox, &QCheckBox::toggled, this, &MainWindow::updateDistributionFits);
+    connect(distributionWatcher, &QFutureWatcher<std::vector<DistributionFit>>::finished, this, &MainWindow::onDistributionFitsFinished);
+    connect(testRunButton, &QPushButton::clicked, this, &MainWindow::runTwoSampleTests);
+    connect(testWatcher, &QFutureWatcher<std::vector<TwoSampleResult>>::finished, this, &MainWindow::onTwoSampleTestsFinished);
 }
 
 std::vector<double> MainWindow::parseNumbersFromLine(const std::string& line) {
@@ -793,6 +1180,24 @@ void MainWindow::loadDataFromFile(const QString& fileName)
 
     hasMultipleColumns = maxColumns > 1;
 
+    columnStore.clear();
+    columnStore.appendRows(rawData);
+    derivedColumns.clear();
+    rollingEngine.clear();
+    sortedCache.clear();
+    detectedPeaks.clear();
+    detectedPeakXColumn = detectedPeakYColumn = -1;
+    publishedFits.clear();
+    fitCache.clear();
+    // 数据已替换，正在进行的拟合作废
+    if (fittingProgress) {
+        fittingProgress->cancel();
+        fittingProgress.reset();
+        ++fittingGeneration;
+        fittingProgressTimer->stop();
+        fittingCancelButton->setEnabled(false);
+    }
+
     // Generate column headers
     columnHeaders.clear();
     columnHeaders.append(QString("行索引(虚拟)")); // Add virtual row index column
@@ -857,7 +1262,7 @@ void MainWindow::loadDataFromFile(const QString& fileName)
                              .arg(rawData.size()).arg(maxColumns));
 
     // Update statistics
-    updateDetailedStatistics(yData);
+    updateDetailedStatistics(columnStore.statistics(maxColumns == 1 ? 0 : 1));
 
     // Set default labels
     if (titleEdit->text().isEmpty()) {
@@ -897,6 +1302,22 @@ void MainWindow::updateColumnSelectionUI()
         yColumnCombo->addItem(header);
     }
 
+    // 滞后相关只针对数据列（不含虚拟行索引），data 为实际列号
+    lagColumnACombo->clear();
+    lagColumnBCombo->clear();
+    lagColumnBCombo->addItem("（自相关）", -1);
+    testColumnACombo->clear();
+    testColumnBCombo->clear();
+    for (int i = 1; i < columnHeaders.size(); ++i) {
+        lagColumnACombo->addItem(columnHeaders[i], i - 1);
+        lagColumnBCombo->addItem(columnHeaders[i], i - 1);
+        testColumnACombo->addItem(columnHeaders[i], i - 1);
+        testColumnBCombo->addItem(columnHeaders[i], i - 1);
+    }
+    if (testColumnBCombo->count() > 1) {
+        testColumnBCombo->setCurrentIndex(1);
+    }
+
     // Set default selections and always show column selection
     columnGroup->setVisible(true);
 
@@ -1061,6 +1482,14 @@ void MainWindow::processAIRequest(const QString& request)
         chartTypeCombo->setCurrentIndex(8);
         response += "已将图表类型改为面积图。";
         handled = true;
+    } else if ((lowerRequest.contains("改为") || lowerRequest.contains("切换") || lowerRequest.contains("使用") || lowerRequest.contains("设置")) && lowerRequest.contains("热力图")) {
+        chartTypeCombo->setCurrentIndex(9);
+        response += "已将图表类型改为相关热力图。";
+        handled = true;
+    } else if ((lowerRequest.contains("改为") || lowerRequest.contains("切换") || lowerRequest.contains("使用") || lowerRequest.contains("设置")) && lowerRequest.contains("频谱")) {
+        chartTypeCombo->setCurrentIndex(10);
+        response += "已将图表类型改为频谱图。";
+        handled = true;
     }
     // 标题修改 - 需要包含动作词
     else if ((lowerRequest.contains("修改标题") || lowerRequest.contains("设置标题") || lowerRequest.contains("改标题") || lowerRequest.contains("标题改为") || lowerRequest.contains("标题设为"))) {
@@ -1500,6 +1929,8 @@ QString MainWindow::getCurrentChartTypeName()
     case 6: return "小提琴图";
     case 7: return "密度图";
     case 8: return "面积图";
+    case 9: return "相关热力图";
+    case 10: return "频谱图";
     default: return "未知";
     }
 }
@@ -1516,6 +1947,8 @@ void MainWindow::applyConfiguration(const PlotConfig& config)
     else if (config.chartType == "violin") chartTypeCombo->setCurrentIndex(6);
     else if (config.chartType == "density") chartTypeCombo->setCurrentIndex(7);
     else if (config.chartType == "area") chartTypeCombo->setCurrentIndex(8);
+    else if (config.chartType == "heatmap") chartTypeCombo->setCurrentIndex(9);
+    else if (config.chartType == "spectrum") chartTypeCombo->setCurrentIndex(10);
 
     // Apply labels
     if (!config.title.isEmpty()) {
@@ -1668,6 +2101,8 @@ QString MainWindow::getCurrentChartTypeString()
     case 6: return "violin";
     case 7: return "density";
     case 8: return "area";
+    case 9: return "heatmap";
+    case 10: return "spectrum";
     default: return "line";
     }
 }
@@ -1683,6 +2118,8 @@ void MainWindow::setChartTypeByString(const QString& type)
     else if (type == "violin") chartTypeCombo->setCurrentIndex(6);
     else if (type == "density") chartTypeCombo->setCurrentIndex(7);
     else if (type == "area") chartTypeCombo->setCurrentIndex(8);
+    else if (type == "heatmap") chartTypeCombo->setCurrentIndex(9);
+    else if (type == "spectrum") chartTypeCombo->setCurrentIndex(10);
 }
 
 void MainWindow::applyColorsToPlotWidget(const PlotConfig& config)
@@ -1704,49 +2141,30 @@ int MainWindow::getCheckedChartTypeId()
 
 void MainWindow::updateDetailedStatistics(const std::vector<double>& data)
 {
-    if (data.empty()) {
+    StatisticsAccumulator stats;
+    stats.append(data);
+    updateDetailedStatistics(stats);
+}
+
+void MainWindow::updateDetailedStatistics(const StatisticsAccumulator& stats)
+{
+    if (stats.isEmpty()) {
         statsText->clear();
         return;
     }
 
-    // Calculate detailed statistics
-    double sum = std::accumulate(data.begin(), data.end(), 0.0);
-    double mean = sum / data.size();
-
-    double variance = 0.0;
-    for (double value : data) {
-        variance += (value - mean) * (value - mean);
-    }
-    variance /= data.size();
-    double stddev = std::sqrt(variance);
-
-    auto minmax = std::minmax_element(data.begin(), data.end());
-
-    // Calculate median
-    std::vector<double> sortedData = data;
-    std::sort(sortedData.begin(), sortedData.end());
-    double median;
-    if (sortedData.size() % 2 == 0) {
-        median = (sortedData[sortedData.size()/2 - 1] + sortedData[sortedData.size()/2]) / 2.0;
-    } else {
-        median = sortedData[sortedData.size()/2];
-    }
-
-    // Calculate quartiles
-    double q1 = sortedData[sortedData.size() / 4];
-    double q3 = sortedData[3 * sortedData.size() / 4];
-
+    // 所有统计量直接从累加器读取：均值/方差为 Welford 结果，分位数来自草图
     QString statsInfo = "📊 统计总结:\n\n";
-    statsInfo += QString("数量: %1\n").arg(data.size());
-    statsInfo += QString("总和: %1\n").arg(sum, 0, 'f', 3);
-    statsInfo += QString("平均值: %1\n").arg(mean, 0, 'f', 3);
-    statsInfo += QString("中位数: %1\n").arg(median, 0, 'f', 3);
-    statsInfo += QString("标准差: %1\n").arg(stddev, 0, 'f', 3);
-    statsInfo += QString("最小值: %1\n").arg(*minmax.first, 0, 'f', 3);
-    statsInfo += QString("最大值: %1\n").arg(*minmax.second, 0, 'f', 3);
-    statsInfo += QString("第一四分位数: %1\n").arg(q1, 0, 'f', 3);
-    statsInfo += QString("第三四分位数: %1\n").arg(q3, 0, 'f', 3);
-    statsInfo += QString("范围: %1").arg(*minmax.second - *minmax.first, 0, 'f', 3);
+    statsInfo += QString("数量: %1\n").arg(stats.count());
+    statsInfo += QString("总和: %1\n").arg(stats.sum(), 0, 'f', 3);
+    statsInfo += QString("平均值: %1\n").arg(stats.mean(), 0, 'f', 3);
+    statsInfo += QString("中位数: %1\n").arg(stats.median(), 0, 'f', 3);
+    statsInfo += QString("标准差: %1\n").arg(stats.stddev(), 0, 'f', 3);
+    statsInfo += QString("最小值: %1\n").arg(stats.min(), 0, 'f', 3);
+    statsInfo += QString("最大值: %1\n").arg(stats.max(), 0, 'f', 3);
+    statsInfo += QString("第一四分位数: %1\n").arg(stats.quantile(0.25), 0, 'f', 3);
+    statsInfo += QString("第三四分位数: %1\n").arg(stats.quantile(0.75), 0, 'f', 3);
+    statsInfo += QString("范围: %1").arg(stats.range(), 0, 'f', 3);
 
     statsText->setPlainText(statsInfo);
 }
@@ -1914,7 +2332,11 @@ void MainWindow::applyMultiColumnSelection()
         }
         
         plotWidget->setData(xData, yData);
-        updateDetailedStatistics(yData);
+        if (realYCol < (int)columnStore.columnCount()) {
+            updateDetailedStatistics(columnStore.statistics(realYCol));
+        } else {
+            updateDetailedStatistics(yData);
+        }
         
         // Update axis labels
         xLabelEdit->setText(columnHeaders[xCol]);
@@ -1965,7 +2387,10 @@ void MainWindow::applyMultiColumnSelection()
         plotWidget->setMultiSeriesData(xData, ySeriesData, seriesNames);
         
         // Use first series for statistics
-        if (!ySeriesData.empty()) {
+        int firstRealCol = selectedColumns[0] - 1;
+        if (firstRealCol < (int)columnStore.columnCount()) {
+            updateDetailedStatistics(columnStore.statistics(firstRealCol));
+        } else if (!ySeriesData.empty()) {
             updateDetailedStatistics(ySeriesData[0]);
         }
         
@@ -1983,367 +2408,757 @@ void MainWindow::applyMultiColumnSelection()
     }
 }
 
-bool MainWindow::validateColumnIndices()
+void MainWindow::onHistogramBinningChanged()
 {
-    // Validate X column combo
-    if (xColumnCombo->currentIndex() < 0 || xColumnCombo->currentIndex() >= columnHeaders.size()) {
-        return false;
-    }
-    
-    // Validate Y column combo
-    if (yColumnCombo->currentIndex() < 0 || yColumnCombo->currentIndex() >= columnHeaders.size()) {
-        return false;
-    }
-    
-    // Validate multi-column checkboxes if they exist
-    if (multiColumnCheckbox->isChecked()) {
-        for (size_t i = 0; i < columnCheckboxes.size(); ++i) {
-            if (columnCheckboxes[i]->isChecked()) {
-                int columnIndex = i + 1; // +1 because checkboxes start from column 1
-                if (columnIndex >= columnHeaders.size()) {
-                    return false;
-                }
-            }
-        }
+    BinSpec spec;
+    spec.rule = static_cast<BinRule>(histogramBinCombo->currentData().toInt());
+    spec.binCount = histogramBinSpin->value();
+    histogramBinSpin->setEnabled(spec.rule == BinRule::Fixed);
+    plotWidget->setHistogramBinSpec(spec);
+}
+
+void MainWindow::onKdeBandwidthChanged()
+{
+    plotWidget->setKdeBandwidthRule(static_cast<BandwidthRule>(kdeBandwidthCombo->currentData().toInt()));
+}
+
+void MainWindow::onSpectrumSettingsChanged()
+{
+    SpectrumSpec spec;
+    spec.window = static_cast<WindowFunction>(spectrumWindowCombo->currentData().toInt());
+    spec.segmentLength = spectrumSegmentCombo->currentData().toInt();
+    plotWidget->setSpectrumSpec(spec);
+}
+
+void MainWindow::onScatterRenderChanged()
+{
+    ScatterDensitySpec spec;
+    switch (scatterRenderCombo->currentData().toInt()) {
+    case 1:
+        spec.mode = ScatterRenderMode::Points;
+        break;
+    case 2:
+        spec.mode = ScatterRenderMode::Density;
+        break;
+    case 3:
+        spec.mode = ScatterRenderMode::Density;
+        spec.scale = DensityScale::EqualHistogram;
+        break;
+    default:
+        break;
     }
-    
-    return true;
+    plotWidget->setScatterDensitySpec(spec);
 }
 
-void MainWindow::performDataFitting()
+void MainWindow::updateCorrelationMatrix()
 {
-    // 检查是否有数据可拟合
-    if (rawData.empty() || xColumnCombo->currentIndex() < 0 || yColumnCombo->currentIndex() < 0) {
-        QMessageBox::warning(this, "拟合错误", "请先加载数据并选择X、Y轴列");
+    if (columnStore.isEmpty() || chartTypeCombo->currentIndex() != static_cast<int>(ChartType::Heatmap)) {
         return;
     }
-    
-    // 检查是否为多系列模式
+
+    // 多列模式下比较勾选的列（至少两列），否则比较全部数据列
+    std::vector<size_t> selected;
     if (multiColumnCheckbox->isChecked() && multiColumnCheckbox->isVisible()) {
-        QMessageBox::information(this, "拟合提示", "多系列模式下暂不支持拟合，请切换到单系列模式");
-        return;
-    }
-    
-    // 获取当前显示的数据
-    std::vector<double> xData, yData;
-    int xCol = xColumnCombo->currentIndex();
-    int yCol = yColumnCombo->currentIndex();
-    
-    // 构建X数据
-    if (xCol == 0) {
-        for (size_t i = 0; i < rawData.size(); ++i) {
-            xData.push_back(static_cast<double>(i + 1));
-        }
-    } else {
-        int realXCol = xCol - 1;
-        for (const auto& row : rawData) {
-            if (realXCol < (int)row.size()) {
-                xData.push_back(row[realXCol]);
+        for (size_t i = 0; i < columnCheckboxes.size() && i < columnStore.columnCount(); ++i) {
+            if (columnCheckboxes[i]->isChecked()) {
+                selected.push_back(i);
             }
         }
     }
-    
-    // 构建Y数据
-    if (yCol == 0) {
-        for (size_t i = 0; i < rawData.size(); ++i) {
-            yData.push_back(static_cast<double>(i + 1));
-        }
-    } else {
-        int realYCol = yCol - 1;
-        for (const auto& row : rawData) {
-            if (realYCol < (int)row.size()) {
-                yData.push_back(row[realYCol]);
-            }
+    if (selected.size() < 2) {
+        selected.clear();
+        for (size_t i = 0; i < columnStore.columnCount(); ++i) {
+            selected.push_back(i);
         }
     }
-    
-    if (xData.size() != yData.size() || xData.size() < 3) {
-        QMessageBox::warning(this, "拟合错误", "数据点不足，至少需要3个数据点进行拟合");
-        return;
-    }
-    
-    // 获取拟合类型
-    int fittingType = fittingCombo->currentData().toInt();
-    std::vector<double> coefficients;
-    std::vector<double> residuals;
-    QString fittingTypeName;
-    QString statusMessage;
-    
-    if (fittingType <= 2) {
-        // 多项式拟合
-        int degree = fittingType;
-        coefficients = polynomialFit(xData, yData, degree);
-        fittingTypeName = QString("%1次多项式拟合").arg(degree);
-        statusMessage = QString("✅ %1次多项式拟合完成").arg(degree);
-        
-        if (coefficients.empty()) {
-            QMessageBox::critical(this, "拟合错误", "多项式拟合失败，请检查数据");
-            return;
-        }
-        
-        // 计算多项式残差
-        for (size_t i = 0; i < xData.size(); ++i) {
-            double predicted = 0.0;
-            for (size_t j = 0; j < coefficients.size(); ++j) {
-                predicted += coefficients[j] * std::pow(xData[i], j);
-            }
-            residuals.push_back(yData[i] - predicted);
-        }
-    } else if (fittingType == 3) {
-        // 正弦拟合
-        coefficients = sinusoidalFit(xData, yData);
-        fittingTypeName = "正弦拟合";
-        statusMessage = "✅ 正弦拟合完成";
-        
-        if (coefficients.empty() || coefficients.size() < 4) {
-            QMessageBox::critical(this, "拟合错误", "正弦拟合失败，请检查数据");
-            return;
-        }
-        
-        // 计算正弦拟合残差: y = A*sin(B*x + C) + D
-        for (size_t i = 0; i < xData.size(); ++i) {
-            double predicted = coefficients[0] * std::sin(coefficients[1] * xData[i] + coefficients[2]) + coefficients[3];
-            residuals.push_back(yData[i] - predicted);
-        }
-    } else if (fittingType == 4) {
-        // 高斯拟合
-        coefficients = gaussianFit(xData, yData);
-        fittingTypeName = "高斯拟合";
-        statusMessage = "✅ 高斯拟合完成";
-        
-        if (coefficients.empty() || coefficients.size() < 3) {
-            QMessageBox::critical(this, "拟合错误", "高斯拟合失败，请检查数据");
-            return;
-        }
-        
-        // 计算高斯拟合残差: y = A*exp(-((x-B)/C)^2)
-        for (size_t i = 0; i < xData.size(); ++i) {
-            double arg = (xData[i] - coefficients[1]) / coefficients[2];
-            double predicted = coefficients[0] * std::exp(-arg * arg);
-            residuals.push_back(yData[i] - predicted);
-        }
+
+    std::vector<const std::vector<double>*> columns;
+    std::vector<uint64_t> versions;
+    std::vector<QString> names;
+    for (size_t col : selected) {
+        columns.push_back(&columnStore.column(col));
+        versions.push_back(columnStore.version(col));
+        names.push_back(columnHeaders[(int)col + 1]); // +1 跳过虚拟行索引列
     }
-    
-    // 将拟合结果传递给PlotWidget
-    plotWidget->setPolynomialFitting(fittingType, coefficients, residuals, fittingTypeName);
-    
-    // 更新状态信息
-    statusLabel->setText(statusMessage);
-    
-    // 更新统计信息，包含拟合参数
-    QString fittingInfo = QString("🎯 %1参数:\n").arg(fittingTypeName);
-    
-    if (fittingType <= 2) {
-        // 多项式拟合参数
-        for (size_t i = 0; i < coefficients.size(); ++i) {
-            if (i == 0) {
-                fittingInfo += QString("  常数项: %1\n").arg(coefficients[i], 0, 'f', 4);
-            } else if (i == 1) {
-                fittingInfo += QString("  一次项: %1\n").arg(coefficients[i], 0, 'f', 4);
-            } else {
-                fittingInfo += QString("  %1次项: %2\n").arg(i).arg(coefficients[i], 0, 'f', 4);
-            }
+
+    CorrelationMethod method = static_cast<CorrelationMethod>(correlationMethodCombo->currentData().toInt());
+    const CorrelationMatrix& matrix = correlationEngine.matrix(versions, columns, method);
+    plotWidget->setCorrelationMatrix(matrix, names);
+
+    statusLabel->setText(QString("✅ %1 相关矩阵：%2 列，%3 行")
+                             .arg(correlationMethodCombo->currentText())
+                             .arg(matrix.size)
+                             .arg(matrix.sampleCount));
+}
+
+std::vector<double> MainWindow::columnValues(int column) const
+{
+    if (column == 0) {
+        std::vector<double> index(rawData.size());
+        for (size_t i = 0; i < index.size(); ++i) {
+            index[i] = static_cast<double>(i + 1);
         }
-    } else if (fittingType == 3) {
-        // 正弦拟合参数: y = A*sin(B*x + C) + D
-        fittingInfo += QString("  振幅 A: %1\n").arg(coefficients[0], 0, 'f', 4);
-        fittingInfo += QString("  频率 B: %1\n").arg(coefficients[1], 0, 'f', 4);
-        fittingInfo += QString("  相位 C: %1\n").arg(coefficients[2], 0, 'f', 4);
-        fittingInfo += QString("  偏移 D: %1\n").arg(coefficients[3], 0, 'f', 4);
-        fittingInfo += QString("  拟合函数: y = %1*sin(%2*x + %3) + %4\n")
-                           .arg(coefficients[0], 0, 'f', 3)
-                           .arg(coefficients[1], 0, 'f', 3)
-                           .arg(coefficients[2], 0, 'f', 3)
-                           .arg(coefficients[3], 0, 'f', 3);
-    } else if (fittingType == 4) {
-        // 高斯拟合参数: y = A*exp(-((x-B)/C)^2)
-        fittingInfo += QString("  振幅 A: %1\n").arg(coefficients[0], 0, 'f', 4);
-        fittingInfo += QString("  中心 B: %1\n").arg(coefficients[1], 0, 'f', 4);
-        fittingInfo += QString("  标准差 C: %1\n").arg(coefficients[2], 0, 'f', 4);
-        fittingInfo += QString("  拟合函数: y = %1*exp(-((x-%2)/%3)²)\n")
-                           .arg(coefficients[0], 0, 'f', 3)
-                           .arg(coefficients[1], 0, 'f', 3)
-                           .arg(coefficients[2], 0, 'f', 3);
-    }
-    
-    // 计算R²
-    double ssRes = 0.0, ssTot = 0.0;
-    double yMean = std::accumulate(yData.begin(), yData.end(), 0.0) / yData.size();
-    
-    for (size_t i = 0; i < residuals.size(); ++i) {
-        ssRes += residuals[i] * residuals[i];
-        ssTot += (yData[i] - yMean) * (yData[i] - yMean);
+        return index;
     }
-    
-    double rSquared = (ssTot > 0) ? 1.0 - (ssRes / ssTot) : 0.0;
-    fittingInfo += QString("  决定系数 R²: %1").arg(rSquared, 0, 'f', 4);
-    
-    // 将拟合信息附加到统计信息
-    QString currentStats = statsText->toPlainText();
-    if (!currentStats.isEmpty()) {
-        currentStats += "\n\n" + fittingInfo;
-    } else {
-        currentStats = fittingInfo;
+    if (column > 0 && column - 1 < (int)columnStore.columnCount()) {
+        return columnStore.column(column - 1);
     }
-    statsText->setPlainText(currentStats);
+    const DerivedColumn* derived = derivedColumn(column);
+    return derived ? derived->values : std::vector<double>();
 }
 
-// 简单的多项式拟合实现（最小二乘法）
-std::vector<double> MainWindow::polynomialFit(const std::vector<double>& x, const std::vector<double>& y, int degree)
+const DerivedColumn* MainWindow::derivedColumn(int column) const
 {
-    if (x.size() != y.size() || x.size() <= degree) {
-        return std::vector<double>();
+    int index = column - 1 - (int)columnStore.columnCount();
+    if (index < 0 || index >= (int)derivedColumns.size()) {
+        return nullptr;
     }
-    
-    int n = x.size();
-    int m = degree + 1;
-    
-    // 构建设计矩阵 A 和目标向量 b
-    std::vector<std::vector<double>> A(n, std::vector<double>(m));
-    std::vector<double> b = y;
-    
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < m; ++j) {
-            A[i][j] = std::pow(x[i], j);
+    return &derivedColumns[index];
+}
+
+int MainWindow::addDerivedColumn(const DerivedColumn& column)
+{
+    int base = 1 + (int)columnStore.columnCount();
+
+    // 同名派生列（同一组参数重算）原地替换，避免下拉框无限增长
+    for (size_t i = 0; i < derivedColumns.size(); ++i) {
+        if (derivedColumns[i].name == column.name) {
+            derivedColumns[i] = column;
+            derivedColumns[i].version = ++derivedColumnVersion;
+            return base + (int)i;
         }
     }
-    
-    // 构建正规方程 A^T * A * coeffs = A^T * b
-    std::vector<std::vector<double>> AtA(m, std::vector<double>(m, 0.0));
-    std::vector<double> Atb(m, 0.0);
-    
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < m; ++j) {
-            for (int k = 0; k < n; ++k) {
-                AtA[i][j] += A[k][i] * A[k][j];
-            }
-        }
-        for (int k = 0; k < n; ++k) {
-            Atb[i] += A[k][i] * b[k];
+
+    derivedColumns.push_back(column);
+    derivedColumns.back().version = ++derivedColumnVersion;
+    columnHeaders.append(column.name);
+    xColumnCombo->addItem(column.name);
+    yColumnCombo->addItem(column.name);
+    return base + (int)derivedColumns.size() - 1;
+}
+
+bool MainWindow::derivedColumnCurrent(const QString& name, int sourceColumn, uint64_t sourceVersion, size_t window) const
+{
+    for (const DerivedColumn& column : derivedColumns) {
+        if (column.name == name) {
+            return column.sourceColumn == sourceColumn && column.sourceVersion == sourceVersion
+                && column.window == window;
         }
     }
-    
-    // 使用高斯消元法求解线性方程组
-    return gaussianElimination(AtA, Atb);
+    return false;
 }
 
-// 高斯消元法
-std::vector<double> MainWindow::gaussianElimination(std::vector<std::vector<double>>& A, std::vector<double>& b)
+void MainWindow::updateRollingOverlays()
 {
-    int n = A.size();
-    
-    // 前向消元
-    for (int i = 0; i < n; ++i) {
-        // 找到主元
-        int maxRow = i;
-        for (int k = i + 1; k < n; ++k) {
-            if (std::abs(A[k][i]) > std::abs(A[maxRow][i])) {
-                maxRow = k;
+    std::vector<SeriesOverlay> overlays;
+    bool showMean = rollingMeanCheckbox->isChecked();
+    bool showStd = rollingStdCheckbox->isChecked();
+    bool showRange = rollingRangeCheckbox->isChecked();
+    if (columnStore.isEmpty() || !(showMean || showStd || showRange)
+        || chartTypeCombo->currentIndex() != static_cast<int>(ChartType::Line)) {
+        plotWidget->setOverlays(overlays);
+        return;
+    }
+
+    // 叠加到当前绘制的数据列上：多列模式为勾选的列，单列模式为 Y 列（派生列不再叠加）
+    std::vector<int> columns;
+    if (multiColumnCheckbox->isChecked() && multiColumnCheckbox->isVisible()) {
+        for (size_t i = 0; i < columnCheckboxes.size() && i < columnStore.columnCount(); ++i) {
+            if (columnCheckboxes[i]->isChecked()) {
+                columns.push_back((int)i);
             }
         }
-        
-        // 交换行
-        std::swap(A[i], A[maxRow]);
-        std::swap(b[i], b[maxRow]);
-        
-        // 检查奇异矩阵
-        if (std::abs(A[i][i]) < 1e-10) {
-            return std::vector<double>(); // 奇异矩阵
+    } else {
+        int yCol = yColumnCombo->currentIndex();
+        if (yCol > 0 && yCol - 1 < (int)columnStore.columnCount()) {
+            columns.push_back(yCol - 1);
         }
-        
-        // 消元
-        for (int k = i + 1; k < n; ++k) {
-            double factor = A[k][i] / A[i][i];
-            for (int j = i; j < n; ++j) {
-                A[k][j] -= factor * A[i][j];
+    }
+
+    size_t window = static_cast<size_t>(rollingWindowSpin->value());
+    std::vector<DerivedColumn> results;
+    for (size_t s = 0; s < columns.size(); ++s) {
+        int col = columns[s];
+        const std::vector<double>& data = columnStore.column(col);
+        uint64_t version = columnStore.version(col);
+        QString source = columnHeaders[col + 1];
+
+        // 源列版本和窗口都没变的派生列保持原样，不重新编号，其拟合缓存仍然有效
+        auto publish = [&](const QString& name, const std::vector<double>& values) {
+            if (derivedColumnCurrent(name, col, version, window)) return;
+            DerivedColumn column;
+            column.name = name;
+            column.values = values;
+            column.sourceColumn = col;
+            column.sourceVersion = version;
+            column.window = window;
+            results.push_back(std::move(column));
+        };
+
+        if (showMean || showStd) {
+            const std::vector<double>& mean = rollingEngine.series(col, version, data, window, RollingStatistic::Mean);
+            if (showMean) {
+                SeriesOverlay overlay;
+                overlay.name = QString("移动平均(%1): %2").arg(window).arg(source);
+                overlay.seriesIndex = s;
+                overlay.values = mean;
+                overlays.push_back(overlay);
+                publish(QString("移动平均: %1").arg(source), mean);
+            }
+            if (showStd) {
+                const std::vector<double>& deviation = rollingEngine.series(col, version, data, window, RollingStatistic::StdDev);
+                SeriesOverlay overlay;
+                overlay.name = QString("±1σ(%1): %2").arg(window).arg(source);
+                overlay.seriesIndex = s;
+                overlay.values.resize(mean.size());
+                overlay.lower.resize(mean.size());
+                for (size_t i = 0; i < mean.size(); ++i) {
+                    overlay.values[i] = mean[i] + deviation[i];
+                    overlay.lower[i] = mean[i] - deviation[i];
+                }
+                overlays.push_back(overlay);
+                publish(QString("滑动标准差: %1").arg(source), deviation);
             }
-            b[k] -= factor * b[i];
         }
-    }
-    
-    // 回代
-    std::vector<double> x(n);
-    for (int i = n - 1; i >= 0; --i) {
-        x[i] = b[i];
-        for (int j = i + 1; j < n; ++j) {
-            x[i] -= A[i][j] * x[j];
+
+        if (showRange) {
+            const std::vector<double>& minimum = rollingEngine.series(col, version, data, window, RollingStatistic::Minimum);
+            const std::vector<double>& maximum = rollingEngine.series(col, version, data, window, RollingStatistic::Maximum);
+            SeriesOverlay overlay;
+            overlay.name = QString("最小/最大(%1): %2").arg(window).arg(source);
+            overlay.seriesIndex = s;
+            overlay.values = maximum;
+            overlay.lower = minimum;
+            overlay.filled = false;
+            overlays.push_back(overlay);
+            publish(QString("滑动最小值: %1").arg(source), minimum);
+            publish(QString("滑动最大值: %1").arg(source), maximum);
         }
-        x[i] /= A[i][i];
     }
-    
-    return x;
+
+    // 结果同时登记为派生列（同名替换），可以单独选作 Y 列绘制或拟合
+    for (const DerivedColumn& column : results) {
+        addDerivedColumn(column);
+    }
+    plotWidget->setOverlays(overlays);
 }
 
-// 正弦拟合实现 y = A*sin(B*x + C) + D
-std::vector<double> MainWindow::sinusoidalFit(const std::vector<double>& x, const std::vector<double>& y)
+void MainWindow::updateDistributionFits()
 {
-    if (x.size() != y.size() || x.size() < 4) {
-        return std::vector<double>();
+    bool multiMode = multiColumnCheckbox->isChecked() && multiColumnCheckbox->isVisible();
+    int yCol = yColumnCombo->currentIndex();
+    if (!distributionFitCheckbox->isChecked() || columnStore.isEmpty() || multiMode || yCol < 0
+        || chartTypeCombo->currentIndex() != static_cast<int>(ChartType::Histogram)) {
+        plotWidget->setDistributionFits(std::vector<DistributionFit>());
+        return;
     }
-    
-    // 初始估计参数
-    double yMean = std::accumulate(y.begin(), y.end(), 0.0) / y.size();
-    auto yMinMax = std::minmax_element(y.begin(), y.end());
-    double amplitude = (*yMinMax.second - *yMinMax.first) / 2.0;
-    double offset = yMean;
-    
-    // 估计频率：使用FFT的简化版本，这里用简单的周期估计
-    double xRange = *std::max_element(x.begin(), x.end()) - *std::min_element(x.begin(), x.end());
-    double frequency = 2.0 * M_PI / (xRange / 2.0); // 估计频率
-    double phase = 0.0;
-    
-    // 使用非线性最小二乘法拟合（简化版本）
-    // 这里使用迭代优化
-    std::vector<double> params = {amplitude, frequency, phase, offset};
-    
-    // 简单的梯度下降优化
-    double learningRate = 0.001;
-    int maxIterations = 1000;
-    double tolerance = 1e-6;
-    
-    for (int iter = 0; iter < maxIterations; ++iter) {
-        std::vector<double> gradients(4, 0.0);
-        double totalError = 0.0;
-        
-        for (size_t i = 0; i < x.size(); ++i) {
-            double predicted = params[0] * std::sin(params[1] * x[i] + params[2]) + params[3];
-            double error = y[i] - predicted;
-            totalError += error * error;
-            
-            // 计算梯度
-            double cosValue = std::cos(params[1] * x[i] + params[2]);
-            double sinValue = std::sin(params[1] * x[i] + params[2]);
-            
-            gradients[0] += -2.0 * error * sinValue; // ∂E/∂A
-            gradients[1] += -2.0 * error * params[0] * x[i] * cosValue; // ∂E/∂B
-            gradients[2] += -2.0 * error * params[0] * cosValue; // ∂E/∂C
-            gradients[3] += -2.0 * error; // ∂E/∂D
+
+    // 正在计算时只记下请求，完成后按当时的选择重算一次
+    if (distributionWatcher->isRunning()) {
+        distributionFitQueued = true;
+        return;
+    }
+    distributionFitQueued = false;
+    pendingDistributionColumn = yCol;
+    pendingDistributionVersion = columnVersion(yCol);
+
+    // 数据列走排序缓存：命中时直接拟合，否则在后台排序后写回缓存
+    if (yCol > 0 && yCol - 1 < (int)columnStore.columnCount()) {
+        int col = yCol - 1;
+        uint64_t version = columnStore.version(col);
+        SortedColumn cached = sortedCache.lookup(col, version);
+        if (cached) {
+            distributionWatcher->setFuture(QtConcurrent::run([cached]() {
+                return DistributionFitter::fitAll(*cached);
+            }));
+        } else {
+            SortedColumnCache* cache = &sortedCache;
+            std::vector<double> data = columnStore.column(col);
+            distributionWatcher->setFuture(QtConcurrent::run([cache, col, version, data]() {
+                return DistributionFitter::fitAll(*cache->sorted(col, version, data));
+            }));
         }
-        
-        // 更新参数
-        bool converged = true;
-        for (int j = 0; j < 4; ++j) {
-            double update = learningRate * gradients[j] / x.size();
-            if (std::abs(update) > tolerance) converged = false;
-            params[j] -= update;
+    } else {
+        std::vector<double> data = columnValues(yCol);
+        distributionWatcher->setFuture(QtConcurrent::run([data]() {
+            return DistributionFitter::fitAll(SortedColumnCache::parallelSort(data));
+        }));
+    }
+    statusLabel->setText(QString("⏳ 正在拟合 %1 的分布 ...").arg(columnHeaders[yCol]));
+}
+
+void MainWindow::onDistributionFitsFinished()
+{
+    std::vector<DistributionFit> fits = distributionWatcher->result();
+
+    if (distributionFitQueued) {
+        updateDistributionFits();
+        return;
+    }
+    if (yColumnCombo->currentIndex() != pendingDistributionColumn
+        || chartTypeCombo->currentIndex() != static_cast<int>(ChartType::Histogram)) {
+        return;
+    }
+    // 选择未变但数据已重新加载或被替换：结果作废，按当前数据重算
+    if (columnVersion(pendingDistributionColumn) != pendingDistributionVersion) {
+        updateDistributionFits();
+        return;
+    }
+
+    plotWidget->setDistributionFits(fits);
+
+    // A² 越小拟合越好；KS p 值由同一数据估计参数，偏保守
+    const DistributionFit* best = nullptr;
+    QString fitInfo = QString("\n📐 分布拟合 (n=%1):").arg(fits.empty() ? 0 : fits[0].sampleCount);
+    for (const DistributionFit& fit : fits) {
+        QString name = DistributionFitter::name(fit.type);
+        if (!fit.valid) {
+            fitInfo += QString("\n%1: 数据不在支撑集内，跳过").arg(name);
+            continue;
         }
-        
-        if (converged) break;
-        
-        // 自适应学习率
-        if (iter % 100 == 0) {
-            learningRate *= 0.95;
+        QString parameters;
+        switch (fit.type) {
+        case DistributionType::Normal:
+        case DistributionType::LogNormal:
+            parameters = QString("μ=%1, σ=%2").arg(fit.parameters[0], 0, 'g', 5).arg(fit.parameters[1], 0, 'g', 5);
+            break;
+        case DistributionType::Exponential:
+            parameters = QString("λ=%1").arg(fit.parameters[0], 0, 'g', 5);
+            break;
+        case DistributionType::Weibull:
+            parameters = QString("k=%1, λ=%2").arg(fit.parameters[0], 0, 'g', 5).arg(fit.parameters[1], 0, 'g', 5);
+            break;
+        }
+        fitInfo += QString("\n%1: %2 | KS D=%3 (p=%4) | AD A²=%5")
+                       .arg(name)
+                       .arg(parameters)
+                       .arg(fit.ksStatistic, 0, 'g', 4)
+                       .arg(fit.ksPValue, 0, 'g', 3)
+                       .arg(fit.adStatistic, 0, 'g', 4);
+        if (!best || fit.adStatistic < best->adStatistic) best = &fit;
+    }
+    if (best) {
+        fitInfo += QString("\n最佳: %1").arg(DistributionFitter::name(best->type));
+    }
+    statsText->append(fitInfo);
+
+    statusLabel->setText(best ? QString("✅ 分布拟合完成，最佳为%1分布").arg(DistributionFitter::name(best->type))
+                              : QString("❌ 没有可拟合的分布"));
+}
+
+void MainWindow::runTwoSampleTests()
+{
+    if (columnStore.isEmpty() || testColumnACombo->currentIndex() < 0) {
+        statusLabel->setText("❌ 错误：未加载数据");
+        return;
+    }
+    if (testWatcher->isRunning()) {
+        statusLabel->setText("⏳ 双样本检验仍在计算中...");
+        return;
+    }
+
+    // 多列模式且勾选了至少两列时做全部两两比较，否则只比较选定的一对
+    std::vector<int> checked;
+    if (multiColumnCheckbox->isChecked() && multiColumnCheckbox->isVisible()) {
+        for (size_t i = 0; i < columnCheckboxes.size() && i < columnStore.columnCount(); ++i) {
+            if (columnCheckboxes[i]->isChecked()) {
+                checked.push_back((int)i);
+            }
+        }
+    }
+    std::vector<std::pair<int, int>> pairs;
+    if (checked.size() >= 2) {
+        for (size_t i = 0; i < checked.size(); ++i) {
+            for (size_t j = i + 1; j < checked.size(); ++j) {
+                pairs.push_back({checked[i], checked[j]});
+            }
+        }
+    } else {
+        int columnA = testColumnACombo->currentData().toInt();
+        int columnB = testColumnBCombo->currentData().toInt();
+        if (columnA == columnB) {
+            statusLabel->setText("❌ 请选择两列不同的数据");
+            return;
+        }
+        pairs.push_back({columnA, columnB});
+    }
+
+    // 涉及的每列只准备一次：已缓存的直接传排序结果，否则复制原始数据到后台排序并写回缓存
+    std::vector<int> columns;
+    for (const auto& pair : pairs) {
+        columns.push_back(pair.first);
+        columns.push_back(pair.second);
+    }
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+    std::vector<uint64_t> versions;
+    std::vector<SortedColumn> sorted;
+    std::vector<std::vector<double>> unsorted;
+    for (int col : columns) {
+        uint64_t version = columnStore.version(col);
+        SortedColumn cached = sortedCache.lookup(col, version);
+        versions.push_back(version);
+        sorted.push_back(cached);
+        unsorted.push_back(cached ? std::vector<double>() : columnStore.column(col));
+    }
+
+    pendingTestPairs = pairs;
+    pendingTestSources = dataColumnVersions(columns);
+    testRunButton->setEnabled(false);
+    statusLabel->setText(QString("⏳ 正在进行 %1 组双样本检验 ...").arg(pairs.size()));
+
+    SortedColumnCache* cache = &sortedCache;
+    testWatcher->setFuture(QtConcurrent::run([cache, pairs, columns, versions, sorted, unsorted]() mutable {
+        for (size_t c = 0; c < columns.size(); ++c) {
+            if (!sorted[c]) {
+                sorted[c] = cache->sorted(columns[c], versions[c], unsorted[c]);
+                std::vector<double>().swap(unsorted[c]);
+            }
+        }
+        std::vector<const std::vector<double>*> sortedA, sortedB;
+        for (const auto& pair : pairs) {
+            size_t a = std::lower_bound(columns.begin(), columns.end(), pair.first) - columns.begin();
+            size_t b = std::lower_bound(columns.begin(), columns.end(), pair.second) - columns.begin();
+            sortedA.push_back(sorted[a].get());
+            sortedB.push_back(sorted[b].get());
+        }
+        return TwoSampleTests::compareBatch(sortedA, sortedB);
+    }));
+}
+
+void MainWindow::onTwoSampleTestsFinished()
+{
+    testRunButton->setEnabled(true);
+    std::vector<TwoSampleResult> results = testWatcher->result();
+    // 检验期间重新加载了文件或列被替换：列号和表头已不对应，结果作废
+    if (!dataColumnsUnchanged(pendingTestSources)) {
+        statusLabel->setText("⚠️ 数据已变化，丢弃双样本检验的结果");
+        return;
+    }
+
+    if (!testResultDialog) {
+        testResultDialog = new QDialog(this);
+        testResultDialog->setWindowTitle("双样本检验结果");
+        testResultDialog->resize(scaledSize(900), scaledSize(360));
+        QVBoxLayout *layout = new QVBoxLayout(testResultDialog);
+        testResultTable = new QTableWidget(testResultDialog);
+        testResultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        testResultTable->setColumnCount(13);
+        testResultTable->setHorizontalHeaderLabels(QStringList()
+                                                   << "列 A" << "列 B" << "n(A)" << "n(B)"
+                                                   << "均值 A" << "均值 B" << "Welch t" << "自由度" << "p (t)"
+                                                   << "U" << "p (U)" << "KS D" << "p (KS)");
+        testResultTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+        layout->addWidget(testResultTable);
+    }
+
+    // p < 0.05 的单元格标为浅红色
+    auto pValueItem = [](double p) {
+        QTableWidgetItem *item = new QTableWidgetItem(QString::number(p, 'g', 4));
+        if (p < 0.05) item->setBackground(QColor(248, 215, 218));
+        return item;
+    };
+
+    testResultTable->setRowCount((int)results.size());
+    for (size_t r = 0; r < results.size() && r < pendingTestPairs.size(); ++r) {
+        const TwoSampleResult& result = results[r];
+        int row = (int)r;
+        testResultTable->setItem(row, 0, new QTableWidgetItem(columnHeaders[pendingTestPairs[r].first + 1]));
+        testResultTable->setItem(row, 1, new QTableWidgetItem(columnHeaders[pendingTestPairs[r].second + 1]));
+        testResultTable->setItem(row, 2, new QTableWidgetItem(QString::number(result.countA)));
+        testResultTable->setItem(row, 3, new QTableWidgetItem(QString::number(result.countB)));
+        if (!result.valid) {
+            testResultTable->setItem(row, 4, new QTableWidgetItem("样本不足"));
+            continue;
+        }
+        testResultTable->setItem(row, 4, new QTableWidgetItem(QString::number(result.meanA, 'g', 6)));
+        testResultTable->setItem(row, 5, new QTableWidgetItem(QString::number(result.meanB, 'g', 6)));
+        testResultTable->setItem(row, 6, new QTableWidgetItem(QString::number(result.welchT, 'g', 5)));
+        testResultTable->setItem(row, 7, new QTableWidgetItem(QString::number(result.welchDf, 'g', 5)));
+        testResultTable->setItem(row, 8, pValueItem(result.welchP));
+        testResultTable->setItem(row, 9, new QTableWidgetItem(QString::number(result.mannWhitneyU, 'g', 8)));
+        testResultTable->setItem(row, 10, pValueItem(result.mannWhitneyP));
+        testResultTable->setItem(row, 11, new QTableWidgetItem(QString::number(result.ksStatistic, 'g', 4)));
+        testResultTable->setItem(row, 12, pValueItem(result.ksPValue));
+    }
+
+    testResultDialog->show();
+    testResultDialog->raise();
+    statusLabel->setText(QString("✅ 双样本检验完成：%1 组").arg(results.size()));
+}
+
+void MainWindow::findPeaks()
+{
+    if (rawData.empty() || xColumnCombo->currentIndex() < 0 || yColumnCombo->currentIndex() < 0) {
+        statusLabel->setText("❌ 错误：未加载数据");
+        return;
+    }
+    if (multiColumnCheckbox->isChecked() && multiColumnCheckbox->isVisible()) {
+        statusLabel->setText("❌ 寻峰只支持单列模式");
+        return;
+    }
+    if (peakWatcher->isRunning()) {
+        statusLabel->setText("⏳ 寻峰仍在进行中...");
+        return;
+    }
+
+    int xCol = xColumnCombo->currentIndex();
+    int yCol = yColumnCombo->currentIndex();
+    std::vector<double> x = columnValues(xCol);
+    std::vector<double> y = columnValues(yCol);
+    const DerivedColumn* derived = derivedColumn(yCol);
+    if (derived && !derived->axis.empty()) {
+        x = derived->axis;
+    }
+    if (x.size() != y.size() || y.size() < 3) {
+        statusLabel->setText("❌ 错误：数据点不足，无法寻峰");
+        return;
+    }
+
+    PeakSpec spec;
+    spec.minDistance = static_cast<size_t>(peakDistanceSpin->value());
+    spec.minWidth = peakWidthSpin->value();
+    double prominenceRatio = peakProminenceSpin->value() / 100.0;
+
+    pendingPeakXColumn = xCol;
+    pendingPeakYColumn = yCol;
+    pendingPeakXVersion = columnVersion(xCol);
+    pendingPeakYVersion = columnVersion(yCol);
+    peakFindButton->setEnabled(false);
+    statusLabel->setText(QString("⏳ 正在对 %1 寻峰 ...").arg(columnHeaders[yCol]));
+
+    peakWatcher->setFuture(QtConcurrent::run([x, y, spec, prominenceRatio]() mutable {
+        auto range = std::minmax_element(y.begin(), y.end());
+        spec.minProminence = prominenceRatio * (*range.second - *range.first);
+        return PeakFinder::find(x, y, spec);
+    }));
+}
+
+void MainWindow::onPeaksFound()
+{
+    peakFindButton->setEnabled(true);
+    // 寻峰期间重新加载了文件或列被替换：峰位置属于旧数据，不能再标注或用作高斯拟合的初值
+    if (columnVersion(pendingPeakXColumn) != pendingPeakXVersion
+        || columnVersion(pendingPeakYColumn) != pendingPeakYVersion) {
+        statusLabel->setText("⚠️ 数据已变化，丢弃寻峰的结果");
+        return;
+    }
+    detectedPeaks = peakWatcher->result();
+    detectedPeakXColumn = pendingPeakXColumn;
+    detectedPeakYColumn = pendingPeakYColumn;
+
+    // 计算期间切换了列或模式时只保留结果（供高斯拟合），不再标到当前图上
+    bool stillShown = xColumnCombo->currentIndex() == detectedPeakXColumn
+                      && yColumnCombo->currentIndex() == detectedPeakYColumn
+                      && !(multiColumnCheckbox->isChecked() && multiColumnCheckbox->isVisible());
+    if (!stillShown) {
+        statusLabel->setText(QString("✅ 寻峰完成：%1 个峰（列选择已变化，未标注）").arg(detectedPeaks.size()));
+        return;
+    }
+
+    plotWidget->setPeaks(detectedPeaks);
+
+    // 按突起度从大到小列出，最多 20 个
+    std::vector<size_t> order(detectedPeaks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return detectedPeaks[a].prominence > detectedPeaks[b].prominence;
+    });
+    const size_t maxListed = 20;
+    QString peakInfo = QString("\n🔺 峰值 (%1 个):").arg(detectedPeaks.size());
+    for (size_t i = 0; i < order.size() && i < maxListed; ++i) {
+        const Peak& peak = detectedPeaks[order[i]];
+        peakInfo += QString("\n#%1 位置 %2, 高度 %3, 突起度 %4, 半高宽 %5")
+                        .arg(i + 1)
+                        .arg(peak.position, 0, 'g', 6)
+                        .arg(peak.height, 0, 'g', 4)
+                        .arg(peak.prominence, 0, 'g', 4)
+                        .arg(peak.width(), 0, 'g', 4);
+    }
+    if (order.size() > maxListed) {
+        peakInfo += QString("\n... 其余 %1 个").arg(order.size() - maxListed);
+    }
+    statsText->append(peakInfo);
+
+    statusLabel->setText(QString("✅ 寻峰完成：%1 个峰").arg(detectedPeaks.size()));
+}
+
+void MainWindow::computeLagCorrelation()
+{
+    if (columnStore.isEmpty() || lagColumnACombo->currentIndex() < 0) {
+        statusLabel->setText("❌ 错误：未加载数据");
+        return;
+    }
+    if (lagWatcher->isRunning()) {
+        statusLabel->setText("⏳ 滞后相关仍在计算中...");
+        return;
+    }
+
+    int columnA = lagColumnACombo->currentData().toInt();
+    int columnB = lagColumnBCombo->currentData().toInt();
+    bool isAuto = columnB < 0 || columnB == columnA;
+
+    LagCorrelationSpec spec;
+    spec.maxLag = lagMaxSpin->value();
+    spec.zeroPad = lagZeroPadCheckbox->isChecked();
+    spec.normalization = static_cast<LagNormalization>(lagNormalizationCombo->currentData().toInt());
+
+    // 后台线程持有列数据的副本，计算期间重新加载文件不会影响它
+    std::vector<double> x = columnStore.column(columnA);
+    pendingLagSources = dataColumnVersions(isAuto ? std::vector<int>{columnA} : std::vector<int>{columnA, columnB});
+    if (isAuto) {
+        pendingLagName = QString("自相关: %1").arg(columnHeaders[columnA + 1]);
+        lagWatcher->setFuture(QtConcurrent::run([x, spec]() {
+            return LagCorrelation::autoCorrelation(x, spec);
+        }));
+    } else {
+        std::vector<double> y = columnStore.column(columnB);
+        pendingLagName = QString("互相关: %1×%2").arg(columnHeaders[columnA + 1]).arg(columnHeaders[columnB + 1]);
+        lagWatcher->setFuture(QtConcurrent::run([x, y, spec]() {
+            return LagCorrelation::crossCorrelation(x, y, spec);
+        }));
+    }
+
+    lagComputeButton->setEnabled(false);
+    statusLabel->setText(QString("⏳ 正在计算%1 ...").arg(pendingLagName));
+}
+
+void MainWindow::onLagCorrelationFinished()
+{
+    lagComputeButton->setEnabled(true);
+
+    LagCorrelationResult result = lagWatcher->result();
+    // 计算期间重新加载了文件或源列被替换，结果已不对应当前数据
+    if (!dataColumnsUnchanged(pendingLagSources)) {
+        statusLabel->setText(QString("⚠️ 数据已变化，丢弃%1的结果").arg(pendingLagName));
+        return;
+    }
+    if (result.isEmpty()) {
+        statusLabel->setText("❌ 错误：数据点不足，无法计算滞后相关");
+        return;
+    }
+
+    DerivedColumn column;
+    column.name = pendingLagName;
+    column.values = std::move(result.values);
+    column.axis = std::move(result.lags);
+    int index = addDerivedColumn(column);
+
+    // 派生列按单列折线绘制，横轴为滞后
+    if (multiColumnCheckbox->isChecked()) {
+        multiColumnCheckbox->setChecked(false);
+    }
+    chartTypeCombo->setCurrentIndex(static_cast<int>(ChartType::Line));
+    if (yColumnCombo->currentIndex() == index) {
+        applyColumnSelection();
+    } else {
+        yColumnCombo->setCurrentIndex(index);
+    }
+
+    statusLabel->setText(QString("✅ %1：峰值滞后 %2，值 %3")
+                             .arg(pendingLagName)
+                             .arg(result.peakLag)
+                             .arg(result.peakValue, 0, 'g', 4));
+}
+
+bool MainWindow::validateColumnIndices()
+{
+    // Validate X column combo
+    if (xColumnCombo->currentIndex() < 0 || xColumnCombo->currentIndex() >= columnHeaders.size()) {
+        return false;
+    }
+    
+    // Validate Y column combo
+    if (yColumnCombo->currentIndex() < 0 || yColumnCombo->currentIndex() >= columnHeaders.size()) {
+        return false;
+    }
+    
+    // Validate multi-column checkboxes if they exist
+    if (multiColumnCheckbox->isChecked()) {
+        for (size_t i = 0; i < columnCheckboxes.size(); ++i) {
+            if (columnCheckboxes[i]->isChecked()) {
+                int columnIndex = i + 1; // +1 because checkboxes start from column 1
+                if (columnIndex >= columnHeaders.size()) {
+                    return false;
+                }
+            }
         }
     }
     
-    return params;
+    return true;
+}
+
+// 自定义公式的块求值：要 Jacobian 时走自动微分
+static NonlinearBlockModel expressionModel(const ModelExpression& expression)
+{
+    return [&expression](const double* xs, size_t count, const double* p, double* values, double* jacobian) {
+        if (jacobian) {
+            expression.evaluateWithJacobian(xs, count, p, values, jacobian);
+        } else {
+            expression.evaluate(xs, count, p, values);
+        }
+    };
+}
+
+// 正弦拟合实现 y = A*sin(B*x + C) + D
+static LevenbergMarquardtResult sinusoidalFit(const std::vector<double>& x, const std::vector<double>& y,
+                                              FitProgress* progress)
+{
+    if (x.size() != y.size() || x.size() < 4) {
+        return LevenbergMarquardtResult();
+    }
+    
+    // 估计频率：取加窗周期图的主峰（B = 2π f），频谱无峰时退回按半个区间一个周期估计
+    double xRange = *std::max_element(x.begin(), x.end()) - *std::min_element(x.begin(), x.end());
+    double dominant = SpectrumEngine::dominantFrequency(x, y);
+    double frequency = (dominant > 0.0) ? 2.0 * M_PI * dominant : 2.0 * M_PI / (xRange / 2.0);
+    
+    LevenbergMarquardtOptions options;
+    options.progress = progress;
+    
+    // 频率固定时 y = a*sin(Bx) + b*cos(Bx) + D 是线性模型，先解出振幅、相位和偏移作为初值
+    double yMean = std::accumulate(y.begin(), y.end(), 0.0) / y.size();
+    NonlinearModel linear = [frequency](double xi, const double* p, double* gradient) {
+        double s = std::sin(frequency * xi), c = std::cos(frequency * xi);
+        if (gradient) {
+            gradient[0] = s;
+            gradient[1] = c;
+            gradient[2] = 1.0;
+        }
+        return p[0] * s + p[1] * c + p[2];
+    };
+    LevenbergMarquardtResult seed = LevenbergMarquardt::fit(x, y, linear, {0.0, 0.0, yMean}, options);
+    if (seed.status == LevenbergMarquardtStatus::Cancelled) return seed;
+    double amplitude = std::hypot(seed.parameters[0], seed.parameters[1]);
+    double phase = std::atan2(seed.parameters[1], seed.parameters[0]);
+    if (!(amplitude > 0.0)) {
+        auto yMinMax = std::minmax_element(y.begin(), y.end());
+        amplitude = (*yMinMax.second - *yMinMax.first) / 2.0;
+        phase = 0.0;
+    }
+    
+    // 四个参数一起用 Levenberg–Marquardt 精化，Jacobian 为解析式（sineModel）
+    LevenbergMarquardtResult result = LevenbergMarquardt::fit(x, y, NonlinearModel(sineModel),
+                                                              {amplitude, frequency, phase, seed.parameters[2]}, options);
+    
+    // 规范化：振幅取正，相位归到 (-π, π]
+    if (result.parameters[0] < 0.0) {
+        result.parameters[0] = -result.parameters[0];
+        result.parameters[2] += M_PI;
+    }
+    result.parameters[2] = std::remainder(result.parameters[2], 2.0 * M_PI);
+    return result;
 }
 
 // 高斯拟合实现 y = A*exp(-((x-B)/C)^2)
-std::vector<double> MainWindow::gaussianFit(const std::vector<double>& x, const std::vector<double>& y)
+// seed 为当前 X/Y 列突起度最大的峰（没有寻峰结果时为空）：中心为峰位置，
+// exp(-((x-B)/C)^2) 的半高宽为 2*C*sqrt(ln2)，由此反推 C
+static LevenbergMarquardtResult gaussianFit(const std::vector<double>& x, const std::vector<double>& y,
+                                            const Peak* seed, FitProgress* progress)
 {
     if (x.size() != y.size() || x.size() < 3) {
-        return std::vector<double>();
+        return LevenbergMarquardtResult();
     }
     
     // 初始估计参数
@@ -2355,58 +3170,1111 @@ std::vector<double> MainWindow::gaussianFit(const std::vector<double>& x, const
     
     // 估计标准差：找到半最大值的位置
     double halfMax = A / 2.0;
-    double C = 1.0;
+    double C = 0.0;
     
-    // 寻找半最大值宽度来估计标准差
-    for (size_t i = 0; i < y.size(); ++i) {
-        if (std::abs(y[i] - halfMax) < A * 0.1) {
-            C = std::max(C, std::abs(x[i] - B));
+    if (seed && seed->width() > 0.0) {
+        A = seed->height;
+        B = seed->position;
+        C = seed->width() / (2.0 * std::sqrt(std::log(2.0)));
+    } else {
+        // 寻找半最大值宽度来估计标准差：半高半宽为 C*sqrt(ln2)
+        for (size_t i = 0; i < y.size(); ++i) {
+            if (std::abs(y[i] - halfMax) < std::abs(A) * 0.1) {
+                C = std::max(C, std::abs(x[i] - B));
+            }
+        }
+        C /= std::sqrt(std::log(2.0));
+        if (!(C > 0.0)) {
+            auto xMinMax = std::minmax_element(x.begin(), x.end());
+            C = std::max((*xMinMax.second - *xMinMax.first) / 4.0, 1e-12);
         }
     }
     
-    std::vector<double> params = {A, B, C};
+    LevenbergMarquardtOptions options;
+    options.progress = progress;
+    LevenbergMarquardtResult result = LevenbergMarquardt::fit(x, y, NonlinearModel(gaussianModel), {A, B, C}, options);
     
-    // 使用非线性最小二乘法（Levenberg-Marquardt的简化版）
-    double learningRate = 0.001;
-    int maxIterations = 1000;
-    double tolerance = 1e-6;
+    // C 只以平方出现，取正值
+    result.parameters[2] = std::abs(result.parameters[2]);
+    return result;
+}
+
+// 把 [中心', 半宽', a0, a1, ...]（关于 t' 的系数）换算到给定的中心和半宽下：t' = α t + β，
+// 按 Horner 逐项乘以一次式展开，使各次重抽样的系数可以直接比较
+static void recenterPolynomial(std::vector<double>& coefficients, double center, double halfRange)
+{
+    if (coefficients.size() < 3 || coefficients[1] == 0.0) return;
+    double alpha = halfRange / coefficients[1];
+    double beta = (center - coefficients[0]) / coefficients[1];
+    std::vector<double> result(1, 0.0);
+    for (size_t k = coefficients.size(); k-- > 2;) {
+        std::vector<double> next(result.size() + 1, 0.0);
+        for (size_t i = 0; i < result.size(); ++i) {
+            next[i] += beta * result[i];
+            next[i + 1] += alpha * result[i];
+        }
+        next[0] += coefficients[k];
+        result.swap(next);
+    }
+    result.resize(coefficients.size() - 2);
+    coefficients.assign({center, halfRange});
+    coefficients.insert(coefficients.end(), result.begin(), result.end());
+}
+
+// 在拟合线程中执行：只使用 job 里的副本，结果由 onFittingFinished 发布到界面
+static FitOutcome runFitJob(const FitJob& job, FitProgress* progress)
+{
+    FitOutcome outcome;
+    outcome.generation = job.generation;
+    const std::vector<double>& xData = job.x;
+    const std::vector<double>& yData = job.y;
     
-    for (int iter = 0; iter < maxIterations; ++iter) {
-        std::vector<double> gradients(3, 0.0);
-        double totalError = 0.0;
+    if (job.type <= 2 || job.type == 5) {
+        // 多项式拟合：流式 QR，Chebyshev 基；稳健方法在此基础上做 RANSAC 或迭代加权
+        PolynomialFit fit;
+        if (job.robust == RobustMethod::LeastSquares) {
+            fit = PolynomialFitter::fit(xData, yData, job.degree, PolynomialBasis::Chebyshev, progress);
+        } else {
+            RobustFitOptions options;
+            options.method = job.robust;
+            options.progress = progress;
+            RobustFitResult robust = RobustFitter::fitPolynomial(xData, yData, job.degree, options);
+            fit = std::move(robust.fit);
+            outcome.inliers = std::move(robust.inliers);
+            outcome.inlierCount = robust.inlierCount;
+            outcome.robustScale = robust.scale;
+        }
+        if (progress->isCancelled()) {
+            outcome.cancelled = true;
+            return outcome;
+        }
+        if (!fit.valid) {
+            outcome.error = "多项式拟合失败，请检查数据";
+            return outcome;
+        }
+        outcome.statusMessage = QString("✅ %1完成").arg(job.typeName);
         
-        for (size_t i = 0; i < x.size(); ++i) {
-            double arg = (x[i] - params[1]) / params[2];
-            double expValue = std::exp(-arg * arg);
-            double predicted = params[0] * expValue;
-            double error = y[i] - predicted;
-            totalError += error * error;
-            
-            // 计算梯度
-            gradients[0] += -2.0 * error * expValue; // ∂E/∂A
-            gradients[1] += -2.0 * error * params[0] * expValue * (2.0 * arg / params[2]); // ∂E/∂B
-            gradients[2] += -2.0 * error * params[0] * expValue * (2.0 * arg * arg / params[2]); // ∂E/∂C
+        // 低次直接给出关于 x 的系数；高次给出关于 t = (x - 中心) / 半宽 的系数，
+        // 前两项存中心和半宽，避免展开到 x 的幂次后丢失精度
+        if (job.type == 5) {
+            outcome.coefficients = fit.scaledMonomialCoefficients();
+            outcome.coefficients.insert(outcome.coefficients.begin(), {fit.center, fit.halfRange});
+        } else {
+            outcome.coefficients = fit.monomialCoefficients();
+        }
+        
+    } else if (job.type == 7 || job.type == 8) {
+        // 非参数平滑：曲线由节点表示，系数只记录平滑程度的摘要
+        SmoothCurve curve;
+        if (job.type == 7) {
+            SmoothingSplineResult fit = SmoothingSpline::fit(xData, yData, 0.0, progress);
+            curve = std::move(fit.curve);
+            outcome.coefficients = {fit.lambda, fit.degreesOfFreedom, fit.gcv};
+            if (!fit.valid) outcome.error = "平滑样条拟合失败：至少需要 3 个不同的 x";
+        } else {
+            LoessResult fit = Loess::fit(xData, yData, job.span, 1, 2000, progress);
+            curve = std::move(fit.curve);
+            outcome.coefficients = {fit.span, static_cast<double>(fit.neighbours)};
+            if (!fit.valid) outcome.error = "LOESS 拟合失败，请检查数据";
+        }
+        if (progress->isCancelled()) {
+            outcome.error.clear();
+            outcome.cancelled = true;
+            return outcome;
+        }
+        if (!outcome.error.isEmpty()) {
+            return outcome;
         }
+        outcome.curve = std::make_shared<const SmoothCurve>(std::move(curve));
+        outcome.statusMessage = QString("✅ %1完成").arg(job.typeName);
         
-        // 更新参数
-        bool converged = true;
-        for (int j = 0; j < 3; ++j) {
-            double update = learningRate * gradients[j] / x.size();
-            if (std::abs(update) > tolerance) converged = false;
-            params[j] -= update;
+    } else if (job.type == 9) {
+        // 分段回归：动态规划选断点，系数按 FitModel 的分段布局展开
+        SegmentedFitResult fit = SegmentedRegression::fit(xData, yData, job.breakpoints, job.degree, 0, progress);
+        if (progress->isCancelled()) {
+            outcome.cancelled = true;
+            return outcome;
         }
+        if (!fit.valid) {
+            outcome.error = QString("分段回归失败：数据点不足以分成 %1 段，或某段内 x 全相同").arg(job.breakpoints + 1);
+            return outcome;
+        }
+        outcome.coefficients = {fit.center, fit.halfRange, static_cast<double>(fit.degree)};
+        outcome.coefficients.insert(outcome.coefficients.end(), fit.breakpoints.begin(), fit.breakpoints.end());
+        for (const std::vector<double>& segment : fit.coefficients) {
+            outcome.coefficients.insert(outcome.coefficients.end(), segment.begin(), segment.end());
+        }
+        outcome.statusMessage = QString("✅ %1完成（残差平方和 %2，BIC %3）")
+                                    .arg(job.typeName).arg(fit.residualSumOfSquares, 0, 'g', 6).arg(fit.bic, 0, 'f', 1);
         
-        // 防止参数变得不合理
-        if (params[0] <= 0) params[0] = 0.1;
-        if (params[2] <= 0) params[2] = 0.1;
+    } else {
+        LevenbergMarquardtResult fit;
+        size_t parameterCount = 0;
+        QString failure;
+        if (job.type == 3) {
+            fit = sinusoidalFit(xData, yData, progress);
+            parameterCount = 4;
+            failure = "正弦拟合失败，请检查数据";
+        } else if (job.type == 4) {
+            fit = gaussianFit(xData, yData, job.hasPeakSeed ? &job.peakSeed : nullptr, progress);
+            parameterCount = 3;
+            failure = "高斯拟合失败，请检查数据";
+        } else {
+            // 自定义公式：编译为带自动微分的求值器后用 Levenberg–Marquardt 拟合
+            LevenbergMarquardtOptions options;
+            options.progress = progress;
+            fit = LevenbergMarquardt::fit(xData, yData, expressionModel(*job.expression), job.initial, options);
+            parameterCount = job.expression->parameterCount();
+            failure = "自定义公式拟合失败，请检查公式和参数初值";
+        }
         
-        if (converged) break;
+        if (fit.status == LevenbergMarquardtStatus::Cancelled) {
+            outcome.cancelled = true;
+            return outcome;
+        }
+        if (fit.status == LevenbergMarquardtStatus::Failed || fit.parameters.size() < parameterCount) {
+            outcome.error = failure;
+            return outcome;
+        }
+        outcome.coefficients = fit.parameters;
+        outcome.standardErrors = fit.standardErrors;
+        outcome.statusMessage = QString("✅ %1完成（%2，迭代 %3 次）")
+                                    .arg(job.type == 6 ? QString("自定义公式拟合") : job.typeName)
+                                    .arg(LevenbergMarquardt::statusText(fit.status)).arg(fit.iterations);
+    }
+    
+    // 残差与绘图、导出用同一个模型求值（分块并行）
+    outcome.residuals = FitModel(job.type, outcome.coefficients, job.expression, outcome.curve).residuals(xData, yData);
+    
+    // 计算R²
+    double ssRes = 0.0, ssTot = 0.0;
+    double yMean = std::accumulate(yData.begin(), yData.end(), 0.0) / yData.size();
+    
+    for (size_t i = 0; i < outcome.residuals.size(); ++i) {
+        ssRes += outcome.residuals[i] * outcome.residuals[i];
+        ssTot += (yData[i] - yMean) * (yData[i] - yMean);
+    }
+    
+    outcome.rSquared = (ssTot > 0) ? 1.0 - (ssRes / ssTot) : 0.0;
+    return outcome;
+}
+
+// 读取拟合类型及其设置；控件只在界面线程读取，拟合线程不访问界面
+bool MainWindow::prepareFitJob(FitJob& job)
+{
+    job.type = fittingCombo->currentData().toInt();
+    if (job.type <= 2 || job.type == 5) {
+        job.degree = (job.type == 5) ? polynomialDegreeSpin->value() : job.type;
+        job.robust = static_cast<RobustMethod>(robustCombo->currentData().toInt());
+        job.typeName = QString("%1次多项式拟合").arg(job.degree);
+        if (job.robust != RobustMethod::LeastSquares) {
+            job.typeName += QString("（%1）").arg(RobustFitter::methodName(job.robust));
+        }
+    } else if (job.type == 3) {
+        job.typeName = "正弦拟合";
+    } else if (job.type == 4) {
+        job.typeName = "高斯拟合";
+    } else if (job.type == 6) {
+        std::string error;
+        job.expression = ModelExpression::compile(modelFormulaEdit->text().toStdString(), &error);
+        if (!job.expression) {
+            QMessageBox::warning(this, "拟合错误", QString("公式错误：%1").arg(QString::fromStdString(error)));
+            return false;
+        }
+        job.initial = expressionInitialValues(*job.expression);
+        job.typeName = QString("y = %1").arg(modelFormulaEdit->text().trimmed());
+    } else if (job.type == 7) {
+        job.typeName = "平滑样条拟合";
+    } else if (job.type == 8) {
+        job.span = loessSpanSpin->value();
+        job.typeName = "LOESS 拟合";
+    } else if (job.type == 9) {
+        job.breakpoints = segmentCountSpin->value();
+        job.degree = segmentDegreeSpin->value();
+        job.typeName = QString("%1 段%2次回归").arg(job.breakpoints + 1).arg(job.degree);
+    }
+    return true;
+}
+
+// 新任务取代仍在运行的旧任务：旧任务收到取消标志后尽快返回，其结果按代号丢弃
+std::shared_ptr<FitProgress> MainWindow::beginFitTask(FitJob& job)
+{
+    if (fittingProgress) {
+        fittingProgress->cancel();
+    }
+    fittingProgress = std::make_shared<FitProgress>();
+    job.generation = ++fittingGeneration;
+    pendingFit.type = job.type;
+    pendingFit.degree = job.degree;
+    pendingFit.robust = job.robust;
+    pendingFit.typeName = job.typeName;
+    pendingFit.expression = job.expression;
+    pendingFit.initial = job.initial;
+    pendingFit.span = job.span;
+    pendingFit.breakpoints = job.breakpoints;
+    pendingFit.hasPeakSeed = job.hasPeakSeed;
+    pendingFit.peakSeed = job.peakSeed;
+    pendingFit.xColumn = job.xColumn;
+    pendingFit.yColumn = job.yColumn;
+    pendingFit.cacheKey = job.cacheKey;
+    pendingFit.generation = job.generation;
+    return fittingProgress;
+}
+
+void MainWindow::performDataFitting()
+{
+    // 检查是否有数据可拟合
+    if (rawData.empty() || xColumnCombo->currentIndex() < 0 || yColumnCombo->currentIndex() < 0) {
+        QMessageBox::warning(this, "拟合错误", "请先加载数据并选择X、Y轴列");
+        return;
+    }
+    
+    // 多系列模式：对勾选的每一列分别拟合
+    if (multiColumnCheckbox->isChecked() && multiColumnCheckbox->isVisible()) {
+        performBatchFitting();
+        return;
+    }
+    
+    // 获取当前显示的数据
+    FitJob job;
+    int xCol = xColumnCombo->currentIndex();
+    int yCol = yColumnCombo->currentIndex();
+    
+    job.x = columnValues(xCol);
+    job.y = columnValues(yCol);
+    const DerivedColumn* derived = derivedColumn(yCol);
+    if (derived && !derived->axis.empty()) {
+        job.x = derived->axis;
+    }
+    
+    if (job.x.size() != job.y.size() || job.x.size() < 3) {
+        QMessageBox::warning(this, "拟合错误", "数据点不足，至少需要3个数据点进行拟合");
+        return;
+    }
+    
+    if (!prepareFitJob(job)) {
+        return;
+    }
+    job.xColumn = xCol;
+    job.yColumn = yCol;
+    // 高斯拟合：当前 X/Y 列有寻峰结果时，取突起度最大的峰作为初值
+    if (job.type == 4 && detectedPeakXColumn == xCol && detectedPeakYColumn == yCol) {
+        for (const Peak& peak : detectedPeaks) {
+            if (!job.hasPeakSeed || peak.prominence > job.peakSeed.prominence) {
+                job.peakSeed = peak;
+                job.hasPeakSeed = true;
+            }
+        }
+    }
+    
+    job.cacheKey = fitCacheKey(job, xCol, yCol);
+    
+    // 同一份数据、同样设置的拟合已有结果：直接显示，正在进行的拟合作废
+    if (const auto* cached = fitCache.find(job.cacheKey)) {
+        if (fittingProgress) {
+            fittingProgress->cancel();
+            fittingProgress.reset();
+            ++fittingGeneration;
+            fittingProgressTimer->stop();
+            fittingCancelButton->setEnabled(false);
+        }
+        publishFit(cached->value.job, cached->value.outcome, true);
+        return;
+    }
+    
+    std::shared_ptr<FitProgress> progress = beginFitTask(job);
+    fittingWatcher->setFuture(QtConcurrent::run([job = std::move(job), progress]() {
+        return runFitJob(job, progress.get());
+    }));
+    
+    fittingCancelButton->setEnabled(true);
+    fittingProgressTimer->start();
+    statusLabel->setText(QString("⏳ 正在进行%1...").arg(pendingFit.typeName));
+}
+
+// 多系列批量拟合：同一模型分别拟合勾选的每一列，各列之间并行
+void MainWindow::performBatchFitting()
+{
+    int xCol = xColumnCombo->currentIndex();
+    std::vector<int> columns;
+    for (size_t i = 0; i < columnCheckboxes.size(); ++i) {
+        int columnIndex = (int)i + 1; // 复选框从第 1 列开始（不含虚拟列）
+        if (columnCheckboxes[i]->isChecked() && columnIndex < columnHeaders.size()) {
+            columns.push_back(columnIndex);
+        }
+    }
+    if (columns.empty()) {
+        QMessageBox::warning(this, "拟合错误", "请至少勾选一个Y轴列");
+        return;
+    }
+    
+    FitJob job;
+    job.xColumn = xCol;
+    job.x = columnValues(xCol);
+    if (job.x.size() < 3) {
+        QMessageBox::warning(this, "拟合错误", "数据点不足，至少需要3个数据点进行拟合");
+        return;
+    }
+    if (!prepareFitJob(job)) {
+        return;
+    }
+    
+    std::vector<std::vector<double>> ySeries;
+    ySeries.reserve(columns.size());
+    for (int column : columns) {
+        ySeries.push_back(columnValues(column));
+    }
+    
+    std::shared_ptr<FitProgress> progress = beginFitTask(job);
+    progress->totalTasks = (int)columns.size();
+    pendingTaskUnit = "列";
+    pendingBatchColumns = columns;
+    pendingBatchKeys.clear();
+    for (int column : columns) {
+        pendingBatchKeys.push_back(fitCacheKey(job, xCol, column));
+    }
+    
+    // 每列一个任务；单列数据较少时内部不再分块，整体按列并行
+    batchFitWatcher->setFuture(QtConcurrent::run([job = std::move(job), ySeries = std::move(ySeries), progress]() {
+        std::vector<FitOutcome> outcomes(ySeries.size());
+        for (FitOutcome& outcome : outcomes) {
+            outcome.generation = job.generation;
+            outcome.cancelled = true;
+        }
+        parallelForEach(ySeries.size(), [&](size_t i) {
+            if (progress->isCancelled()) return;
+            FitJob seriesJob = job;
+            seriesJob.y = ySeries[i];
+            if (seriesJob.x.size() != seriesJob.y.size()) {
+                outcomes[i].cancelled = false;
+                outcomes[i].error = "X、Y 长度不一致";
+            } else {
+                outcomes[i] = runFitJob(seriesJob, progress.get());
+            }
+            ++progress->completedTasks;
+        });
+        return outcomes;
+    }));
+    
+    fittingCancelButton->setEnabled(true);
+    fittingProgressTimer->start();
+    statusLabel->setText(QString("⏳ 正在对 %1 列进行%2...").arg(columns.size()).arg(pendingFit.typeName));
+}
+
+// 各拟合类型的参数名，与系数顺序一致
+static QStringList fitParameterNames(const FitJob& job)
+{
+    QStringList names;
+    if (job.type <= 2) {
+        names << "常数项" << "一次项";
+        for (int k = 2; k <= job.degree; ++k) names << QString("%1次项").arg(k);
+    } else if (job.type == 5) {
+        names << "中心" << "半宽";
+        for (int k = 0; k <= job.degree; ++k) names << QString("t^%1").arg(k);
+    } else if (job.type == 3) {
+        names << "振幅 A" << "频率 B" << "相位 C" << "偏移 D";
+    } else if (job.type == 4) {
+        names << "振幅 A" << "中心 B" << "标准差 C";
+    } else if (job.type == 6 && job.expression) {
+        for (const std::string& name : job.expression->parameterNames()) names << QString::fromStdString(name);
+    } else if (job.type == 7) {
+        names << "平滑参数 λ" << "等效自由度" << "GCV";
+    } else if (job.type == 8) {
+        names << "窗口比例" << "邻域点数";
+    } else if (job.type == 9) {
+        names << "中心" << "半宽" << "次数";
+        for (int k = 1; k <= job.breakpoints; ++k) names << QString("断点 %1").arg(k);
+        for (int segment = 1; segment <= job.breakpoints + 1; ++segment) {
+            for (int k = 0; k <= job.degree; ++k) names << QString("段%1 t^%2").arg(segment).arg(k);
+        }
+    }
+    return names;
+}
+
+void MainWindow::onBatchFittingFinished()
+{
+    std::vector<FitOutcome> outcomes = batchFitWatcher->result();
+    if (outcomes.empty() || outcomes.front().generation != fittingGeneration) {
+        return;
+    }
+    
+    fittingProgressTimer->stop();
+    fittingCancelButton->setEnabled(false);
+    bool cancelled = fittingProgress && fittingProgress->isCancelled();
+    fittingProgress.reset();
+    
+    // 每个拟合成功的系列一条曲线；系列序号与多系列绘图中勾选列的顺序一致
+    std::vector<SeriesFit> fits;
+    size_t succeeded = 0;
+    for (size_t i = 0; i < outcomes.size() && i < pendingBatchColumns.size(); ++i) {
+        const FitOutcome& outcome = outcomes[i];
+        if (outcome.cancelled || !outcome.error.isEmpty()) continue;
+        SeriesFit fit;
+        fit.name = QString("%1 拟合 (R²=%2)").arg(columnHeaders[pendingBatchColumns[i]]).arg(outcome.rSquared, 0, 'f', 3);
+        fit.seriesIndex = i;
+        fit.model = FitModel(pendingFit.type, outcome.coefficients, pendingFit.expression, outcome.curve);
+        fits.push_back(fit);
+        ++succeeded;
+        if (i < pendingBatchKeys.size()) {
+            cacheFitResult(pendingFit, pendingBatchKeys[i], outcome);
+        }
+    }
+    plotWidget->clearFitting();
+    plotWidget->setSeriesFits(fits);
+    publishedFitXColumn = pendingFit.xColumn;
+    publishedFits.clear();
+    for (const SeriesFit& fit : fits) {
+        publishedFits.emplace_back(pendingBatchColumns[fit.seriesIndex], fit.model);
+    }
+    publishedFitJob = pendingFit;
+    if (outcomes.size() == 1 && succeeded == 1) {
+        // 只勾选一列时按单系列绘制，同时显示残差图
+        plotWidget->setFitting(fits[0].model, outcomes[0].residuals, pendingFit.typeName, outcomes[0].inliers);
+    }
+    
+    if (!batchFitDialog) {
+        batchFitDialog = new QDialog(this);
+        batchFitDialog->setWindowTitle("批量拟合结果");
+        batchFitDialog->resize(scaledSize(900), scaledSize(360));
+        QVBoxLayout *layout = new QVBoxLayout(batchFitDialog);
+        batchFitTable = new QTableWidget(batchFitDialog);
+        batchFitTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        layout->addWidget(batchFitTable);
+        QPushButton *exportButton = new QPushButton("💾 导出 CSV");
+        connect(exportButton, &QPushButton::clicked, this, &MainWindow::exportBatchFitResults);
+        QHBoxLayout *buttonLayout = new QHBoxLayout();
+        buttonLayout->addStretch();
+        buttonLayout->addWidget(exportButton);
+        layout->addLayout(buttonLayout);
+    }
+    
+    // 列：系列、状态、R²、各参数，非线性拟合再附各参数的标准误
+    QStringList parameters = fitParameterNames(pendingFit);
+    bool hasErrors = pendingFit.type == 3 || pendingFit.type == 4 || pendingFit.type == 6;
+    QStringList headers;
+    headers << "系列" << "状态" << "R²" << parameters;
+    if (hasErrors) {
+        for (const QString& name : parameters) headers << QString("标准误 %1").arg(name);
+    }
+    batchFitTable->clear();
+    batchFitTable->setColumnCount(headers.size());
+    batchFitTable->setHorizontalHeaderLabels(headers);
+    batchFitTable->setRowCount((int)outcomes.size());
+    for (size_t r = 0; r < outcomes.size() && r < pendingBatchColumns.size(); ++r) {
+        const FitOutcome& outcome = outcomes[r];
+        int row = (int)r;
+        batchFitTable->setItem(row, 0, new QTableWidgetItem(columnHeaders[pendingBatchColumns[r]]));
+        if (outcome.cancelled) {
+            batchFitTable->setItem(row, 1, new QTableWidgetItem("已取消"));
+            continue;
+        }
+        if (!outcome.error.isEmpty()) {
+            QTableWidgetItem *item = new QTableWidgetItem(outcome.error);
+            item->setBackground(QColor(248, 215, 218));
+            batchFitTable->setItem(row, 1, item);
+            continue;
+        }
+        batchFitTable->setItem(row, 1, new QTableWidgetItem("成功"));
+        batchFitTable->setItem(row, 2, new QTableWidgetItem(QString::number(outcome.rSquared, 'f', 6)));
+        for (int k = 0; k < parameters.size() && k < (int)outcome.coefficients.size(); ++k) {
+            batchFitTable->setItem(row, 3 + k, new QTableWidgetItem(QString::number(outcome.coefficients[k], 'g', 8)));
+            if (hasErrors && k < (int)outcome.standardErrors.size()) {
+                batchFitTable->setItem(row, 3 + parameters.size() + k,
+                                       new QTableWidgetItem(QString::number(outcome.standardErrors[k], 'g', 4)));
+            }
+        }
+    }
+    batchFitTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    
+    batchFitDialog->show();
+    batchFitDialog->raise();
+    statusLabel->setText(QString("%1 批量%2：%3/%4 列成功")
+                             .arg(cancelled ? "⏹" : "✅")
+                             .arg(pendingFit.typeName).arg(succeeded).arg(outcomes.size()));
+}
+
+// 把批量拟合结果表导出为 CSV（UTF-8 带 BOM，便于表格软件识别中文表头）
+void MainWindow::exportBatchFitResults()
+{
+    if (!batchFitTable || batchFitTable->rowCount() == 0) return;
+    QString fileName = QFileDialog::getSaveFileName(this, "导出拟合结果", "", "CSV文件 (*.csv)");
+    if (fileName.isEmpty()) return;
+    
+    auto csvField = [](QString text) {
+        if (text.contains(',') || text.contains('"') || text.contains('\n')) {
+            text.replace("\"", "\"\"");
+            text = "\"" + text + "\"";
+        }
+        return text;
+    };
+    
+    QString csv;
+    QStringList fields;
+    for (int c = 0; c < batchFitTable->columnCount(); ++c) {
+        fields << csvField(batchFitTable->horizontalHeaderItem(c)->text());
+    }
+    csv += fields.join(",") + "\n";
+    for (int r = 0; r < batchFitTable->rowCount(); ++r) {
+        fields.clear();
+        for (int c = 0; c < batchFitTable->columnCount(); ++c) {
+            QTableWidgetItem *item = batchFitTable->item(r, c);
+            fields << (item ? csvField(item->text()) : QString());
+        }
+        csv += fields.join(",") + "\n";
+    }
+    
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("\xEF\xBB\xBF");
+        file.write(csv.toUtf8());
+        file.close();
+        statusLabel->setText(QString("💾 拟合结果已导出到 %1").arg(QFileInfo(fileName).fileName()));
+    } else {
+        QMessageBox::warning(this, "错误", "无法写入文件");
+    }
+}
+
+// 导出当前拟合：每个 Y 列输出原始值、拟合值和残差，拟合值由 FitModel 按块求值
+void MainWindow::exportFittedData()
+{
+    if (publishedFits.empty()) {
+        QMessageBox::information(this, "导出拟合数据", "当前没有拟合结果，请先进行数据拟合");
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(this, "导出拟合数据", "", "CSV文件 (*.csv)");
+    if (fileName.isEmpty()) return;
+    
+    // 派生列自带横轴时用它代替 X 列，与拟合时一致
+    std::vector<double> x = columnValues(publishedFitXColumn);
+    const DerivedColumn* derived = derivedColumn(publishedFits.front().first);
+    if (publishedFits.size() == 1 && derived && !derived->axis.empty()) {
+        x = derived->axis;
+    }
+    
+    std::vector<std::vector<double>> columns;
+    QStringList headers;
+    headers << columnHeaders.value(publishedFitXColumn, "x");
+    for (const auto& entry : publishedFits) {
+        std::vector<double> y = columnValues(entry.first);
+        if (y.size() != x.size()) continue;
+        std::vector<double> fitted = entry.second.evaluate(x);
+        std::vector<double> residual(y.size());
+        for (size_t i = 0; i < y.size(); ++i) residual[i] = y[i] - fitted[i];
+        QString name = columnHeaders.value(entry.first);
+        headers << name << QString("%1 拟合值").arg(name) << QString("%1 残差").arg(name);
+        columns.push_back(std::move(y));
+        columns.push_back(std::move(fitted));
+        columns.push_back(std::move(residual));
+    }
+    
+    QString csv = headers.join(",") + "\n";
+    for (size_t i = 0; i < x.size(); ++i) {
+        QStringList fields;
+        fields << QString::number(x[i], 'g', 15);
+        for (const std::vector<double>& column : columns) {
+            fields << QString::number(column[i], 'g', 15);
+        }
+        csv += fields.join(",") + "\n";
+    }
+    
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("\xEF\xBB\xBF");
+        file.write(csv.toUtf8());
+        file.close();
+        statusLabel->setText(QString("💾 拟合数据已导出到 %1").arg(QFileInfo(fileName).fileName()));
+    } else {
+        QMessageBox::warning(this, "错误", "无法写入文件");
+    }
+}
+
+void MainWindow::onFittingFinished()
+{
+    FitOutcome outcome = fittingWatcher->result();
+    // 已被新任务取代或数据已重新加载
+    if (outcome.generation != fittingGeneration) {
+        return;
+    }
+    
+    fittingProgressTimer->stop();
+    fittingCancelButton->setEnabled(false);
+    fittingProgress.reset();
+    
+    if (outcome.cancelled) {
+        statusLabel->setText("⏹ 拟合已取消");
+        return;
+    }
+    if (!outcome.error.isEmpty()) {
+        statusLabel->setText("❌ 拟合失败");
+        QMessageBox::critical(this, "拟合错误", outcome.error);
+        return;
+    }
+    
+    publishFit(pendingFit, outcome, false);
+    cacheFitResult(pendingFit, pendingFit.cacheKey, std::move(outcome));
+}
+
+// 显示一个单系列拟合：曲线、残差和统计信息；缓存的结果不含残差，按当前数据重算
+void MainWindow::publishFit(const FitJob& job, const FitOutcome& outcome, bool fromCache)
+{
+    const int fittingType = job.type;
+    const QString& fittingTypeName = job.typeName;
+    const std::vector<double>& coefficients = outcome.coefficients;
+    const std::vector<double>& standardErrors = outcome.standardErrors;
+    
+    // 将拟合结果传递给PlotWidget
+    FitModel model(fittingType, coefficients, job.expression, outcome.curve);
+    std::vector<double> residuals = outcome.residuals;
+    if (residuals.empty()) {
+        std::vector<double> x = columnValues(job.xColumn);
+        const DerivedColumn* derived = derivedColumn(job.yColumn);
+        if (derived && !derived->axis.empty()) {
+            x = derived->axis;
+        }
+        residuals = model.residuals(x, columnValues(job.yColumn));
+    }
+    plotWidget->setFitting(model, residuals, fittingTypeName, outcome.inliers);
+    publishedFitXColumn = job.xColumn;
+    publishedFits.assign(1, std::make_pair(job.yColumn, model));
+    publishedFitJob = job;
+    
+    // 更新状态信息
+    statusLabel->setText(fromCache ? outcome.statusMessage + "（缓存）" : outcome.statusMessage);
+    
+    // 更新统计信息，包含拟合参数
+    QString fittingInfo = QString("🎯 %1参数:\n").arg(fittingTypeName);
+    // 非线性拟合的参数附带标准误
+    auto parameterText = [&](size_t i) {
+        QString text = QString::number(coefficients[i], 'f', 4);
+        if (i < standardErrors.size()) {
+            text += QString(" ± %1").arg(standardErrors[i], 0, 'g', 3);
+        }
+        return text;
+    };
+    
+    if (fittingType <= 2) {
+        // 多项式拟合参数
+        for (size_t i = 0; i < coefficients.size(); ++i) {
+            if (i == 0) {
+                fittingInfo += QString("  常数项: %1\n").arg(coefficients[i], 0, 'f', 4);
+            } else if (i == 1) {
+                fittingInfo += QString("  一次项: %1\n").arg(coefficients[i], 0, 'f', 4);
+            } else {
+                fittingInfo += QString("  %1次项: %2\n").arg(i).arg(coefficients[i], 0, 'f', 4);
+            }
+        }
+    } else if (fittingType == 5) {
+        fittingInfo += QString("  t = (x - %1) / %2\n").arg(coefficients[0], 0, 'g', 6).arg(coefficients[1], 0, 'g', 6);
+        for (size_t i = 2; i < coefficients.size(); ++i) {
+            fittingInfo += QString("  t^%1: %2\n").arg(i - 2).arg(coefficients[i], 0, 'g', 6);
+        }
+    } else if (fittingType == 6) {
+        const std::vector<std::string>& names = job.expression->parameterNames();
+        for (size_t i = 0; i < names.size() && i < coefficients.size(); ++i) {
+            fittingInfo += QString("  %1: %2\n").arg(QString::fromStdString(names[i])).arg(parameterText(i));
+        }
+    } else if (fittingType == 3) {
+        // 正弦拟合参数: y = A*sin(B*x + C) + D
+        fittingInfo += QString("  振幅 A: %1\n").arg(parameterText(0));
+        fittingInfo += QString("  频率 B: %1\n").arg(parameterText(1));
+        fittingInfo += QString("  相位 C: %1\n").arg(parameterText(2));
+        fittingInfo += QString("  偏移 D: %1\n").arg(parameterText(3));
+        fittingInfo += QString("  拟合函数: y = %1*sin(%2*x + %3) + %4\n")
+                           .arg(coefficients[0], 0, 'f', 3)
+                           .arg(coefficients[1], 0, 'f', 3)
+                           .arg(coefficients[2], 0, 'f', 3)
+                           .arg(coefficients[3], 0, 'f', 3);
+    } else if (fittingType == 4) {
+        // 高斯拟合参数: y = A*exp(-((x-B)/C)^2)
+        fittingInfo += QString("  振幅 A: %1\n").arg(parameterText(0));
+        fittingInfo += QString("  中心 B: %1\n").arg(parameterText(1));
+        fittingInfo += QString("  标准差 C: %1\n").arg(parameterText(2));
+        fittingInfo += QString("  拟合函数: y = %1*exp(-((x-%2)/%3)²)\n")
+                           .arg(coefficients[0], 0, 'f', 3)
+                           .arg(coefficients[1], 0, 'f', 3)
+                           .arg(coefficients[2], 0, 'f', 3);
+    } else if (fittingType == 7) {
+        fittingInfo += QString("  平滑参数 λ: %1\n").arg(coefficients[0], 0, 'g', 4);
+        fittingInfo += QString("  等效自由度: %1\n").arg(coefficients[1], 0, 'f', 2);
+        fittingInfo += QString("  GCV: %1\n").arg(coefficients[2], 0, 'g', 6);
+        fittingInfo += QString("  节点数: %1\n").arg(outcome.curve->knots.size());
+    } else if (fittingType == 8) {
+        fittingInfo += QString("  窗口比例: %1\n").arg(coefficients[0], 0, 'f', 2);
+        fittingInfo += QString("  邻域点数: %1\n").arg(static_cast<qlonglong>(coefficients[1]));
+        fittingInfo += QString("  评估点数: %1\n").arg(outcome.curve->knots.size());
+    } else if (fittingType == 9) {
+        // 各段换算成关于 x 的幂次系数显示
+        std::vector<double> breaks = model.breakpoints();
+        size_t perSegment = static_cast<size_t>(coefficients[2]) + 1;
+        const double* segments = coefficients.data() + 3 + breaks.size();
+        for (size_t j = 0; j <= breaks.size(); ++j) {
+            std::vector<double> polynomial = {coefficients[0], coefficients[1]};
+            polynomial.insert(polynomial.end(), segments + j * perSegment, segments + (j + 1) * perSegment);
+            recenterPolynomial(polynomial, 0.0, 1.0);
+            QString range = QString("%1 ~ %2").arg(j == 0 ? QString("-∞") : QString::number(breaks[j - 1], 'g', 6))
+                                              .arg(j == breaks.size() ? QString("+∞") : QString::number(breaks[j], 'g', 6));
+            QStringList terms;
+            for (size_t k = 2; k < polynomial.size(); ++k) {
+                terms << (k == 2 ? QString::number(polynomial[k], 'g', 6)
+                                 : QString("%1·x%2").arg(polynomial[k], 0, 'g', 6).arg(k == 3 ? QString() : QString("^%1").arg(k - 2)));
+            }
+            fittingInfo += QString("  段 %1 [%2]: y = %3\n").arg(j + 1).arg(range).arg(terms.join(" + "));
+        }
+    }
+    
+    if (!outcome.inliers.empty()) {
+        fittingInfo += QString("  内点: %1/%2，离群点 %3，残差尺度 %4\n")
+                           .arg(outcome.inlierCount).arg(outcome.inliers.size())
+                           .arg(outcome.inliers.size() - outcome.inlierCount).arg(outcome.robustScale, 0, 'g', 4);
+    }
+    fittingInfo += QString("  决定系数 R²: %1").arg(outcome.rSquared, 0, 'f', 4);
+    
+    // 将拟合信息附加到统计信息
+    QString currentStats = statsText->toPlainText();
+    if (!currentStats.isEmpty()) {
+        currentStats += "\n\n" + fittingInfo;
+    } else {
+        currentStats = fittingInfo;
+    }
+    statsText->setPlainText(currentStats);
+}
+
+// 列的数据版本：数据列取 ColumnStore 的版本，派生列取加入或替换时的编号；
+// 行索引列只随重新加载改变，而重新加载时缓存整体清空
+uint64_t MainWindow::columnVersion(int column) const
+{
+    if (column > 0 && column - 1 < (int)columnStore.columnCount()) {
+        return columnStore.version(column - 1);
+    }
+    const DerivedColumn* derived = derivedColumn(column);
+    return derived ? derived->version : 0;
+}
+
+// 后台任务开始时记下源数据列（columnStore 下标）的版本；版本全局唯一，
+// 列被替换或文件重新加载后必然不同，结果返回时据此丢弃过期结果
+std::vector<std::pair<int, uint64_t>> MainWindow::dataColumnVersions(const std::vector<int>& columns) const
+{
+    std::vector<std::pair<int, uint64_t>> versions;
+    versions.reserve(columns.size());
+    for (int column : columns) {
+        versions.emplace_back(column, columnStore.version(column));
+    }
+    return versions;
+}
+
+bool MainWindow::dataColumnsUnchanged(const std::vector<std::pair<int, uint64_t>>& versions) const
+{
+    for (const auto& entry : versions) {
+        if (entry.first < 0 || entry.first >= (int)columnStore.columnCount()) return false;
+        if (columnStore.version(entry.first) != entry.second) return false;
+    }
+    return true;
+}
+
+// 拟合缓存键：两列的当前数据版本，加上影响结果的全部设置
+FitCacheKey MainWindow::fitCacheKey(const FitJob& job, int xColumn, int yColumn) const
+{
+    FitCacheKey key;
+    key.xColumn = xColumn;
+    key.yColumn = yColumn;
+    key.xVersion = columnVersion(xColumn);
+    key.yVersion = columnVersion(yColumn);
+    // typeName 已含次数、稳健方法、段数和公式文本
+    QStringList fields;
+    fields << QString::number(job.type) << QString::number(job.degree)
+           << QString::number(static_cast<int>(job.robust)) << job.typeName;
+    if (job.type == 8) fields << QString::number(job.span, 'g', 17);
+    if (job.type == 9) fields << QString::number(job.breakpoints);
+    for (double value : job.initial) fields << QString::number(value, 'g', 17);
+    if (job.hasPeakSeed) {
+        fields << QString("peak %1 %2 %3").arg(job.peakSeed.position, 0, 'g', 17)
+                                           .arg(job.peakSeed.height, 0, 'g', 17)
+                                           .arg(job.peakSeed.widthSamples, 0, 'g', 17);
+    }
+    key.model = fields.join("|").toStdString();
+    return key;
+}
+
+// 写入缓存：残差与数据等长，不保存，恢复时重算；列号取自键（批量拟合的设置里没有 Y 列）
+void MainWindow::cacheFitResult(const FitJob& job, const FitCacheKey& key, FitOutcome outcome)
+{
+    CachedFit entry;
+    entry.job = job;
+    entry.job.xColumn = key.xColumn;
+    entry.job.yColumn = key.yColumn;
+    entry.job.cacheKey = key;
+    entry.outcome = std::move(outcome);
+    entry.outcome.residuals.clear();
+    entry.outcome.residuals.shrink_to_fit();
+    fitCache.insert(key, std::move(entry));
+    if (fitCacheDialog && fitCacheDialog->isVisible()) {
+        updateFitCacheTable();
+    }
+}
+
+// 这对列在当前数据上拟合过时，恢复最近使用的那次拟合
+bool MainWindow::restoreCachedFit(int xColumn, int yColumn)
+{
+    const auto* cached = fitCache.latest(xColumn, yColumn, columnVersion(xColumn), columnVersion(yColumn));
+    if (!cached) {
+        return false;
+    }
+    publishFit(cached->value.job, cached->value.outcome, true);
+    return true;
+}
+
+// 列出缓存的拟合（最近使用的在前），便于比较不同模型；双击数据未变的一行切换到它
+void MainWindow::showFitCache()
+{
+    if (!fitCacheDialog) {
+        fitCacheDialog = new QDialog(this);
+        fitCacheDialog->setWindowTitle("拟合结果缓存");
+        fitCacheDialog->resize(scaledSize(900), scaledSize(360));
+        QVBoxLayout *layout = new QVBoxLayout(fitCacheDialog);
+        fitCacheTable = new QTableWidget(fitCacheDialog);
+        fitCacheTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        fitCacheTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+        connect(fitCacheTable, &QTableWidget::cellDoubleClicked, this, &MainWindow::onFitCacheActivated);
+        layout->addWidget(fitCacheTable);
+        QLabel *hint = new QLabel("双击一行显示该拟合；数据已变化的结果不能恢复");
+        layout->addWidget(hint);
+    }
+    updateFitCacheTable();
+    fitCacheDialog->show();
+    fitCacheDialog->raise();
+}
+
+void MainWindow::updateFitCacheTable()
+{
+    QStringList headers;
+    headers << "X 列" << "Y 列" << "模型" << "R²" << "数据" << "参数";
+    fitCacheTable->clear();
+    fitCacheTable->setColumnCount(headers.size());
+    fitCacheTable->setHorizontalHeaderLabels(headers);
+    fitCacheTable->setRowCount((int)fitCache.size());
+    fitCacheRows.clear();
+    int row = 0;
+    for (const auto& entry : fitCache.entries()) {
+        const FitCacheKey& key = entry.key;
+        const FitJob& job = entry.value.job;
+        const FitOutcome& outcome = entry.value.outcome;
+        bool current = key.sameData(key.xColumn, key.yColumn, columnVersion(key.xColumn), columnVersion(key.yColumn));
+        QStringList names = fitParameterNames(job);
+        QStringList parameters;
+        for (int k = 0; k < names.size() && k < (int)outcome.coefficients.size(); ++k) {
+            parameters << QString("%1 = %2").arg(names[k]).arg(outcome.coefficients[k], 0, 'g', 6);
+        }
+        fitCacheTable->setItem(row, 0, new QTableWidgetItem(columnHeaders.value(key.xColumn, "?")));
+        fitCacheTable->setItem(row, 1, new QTableWidgetItem(columnHeaders.value(key.yColumn, "?")));
+        fitCacheTable->setItem(row, 2, new QTableWidgetItem(job.typeName));
+        fitCacheTable->setItem(row, 3, new QTableWidgetItem(QString::number(outcome.rSquared, 'f', 6)));
+        QTableWidgetItem *status = new QTableWidgetItem(current ? "当前" : "已变化");
+        if (!current) status->setBackground(QColor(248, 215, 218));
+        fitCacheTable->setItem(row, 4, status);
+        fitCacheTable->setItem(row, 5, new QTableWidgetItem(parameters.join("，")));
+        fitCacheRows.push_back(key);
+        ++row;
+    }
+    fitCacheTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+}
+
+void MainWindow::onFitCacheActivated(int row)
+{
+    if (row < 0 || row >= (int)fitCacheRows.size()) return;
+    FitCacheKey key = fitCacheRows[row];
+    if (key.yColumn >= columnHeaders.size()
+        || !key.sameData(key.xColumn, key.yColumn, columnVersion(key.xColumn), columnVersion(key.yColumn))) {
+        statusLabel->setText("❌ 该拟合所用的数据已变化，不能恢复");
+        return;
+    }
+    // 移到最前：切换到这对列时恢复的就是它
+    if (!fitCache.find(key)) return;
+    if (multiColumnCheckbox->isChecked()) {
+        QSignalBlocker blocker(multiColumnCheckbox);
+        multiColumnCheckbox->setChecked(false);
+        columnCheckboxArea->setVisible(false);
+        yColumnCombo->setVisible(true);
+        plotWidget->clearData();
+    }
+    {
+        QSignalBlocker xBlocker(xColumnCombo);
+        QSignalBlocker yBlocker(yColumnCombo);
+        xColumnCombo->setCurrentIndex(key.xColumn);
+        yColumnCombo->setCurrentIndex(key.yColumn);
+    }
+    applyColumnSelection();
+    updateFitCacheTable();
+}
+
+void MainWindow::cancelFitting()
+{
+    if (!fittingProgress) return;
+    fittingProgress->cancel();
+    fittingCancelButton->setEnabled(false);
+    statusLabel->setText("⏹ 正在取消拟合...");
+}
+
+// 定时读取拟合线程写入的进度：迭代算法显示迭代次数和残差平方和，多项式显示完成比例
+void MainWindow::updateFittingProgress()
+{
+    if (!fittingProgress || fittingProgress->isCancelled()) return;
+    if (fittingProgress->totalTasks > 0) {
+        statusLabel->setText(QString("⏳ %1：已完成 %2/%3 %4")
+                                 .arg(pendingFit.typeName).arg(fittingProgress->completedTasks.load())
+                                 .arg(fittingProgress->totalTasks).arg(pendingTaskUnit));
+        return;
+    }
+    int iteration = fittingProgress->iteration.load();
+    double objective = fittingProgress->objective.load();
+    if (iteration > 0 || std::isfinite(objective)) {
+        statusLabel->setText(QString("⏳ %1：迭代 %2 次，残差平方和 %3")
+                                 .arg(pendingFit.typeName).arg(iteration).arg(objective, 0, 'g', 6));
+    } else {
+        statusLabel->setText(QString("⏳ %1：%2%")
+                                 .arg(pendingFit.typeName).arg(fittingProgress->fraction.load() * 100.0, 0, 'f', 0));
+    }
+}
+
+// Bootstrap 置信带：在后台对当前显示的单系列拟合做重抽样重拟合，与拟合共用进度、取消和代号
+void MainWindow::performBootstrap()
+{
+    if (publishedFits.size() != 1 || !publishedFits.front().second.isValid()) {
+        QMessageBox::information(this, "置信带", "请先对单个系列进行数据拟合");
+        return;
+    }
+    
+    FitJob job = publishedFitJob;
+    int yColumn = publishedFits.front().first;
+    job.x = columnValues(publishedFitXColumn);
+    job.y = columnValues(yColumn);
+    const DerivedColumn* derived = derivedColumn(yColumn);
+    if (derived && !derived->axis.empty()) {
+        job.x = derived->axis;
+    }
+    if (job.x.size() != job.y.size() || job.x.size() < 3) {
+        QMessageBox::warning(this, "置信带", "数据已变化，请重新拟合");
+        return;
+    }
+    
+    FitModel fitted = publishedFits.front().second;
+    if (job.type == 6) {
+        job.initial = fitted.coefficients();   // 从原拟合结果出发，重拟合收敛更快
+    }
+    BootstrapOptions options;
+    options.method = static_cast<BootstrapMethod>(bootstrapCombo->currentData().toInt());
+    options.replicates = bootstrapCountSpin->value();
+    
+    std::shared_ptr<FitProgress> progress = beginFitTask(job);
+    progress->totalTasks = options.replicates;
+    pendingTaskUnit = "次重抽样";
+    
+    bootstrapWatcher->setFuture(QtConcurrent::run([job = std::move(job), fitted, options, progress]() mutable {
+        BootstrapOutcome outcome;
+        outcome.generation = job.generation;
+        outcome.method = options.method;
+        outcome.requested = options.replicates;
+        options.progress = progress.get();
         
-        // 自适应学习率
-        if (iter % 100 == 0) {
-            learningRate *= 0.95;
+        FitJob settings = job;
+        settings.x.clear();
+        settings.y.clear();
+        BootstrapRefit refit = [&settings, &fitted, &progress](const std::vector<double>& x, const std::vector<double>& y) {
+            FitJob replicate = settings;
+            replicate.x = x;
+            replicate.y = y;
+            FitOutcome fit = runFitJob(replicate, progress.get());
+            if (fit.cancelled || !fit.error.isEmpty()) return FitModel();
+            // 成对重抽样改变了 x 的范围，系数换回原拟合的 t 坐标
+            const std::vector<double>& original = fitted.coefficients();
+            if (replicate.type == 3 && fit.coefficients.size() == original.size()) {
+                fit.coefficients[2] = nearestEquivalentAngle(fit.coefficients[2], original[2]);
+            } else if (replicate.type == 5) {
+                recenterPolynomial(fit.coefficients, original[0], original[1]);
+            } else if (replicate.type == 9 && fit.coefficients.size() == original.size()) {
+                size_t perSegment = static_cast<size_t>(original[2]) + 1;
+                size_t first = 3 + static_cast<size_t>(replicate.breakpoints);
+                for (size_t start = first; start + perSegment <= fit.coefficients.size(); start += perSegment) {
+                    std::vector<double> segment = {fit.coefficients[0], fit.coefficients[1]};
+                    segment.insert(segment.end(), fit.coefficients.begin() + start, fit.coefficients.begin() + start + perSegment);
+                    recenterPolynomial(segment, original[0], original[1]);
+                    std::copy(segment.begin() + 2, segment.end(), fit.coefficients.begin() + start);
+                }
+                fit.coefficients[0] = original[0];
+                fit.coefficients[1] = original[1];
+            }
+            return FitModel(replicate.type, fit.coefficients, replicate.expression, fit.curve);
+        };
+        outcome.result = Bootstrap::run(job.x, job.y, fitted, refit, options);
+        outcome.cancelled = progress->isCancelled();
+        return outcome;
+    }));
+    
+    fittingCancelButton->setEnabled(true);
+    fittingProgressTimer->start();
+    statusLabel->setText(QString("⏳ 正在对%1做 bootstrap...").arg(pendingFit.typeName));
+}
+
+void MainWindow::onBootstrapFinished()
+{
+    BootstrapOutcome outcome = bootstrapWatcher->result();
+    if (outcome.generation != fittingGeneration) {
+        return;
+    }
+    
+    fittingProgressTimer->stop();
+    fittingCancelButton->setEnabled(false);
+    fittingProgress.reset();
+    
+    if (outcome.cancelled) {
+        statusLabel->setText("⏹ bootstrap 已取消");
+        return;
+    }
+    const BootstrapResult& result = outcome.result;
+    if (!result.valid) {
+        statusLabel->setText("❌ bootstrap 失败");
+        QMessageBox::warning(this, "置信带", "重抽样后的重拟合几乎全部失败，无法估计置信区间");
+        return;
+    }
+    
+    plotWidget->setFittingBand(result.bandX, result.bandLower, result.bandUpper, "95% 置信带");
+    
+    QString info = QString("🎲 Bootstrap（%1，成功 %2/%3 次）95% 置信区间:\n")
+                       .arg(Bootstrap::methodName(outcome.method)).arg(result.replicates).arg(outcome.requested);
+    if (pendingFit.type == 7 || pendingFit.type == 8) {
+        info += "  非参数平滑没有可解释的参数，只绘制逐点置信带\n";
+    } else {
+        QStringList names = fitParameterNames(pendingFit);
+        for (int k = 0; k < names.size() && k < (int)result.parameterLower.size(); ++k) {
+            // 中心、半宽（和分段回归的次数）是坐标变换，不是拟合参数
+            if ((pendingFit.type == 5 && k < 2) || (pendingFit.type == 9 && k < 3)) continue;
+            info += QString("  %1: [%2, %3]，标准差 %4\n")
+                        .arg(names[k])
+                        .arg(result.parameterLower[k], 0, 'g', 6)
+                        .arg(result.parameterUpper[k], 0, 'g', 6)
+                        .arg(result.parameterStdDev[k], 0, 'g', 3);
         }
     }
     
-    return params;
+    QString currentStats = statsText->toPlainText();
+    statsText->setPlainText(currentStats.isEmpty() ? info : currentStats + "\n\n" + info);
+    statusLabel->setText(QString("✅ bootstrap 完成：%1 次重拟合").arg(result.replicates));
+}
+
+// 自定义公式的参数初值：取自初值输入框（name=value，逗号或分号分隔，等号两侧可有空格），未给出的参数为 1
+std::vector<double> MainWindow::expressionInitialValues(const ModelExpression& expression) const
+{
+    const std::vector<std::string>& names = expression.parameterNames();
+    std::vector<double> initial(names.size(), 1.0);
+    const QStringList assignments = modelInitialEdit->text().split(QRegExp("[,;，；]+"), Qt::SkipEmptyParts);
+    for (const QString& assignment : assignments) {
+        QStringList parts = assignment.trimmed().split('=');
+        if (parts.size() != 2) continue;
+        bool ok = false;
+        double value = parts[1].trimmed().toDouble(&ok);
+        auto it = std::find(names.begin(), names.end(), parts[0].trimmed().toStdString());
+        if (ok && it != names.end()) {
+            initial[it - names.begin()] = value;
+        }
+    }
+    return initial;
 }
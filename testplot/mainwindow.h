@@ -15,8 +15,83 @@
 #include <QTextBrowser>
 #include <QNetworkAccessManager>
 #include <QCheckBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QFutureWatcher>
+#include <QDialog>
+#include <QTableWidget>
+#include <QTimer>
 #include "plotwidget_new.h"
 #include "deepseek_dialog.h"
+#include "column_store.h"
+#include "lag_correlation.h"
+#include "rolling_window.h"
+#include "peak_finder.h"
+#include "sorted_column_cache.h"
+#include "distribution_fit.h"
+#include "two_sample_tests.h"
+#include "polynomial_fit.h"
+#include "levenberg_marquardt.h"
+#include "model_expression.h"
+#include "fit_model.h"
+#include "robust_fit.h"
+#include "bootstrap_fit.h"
+#include "segmented_fit.h"
+#include "fit_cache.h"
+
+// 由分析功能生成的派生列，追加在数据列之后，可以像普通列一样选择绘制
+struct DerivedColumn {
+    QString name;
+    std::vector<double> values;
+    std::vector<double> axis;   // 非空时为自带的横轴（如滞后量），绘制时代替所选的 X 列
+    uint64_t version = 0;       // 每次加入或替换时重新编号，拟合缓存据此判断结果是否过期
+    int sourceColumn = -1;      // 滑动窗口统计的源数据列，-1 表示不跟踪来源
+    uint64_t sourceVersion = 0; // 计算时源列的数据版本
+    size_t window = 0;          // 计算时的窗口大小
+};
+
+// 后台拟合任务：界面线程收集数据和设置，拟合线程只读这些副本，不访问任何控件
+struct FitJob {
+    int type = 1;                    // fittingCombo 的类型码
+    int degree = 1;                  // 多项式次数
+    RobustMethod robust = RobustMethod::LeastSquares; // 多项式拟合的稳健方法
+    std::vector<double> x;
+    std::vector<double> y;
+    std::shared_ptr<const ModelExpression> expression; // 自定义公式
+    std::vector<double> initial;     // 自定义公式的参数初值
+    double span = 0.3;               // LOESS 的窗口比例
+    int breakpoints = 1;             // 分段回归的断点数
+    bool hasPeakSeed = false;        // 高斯拟合：寻峰结果作为初值
+    Peak peakSeed;
+    QString typeName;
+    int xColumn = -1;                // 单系列拟合的 X、Y 列号
+    int yColumn = -1;
+    FitCacheKey cacheKey;            // 单系列拟合在提交时的缓存键（含两列的数据版本）
+    unsigned int generation = 0;     // 新任务递增，过期任务的结果被丢弃
+};
+
+struct FitOutcome {
+    unsigned int generation = 0;
+    bool cancelled = false;
+    QString error;                   // 非空表示拟合失败
+    QString statusMessage;
+    std::vector<double> coefficients;
+    std::vector<double> standardErrors;
+    std::vector<double> residuals;
+    std::vector<char> inliers;       // 稳健拟合的内点标记，普通最小二乘时为空
+    std::shared_ptr<const SmoothCurve> curve; // 平滑样条、LOESS 的曲线
+    size_t inlierCount = 0;
+    double robustScale = 0.0;
+    double rSquared = 0.0;
+};
+
+struct BootstrapOutcome {
+    unsigned int generation = 0;
+    bool cancelled = false;
+    BootstrapMethod method = BootstrapMethod::Residuals;
+    int requested = 0;               // 请求的重抽样次数
+    BootstrapResult result;
+};
 
 class MainWindow : public QMainWindow
 {
@@ -42,6 +117,30 @@ private slots:
     void onMultiColumnToggled(bool checked);
     void onMultiColumnCheckboxChanged();
     void performDataFitting();
+    void onHistogramBinningChanged();
+    void onKdeBandwidthChanged();
+    void updateCorrelationMatrix();
+    void onSpectrumSettingsChanged();
+    void onScatterRenderChanged();
+    void computeLagCorrelation();
+    void onLagCorrelationFinished();
+    void updateRollingOverlays();
+    void findPeaks();
+    void onPeaksFound();
+    void updateDistributionFits();
+    void onDistributionFitsFinished();
+    void runTwoSampleTests();
+    void onTwoSampleTestsFinished();
+    void onFittingFinished();
+    void onBatchFittingFinished();
+    void exportBatchFitResults();
+    void exportFittedData();
+    void cancelFitting();
+    void updateFittingProgress();
+    void performBootstrap();
+    void onBootstrapFinished();
+    void showFitCache();
+    void onFitCacheActivated(int row);
 
 private:
     int scaledSize(int baseSize) const;
@@ -53,6 +152,7 @@ private:
     void updateColumnSelectionUI();
     void setupMultiColumnCheckboxes();
     void updateDetailedStatistics(const std::vector<double>& data);
+    void updateDetailedStatistics(const StatisticsAccumulator& stats);
     void createAIChatInterface(QVBoxLayout *layout);
     void processAIRequest(const QString& request);
     void fallbackToDeepSeek(const QString& request);
@@ -68,10 +168,22 @@ private:
     int getCheckedChartTypeId();
     std::vector<double> parseNumbersFromLine(const std::string& line);
     bool validateColumnIndices();
-    std::vector<double> polynomialFit(const std::vector<double>& x, const std::vector<double>& y, int degree);
-    std::vector<double> gaussianElimination(std::vector<std::vector<double>>& A, std::vector<double>& b);
-    std::vector<double> sinusoidalFit(const std::vector<double>& x, const std::vector<double>& y);
-    std::vector<double> gaussianFit(const std::vector<double>& x, const std::vector<double>& y);
+    std::vector<double> columnValues(int column) const;
+    const DerivedColumn* derivedColumn(int column) const;
+    int addDerivedColumn(const DerivedColumn& column);
+    bool derivedColumnCurrent(const QString& name, int sourceColumn, uint64_t sourceVersion, size_t window) const;
+    std::vector<double> expressionInitialValues(const ModelExpression& expression) const;
+    bool prepareFitJob(FitJob& job);
+    uint64_t columnVersion(int column) const;
+    std::vector<std::pair<int, uint64_t>> dataColumnVersions(const std::vector<int>& columns) const;
+    bool dataColumnsUnchanged(const std::vector<std::pair<int, uint64_t>>& versions) const;
+    FitCacheKey fitCacheKey(const FitJob& job, int xColumn, int yColumn) const;
+    void cacheFitResult(const FitJob& job, const FitCacheKey& key, FitOutcome outcome);
+    bool restoreCachedFit(int xColumn, int yColumn);
+    void publishFit(const FitJob& job, const FitOutcome& outcome, bool fromCache);
+    void updateFitCacheTable();
+    std::shared_ptr<FitProgress> beginFitTask(FitJob& job);
+    void performBatchFitting();
 
     // UI components
     PlotWidget *plotWidget;
@@ -92,12 +204,102 @@ private:
     QWidget *columnCheckboxWidget;
     std::vector<QCheckBox*> columnCheckboxes;
     
+    // Histogram binning
+    QComboBox *histogramBinCombo;
+    QSpinBox *histogramBinSpin;
+    QComboBox *kdeBandwidthCombo;
+    QComboBox *correlationMethodCombo;
+    QComboBox *spectrumWindowCombo;
+    QComboBox *spectrumSegmentCombo;
+    QComboBox *scatterRenderCombo;
+    
+    // Data analysis
+    QComboBox *lagColumnACombo;
+    QComboBox *lagColumnBCombo;
+    QSpinBox *lagMaxSpin;
+    QCheckBox *lagZeroPadCheckbox;
+    QComboBox *lagNormalizationCombo;
+    QPushButton *lagComputeButton;
+    QFutureWatcher<LagCorrelationResult> *lagWatcher;
+    QString pendingLagName;
+    std::vector<std::pair<int, uint64_t>> pendingLagSources; // 源数据列及开始时的版本
+    QSpinBox *rollingWindowSpin;
+    QCheckBox *rollingMeanCheckbox;
+    QCheckBox *rollingStdCheckbox;
+    QCheckBox *rollingRangeCheckbox;
+    QDoubleSpinBox *peakProminenceSpin;
+    QSpinBox *peakDistanceSpin;
+    QDoubleSpinBox *peakWidthSpin;
+    QPushButton *peakFindButton;
+    QFutureWatcher<std::vector<Peak>> *peakWatcher;
+    int pendingPeakXColumn = -1;
+    int pendingPeakYColumn = -1;
+    uint64_t pendingPeakXVersion = 0; // 开始寻峰时两列的数据版本
+    uint64_t pendingPeakYVersion = 0;
+    QCheckBox *distributionFitCheckbox;
+    QFutureWatcher<std::vector<DistributionFit>> *distributionWatcher;
+    int pendingDistributionColumn = -1;
+    uint64_t pendingDistributionVersion = 0; // 开始拟合时该列的数据版本
+    bool distributionFitQueued = false;
+    QComboBox *testColumnACombo;
+    QComboBox *testColumnBCombo;
+    QPushButton *testRunButton;
+    QFutureWatcher<std::vector<TwoSampleResult>> *testWatcher;
+    std::vector<std::pair<int, int>> pendingTestPairs; // 实际列号
+    std::vector<std::pair<int, uint64_t>> pendingTestSources; // 涉及的列及开始时的版本
+    QDialog *testResultDialog = nullptr;
+    QTableWidget *testResultTable = nullptr;
+    
     // Data fitting components
     QComboBox *fittingCombo;
+    QSpinBox *polynomialDegreeSpin;
+    QComboBox *robustCombo;
+    QDoubleSpinBox *loessSpanSpin;
+    QSpinBox *segmentCountSpin;
+    QSpinBox *segmentDegreeSpin;
+    QLineEdit *modelFormulaEdit;
+    QLineEdit *modelInitialEdit;
     QPushButton *fittingButton;
+    QPushButton *fittingCancelButton;
+    QFutureWatcher<FitOutcome> *fittingWatcher;
+    QFutureWatcher<std::vector<FitOutcome>> *batchFitWatcher; // 多系列批量拟合，与单个拟合共用进度和代号
+    QComboBox *bootstrapCombo;
+    QSpinBox *bootstrapCountSpin;
+    QPushButton *bootstrapButton;
+    QFutureWatcher<BootstrapOutcome> *bootstrapWatcher; // 同样共用进度和代号
+    QTimer *fittingProgressTimer;
+    std::shared_ptr<FitProgress> fittingProgress; // 当前任务的进度与取消标志
+    unsigned int fittingGeneration = 0;
+    FitJob pendingFit;               // 当前任务的设置（不含数据），结果返回后用于显示
+    std::vector<int> pendingBatchColumns; // 批量拟合的 Y 列，顺序与多系列绘图一致
+    std::vector<FitCacheKey> pendingBatchKeys; // 批量拟合各列的缓存键
+    QString pendingTaskUnit;         // 多任务进度的计数单位（列、次重抽样）
+    QDialog *batchFitDialog = nullptr;
+    QTableWidget *batchFitTable = nullptr;
+    int publishedFitXColumn = -1;    // 当前显示的拟合（Y 列号, 模型），导出拟合数据用
+    std::vector<std::pair<int, FitModel>> publishedFits;
+    FitJob publishedFitJob;          // 当前显示的单系列拟合的设置（不含数据），bootstrap 按它重拟合
+    // 拟合结果缓存（不含残差，恢复时按数据重算）：切换列或视图后同一份数据上的拟合立即恢复，不再重算
+    struct CachedFit {
+        FitJob job;                  // 设置，不含数据
+        FitOutcome outcome;
+    };
+    FitResultCache<CachedFit> fitCache;
+    QDialog *fitCacheDialog = nullptr;
+    QTableWidget *fitCacheTable = nullptr;
+    std::vector<FitCacheKey> fitCacheRows; // 表格各行对应的缓存键
     
     // Data
     std::vector<std::vector<double>> rawData;
+    ColumnStore columnStore; // 列式副本，带增量统计
+    CorrelationEngine correlationEngine; // 热力图用的相关矩阵缓存
+    RollingWindowEngine rollingEngine; // 滑动窗口统计缓存
+    SortedColumnCache sortedCache; // 每列每个版本排序一次，分布拟合与检验共用
+    std::vector<DerivedColumn> derivedColumns; // 列号 = 1 + 数据列数 + 下标
+    uint64_t derivedColumnVersion = 0;
+    std::vector<Peak> detectedPeaks; // 最近一次寻峰结果，高斯拟合用作初值
+    int detectedPeakXColumn = -1;
+    int detectedPeakYColumn = -1;
     QStringList columnHeaders;
     bool hasMultipleColumns;
     
@@ -0,0 +1,524 @@
+#include "model_expression.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+typedef ModelExpression::OpCode OpCode;
+typedef ModelExpression::Instruction Instruction;
+
+const size_t BlockSize = 256;
+
+// ---------------------------------------------------------------------------
+// 解析：递归下降，直接生成后缀指令
+//   expression := term (('+' | '-') term)*
+//   term       := unary (('*' | '/') unary)*
+//   unary      := ('-' | '+') unary | power
+//   power      := primary ('^' unary)?          右结合，-x^2 = -(x^2)
+//   primary    := number | 'x' | 'pi' | name | function '(' expression [',' expression] ')' | '(' expression ')'
+// ---------------------------------------------------------------------------
+class Parser
+{
+public:
+    Parser(const std::string& text, std::vector<std::string>& names, std::vector<Instruction>& program)
+        : text(text), names(names), program(program) {}
+
+    bool parse(std::string* error)
+    {
+        skipSpaces();
+        // 允许写成 "y = ..."
+        if (position + 1 < text.size() && (text[position] == 'y' || text[position] == 'Y')) {
+            size_t next = position + 1;
+            while (next < text.size() && std::isspace(static_cast<unsigned char>(text[next]))) ++next;
+            if (next < text.size() && text[next] == '=') position = next + 1;
+        }
+        bool ok = parseExpression();
+        skipSpaces();
+        if (ok && position < text.size()) fail("无法识别的字符 '" + std::string(1, text[position]) + "'");
+        if (!message.empty()) {
+            if (error) *error = message;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const std::string& text;
+    std::vector<std::string>& names;
+    std::vector<Instruction>& program;
+    size_t position = 0;
+    std::string message;
+
+    bool fail(const std::string& why)
+    {
+        if (message.empty()) message = why;
+        return false;
+    }
+
+    void skipSpaces()
+    {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) ++position;
+    }
+
+    bool accept(char c)
+    {
+        skipSpaces();
+        if (position < text.size() && text[position] == c) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    void emit(OpCode op, double constant = 0.0, size_t index = 0)
+    {
+        program.push_back({op, constant, index});
+    }
+
+    bool parseExpression()
+    {
+        if (!parseTerm()) return false;
+        for (;;) {
+            if (accept('+')) {
+                if (!parseTerm()) return false;
+                emit(OpCode::Add);
+            } else if (accept('-')) {
+                if (!parseTerm()) return false;
+                emit(OpCode::Subtract);
+            } else {
+                return true;
+            }
+        }
+    }
+
+    bool parseTerm()
+    {
+        if (!parseUnary()) return false;
+        for (;;) {
+            if (accept('*')) {
+                if (!parseUnary()) return false;
+                emit(OpCode::Multiply);
+            } else if (accept('/')) {
+                if (!parseUnary()) return false;
+                emit(OpCode::Divide);
+            } else {
+                return true;
+            }
+        }
+    }
+
+    bool parseUnary()
+    {
+        if (accept('-')) {
+            if (!parseUnary()) return false;
+            emit(OpCode::Negate);
+            return true;
+        }
+        if (accept('+')) return parseUnary();
+        return parsePower();
+    }
+
+    bool parsePower()
+    {
+        if (!parsePrimary()) return false;
+        if (accept('^')) {
+            if (!parseUnary()) return false;
+            emitPower();
+        }
+        return true;
+    }
+
+    // 指数为常数时（最常见的 x^2 等）不需要对指数求导，也避免底数为负时出现 ln(负数)
+    void emitPower()
+    {
+        if (program.back().op == OpCode::Constant) {
+            double exponent = program.back().constant;
+            program.pop_back();
+            emit(OpCode::PowerConstant, exponent);
+        } else {
+            emit(OpCode::Power);
+        }
+    }
+
+    bool parsePrimary()
+    {
+        skipSpaces();
+        if (position >= text.size()) return fail("公式不完整");
+
+        char c = text[position];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            const char* begin = text.c_str() + position;
+            char* end = nullptr;
+            double value = std::strtod(begin, &end);
+            if (end == begin) return fail("无法解析的数字");
+            position += end - begin;
+            emit(OpCode::Constant, value);
+            return true;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = position;
+            while (position < text.size()
+                   && (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_')) {
+                ++position;
+            }
+            std::string name = text.substr(start, position - start);
+            skipSpaces();
+            if (position < text.size() && text[position] == '(') {
+                ++position;
+                return parseFunction(name);
+            }
+            if (name == "x" || name == "X") {
+                emit(OpCode::Variable);
+            } else if (name == "pi") {
+                emit(OpCode::Constant, M_PI);
+            } else {
+                auto it = std::find(names.begin(), names.end(), name);
+                if (it == names.end()) {
+                    if (names.size() >= ModelExpression::MaxParameters) {
+                        return fail("参数过多（最多 " + std::to_string(ModelExpression::MaxParameters) + " 个）");
+                    }
+                    names.push_back(name);
+                    it = names.end() - 1;
+                }
+                emit(OpCode::Parameter, 0.0, static_cast<size_t>(it - names.begin()));
+            }
+            return true;
+        }
+
+        if (accept('(')) {
+            if (!parseExpression()) return false;
+            if (!accept(')')) return fail("缺少右括号");
+            return true;
+        }
+        return fail("无法识别的字符 '" + std::string(1, c) + "'");
+    }
+
+    bool parseFunction(const std::string& name)
+    {
+        static const struct { const char* name; OpCode op; } functions[] = {
+            {"sin", OpCode::Sin}, {"cos", OpCode::Cos}, {"tan", OpCode::Tan},
+            {"asin", OpCode::Asin}, {"acos", OpCode::Acos}, {"atan", OpCode::Atan},
+            {"sinh", OpCode::Sinh}, {"cosh", OpCode::Cosh}, {"tanh", OpCode::Tanh},
+            {"exp", OpCode::Exp}, {"log", OpCode::Log}, {"ln", OpCode::Log}, {"log10", OpCode::Log10},
+            {"sqrt", OpCode::Sqrt}, {"abs", OpCode::Abs}
+        };
+
+        if (!parseExpression()) return false;
+        if (name == "pow") {
+            if (!accept(',')) return fail("pow 需要两个参数");
+            if (!parseExpression()) return false;
+            if (!accept(')')) return fail("缺少右括号");
+            emitPower();
+            return true;
+        }
+        if (!accept(')')) return fail("缺少右括号");
+        for (const auto& f : functions) {
+            if (name == f.name) {
+                emit(f.op);
+                return true;
+            }
+        }
+        return fail("未知函数 " + name);
+    }
+};
+
+// 执行时的栈深度
+size_t requiredStackDepth(const std::vector<Instruction>& program)
+{
+    size_t depth = 0, maximum = 0;
+    for (const Instruction& instruction : program) {
+        switch (instruction.op) {
+        case OpCode::Constant:
+        case OpCode::Variable:
+        case OpCode::Parameter:
+            maximum = std::max(maximum, ++depth);
+            break;
+        case OpCode::Add:
+        case OpCode::Subtract:
+        case OpCode::Multiply:
+        case OpCode::Divide:
+        case OpCode::Power:
+            --depth;
+            break;
+        default:
+            break;
+        }
+    }
+    return maximum;
+}
+
+// ---------------------------------------------------------------------------
+// 前向模式自动微分：Dual<N> 携带函数值和对 N 个参数的偏导数
+// ---------------------------------------------------------------------------
+template <size_t N>
+struct Dual {
+    double v;
+    double d[N];
+};
+
+// 标量版本：模板求值代码对 double 和 Dual<N> 写法一致
+struct Scalar {
+    static const bool derivatives = false;
+    static double constant(double c) { return c; }
+    static double value(double a) { return a; }
+    // f(a) 的值为 f，导数为 df
+    static double chain(double, double f, double) { return f; }
+    static double add(double a, double b) { return a + b; }
+    static double subtract(double a, double b) { return a - b; }
+    static double multiply(double a, double b) { return a * b; }
+    static double divide(double a, double b) { return a / b; }
+    static double power(double a, double b) { return std::pow(a, b); }
+};
+
+template <size_t N>
+struct DualOps {
+    typedef Dual<N> T;
+    static const bool derivatives = true;
+    static T constant(double c)
+    {
+        T r;
+        r.v = c;
+        std::fill(r.d, r.d + N, 0.0);
+        return r;
+    }
+    static double value(const T& a) { return a.v; }
+    static T chain(const T& a, double f, double df)
+    {
+        T r;
+        r.v = f;
+        for (size_t k = 0; k < N; ++k) r.d[k] = df * a.d[k];
+        return r;
+    }
+    static T add(const T& a, const T& b)
+    {
+        T r;
+        r.v = a.v + b.v;
+        for (size_t k = 0; k < N; ++k) r.d[k] = a.d[k] + b.d[k];
+        return r;
+    }
+    static T subtract(const T& a, const T& b)
+    {
+        T r;
+        r.v = a.v - b.v;
+        for (size_t k = 0; k < N; ++k) r.d[k] = a.d[k] - b.d[k];
+        return r;
+    }
+    static T multiply(const T& a, const T& b)
+    {
+        T r;
+        r.v = a.v * b.v;
+        for (size_t k = 0; k < N; ++k) r.d[k] = a.d[k] * b.v + a.v * b.d[k];
+        return r;
+    }
+    static T divide(const T& a, const T& b)
+    {
+        T r;
+        r.v = a.v / b.v;
+        double inverse = 1.0 / b.v;
+        for (size_t k = 0; k < N; ++k) r.d[k] = (a.d[k] - r.v * b.d[k]) * inverse;
+        return r;
+    }
+    // d(a^b) = b a^(b-1) da + a^b ln(a) db
+    static T power(const T& a, const T& b)
+    {
+        T r;
+        r.v = std::pow(a.v, b.v);
+        double da = b.v * std::pow(a.v, b.v - 1.0);
+        double db = a.v > 0.0 ? r.v * std::log(a.v) : 0.0;
+        for (size_t k = 0; k < N; ++k) r.d[k] = da * a.d[k] + db * b.d[k];
+        return r;
+    }
+};
+
+// 一元函数：值和导数一起算，再用 chain 传播；标量求值时不计算导数
+template <typename Ops, typename T>
+T unary(OpCode op, const T& a)
+{
+    double v = Ops::value(a);
+    switch (op) {
+    case OpCode::Negate:
+        return Ops::chain(a, -v, -1.0);
+    case OpCode::Sin:
+        return Ops::chain(a, std::sin(v), Ops::derivatives ? std::cos(v) : 0.0);
+    case OpCode::Cos:
+        return Ops::chain(a, std::cos(v), Ops::derivatives ? -std::sin(v) : 0.0);
+    case OpCode::Tan: {
+        double t = std::tan(v);
+        return Ops::chain(a, t, 1.0 + t * t);
+    }
+    case OpCode::Asin:
+        return Ops::chain(a, std::asin(v), Ops::derivatives ? 1.0 / std::sqrt(1.0 - v * v) : 0.0);
+    case OpCode::Acos:
+        return Ops::chain(a, std::acos(v), Ops::derivatives ? -1.0 / std::sqrt(1.0 - v * v) : 0.0);
+    case OpCode::Atan:
+        return Ops::chain(a, std::atan(v), 1.0 / (1.0 + v * v));
+    case OpCode::Sinh:
+        return Ops::chain(a, std::sinh(v), Ops::derivatives ? std::cosh(v) : 0.0);
+    case OpCode::Cosh:
+        return Ops::chain(a, std::cosh(v), Ops::derivatives ? std::sinh(v) : 0.0);
+    case OpCode::Tanh: {
+        double t = std::tanh(v);
+        return Ops::chain(a, t, 1.0 - t * t);
+    }
+    case OpCode::Exp: {
+        double e = std::exp(v);
+        return Ops::chain(a, e, e);
+    }
+    case OpCode::Log:
+        return Ops::chain(a, std::log(v), 1.0 / v);
+    case OpCode::Log10:
+        return Ops::chain(a, std::log10(v), 1.0 / (v * std::log(10.0)));
+    case OpCode::Sqrt: {
+        double s = std::sqrt(v);
+        return Ops::chain(a, s, 0.5 / s);
+    }
+    case OpCode::Abs:
+        return Ops::chain(a, std::abs(v), v < 0.0 ? -1.0 : 1.0);
+    default:
+        return a;
+    }
+}
+
+template <typename Ops, typename T>
+T powerConstant(const T& a, double exponent)
+{
+    double v = Ops::value(a);
+    if (exponent == 2.0) return Ops::chain(a, v * v, 2.0 * v);
+    return Ops::chain(a, std::pow(v, exponent), Ops::derivatives ? exponent * std::pow(v, exponent - 1.0) : 0.0);
+}
+
+// 对一块数据执行指令序列：栈的每一层是长度为 count 的数组，每条指令是一个对整块的循环
+template <typename Ops, typename T>
+void runBlock(const std::vector<Instruction>& program, const double* x, size_t count,
+              const T* parameters, std::vector<T>& stack, T* out)
+{
+    size_t top = 0;  // 栈中的层数
+    for (const Instruction& instruction : program) {
+        T* slot = stack.data() + top * BlockSize;
+        T* below = slot - BlockSize;
+        switch (instruction.op) {
+        case OpCode::Constant: {
+            T c = Ops::constant(instruction.constant);
+            std::fill(slot, slot + count, c);
+            ++top;
+            break;
+        }
+        case OpCode::Variable:
+            for (size_t i = 0; i < count; ++i) slot[i] = Ops::constant(x[i]);
+            ++top;
+            break;
+        case OpCode::Parameter:
+            std::fill(slot, slot + count, parameters[instruction.index]);
+            ++top;
+            break;
+        case OpCode::Add:
+            below = slot - 2 * BlockSize;
+            for (size_t i = 0; i < count; ++i) below[i] = Ops::add(below[i], below[i + BlockSize]);
+            --top;
+            break;
+        case OpCode::Subtract:
+            below = slot - 2 * BlockSize;
+            for (size_t i = 0; i < count; ++i) below[i] = Ops::subtract(below[i], below[i + BlockSize]);
+            --top;
+            break;
+        case OpCode::Multiply:
+            below = slot - 2 * BlockSize;
+            for (size_t i = 0; i < count; ++i) below[i] = Ops::multiply(below[i], below[i + BlockSize]);
+            --top;
+            break;
+        case OpCode::Divide:
+            below = slot - 2 * BlockSize;
+            for (size_t i = 0; i < count; ++i) below[i] = Ops::divide(below[i], below[i + BlockSize]);
+            --top;
+            break;
+        case OpCode::Power:
+            below = slot - 2 * BlockSize;
+            for (size_t i = 0; i < count; ++i) below[i] = Ops::power(below[i], below[i + BlockSize]);
+            --top;
+            break;
+        case OpCode::PowerConstant:
+            for (size_t i = 0; i < count; ++i) below[i] = powerConstant<Ops>(below[i], instruction.constant);
+            break;
+        default:
+            for (size_t i = 0; i < count; ++i) below[i] = unary<Ops>(instruction.op, below[i]);
+            break;
+        }
+    }
+    std::copy(stack.data(), stack.data() + count, out);
+}
+
+template <size_t N>
+void evaluateDual(const std::vector<Instruction>& program, size_t depth, const double* x, size_t count,
+                  const double* parameters, double* values, double* jacobian)
+{
+    typedef Dual<N> T;
+    T seeds[N];
+    for (size_t k = 0; k < N; ++k) {
+        seeds[k] = DualOps<N>::constant(parameters[k]);
+        seeds[k].d[k] = 1.0;
+    }
+    std::vector<T> stack(std::max<size_t>(depth, 1) * BlockSize);
+    std::vector<T> out(BlockSize);
+    for (size_t start = 0; start < count; start += BlockSize) {
+        size_t rows = std::min(BlockSize, count - start);
+        runBlock<DualOps<N>>(program, x + start, rows, seeds, stack, out.data());
+        for (size_t i = 0; i < rows; ++i) {
+            values[start + i] = out[i].v;
+        }
+        if (jacobian) {
+            for (size_t k = 0; k < N; ++k) {
+                double* column = jacobian + k * count + start;
+                for (size_t i = 0; i < rows; ++i) column[i] = out[i].d[k];
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const ModelExpression> ModelExpression::compile(const std::string& text, std::string* error)
+{
+    std::shared_ptr<ModelExpression> expression(new ModelExpression());
+    expression->source = text;
+    Parser parser(text, expression->names, expression->program);
+    if (!parser.parse(error)) return nullptr;
+    if (expression->names.empty()) {
+        if (error) *error = "公式中没有待拟合的参数";
+        return nullptr;
+    }
+    expression->stackDepth = requiredStackDepth(expression->program);
+    return expression;
+}
+
+void ModelExpression::evaluate(const double* x, size_t count, const double* parameters, double* values) const
+{
+    std::vector<double> stack(std::max<size_t>(stackDepth, 1) * BlockSize);
+    for (size_t start = 0; start < count; start += BlockSize) {
+        size_t rows = std::min(BlockSize, count - start);
+        runBlock<Scalar>(program, x + start, rows, parameters, stack, values + start);
+    }
+}
+
+void ModelExpression::evaluateWithJacobian(const double* x, size_t count, const double* parameters,
+                                           double* values, double* jacobian) const
+{
+    // 参数个数在编译期展开成固定长度的 Dual
+    switch (names.size()) {
+    case 1: evaluateDual<1>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    case 2: evaluateDual<2>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    case 3: evaluateDual<3>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    case 4: evaluateDual<4>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    case 5: evaluateDual<5>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    case 6: evaluateDual<6>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    case 7: evaluateDual<7>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    case 8: evaluateDual<8>(program, stackDepth, x, count, parameters, values, jacobian); break;
+    default: break;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef MODEL_EXPRESSION_H
+#define MODEL_EXPRESSION_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+
+// 用户输入的拟合公式，例如 "a*exp(-b*x) + c"
+// 自变量为 x，其余标识符按出现顺序作为待拟合参数（最多 MaxParameters 个），pi 为常数
+// 支持 + - * / ^、括号、一元负号，以及 sin cos tan asin acos atan sinh cosh tanh exp log(ln) log10 sqrt abs pow(a, b)
+//
+// 公式编译成后缀形式的指令序列；求值时按块（每块 256 个点）逐条执行指令，每条指令对整块数据做一次紧凑循环，
+// 解释开销按块摊销。Jacobian 用前向模式自动微分：同一段求值模板以 Dual<N>（函数值 + N 个偏导数）为元素类型实例化
+class ModelExpression
+{
+public:
+    static const size_t MaxParameters = 8;
+
+    // 解析失败返回空指针，error 中给出原因
+    static std::shared_ptr<const ModelExpression> compile(const std::string& text, std::string* error);
+
+    const std::string& text() const { return source; }
+    const std::vector<std::string>& parameterNames() const { return names; }
+    size_t parameterCount() const { return names.size(); }
+
+    void evaluate(const double* x, size_t count, const double* parameters, double* values) const;
+    // jacobian 按列存储：jacobian[k * count + i] = ∂f(x_i) / ∂p_k，可为空
+    void evaluateWithJacobian(const double* x, size_t count, const double* parameters,
+                              double* values, double* jacobian) const;
+
+    enum class OpCode {
+        Constant, Variable, Parameter,
+        Add, Subtract, Multiply, Divide, Power, PowerConstant, Negate,
+        Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh, Exp, Log, Log10, Sqrt, Abs
+    };
+
+    struct Instruction {
+        OpCode op;
+        double constant;   // Constant / PowerConstant
+        size_t index;      // Parameter
+    };
+
+private:
+    ModelExpression() {}
+
+    std::string source;
+    std::vector<std::string> names;
+    std::vector<Instruction> program;
+    size_t stackDepth = 0;
+};
+
+#endif // MODEL_EXPRESSION_H
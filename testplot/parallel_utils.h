@@ -0,0 +1,169 @@
+#ifndef PARALLEL_UTILS_H
+#define PARALLEL_UTILS_H
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// 简单的数据并行工具：把 [0, count) 切成固定的若干块，由常驻线程池和调用线程一起执行
+// 分块边界只取决于 count 和块数，因此按块序号归约的结果是确定的
+
+// 线程数上限，0 表示使用全部硬件线程（基准测试用来比较不同线程数）
+inline std::atomic<unsigned int>& workerThreadLimit()
+{
+    static std::atomic<unsigned int> limit(0);
+    return limit;
+}
+
+inline unsigned int workerThreadCount()
+{
+    unsigned int limit = workerThreadLimit().load();
+    if (limit > 0) return limit;
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// 每块至少 minChunk 个元素，块数不超过线程数
+inline size_t parallelChunkCount(size_t count, size_t minChunk = 65536)
+{
+    if (count == 0) return 0;
+    size_t byWork = (count + minChunk - 1) / std::max<size_t>(1, minChunk);
+    return std::max<size_t>(1, std::min<size_t>(byWork, workerThreadCount()));
+}
+
+// 常驻工作线程池：硬件线程数 - 1 个线程在首次使用时创建，之后一直复用，避免每次并行循环都创建线程
+// 一次并行循环是一个任务，各块由调用线程和空闲的工作线程按块序号先到先取，调用线程取完后等待其余块完成
+// 正在执行某块的线程（工作线程或调用线程）再发起的并行循环直接在本线程串行执行，
+// 嵌套（如批量拟合、bootstrap 中的每次拟合）时线程数不会超过池的大小
+class ParallelThreadPool
+{
+public:
+    static ParallelThreadPool& instance()
+    {
+        // 有意不析构：程序退出时工作线程可能仍在等待任务
+        static ParallelThreadPool* pool = new ParallelThreadPool();
+        return *pool;
+    }
+
+    // 当前线程是否正在执行并行循环中的某一块
+    static bool& insideParallelRegion()
+    {
+        thread_local bool inside = false;
+        return inside;
+    }
+
+    // 对 [0, chunks) 的每个块调用 runChunk(chunk)，返回时全部块已完成
+    void run(size_t chunks, const std::function<void(size_t)>& runChunk)
+    {
+        std::shared_ptr<Task> task = std::make_shared<Task>(chunks, runChunk);
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            // 每个可能参与的工作线程取一次队列项，多余的项在块取完后空转出队
+            size_t helpers = std::min(chunks - 1, workers.size());
+            for (size_t i = 0; i < helpers; ++i) queue.push_back(task);
+        }
+        queueReady.notify_all();
+
+        work(*task);
+        std::unique_lock<std::mutex> lock(task->doneMutex);
+        task->allDone.wait(lock, [&task]() { return task->done.load() == task->chunks; });
+    }
+
+private:
+    struct Task {
+        Task(size_t count, const std::function<void(size_t)>& fn) : chunks(count), runChunk(fn) {}
+
+        size_t chunks;
+        const std::function<void(size_t)>& runChunk; // 调用方等待全部块完成后才返回，引用一直有效
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex doneMutex;
+        std::condition_variable allDone;
+    };
+
+    ParallelThreadPool()
+    {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        size_t count = hardware > 1 ? hardware - 1 : 0;
+        for (size_t i = 0; i < count; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    static void work(Task& task)
+    {
+        bool& inside = insideParallelRegion();
+        bool wasInside = inside;
+        inside = true;
+        for (size_t chunk = task.next++; chunk < task.chunks; chunk = task.next++) {
+            task.runChunk(chunk);
+            if (++task.done == task.chunks) {
+                std::lock_guard<std::mutex> lock(task.doneMutex);
+                task.allDone.notify_all();
+            }
+        }
+        inside = wasInside;
+    }
+
+    void workerLoop()
+    {
+        for (;;) {
+            std::shared_ptr<Task> task;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this]() { return !queue.empty(); });
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            work(*task);
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<std::shared_ptr<Task>> queue;
+};
+
+// fn(chunkIndex, begin, end)；调用线程也参与执行，嵌套调用时在本线程依次执行各块
+template <typename Func>
+void parallelForChunks(size_t count, size_t chunks, Func&& fn)
+{
+    if (count == 0 || chunks == 0) return;
+    chunks = std::min(chunks, count);
+
+    auto bounds = [count, chunks](size_t chunk) {
+        return count / chunks * chunk + std::min(chunk, count % chunks);
+    };
+
+    if (chunks == 1 || ParallelThreadPool::insideParallelRegion()) {
+        for (size_t c = 0; c < chunks; ++c) {
+            fn(c, bounds(c), bounds(c + 1));
+        }
+        return;
+    }
+
+    std::function<void(size_t)> runChunk = [&fn, &bounds](size_t c) { fn(c, bounds(c), bounds(c + 1)); };
+    ParallelThreadPool::instance().run(chunks, runChunk);
+}
+
+// 对独立任务 [0, taskCount) 并行执行 fn(taskIndex)，任务按块静态分配
+template <typename Func>
+void parallelForEach(size_t taskCount, Func&& fn)
+{
+    size_t chunks = std::min<size_t>(taskCount, workerThreadCount());
+    parallelForChunks(taskCount, chunks, [&fn](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            fn(i);
+        }
+    });
+}
+
+#endif // PARALLEL_UTILS_H
@@ -0,0 +1,240 @@
+#include "peak_finder.h"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+namespace {
+
+const size_t NoIndex = std::numeric_limits<size_t>::max();
+
+// 区间查找：在 [lo, hi] 中找最靠右/最靠左的 y <= h 的下标
+// 按 64 个点分块，块内线性扫描，块最小值上建线段树二分，单次 O(64 + log n)，额外内存只有 n/32 个 double
+class ThresholdSearch
+{
+public:
+    static constexpr size_t BlockSize = 64;
+
+    explicit ThresholdSearch(const std::vector<double>& values) : y(values)
+    {
+        size_t blocks = (values.size() + BlockSize - 1) / BlockSize;
+        leaves = 1;
+        while (leaves < blocks) leaves <<= 1;
+        tree.assign(2 * leaves, std::numeric_limits<double>::infinity());
+        for (size_t i = 0; i < values.size(); ++i) {
+            double& slot = tree[leaves + i / BlockSize];
+            slot = std::min(slot, values[i]);
+        }
+        for (size_t i = leaves - 1; i > 0; --i) {
+            tree[i] = std::min(tree[2 * i], tree[2 * i + 1]);
+        }
+    }
+
+    size_t rightmostAtMost(size_t lo, size_t hi, double h) const
+    {
+        size_t firstBlock = lo / BlockSize, lastBlock = hi / BlockSize;
+        if (firstBlock == lastBlock) return scanDown(lo, hi, h);
+
+        size_t found = scanDown(lastBlock * BlockSize, hi, h);
+        if (found != NoIndex) return found;
+        if (lastBlock > firstBlock + 1) {
+            size_t block = searchBlocks(1, 0, leaves - 1, firstBlock + 1, lastBlock - 1, h, true);
+            if (block != NoIndex) return scanDown(block * BlockSize, block * BlockSize + BlockSize - 1, h);
+        }
+        return scanDown(lo, firstBlock * BlockSize + BlockSize - 1, h);
+    }
+
+    size_t leftmostAtMost(size_t lo, size_t hi, double h) const
+    {
+        size_t firstBlock = lo / BlockSize, lastBlock = hi / BlockSize;
+        if (firstBlock == lastBlock) return scanUp(lo, hi, h);
+
+        size_t found = scanUp(lo, firstBlock * BlockSize + BlockSize - 1, h);
+        if (found != NoIndex) return found;
+        if (lastBlock > firstBlock + 1) {
+            size_t block = searchBlocks(1, 0, leaves - 1, firstBlock + 1, lastBlock - 1, h, false);
+            if (block != NoIndex) return scanUp(block * BlockSize, block * BlockSize + BlockSize - 1, h);
+        }
+        return scanUp(lastBlock * BlockSize, hi, h);
+    }
+
+private:
+    size_t scanDown(size_t lo, size_t hi, double h) const
+    {
+        for (size_t i = hi + 1; i-- > lo;) {
+            if (y[i] <= h) return i;
+        }
+        return NoIndex;
+    }
+
+    size_t scanUp(size_t lo, size_t hi, double h) const
+    {
+        for (size_t i = lo; i <= hi; ++i) {
+            if (y[i] <= h) return i;
+        }
+        return NoIndex;
+    }
+
+    size_t searchBlocks(size_t node, size_t nodeLo, size_t nodeHi, size_t lo, size_t hi, double h, bool fromRight) const
+    {
+        if (nodeHi < lo || nodeLo > hi || tree[node] > h) return NoIndex;
+        if (nodeLo == nodeHi) return nodeLo;
+        size_t mid = nodeLo + (nodeHi - nodeLo) / 2;
+        size_t found;
+        if (fromRight) {
+            found = searchBlocks(2 * node + 1, mid + 1, nodeHi, lo, hi, h, fromRight);
+            if (found == NoIndex) found = searchBlocks(2 * node, nodeLo, mid, lo, hi, h, fromRight);
+        } else {
+            found = searchBlocks(2 * node, nodeLo, mid, lo, hi, h, fromRight);
+            if (found == NoIndex) found = searchBlocks(2 * node + 1, mid + 1, nodeHi, lo, hi, h, fromRight);
+        }
+        return found;
+    }
+
+    const std::vector<double>& y;
+    size_t leaves;
+    std::vector<double> tree;
+};
+
+// 局部极大值；平台（连续相等的值）取中点
+std::vector<size_t> localMaxima(const std::vector<double>& y)
+{
+    std::vector<size_t> maxima;
+    size_t n = y.size();
+    size_t i = 1;
+    while (i + 1 < n) {
+        if (y[i - 1] < y[i]) {
+            size_t ahead = i + 1;
+            while (ahead + 1 < n && y[ahead] == y[i]) ++ahead;
+            if (y[ahead] < y[i]) {
+                maxima.push_back((i + ahead - 1) / 2);
+            }
+            i = ahead;
+        } else {
+            ++i;
+        }
+    }
+    return maxima;
+}
+
+// 对每个点求单侧谷底：从该点向一侧走到第一个严格更高的点（或端点）为止，途经的最小值
+// 单调栈中每个元素记录它与栈中下一个元素之间的最小值，弹栈时合并，每个点只进出栈一次
+// 值相同时取离该点更近的下标（与逐点扫描的结果一致）
+std::vector<size_t> sideBases(const std::vector<double>& y, bool fromLeft)
+{
+    struct Entry {
+        size_t index;
+        size_t minIndex;   // 与下方元素之间（不含两端）的最小值下标，NoIndex 表示区间为空
+    };
+
+    size_t n = y.size();
+    std::vector<size_t> bases(n);
+    std::vector<Entry> stack;
+    stack.reserve(64);
+
+    // 后出现的（离当前点更近的）候选在相等时优先
+    auto closer = [&y](size_t later, size_t earlier) {
+        if (later == NoIndex) return earlier;
+        if (earlier == NoIndex) return later;
+        return y[later] <= y[earlier] ? later : earlier;
+    };
+
+    for (size_t step = 0; step < n; ++step) {
+        size_t i = fromLeft ? step : n - 1 - step;
+        size_t acc = NoIndex;
+        while (!stack.empty() && y[stack.back().index] <= y[i]) {
+            const Entry& top = stack.back();
+            acc = closer(acc, closer(top.index, top.minIndex));
+            stack.pop_back();
+        }
+        bases[i] = closer(i, acc);
+        stack.push_back({i, acc});
+    }
+    return bases;
+}
+
+} // namespace
+
+std::vector<Peak> PeakFinder::find(const std::vector<double>& x, const std::vector<double>& y, const PeakSpec& spec)
+{
+    std::vector<Peak> peaks;
+    size_t n = y.size();
+    if (n < 3) return peaks;
+
+    std::vector<size_t> candidates = localMaxima(y);
+    if (candidates.empty()) return peaks;
+
+    // 最小间隔：从最高的峰开始，去掉其两侧间隔内的其他峰
+    if (spec.minDistance > 1 && candidates.size() > 1) {
+        size_t count = candidates.size();
+        std::vector<size_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return y[candidates[a]] < y[candidates[b]];
+        });
+
+        std::vector<char> keep(count, 1);
+        for (size_t r = count; r-- > 0;) {
+            size_t j = order[r];
+            if (!keep[j]) continue;
+            for (size_t k = j; k-- > 0 && candidates[j] - candidates[k] < spec.minDistance;) {
+                keep[k] = 0;
+            }
+            for (size_t k = j + 1; k < count && candidates[k] - candidates[j] < spec.minDistance; ++k) {
+                keep[k] = 0;
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (keep[i]) candidates[kept++] = candidates[i];
+        }
+        candidates.resize(kept);
+    }
+
+    std::vector<size_t> leftBases = sideBases(y, true);
+    std::vector<size_t> rightBases = sideBases(y, false);
+
+    auto positionAt = [&x](double fractionalIndex) {
+        if (x.empty()) return fractionalIndex;
+        size_t lower = std::min(static_cast<size_t>(fractionalIndex), x.size() - 1);
+        if (lower + 1 >= x.size()) return x[lower];
+        double t = fractionalIndex - lower;
+        return x[lower] + t * (x[lower + 1] - x[lower]);
+    };
+
+    ThresholdSearch tree(y);
+    for (size_t p : candidates) {
+        Peak peak;
+        peak.index = p;
+        peak.height = y[p];
+        peak.leftBase = leftBases[p];
+        peak.rightBase = rightBases[p];
+        peak.prominence = y[p] - std::max(y[peak.leftBase], y[peak.rightBase]);
+        if (peak.prominence < spec.minProminence) continue;
+
+        // 宽度：在 widthHeight 处向两侧找到第一个不高于它的点，再做线性插值
+        double h = y[p] - peak.prominence * spec.relHeight;
+        peak.widthHeight = h;
+
+        // 找不到时停在谷底（谷底一定不高于 h）
+        size_t left = (p > peak.leftBase) ? tree.rightmostAtMost(peak.leftBase + 1, p, h) : NoIndex;
+        if (left == NoIndex) left = peak.leftBase;
+        double leftIp = static_cast<double>(left);
+        if (y[left] < h) leftIp += (h - y[left]) / (y[left + 1] - y[left]);
+
+        size_t right = (peak.rightBase > p) ? tree.leftmostAtMost(p, peak.rightBase - 1, h) : NoIndex;
+        if (right == NoIndex) right = peak.rightBase;
+        double rightIp = static_cast<double>(right);
+        if (y[right] < h) rightIp -= (h - y[right]) / (y[right - 1] - y[right]);
+
+        peak.widthSamples = rightIp - leftIp;
+        if (peak.widthSamples < spec.minWidth) continue;
+
+        peak.position = positionAt(static_cast<double>(p));
+        peak.leftPosition = positionAt(leftIp);
+        peak.rightPosition = positionAt(rightIp);
+        peaks.push_back(peak);
+    }
+    return peaks;
+}
@@ -0,0 +1,38 @@
+#ifndef PEAK_FINDER_H
+#define PEAK_FINDER_H
+
+#include <vector>
+#include <cstddef>
+
+struct PeakSpec {
+    double minProminence = 0.0;   // 最小突起度（与数据同单位），0 表示不过滤
+    size_t minDistance = 1;       // 相邻峰的最小间隔（采样点数），冲突时保留较高的峰，同高时保留靠后的
+    double minWidth = 0.0;        // 最小宽度（采样点数，在 relHeight 处测量），0 表示不过滤
+    double relHeight = 0.5;       // 测量宽度的位置：峰顶向下 relHeight 倍突起度，0.5 即半高宽
+};
+
+struct Peak {
+    size_t index = 0;           // 峰顶下标（平台取中点）
+    double position = 0.0;      // 峰顶的 x
+    double height = 0.0;
+    double prominence = 0.0;
+    size_t leftBase = 0;        // 突起度两侧的谷底下标
+    size_t rightBase = 0;
+    double widthHeight = 0.0;   // 测量宽度所在的高度
+    double leftPosition = 0.0;  // 宽度线与曲线左右交点的 x（线性插值）
+    double rightPosition = 0.0;
+    double widthSamples = 0.0;  // 以采样点计的宽度
+
+    double width() const { return rightPosition - leftPosition; }
+};
+
+// 寻峰：局部极大值 -> 最小间隔 -> 突起度 -> 宽度，依次过滤（与 scipy.signal.find_peaks 的定义一致）
+// 突起度用单调栈两遍扫描求得，O(n)；宽度交点在分块最小值线段树上查找，每个峰 O(log n)；整体 O(n log n)
+class PeakFinder
+{
+public:
+    // x 为空时以下标作为位置；结果按位置排序
+    static std::vector<Peak> find(const std::vector<double>& x, const std::vector<double>& y, const PeakSpec& spec);
+};
+
+#endif // PEAK_FINDER_H
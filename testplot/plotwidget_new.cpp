@@ -1,13 +1,14 @@
 #include "plotwidget_new.h"
 #include <QApplication>
 #include <QTextCodec>
+#include <QtConcurrent>
 #include <random>
 #include <regex>
 
 PlotWidget::PlotWidget(QWidget *parent) 
     : QWidget(parent), chartType(ChartType::Line),
       zoomFactor(1.0), panOffset(0, 0), isDragging(false), isMultiSeries(false),
-      hasFitting(false), fittingDegree(0), showResidualChart(false)
+      hasFitting(false), showResidualChart(false)
 {
     setMinimumSize(static_cast<int>(600 * 1.5), 
                    static_cast<int>(400 * 1.5));
@@ -45,10 +46,21 @@ PlotWidget::PlotWidget(QWidget *parent)
     // 设置鼠标跟踪和缩放参数
     setFocusPolicy(Qt::StrongFocus);
     setAttribute(Qt::WA_AcceptTouchEvents);
+    
+    // 后台频谱计算完成后回到 GUI 线程保存结果并重绘
+    spectrumWatcher = new QFutureWatcher<std::vector<SpectrumResult>>(this);
+    connect(spectrumWatcher, &QFutureWatcher<std::vector<SpectrumResult>>::finished, this, [this]() {
+        spectra = spectrumWatcher->result();
+        spectraVersion = pendingSpectrumVersion;
+        spectraSpec = pendingSpectrumSpec;
+        spectraValid = true;
+        update();
+    });
 }
 
 void PlotWidget::setData(const std::vector<double>& x, const std::vector<double>& y)
 {
+    ++dataVersion;
     xData = x;
     yData = y;
     calculateStatistics();
@@ -57,6 +69,7 @@ void PlotWidget::setData(const std::vector<double>& x, const std::vector<double>
 
 void PlotWidget::setData(const std::vector<double>& data)
 {
+    ++dataVersion;
     yData = data;
     xData.clear();
     for (size_t i = 0; i < data.size(); ++i) {
@@ -68,6 +81,7 @@ void PlotWidget::setData(const std::vector<double>& data)
 
 void PlotWidget::setData(const std::vector<std::vector<double>>& allData, int xCol, int yCol)
 {
+    ++dataVersion;
     xData.clear();
     yData.clear();
     
@@ -85,6 +99,7 @@ void PlotWidget::setData(const std::vector<std::vector<double>>& allData, int xC
 
 void PlotWidget::setMultiSeriesData(const std::vector<double>& x, const std::vector<std::vector<double>>& ySeries, const std::vector<QString>& seriesNames)
 {
+    ++dataVersion;
     xData = x;
     ySeriesData = ySeries;
     this->seriesNames = seriesNames;
@@ -98,6 +113,21 @@ void PlotWidget::setMultiSeriesData(const std::vector<double>& x, const std::vec
     update();
 }
 
+void PlotWidget::appendData(const std::vector<double>& x, const std::vector<double>& y)
+{
+    size_t count = std::min(x.size(), y.size());
+    if (count == 0) return;
+    
+    ++dataVersion;
+    xData.insert(xData.end(), x.begin(), x.begin() + count);
+    yData.insert(yData.end(), y.begin(), y.begin() + count);
+    
+    // 只对新增的 k 个点做 O(k) 的统计更新
+    yStatistics.append(y.data(), count);
+    updateStatisticsText();
+    update();
+}
+
 void PlotWidget::setLabels(const std::vector<QString>& labels)
 {
     dataLabels = labels;
@@ -106,17 +136,27 @@ void PlotWidget::setLabels(const std::vector<QString>& labels)
 
 void PlotWidget::clearData()
 {
+    ++dataVersion;
     xData.clear();
     yData.clear();
     dataLabels.clear();
     statistics.clear();
+    yStatistics.clear();
     ySeriesData.clear();
     seriesNames.clear();
     isMultiSeries = false;
     hasFitting = false;
-    fittingCoefficients.clear();
+    fittingModel = FitModel();
+    fittingInliers.clear();
+    clearFittingBand();
     residuals.clear();
     showResidualChart = false;
+    correlationMatrix = CorrelationMatrix();
+    correlationNames.clear();
+    heatmapImage = QImage();
+    heatmapImageDirty = true;
+    densityCache = DensityCache();
+    overlays.clear();
     update();
 }
 
@@ -174,6 +214,61 @@ void PlotWidget::setFontSizes(double title, double label, double axis)
     update();
 }
 
+void PlotWidget::setHistogramBinSpec(const BinSpec& spec)
+{
+    histogramBinSpec = spec;
+    update();
+}
+
+void PlotWidget::setKdeBandwidthRule(BandwidthRule rule)
+{
+    kdeSpec.rule = rule;
+    update();
+}
+
+void PlotWidget::setSpectrumSpec(const SpectrumSpec& spec)
+{
+    spectrumSpec = spec;
+    update();
+}
+
+void PlotWidget::setScatterDensitySpec(const ScatterDensitySpec& spec)
+{
+    if (spec != scatterDensitySpec) {
+        scatterDensitySpec = spec;
+        densityCache.imageValid = false;
+    }
+    update();
+}
+
+void PlotWidget::setOverlays(const std::vector<SeriesOverlay>& overlays)
+{
+    this->overlays = overlays;
+    update();
+}
+
+void PlotWidget::setPeaks(const std::vector<Peak>& peaks)
+{
+    this->peaks = peaks;
+    peaksVersion = dataVersion;
+    update();
+}
+
+void PlotWidget::setDistributionFits(const std::vector<DistributionFit>& fits)
+{
+    distributionFits = fits;
+    distributionFitsVersion = dataVersion;
+    update();
+}
+
+void PlotWidget::setCorrelationMatrix(const CorrelationMatrix& matrix, const std::vector<QString>& names)
+{
+    correlationMatrix = matrix;
+    correlationNames = names;
+    heatmapImageDirty = true;
+    update();
+}
+
 void PlotWidget::resetView()
 {
     zoomFactor = 1.0;
@@ -181,21 +276,52 @@ void PlotWidget::resetView()
     update();
 }
 
-void PlotWidget::setPolynomialFitting(int degree, const std::vector<double>& coefficients, const std::vector<double>& residuals, const QString& typeName)
+void PlotWidget::setFitting(const FitModel& model, const std::vector<double>& residuals, const QString& typeName,
+                            const std::vector<char>& inliers)
 {
     hasFitting = true;
-    fittingDegree = degree;
-    fittingCoefficients = coefficients;
+    fittingModel = model;
+    fittingInliers = inliers;
+    clearFittingBand();
     this->residuals = residuals;
     fittingTypeName = typeName;
     showResidualChart = true;
     update();
 }
 
+void PlotWidget::setFittingBand(const std::vector<double>& x, const std::vector<double>& lower,
+                                const std::vector<double>& upper, const QString& label)
+{
+    if (x.size() != lower.size() || x.size() != upper.size()) return;
+    fittingBandX = x;
+    fittingBandLower = lower;
+    fittingBandUpper = upper;
+    fittingBandLabel = label;
+    update();
+}
+
+void PlotWidget::clearFittingBand()
+{
+    fittingBandX.clear();
+    fittingBandLower.clear();
+    fittingBandUpper.clear();
+    fittingBandLabel.clear();
+}
+
+void PlotWidget::setSeriesFits(const std::vector<SeriesFit>& fits)
+{
+    seriesFits = fits;
+    seriesFitsVersion = dataVersion;
+    update();
+}
+
 void PlotWidget::clearFitting()
 {
     hasFitting = false;
-    fittingCoefficients.clear();
+    seriesFits.clear();
+    fittingModel = FitModel();
+    fittingInliers.clear();
+    clearFittingBand();
     residuals.clear();
     fittingTypeName.clear();
     showResidualChart = false;
@@ -252,40 +378,24 @@ void PlotWidget::paintEvent(QPaintEvent *event)
 
 void PlotWidget::calculateStatistics()
 {
-    if (yData.empty()) return;
-    
+    yStatistics.clear();
+    yStatistics.append(yData);
+    updateStatisticsText();
+}
+
+void PlotWidget::updateStatisticsText()
+{
     statistics.clear();
-    
-    // 计算基本统计信息
-    double sum = std::accumulate(yData.begin(), yData.end(), 0.0);
-    double mean = sum / yData.size();
-    
-    double variance = 0.0;
-    for (double value : yData) {
-        variance += (value - mean) * (value - mean);
-    }
-    variance /= yData.size();
-    double stddev = std::sqrt(variance);
-    
-    auto minmax = std::minmax_element(yData.begin(), yData.end());
-    
-    statistics["数量"] = QString::number(yData.size());
-    statistics["总和"] = QString::number(sum, 'f', 2);
-    statistics["平均值"] = QString::number(mean, 'f', 2);
-    statistics["标准差"] = QString::number(stddev, 'f', 2);
-    statistics["最小值"] = QString::number(*minmax.first, 'f', 2);
-    statistics["最大值"] = QString::number(*minmax.second, 'f', 2);
-    
-    // 计算中位数
-    std::vector<double> sortedData = yData;
-    std::sort(sortedData.begin(), sortedData.end());
-    double median;
-    if (sortedData.size() % 2 == 0) {
-        median = (sortedData[sortedData.size()/2 - 1] + sortedData[sortedData.size()/2]) / 2.0;
-    } else {
-        median = sortedData[sortedData.size()/2];
-    }
-    statistics["中位数"] = QString::number(median, 'f', 2);
+    if (yStatistics.isEmpty()) return;
+    
+    // 基本统计信息全部来自增量累加器，无需再次遍历或排序数据
+    statistics["数量"] = QString::number(yStatistics.count());
+    statistics["总和"] = QString::number(yStatistics.sum(), 'f', 2);
+    statistics["平均值"] = QString::number(yStatistics.mean(), 'f', 2);
+    statistics["标准差"] = QString::number(yStatistics.stddev(), 'f', 2);
+    statistics["最小值"] = QString::number(yStatistics.min(), 'f', 2);
+    statistics["最大值"] = QString::number(yStatistics.max(), 'f', 2);
+    statistics["中位数"] = QString::number(yStatistics.median(), 'f', 2);
 }
 
 void PlotWidget::drawNoDataMessage(QPainter& painter)
@@ -446,13 +556,14 @@ void PlotWidget::drawLineChart(QPainter& painter)
     
     if (xData.size() < 2) return;
     
-    auto xMinMax = std::minmax_element(xData.begin(), xData.end());
-    auto yMinMax = std::minmax_element(yData.begin(), yData.end());
+    // 范围、x 是否有序和 min/max 金字塔按数据版本缓存，重绘不再扫描全部数据
+    const LinePyramid& pyramid = lineDecimationEngine.pyramid(dataVersion, xData, yData);
+    if (!pyramid.hasRange) return;
     
-    double xMin = *xMinMax.first;
-    double xMax = *xMinMax.second;
-    double yMin = *yMinMax.first;
-    double yMax = *yMinMax.second;
+    double xMin = pyramid.xMin;
+    double xMax = pyramid.xMax;
+    double yMin = pyramid.yMin;
+    double yMax = pyramid.yMax;
     
     double xRange = xMax - xMin;
     double yRange = yMax - yMin;
@@ -464,28 +575,44 @@ void PlotWidget::drawLineChart(QPainter& painter)
     yMin -= yRange * 0.05;
     yMax += yRange * 0.05;
     
+    QPolygonF line;
+    auto appendPoint = [&](size_t i) {
+        if (!std::isfinite(xData[i]) || !std::isfinite(yData[i])) return;
+        line << QPointF(plotRect.left() + (xData[i] - xMin) / (xMax - xMin) * plotRect.width(),
+                        plotRect.bottom() - (yData[i] - yMin) / (yMax - yMin) * plotRect.height());
+    };
+    if (pyramid.sorted) {
+        // x 有序：按屏幕上的像素列做 M4 抽取，只取可见范围，绘制的点数与缩放无关、与像素数相当
+        // 设备坐标 = panOffset + zoomFactor * 逻辑坐标
+        double deviceLeft = std::max(0.0, std::floor(panOffset.x() + zoomFactor * plotRect.left()));
+        double deviceRight = std::min<double>(width(), std::ceil(panOffset.x() + zoomFactor * plotRect.right()));
+        auto dataX = [&](double device) {
+            double logical = (device - panOffset.x()) / zoomFactor;
+            return xMin + (logical - plotRect.left()) / plotRect.width() * (xMax - xMin);
+        };
+        std::vector<size_t> indices = LineDecimationEngine::decimate(pyramid, xData, yData, dataX(deviceLeft),
+                                                                     dataX(deviceRight), (int)(deviceRight - deviceLeft));
+        line.reserve((int)indices.size());
+        for (size_t i : indices) appendPoint(i);
+    } else {
+        // x 无序时按数据顺序连线，不能按列抽取
+        line.reserve((int)xData.size());
+        for (size_t i = 0; i < xData.size(); ++i) appendPoint(i);
+    }
+    
     // 绘制连线
     painter.setPen(QPen(colors[0], 3));
     painter.setBrush(Qt::NoBrush);
-    for (size_t i = 0; i < xData.size() - 1; ++i) {
-        int x1 = plotRect.left() + (int)((xData[i] - xMin) / (xMax - xMin) * plotRect.width());
-        int y1 = plotRect.bottom() - (int)((yData[i] - yMin) / (yMax - yMin) * plotRect.height());
-        int x2 = plotRect.left() + (int)((xData[i+1] - xMin) / (xMax - xMin) * plotRect.width());
-        int y2 = plotRect.bottom() - (int)((yData[i+1] - yMin) / (yMax - yMin) * plotRect.height());
-        
-        painter.drawLine(x1, y1, x2, y2);
-    }
+    painter.drawPolyline(line);
     
-    // 绘制数据点
-    for (size_t i = 0; i < xData.size(); ++i) {
-        int x = plotRect.left() + (int)((xData[i] - xMin) / (xMax - xMin) * plotRect.width());
-        int y = plotRect.bottom() - (int)((yData[i] - yMin) / (yMax - yMin) * plotRect.height());
-        
-        painter.setPen(QPen(colors[0].darker(), 2));
-        painter.setBrush(colors[0]);
-        painter.drawEllipse(x - pointSize, y - pointSize, pointSize * 2, pointSize * 2);
+    // 绘制数据点：抽取后每列的首末和最值点已构成该列的全部可见轮廓
+    painter.setPen(QPen(colors[0].darker(), 2));
+    painter.setBrush(colors[0]);
+    for (const QPointF& point : line) {
+        painter.drawEllipse(point, pointSize, pointSize);
     }
     
+    drawOverlays(painter, plotRect, xMin, xMax, yMin, yMax);
     drawAxisLabels(painter, plotRect, xMin, xMax, yMin, yMax);
     drawLegend(painter, plotRect); // 也为单系列图表绘制legend（如果有拟合线）
 }
@@ -579,6 +706,14 @@ void PlotWidget::drawScatterChart(QPainter& painter)
     
     if (xData.empty() || yData.empty()) return;
     
+    if (useScatterDensity(xData.size())) {
+        double xMin, xMax, yMin, yMax;
+        if (!drawScatterDensity(painter, plotRect, {&yData}, xMin, xMax, yMin, yMax)) return;
+        drawAxisLabels(painter, plotRect, xMin, xMax, yMin, yMax);
+        drawLegend(painter, plotRect);
+        return;
+    }
+    
     auto xMinMax = std::minmax_element(xData.begin(), xData.end());
     auto yMinMax = std::minmax_element(yData.begin(), yData.end());
     
@@ -611,23 +746,143 @@ void PlotWidget::drawScatterChart(QPainter& painter)
     drawLegend(painter, plotRect); // 也为单系列图表绘制legend（如果有拟合线）
 }
 
-void PlotWidget::drawHistogram(QPainter& painter)
+bool PlotWidget::useScatterDensity(size_t points) const
 {
-    if (yData.empty()) return;
+    switch (scatterDensitySpec.mode) {
+    case ScatterRenderMode::Points: return false;
+    case ScatterRenderMode::Density: return true;
+    case ScatterRenderMode::Auto: break;
+    }
+    return points > scatterDensitySpec.autoThreshold;
+}
+
+// 密度图：可见的绘图区按设备像素计数（多线程），计数经对数或直方图均衡映射到 256 级查找表后写入 QImage
+// 单系列由浅到深着色；多系列每个像素按各系列的计数混合系列颜色，总计数决定不透明度
+// 返回 false 表示没有可绘制的点；xMin 等为含 5% 边距的坐标范围
+bool PlotWidget::drawScatterDensity(QPainter& painter, const QRect& plotRect,
+                                    const std::vector<const std::vector<double>*>& series,
+                                    double& xMin, double& xMax, double& yMin, double& yMax)
+{
+    DensityCache& cache = densityCache;
+    if (!cache.rangeValid || cache.rangeVersion != dataVersion) {
+        cache.rangeValid = DensityRasterizer::dataRange(xData, series, cache.xMin, cache.xMax, cache.yMin, cache.yMax);
+        cache.rangeVersion = dataVersion;
+        cache.imageValid = false;
+    }
+    if (!cache.rangeValid) return false;
     
-    // 计算直方图数据
-    int bins = std::min(20, (int)std::sqrt(yData.size()));
-    if (bins < 5) bins = 5;
+    xMin = cache.xMin;
+    xMax = cache.xMax;
+    yMin = cache.yMin;
+    yMax = cache.yMax;
+    double xRange = xMax - xMin;
+    double yRange = yMax - yMin;
+    if (xRange == 0) xRange = 1;
+    if (yRange == 0) yRange = 1;
+    xMin -= xRange * 0.05;
+    xMax += xRange * 0.05;
+    yMin -= yRange * 0.05;
+    yMax += yRange * 0.05;
     
-    double minVal = *std::min_element(yData.begin(), yData.end());
-    double maxVal = *std::max_element(yData.begin(), yData.end());
-    double binWidth = (maxVal - minVal) / bins;
+    bool current = cache.imageValid && cache.imageVersion == dataVersion && cache.zoom == zoomFactor
+                   && cache.pan == panOffset && cache.plotRect == plotRect;
+    if (!current) {
+        cache.imageValid = true;
+        cache.imageVersion = dataVersion;
+        cache.zoom = zoomFactor;
+        cache.pan = panOffset;
+        cache.plotRect = plotRect;
+        cache.image = QImage();
+        
+        // 绘图区在屏幕上可见部分的设备像素范围：设备坐标 = panOffset + zoomFactor * 逻辑坐标
+        int left = std::max(0, (int)std::floor(panOffset.x() + zoomFactor * plotRect.left()));
+        int right = std::min(width(), (int)std::ceil(panOffset.x() + zoomFactor * (plotRect.left() + plotRect.width())));
+        int top = std::max(0, (int)std::floor(panOffset.y() + zoomFactor * plotRect.top()));
+        int bottom = std::min(height(), (int)std::ceil(panOffset.y() + zoomFactor * (plotRect.top() + plotRect.height())));
+        if (right <= left || bottom <= top) return true;
+        int pixelWidth = right - left;
+        int pixelHeight = bottom - top;
+        auto dataX = [&](double device) {
+            return xMin + ((device - panOffset.x()) / zoomFactor - plotRect.left()) / plotRect.width() * (xMax - xMin);
+        };
+        auto dataY = [&](double device) {
+            return yMin + (plotRect.bottom() - (device - panOffset.y()) / zoomFactor) / plotRect.height() * (yMax - yMin);
+        };
+        
+        std::vector<DensityGrid> grids;
+        for (const std::vector<double>* y : series) {
+            grids.push_back(DensityRasterizer::accumulate(xData, *y, pixelWidth, pixelHeight,
+                                                          dataX(left), dataX(right), dataY(bottom), dataY(top)));
+        }
+        
+        // 多系列先求每个像素的总计数，色阶由总计数决定
+        std::vector<uint32_t> totals;
+        uint32_t maxTotal = grids.front().maxCount;
+        if (grids.size() > 1) {
+            totals.assign((size_t)pixelWidth * pixelHeight, 0);
+            for (const DensityGrid& grid : grids) {
+                for (size_t p = 0; p < totals.size(); ++p) totals[p] += grid.counts[p];
+            }
+            maxTotal = *std::max_element(totals.begin(), totals.end());
+        }
+        const std::vector<uint32_t>& counts = grids.size() > 1 ? totals : grids.front().counts;
+        if (maxTotal == 0) return true;
+        std::vector<uint8_t> levels = DensityRasterizer::shade(counts, maxTotal, scatterDensitySpec.scale);
+        
+        // 查找表：色阶越高颜色越深、越不透明，低密度处仍能看到网格
+        std::vector<int> alpha(256, 0);
+        for (int k = 1; k < 256; ++k) alpha[k] = 90 + (165 * (k - 1)) / 254;
+        std::vector<QRgb> lut(256, qRgba(0, 0, 0, 0));
+        QColor low = colors[0].lighter(150);
+        QColor high = colors[0].darker(170);
+        for (int k = 1; k < 256; ++k) {
+            double t = (k - 1) / 254.0;
+            lut[k] = qRgba((int)(low.red() + t * (high.red() - low.red())),
+                           (int)(low.green() + t * (high.green() - low.green())),
+                           (int)(low.blue() + t * (high.blue() - low.blue())), alpha[k]);
+        }
+        
+        cache.image = QImage(pixelWidth, pixelHeight, QImage::Format_ARGB32);
+        for (int row = 0; row < pixelHeight; ++row) {
+            QRgb* line = reinterpret_cast<QRgb*>(cache.image.scanLine(row));
+            size_t offset = (size_t)row * pixelWidth;
+            for (int column = 0; column < pixelWidth; ++column) {
+                size_t p = offset + column;
+                uint8_t level = levels[p];
+                if (level == 0 || grids.size() == 1) {
+                    line[column] = lut[level];
+                    continue;
+                }
+                double red = 0.0, green = 0.0, blue = 0.0;
+                for (size_t s = 0; s < grids.size(); ++s) {
+                    uint32_t c = grids[s].counts[p];
+                    if (c == 0) continue;
+                    const QColor& color = colors[s % colors.size()];
+                    red += (double)c * color.red();
+                    green += (double)c * color.green();
+                    blue += (double)c * color.blue();
+                }
+                double total = (double)counts[p];
+                line[column] = qRgba((int)(red / total), (int)(green / total), (int)(blue / total), alpha[level]);
+            }
+        }
+        cache.target = QRectF((left - panOffset.x()) / zoomFactor, (top - panOffset.y()) / zoomFactor,
+                              pixelWidth / zoomFactor, pixelHeight / zoomFactor);
+    }
     
-    std::vector<int> histogram(bins, 0);
-    for (double value : yData) {
-        int bin = std::min(bins - 1, (int)((value - minVal) / binWidth));
-        histogram[bin]++;
+    if (!cache.image.isNull()) {
+        painter.drawImage(cache.target, cache.image);
     }
+    return true;
+}
+
+void PlotWidget::drawHistogram(QPainter& painter)
+{
+    if (yData.empty()) return;
+    
+    // 分箱结果按 (数据版本, 分箱规格) 缓存，重绘时只绘制计数
+    const HistogramResult& hist = histogramEngine.histogram(dataVersion, yData, histogramBinSpec, &yStatistics);
+    if (hist.isEmpty()) return;
     
     int margin = 80;
     QRect plotRect = rect().adjusted(margin, margin, -margin, -margin);
@@ -636,89 +891,315 @@ void PlotWidget::drawHistogram(QPainter& painter)
     drawGrid(painter, plotRect);
     drawAxes(painter, plotRect);
     
-    int maxCount = *std::max_element(histogram.begin(), histogram.end());
-    if (maxCount == 0) return;
+    if (hist.maxCount == 0) return;
     
-    int barWidth = plotRect.width() / bins;
+    int bins = (int)hist.counts.size();
+    double barWidth = (double)plotRect.width() / bins;
+    QColor color = colors[0];
+    
+    // 箱很多时去掉描边和渐变，避免逐箱切换画笔
+    bool denseBins = barWidth < 3.0;
+    if (denseBins) {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(color);
+    }
     
     for (int i = 0; i < bins; ++i) {
-        int x = plotRect.left() + i * barWidth;
-        int barHeight = (int)((double)histogram[i] / maxCount * plotRect.height());
-        int y = plotRect.bottom() - barHeight;
+        if (hist.counts[i] == 0) continue;
         
-        QRect barRect(x, y, barWidth - 1, barHeight);
+        double x = plotRect.left() + i * barWidth;
+        double barHeight = (double)hist.counts[i] / hist.maxCount * plotRect.height();
+        double y = plotRect.bottom() - barHeight;
         
-        QLinearGradient gradient(x, y, x, y + barHeight);
-        QColor color = colors[0];
-        gradient.setColorAt(0, color.lighter(120));
-        gradient.setColorAt(1, color);
+        QRectF barRect(x, y, denseBins ? barWidth : barWidth - 1, barHeight);
         
-        painter.setBrush(gradient);
-        painter.setPen(QPen(color.darker(), 1));
+        if (!denseBins) {
+            QLinearGradient gradient(x, y, x, y + barHeight);
+            gradient.setColorAt(0, color.lighter(120));
+            gradient.setColorAt(1, color);
+            
+            painter.setBrush(gradient);
+            painter.setPen(QPen(color.darker(), 1));
+        }
         painter.drawRect(barRect);
     }
+    
+    // 拟合分布的期望频数曲线：n * 箱宽 * pdf(x)，与柱子同一纵轴
+    if (distributionFitsVersion == dataVersion && !distributionFits.empty() && hist.maxValue > hist.minValue) {
+        painter.save();
+        painter.setClipRect(plotRect);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        const int samples = std::max(64, plotRect.width() / 2);
+        double scale = hist.total * hist.binWidth;
+        for (size_t f = 0; f < distributionFits.size(); ++f) {
+            const DistributionFit& fit = distributionFits[f];
+            if (!fit.valid) continue;
+            QPolygonF curve;
+            curve.reserve(samples + 1);
+            for (int i = 0; i <= samples; ++i) {
+                double x = hist.minValue + (hist.maxValue - hist.minValue) * i / samples;
+                double expected = std::min(scale * fit.pdf(x), 4.0 * hist.maxCount);
+                curve << QPointF(plotRect.left() + (double)plotRect.width() * i / samples,
+                                 plotRect.bottom() - expected / hist.maxCount * plotRect.height());
+            }
+            painter.setPen(QPen(colors[(f + 1) % colors.size()].darker(120), 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawPolyline(curve);
+        }
+        painter.restore();
+    }
+    
+    drawAxisLabels(painter, plotRect, hist.minValue, hist.maxValue, 0.0, (double)hist.maxCount);
+    if (distributionFitsVersion == dataVersion && !distributionFits.empty()) {
+        drawLegend(painter, plotRect);
+    }
 }
 
 void PlotWidget::drawBoxPlot(QPainter& painter)
 {
-    // 简化的箱线图实现
     int margin = 80;
     QRect plotRect = rect().adjusted(margin, margin, -margin, -margin);
     
     drawTitle(painter, plotRect);
+    drawGrid(painter, plotRect);
     drawAxes(painter, plotRect);
     
-    if (yData.empty()) return;
-    
-    std::vector<double> sortedData = yData;
-    std::sort(sortedData.begin(), sortedData.end());
+    // 五数概括按数据版本缓存，重绘时不再排序
+    const std::vector<BoxSummary>& summaries = seriesBoxSummaries();
+    if (summaries.empty()) return;
     
-    size_t n = sortedData.size();
-    double q1 = sortedData[n / 4];
-    double median = (n % 2 == 0) ? (sortedData[n/2-1] + sortedData[n/2]) / 2.0 : sortedData[n/2];
-    double q3 = sortedData[3 * n / 4];
+    double yMin = std::numeric_limits<double>::max();
+    double yMax = std::numeric_limits<double>::lowest();
+    for (const BoxSummary& box : summaries) {
+        if (box.isEmpty()) continue;
+        yMin = std::min(yMin, box.minValue);
+        yMax = std::max(yMax, box.maxValue);
+    }
+    if (yMin > yMax) return;
     
-    double yMin = sortedData.front();
-    double yMax = sortedData.back();
     double yRange = yMax - yMin;
     if (yRange == 0) yRange = 1;
-    
     yMin -= yRange * 0.1;
     yMax += yRange * 0.1;
     yRange = yMax - yMin;
     
-    int boxWidth = plotRect.width() / 3;
-    int boxLeft = plotRect.left() + plotRect.width() / 2 - boxWidth / 2;
-    
-    auto scaleY = [&](double value) -> int {
-        return plotRect.bottom() - (int)((value - yMin) / yRange * plotRect.height());
+    auto scaleY = [&](double value) -> double {
+        return plotRect.bottom() - (value - yMin) / yRange * plotRect.height();
     };
     
-    int q1Y = scaleY(q1);
-    int medianY = scaleY(median);
-    int q3Y = scaleY(q3);
+    double slotWidth = (double)plotRect.width() / summaries.size();
+    double boxWidth = std::min(slotWidth * 0.6, (double)plotRect.width() / 3);
+    // 列很多时槽位很窄，省去描边细节
+    bool compact = slotWidth < 12.0;
+    double outlierRadius = compact ? 1.5 : 3.0;
     
-    // 箱体
-    QRect boxRect(boxLeft, q3Y, boxWidth, q1Y - q3Y);
-    painter.setBrush(colors[0].lighter(140));
-    painter.setPen(QPen(colors[0], 2));
-    painter.drawRect(boxRect);
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const BoxSummary& box = summaries[i];
+        if (box.isEmpty()) continue;
+        
+        QColor color = colors[i % colors.size()];
+        double center = plotRect.left() + slotWidth * (i + 0.5);
+        double left = center - boxWidth / 2;
+        double capHalf = boxWidth / 4;
+        
+        double q1Y = scaleY(box.q1);
+        double q3Y = scaleY(box.q3);
+        double lowY = scaleY(box.lowerWhisker);
+        double highY = scaleY(box.upperWhisker);
+        
+        // 须线和端帽
+        painter.setPen(QPen(color.darker(130), compact ? 1 : 2));
+        painter.drawLine(QPointF(center, q1Y), QPointF(center, lowY));
+        painter.drawLine(QPointF(center, q3Y), QPointF(center, highY));
+        if (!compact) {
+            painter.drawLine(QPointF(center - capHalf, lowY), QPointF(center + capHalf, lowY));
+            painter.drawLine(QPointF(center - capHalf, highY), QPointF(center + capHalf, highY));
+        }
+        
+        // 箱体
+        painter.setBrush(color.lighter(140));
+        painter.setPen(compact ? QPen(Qt::NoPen) : QPen(color, 2));
+        painter.drawRect(QRectF(left, q3Y, boxWidth, q1Y - q3Y));
+        
+        // 中位数线
+        double medianY = scaleY(box.median);
+        painter.setPen(QPen(color.darker(170), compact ? 1 : 3));
+        painter.drawLine(QPointF(left, medianY), QPointF(left + boxWidth, medianY));
+        
+        // 离群点
+        if (!box.outliers.empty()) {
+            painter.setPen(QPen(color.darker(150), 1));
+            painter.setBrush(Qt::NoBrush);
+            for (double value : box.outliers) {
+                painter.drawEllipse(QPointF(center, scaleY(value)), outlierRadius, outlierRadius);
+            }
+        }
+    }
     
-    // 中位数线
-    painter.setPen(QPen(colors[1], 3));
-    painter.drawLine(boxLeft, medianY, boxLeft + boxWidth, medianY);
+    drawValueAxisLabels(painter, plotRect, yMin, yMax);
+    drawCategoryLabels(painter, plotRect, distributionSeriesNames());
+}
+
+size_t PlotWidget::distributionSeriesCount() const
+{
+    return isMultiSeries ? ySeriesData.size() : (yData.empty() ? 0 : 1);
+}
+
+const std::vector<double>& PlotWidget::distributionSeries(size_t index) const
+{
+    return isMultiSeries ? ySeriesData[index] : yData;
+}
+
+std::vector<QString> PlotWidget::distributionSeriesNames() const
+{
+    if (isMultiSeries) return seriesNames;
+    return std::vector<QString>(1, yAxisLabel);
+}
+
+const KdeResult& PlotWidget::seriesDensity(size_t index)
+{
+    // 单系列可直接使用已有的统计量；多系列由引擎在缓存未命中时自行统计
+    const StatisticsAccumulator* stats = isMultiSeries ? nullptr : &yStatistics;
+    return kdeEngine.density((int)index, dataVersion, distributionSeries(index), kdeSpec, stats);
+}
+
+const std::vector<BoxSummary>& PlotWidget::seriesBoxSummaries()
+{
+    std::vector<const std::vector<double>*> series;
+    for (size_t i = 0; i < distributionSeriesCount(); ++i) {
+        series.push_back(&distributionSeries(i));
+    }
+    return boxSummaryEngine.summaries(dataVersion, series);
 }
 
 void PlotWidget::drawViolinPlot(QPainter& painter)
 {
-    // 简化的小提琴图实现
-    drawBoxPlot(painter);
+    int margin = 80;
+    QRect plotRect = rect().adjusted(margin, margin, -margin, -margin);
+    
+    drawTitle(painter, plotRect);
+    drawGrid(painter, plotRect);
+    drawAxes(painter, plotRect);
+    
+    size_t seriesCount = distributionSeriesCount();
+    if (seriesCount == 0) return;
+    
+    // 所有小提琴共用一个数值轴
+    double vMin = std::numeric_limits<double>::max();
+    double vMax = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < seriesCount; ++i) {
+        const KdeResult& kde = seriesDensity(i);
+        if (kde.isEmpty()) continue;
+        vMin = std::min(vMin, kde.grid.front());
+        vMax = std::max(vMax, kde.grid.back());
+    }
+    if (vMin >= vMax) return;
+    
+    auto scaleY = [&](double value) -> double {
+        return plotRect.bottom() - (value - vMin) / (vMax - vMin) * plotRect.height();
+    };
+    
+    double slotWidth = (double)plotRect.width() / seriesCount;
+    double maxHalfWidth = slotWidth * 0.4;
+    const std::vector<BoxSummary>& summaries = seriesBoxSummaries();
+    
+    for (size_t i = 0; i < seriesCount; ++i) {
+        const KdeResult& kde = seriesDensity(i);
+        if (kde.isEmpty() || kde.maxDensity <= 0) continue;
+        
+        double center = plotRect.left() + slotWidth * (i + 0.5);
+        double widthScale = maxHalfWidth / kde.maxDensity;
+        
+        // 右半边自下而上，左半边自上而下，组成对称轮廓
+        QPolygonF outline;
+        for (size_t k = 0; k < kde.grid.size(); ++k) {
+            outline << QPointF(center + kde.density[k] * widthScale, scaleY(kde.grid[k]));
+        }
+        for (size_t k = kde.grid.size(); k-- > 0;) {
+            outline << QPointF(center - kde.density[k] * widthScale, scaleY(kde.grid[k]));
+        }
+        
+        QColor color = colors[i % colors.size()];
+        painter.setPen(QPen(color.darker(120), 2));
+        painter.setBrush(color.lighter(150));
+        painter.drawPolygon(outline);
+        
+        // 叠加四分位箱和中位数点
+        const BoxSummary& box = summaries[i];
+        if (box.isEmpty()) continue;
+        double boxHalf = std::max(1.5, maxHalfWidth * 0.08);
+        double q1Y = scaleY(box.q1);
+        double q3Y = scaleY(box.q3);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(color.darker(150));
+        painter.drawRect(QRectF(center - boxHalf, q3Y, boxHalf * 2, q1Y - q3Y));
+        
+        painter.setBrush(Qt::white);
+        painter.setPen(QPen(color.darker(150), 1));
+        double dotRadius = std::min(4.0, maxHalfWidth * 0.1 + 1.0);
+        painter.drawEllipse(QPointF(center, scaleY(box.median)), dotRadius, dotRadius);
+    }
+    
+    drawValueAxisLabels(painter, plotRect, vMin, vMax);
+    drawCategoryLabels(painter, plotRect, distributionSeriesNames());
 }
 
 void PlotWidget::drawDensityPlot(QPainter& painter)
 {
-    // 简化的密度图实现
-    drawLineChart(painter);
+    int margin = 80;
+    QRect plotRect = rect().adjusted(margin, margin, -margin, -margin);
+    
+    drawTitle(painter, plotRect);
+    drawGrid(painter, plotRect);
+    drawAxes(painter, plotRect);
+    
+    size_t seriesCount = distributionSeriesCount();
+    if (seriesCount == 0) return;
+    
+    double xMin = std::numeric_limits<double>::max();
+    double xMax = std::numeric_limits<double>::lowest();
+    double dMax = 0.0;
+    for (size_t i = 0; i < seriesCount; ++i) {
+        const KdeResult& kde = seriesDensity(i);
+        if (kde.isEmpty()) continue;
+        xMin = std::min(xMin, kde.grid.front());
+        xMax = std::max(xMax, kde.grid.back());
+        dMax = std::max(dMax, kde.maxDensity);
+    }
+    if (xMin >= xMax || dMax <= 0) return;
+    
+    double yMax = dMax * 1.05;
+    
+    for (size_t i = 0; i < seriesCount; ++i) {
+        const KdeResult& kde = seriesDensity(i);
+        if (kde.isEmpty()) continue;
+        
+        QPolygonF curve;
+        for (size_t k = 0; k < kde.grid.size(); ++k) {
+            double x = plotRect.left() + (kde.grid[k] - xMin) / (xMax - xMin) * plotRect.width();
+            double y = plotRect.bottom() - kde.density[k] / yMax * plotRect.height();
+            curve << QPointF(x, y);
+        }
+        
+        QColor color = colors[i % colors.size()];
+        
+        // 曲线下方的半透明填充
+        QPolygonF area = curve;
+        area << QPointF(curve.last().x(), plotRect.bottom());
+        area << QPointF(curve.first().x(), plotRect.bottom());
+        QColor fill = color.lighter(150);
+        fill.setAlpha(seriesCount > 1 ? 90 : 160);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(fill);
+        painter.drawPolygon(area);
+        
+        painter.setPen(QPen(color, lineWidth));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPolyline(curve);
+    }
+    
+    drawAxisLabels(painter, plotRect, xMin, xMax, 0.0, yMax);
+    drawLegend(painter, plotRect);
 }
 
 void PlotWidget::drawAreaChart(QPainter& painter)
@@ -776,25 +1257,237 @@ void PlotWidget::drawAreaChart(QPainter& painter)
     drawAxisLabels(painter, plotRect, xMin, xMax, yMin, yMax);
 }
 
-void PlotWidget::drawAxisLabels(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
+namespace {
+
+// 发散色带：-1 蓝，0 白，+1 红；NaN（方差为 0）显示为灰色
+QRgb correlationColor(double r)
 {
-    painter.setPen(textColor);
+    if (std::isnan(r)) return qRgb(200, 200, 200);
+    r = std::max(-1.0, std::min(1.0, r));
+    const int neutral[3] = {247, 247, 247};
+    const int negative[3] = {59, 76, 192};
+    const int positive[3] = {180, 4, 38};
+    const int* end = r < 0 ? negative : positive;
+    double t = std::abs(r);
+    return qRgb((int)(neutral[0] + (end[0] - neutral[0]) * t),
+                (int)(neutral[1] + (end[1] - neutral[1]) * t),
+                (int)(neutral[2] + (end[2] - neutral[2]) * t));
+}
+
+} // namespace
+
+void PlotWidget::rebuildHeatmapImage()
+{
+    heatmapImageDirty = false;
+    size_t n = correlationMatrix.size;
+    if (n == 0) {
+        heatmapImage = QImage();
+        return;
+    }
+    
+    // 256 级查找表，逐像素直接写扫描线，每个矩阵元素对应一个像素
+    std::vector<QRgb> lut(256);
+    for (int k = 0; k < 256; ++k) {
+        lut[k] = correlationColor(k / 127.5 - 1.0);
+    }
+    QRgb missing = correlationColor(std::numeric_limits<double>::quiet_NaN());
+    
+    heatmapImage = QImage((int)n, (int)n, QImage::Format_RGB32);
+    for (size_t i = 0; i < n; ++i) {
+        QRgb* line = reinterpret_cast<QRgb*>(heatmapImage.scanLine((int)i));
+        for (size_t j = 0; j < n; ++j) {
+            double r = correlationMatrix.at(i, j);
+            line[j] = std::isnan(r) ? missing : lut[std::max(0, std::min(255, (int)((r + 1.0) * 127.5)))];
+        }
+    }
+}
+
+void PlotWidget::drawHeatmap(QPainter& painter)
+{
+    int margin = 80;
+    QRect plotRect = rect().adjusted(margin, margin, -margin, -margin);
+    
+    drawTitle(painter, plotRect);
+    
+    if (correlationMatrix.isEmpty()) return;
+    if (heatmapImageDirty) rebuildHeatmapImage();
+    
+    // 方形矩阵区域，右侧留出色标
+    int colorBarWidth = 16;
+    int side = std::min(plotRect.width() - colorBarWidth - 50, plotRect.height());
+    if (side <= 0) return;
+    QRect matrixRect(plotRect.left(), plotRect.top(), side, side);
+    
+    painter.drawImage(matrixRect, heatmapImage);
+    painter.setPen(QPen(axisColor, 1));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(matrixRect);
+    
+    size_t n = correlationMatrix.size;
+    double cell = (double)side / n;
+    
     QFont axisFont("Microsoft YaHei", static_cast<int>(axisFontSize));
     painter.setFont(axisFont);
     QFontMetrics fm(axisFont);
     
-    // Y轴标签 - 确保标签不超出边界
-    for (int i = 0; i <= 5; ++i) {
-        double value = yMin + (yMax - yMin) * i / 5.0;
-        int y = plotRect.bottom() - (int)(plotRect.height() * i / 5.0);
-        QString valueText = QString::number(value, 'f', 1);
-        int textWidth = fm.width(valueText);
+    // 单元格足够大时标注系数
+    if (cell >= fm.width("-0.00") + 6 && cell >= fm.height() + 4) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double r = correlationMatrix.at(i, j);
+                QRectF cellRect(matrixRect.left() + j * cell, matrixRect.top() + i * cell, cell, cell);
+                painter.setPen(std::abs(r) > 0.6 ? QColor(Qt::white) : textColor);
+                painter.drawText(cellRect, Qt::AlignCenter, std::isnan(r) ? QString("—") : QString::number(r, 'f', 2));
+            }
+        }
+    }
+    
+    // 行、列名称；单元格太小时隔行标注
+    size_t step = std::max<size_t>(1, (size_t)std::ceil((fm.height() + 2) / cell));
+    painter.setPen(textColor);
+    for (size_t i = 0; i < n && i < correlationNames.size(); i += step) {
+        double center = matrixRect.top() + (i + 0.5) * cell;
+        painter.drawText(QRectF(0, center - fm.height() / 2.0, matrixRect.left() - 6, fm.height()),
+                         Qt::AlignRight | Qt::AlignVCenter, correlationNames[i]);
+    }
+    std::vector<QString> columnNames = correlationNames;
+    columnNames.resize(n);
+    drawCategoryLabels(painter, matrixRect, columnNames);
+    
+    // 色标
+    QRect barRect(matrixRect.right() + 20, matrixRect.top(), colorBarWidth, side);
+    QLinearGradient gradient(barRect.left(), barRect.top(), barRect.left(), barRect.bottom());
+    gradient.setColorAt(0, QColor(correlationColor(1.0)));
+    gradient.setColorAt(0.5, QColor(correlationColor(0.0)));
+    gradient.setColorAt(1, QColor(correlationColor(-1.0)));
+    painter.setBrush(gradient);
+    painter.setPen(QPen(axisColor, 1));
+    painter.drawRect(barRect);
+    
+    painter.setPen(textColor);
+    int labelLeft = barRect.right() + 4;
+    painter.drawText(QRect(labelLeft, barRect.top() - fm.height() / 2, 40, fm.height()), Qt::AlignLeft | Qt::AlignVCenter, "1");
+    painter.drawText(QRect(labelLeft, barRect.center().y() - fm.height() / 2, 40, fm.height()), Qt::AlignLeft | Qt::AlignVCenter, "0");
+    painter.drawText(QRect(labelLeft, barRect.bottom() - fm.height() / 2, 40, fm.height()), Qt::AlignLeft | Qt::AlignVCenter, "-1");
+}
+
+void PlotWidget::requestSpectrum()
+{
+    // 同一时间只跑一个任务；完成后重绘时若数据或规格已变化会再次发起
+    if (spectrumWatcher->isRunning()) return;
+    
+    pendingSpectrumVersion = dataVersion;
+    pendingSpectrumSpec = spectrumSpec;
+    
+    // 后台任务持有数据副本，GUI 线程可以继续修改数据
+    std::vector<double> x = xData;
+    std::vector<std::vector<double>> series;
+    for (size_t i = 0; i < distributionSeriesCount(); ++i) {
+        series.push_back(distributionSeries(i));
+    }
+    SpectrumSpec spec = spectrumSpec;
+    
+    spectrumWatcher->setFuture(QtConcurrent::run([x, series, spec]() {
+        std::vector<SpectrumResult> results;
+        for (const std::vector<double>& y : series) {
+            results.push_back(SpectrumEngine::compute(x, y, spec));
+        }
+        return results;
+    }));
+}
+
+void PlotWidget::drawSpectrum(QPainter& painter)
+{
+    int margin = 80;
+    QRect plotRect = rect().adjusted(margin, margin, -margin, -margin);
+    
+    drawTitle(painter, plotRect);
+    drawGrid(painter, plotRect);
+    drawAxes(painter, plotRect);
+    
+    bool current = spectraValid && spectraVersion == dataVersion && spectraSpec == spectrumSpec;
+    if (!current) requestSpectrum();
+    
+    QFont axisFont("Microsoft YaHei", static_cast<int>(axisFontSize));
+    painter.setFont(axisFont);
+    if (!current) {
+        // 计算期间继续显示上一次的结果
+        painter.setPen(textColor);
+        painter.drawText(plotRect.adjusted(0, 4, -8, 0), Qt::AlignRight | Qt::AlignTop, "正在计算频谱…");
+    }
+    if (!spectraValid) return;
+    
+    // 纵轴用分贝，动态范围限制在峰值以下 120 dB
+    auto toDecibel = [](double p) { return 10.0 * std::log10(std::max(p, 1e-300)); };
+    double fMax = 0.0;
+    double dbMax = std::numeric_limits<double>::lowest();
+    for (const SpectrumResult& s : spectra) {
+        if (s.isEmpty()) continue;
+        fMax = std::max(fMax, s.frequency.back());
+        for (double p : s.power) dbMax = std::max(dbMax, toDecibel(p));
+    }
+    if (fMax <= 0.0) return;
+    double dbMin = dbMax - 120.0;
+    for (const SpectrumResult& s : spectra) {
+        for (double p : s.power) dbMin = std::min(dbMin, std::max(toDecibel(p), dbMax - 120.0));
+    }
+    double dbRange = dbMax - dbMin;
+    if (dbRange <= 0.0) dbRange = 1.0;
+    double yMin = dbMin - dbRange * 0.05;
+    double yMax = dbMax + dbRange * 0.05;
+    
+    auto scaleX = [&](double f) { return plotRect.left() + f / fMax * plotRect.width(); };
+    auto scaleY = [&](double db) { return plotRect.bottom() - (db - yMin) / (yMax - yMin) * plotRect.height(); };
+    
+    for (size_t i = 0; i < spectra.size(); ++i) {
+        const SpectrumResult& s = spectra[i];
+        if (s.isEmpty()) continue;
         
-        // 确保Y轴标签在左边界内
-        int textX = std::max(5, plotRect.left() - textWidth - 8);
-        painter.drawText(textX, y + 4, valueText);
+        // 频点远多于像素时，每个像素列只保留最大值，保证谱峰不丢
+        QPolygonF curve;
+        int lastColumn = std::numeric_limits<int>::min();
+        for (size_t k = 0; k < s.frequency.size(); ++k) {
+            double x = scaleX(s.frequency[k]);
+            double y = scaleY(std::max(toDecibel(s.power[k]), dbMin));
+            int column = (int)x;
+            if (column == lastColumn) {
+                if (y < curve.last().y()) curve.last().setY(y);
+                continue;
+            }
+            curve << QPointF(x, y);
+            lastColumn = column;
+        }
+        
+        QColor color = colors[i % colors.size()];
+        painter.setPen(QPen(color, std::max(1, lineWidth - 1)));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPolyline(curve);
+        
+        // 主峰标记
+        if (s.peakFrequency > 0.0) {
+            double px = scaleX(s.peakFrequency);
+            double py = scaleY(toDecibel(s.peakPower));
+            painter.setPen(QPen(color.darker(130), 1, Qt::DashLine));
+            painter.drawLine(QPointF(px, py), QPointF(px, plotRect.bottom()));
+            if (!isMultiSeries) {
+                painter.setPen(textColor);
+                painter.drawText(QPointF(px + 6, py - 6), QString("主频 %1").arg(s.peakFrequency, 0, 'g', 5));
+            }
+        }
     }
     
+    drawAxisLabels(painter, plotRect, 0.0, fMax, yMin, yMax);
+    drawLegend(painter, plotRect);
+}
+
+void PlotWidget::drawAxisLabels(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
+{
+    drawValueAxisLabels(painter, plotRect, yMin, yMax);
+    
+    QFont axisFont("Microsoft YaHei", static_cast<int>(axisFontSize));
+    painter.setFont(axisFont);
+    QFontMetrics fm(axisFont);
+    
     // X轴标签 - 确保标签不超出边界并且居中对齐
     for (int i = 0; i <= 5; ++i) {
         double value = xMin + (xMax - xMin) * i / 5.0;
@@ -812,6 +1505,53 @@ void PlotWidget::drawAxisLabels(QPainter& painter, const QRect& plotRect, double
     }
 }
 
+void PlotWidget::drawValueAxisLabels(QPainter& painter, const QRect& plotRect, double yMin, double yMax)
+{
+    painter.setPen(textColor);
+    QFont axisFont("Microsoft YaHei", static_cast<int>(axisFontSize));
+    painter.setFont(axisFont);
+    QFontMetrics fm(axisFont);
+    
+    // Y轴标签 - 确保标签不超出边界
+    for (int i = 0; i <= 5; ++i) {
+        double value = yMin + (yMax - yMin) * i / 5.0;
+        int y = plotRect.bottom() - (int)(plotRect.height() * i / 5.0);
+        QString valueText = QString::number(value, 'f', 1);
+        int textWidth = fm.width(valueText);
+        
+        // 确保Y轴标签在左边界内
+        int textX = std::max(5, plotRect.left() - textWidth - 8);
+        painter.drawText(textX, y + 4, valueText);
+    }
+}
+
+void PlotWidget::drawCategoryLabels(QPainter& painter, const QRect& plotRect, const std::vector<QString>& names)
+{
+    if (names.empty()) return;
+    
+    painter.setPen(textColor);
+    QFont axisFont("Microsoft YaHei", static_cast<int>(axisFontSize));
+    painter.setFont(axisFont);
+    
+    // 每个类别占一个等宽槽位，名称居中显示在槽位下方
+    double slotWidth = (double)plotRect.width() / names.size();
+    int textY = std::min(plotRect.bottom() + 4, height() - 20);
+    
+    // 类别很多时按最宽名称隔几个槽位标注一次，避免文字重叠
+    QFontMetrics fm(axisFont);
+    int widestName = 0;
+    for (const QString& name : names) {
+        widestName = std::max(widestName, fm.width(name));
+    }
+    size_t step = std::max<size_t>(1, (size_t)std::ceil((widestName + 6) / slotWidth));
+    double labelWidth = std::max(slotWidth, (double)widestName + 6);
+    for (size_t i = 0; i < names.size(); i += step) {
+        double center = plotRect.left() + slotWidth * (i + 0.5);
+        QRectF slot(center - labelWidth / 2, textY, labelWidth, 18);
+        painter.drawText(slot, Qt::AlignHCenter | Qt::AlignTop, names[i]);
+    }
+}
+
 void PlotWidget::drawLegend(QPainter& painter, const QRect& plotRect)
 {
     // 计算需要显示的项目
@@ -824,10 +1564,46 @@ void PlotWidget::drawLegend(QPainter& painter, const QRect& plotRect)
         }
     }
     
-    // 添加拟合线
-    if (hasFitting && !fittingTypeName.isEmpty()) {
+    // 添加叠加曲线（仅折线图绘制）
+    bool showOverlays = chartType == ChartType::Line;
+    if (showOverlays) {
+        for (const SeriesOverlay& overlay : overlays) {
+            legendItems.append(overlay.name);
+        }
+    }
+    
+    // 添加直方图上的分布拟合
+    bool showDistributions = chartType == ChartType::Histogram && distributionFitsVersion == dataVersion;
+    std::vector<size_t> shownFits;
+    if (showDistributions) {
+        for (size_t f = 0; f < distributionFits.size(); ++f) {
+            if (distributionFits[f].valid) {
+                shownFits.push_back(f);
+                legendItems.append(QString("%1 (A²=%2)")
+                                       .arg(DistributionFitter::name(distributionFits[f].type))
+                                       .arg(distributionFits[f].adStatistic, 0, 'g', 3));
+            }
+        }
+    }
+    
+    // 添加拟合线（直方图不画拟合线）
+    bool showFitting = hasFitting && !fittingTypeName.isEmpty() && chartType != ChartType::Histogram;
+    if (showFitting) {
         legendItems.append(fittingTypeName);
     }
+    bool showBand = showFitting && !isMultiSeries && !fittingBandX.empty();
+    if (showBand) {
+        legendItems.append(fittingBandLabel);
+    }
+    
+    // 添加多系列批量拟合，每条一项
+    bool showSeriesFits = isMultiSeries && seriesFitsVersion == dataVersion &&
+                          (chartType == ChartType::Line || chartType == ChartType::Scatter);
+    if (showSeriesFits) {
+        for (const SeriesFit& fit : seriesFits) {
+            legendItems.append(fit.name);
+        }
+    }
     
     // 如果没有任何项目，直接返回
     if (legendItems.isEmpty()) return;
@@ -884,8 +1660,42 @@ void PlotWidget::drawLegend(QPainter& painter, const QRect& plotRect)
         }
     }
     
+    // Draw overlay items
+    if (showOverlays) {
+        for (const SeriesOverlay& overlay : overlays) {
+            int itemY = legendY + 5 + itemIndex * itemHeight;
+            QColor overlayColor = colors[overlay.seriesIndex % colors.size()].darker(150);
+            
+            if (!overlay.lower.empty() && overlay.filled) {
+                QColor band = overlayColor;
+                band.setAlpha(60);
+                painter.fillRect(QRect(legendX + 8, itemY + 2, 12, 10), band);
+            } else {
+                painter.setPen(QPen(overlayColor, 2, overlay.lower.empty() ? Qt::SolidLine : Qt::DashLine));
+                painter.drawLine(legendX + 8, itemY + 7, legendX + 20, itemY + 7);
+            }
+            
+            painter.setPen(textColor);
+            painter.setBrush(Qt::NoBrush);
+            painter.drawText(legendX + 28, itemY + 11, overlay.name);
+            itemIndex++;
+        }
+    }
+    
+    // Draw distribution fit items
+    for (size_t f : shownFits) {
+        int itemY = legendY + 5 + itemIndex * itemHeight;
+        painter.setPen(QPen(colors[(f + 1) % colors.size()].darker(120), 2));
+        painter.drawLine(legendX + 8, itemY + 7, legendX + 20, itemY + 7);
+        
+        painter.setPen(textColor);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawText(legendX + 28, itemY + 11, legendItems[itemIndex]);
+        itemIndex++;
+    }
+    
     // Draw fitting line item
-    if (hasFitting && !fittingTypeName.isEmpty()) {
+    if (showFitting) {
         int itemY = legendY + 5 + itemIndex * itemHeight;
         QColor fittingColor = QColor(255, 0, 0); // 红色拟合线
         
@@ -897,9 +1707,96 @@ void PlotWidget::drawLegend(QPainter& painter, const QRect& plotRect)
         painter.setPen(textColor);
         painter.setBrush(Qt::NoBrush);
         painter.drawText(legendX + 28, itemY + 11, fittingTypeName);
+        itemIndex++;
+    }
+    
+    // 置信带：半透明色块
+    if (showBand) {
+        int itemY = legendY + 5 + itemIndex * itemHeight;
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor(255, 0, 0, 45));
+        painter.drawRect(legendX + 8, itemY + 2, 12, 10);
+        
+        painter.setPen(textColor);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawText(legendX + 28, itemY + 11, fittingBandLabel);
+        itemIndex++;
+    }
+    
+    // Draw series fit items：虚线颜色取所属系列的深色
+    if (showSeriesFits) {
+        for (const SeriesFit& fit : seriesFits) {
+            int itemY = legendY + 5 + itemIndex * itemHeight;
+            painter.setPen(QPen(colors[fit.seriesIndex % colors.size()].darker(150), 2, Qt::DashLine));
+            painter.drawLine(legendX + 8, itemY + 7, legendX + 20, itemY + 7);
+            
+            painter.setPen(textColor);
+            painter.setBrush(Qt::NoBrush);
+            painter.drawText(legendX + 28, itemY + 11, fit.name);
+            itemIndex++;
+        }
     }
 }
 
+void PlotWidget::drawOverlays(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
+{
+    if (overlays.empty() || xData.size() < 2) return;
+    
+    auto toScreen = [&](double x, double y) {
+        return QPointF(plotRect.left() + (x - xMin) / (xMax - xMin) * plotRect.width(),
+                       plotRect.bottom() - (y - yMin) / (yMax - yMin) * plotRect.height());
+    };
+    
+    painter.save();
+    painter.setClipRect(plotRect);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    
+    for (const SeriesOverlay& overlay : overlays) {
+        if (overlay.values.size() != xData.size()) continue;
+        bool isBand = overlay.lower.size() == overlay.values.size();
+        QColor overlayColor = colors[overlay.seriesIndex % colors.size()].darker(150);
+        
+        QPolygonF upper;
+        upper.reserve(static_cast<int>(xData.size()));
+        for (size_t i = 0; i < xData.size(); ++i) {
+            upper << toScreen(xData[i], overlay.values[i]);
+        }
+        
+        if (!isBand) {
+            painter.setPen(QPen(overlayColor, 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawPolyline(upper);
+            continue;
+        }
+        
+        QPolygonF lower;
+        lower.reserve(static_cast<int>(xData.size()));
+        for (size_t i = 0; i < xData.size(); ++i) {
+            lower << toScreen(xData[i], overlay.lower[i]);
+        }
+        
+        if (overlay.filled) {
+            // 上沿正向、下沿反向拼成闭合多边形
+            QPolygonF band = upper;
+            for (int i = lower.size() - 1; i >= 0; --i) {
+                band << lower[i];
+            }
+            QColor fill = overlayColor;
+            fill.setAlpha(50);
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(fill);
+            painter.drawPolygon(band);
+        } else {
+            painter.setPen(QPen(overlayColor, 1.5, Qt::DashLine));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawPolyline(upper);
+            painter.drawPolyline(lower);
+        }
+    }
+    
+    painter.restore();
+}
+
 void PlotWidget::drawMultiSeriesLineChart(QPainter& painter)
 {
     if (xData.empty() || ySeriesData.empty()) return;
@@ -911,6 +1808,19 @@ void PlotWidget::drawMultiSeriesLineChart(QPainter& painter)
     drawGrid(painter, plotRect);
     drawAxes(painter, plotRect);
     
+    if (useScatterDensity(xData.size() * ySeriesData.size())) {
+        std::vector<const std::vector<double>*> series;
+        for (const auto& ySeriesVec : ySeriesData) {
+            if (!ySeriesVec.empty() && ySeriesVec.size() == xData.size()) series.push_back(&ySeriesVec);
+        }
+        double xMin, xMax, yMin, yMax;
+        if (series.empty() || !drawScatterDensity(painter, plotRect, series, xMin, xMax, yMin, yMax)) return;
+        drawSeriesFits(painter, plotRect, xMin, xMax, yMin, yMax);
+        drawAxisLabels(painter, plotRect, xMin, xMax, yMin, yMax);
+        drawLegend(painter, plotRect);
+        return;
+    }
+    
     // Calculate combined data range
     double xMin = *std::min_element(xData.begin(), xData.end());
     double xMax = *std::max_element(xData.begin(), xData.end());
@@ -965,6 +1875,8 @@ void PlotWidget::drawMultiSeriesLineChart(QPainter& painter)
         }
     }
     
+    drawOverlays(painter, plotRect, xMin, xMax, yMin, yMax);
+    drawSeriesFits(painter, plotRect, xMin, xMax, yMin, yMax);
     drawAxisLabels(painter, plotRect, xMin, xMax, yMin, yMax);
     drawLegend(painter, plotRect);
 }
@@ -1021,6 +1933,7 @@ void PlotWidget::drawMultiSeriesScatterChart(QPainter& painter)
         }
     }
     
+    drawSeriesFits(painter, plotRect, xMin, xMax, yMin, yMax);
     drawAxisLabels(painter, plotRect, xMin, xMax, yMin, yMax);
     drawLegend(painter, plotRect);
 }
@@ -1037,6 +1950,21 @@ void PlotWidget::drawMainChart(QPainter& painter)
             case ChartType::Scatter:
                 drawMultiSeriesScatterChart(painter);
                 break;
+            case ChartType::BoxPlot:
+                drawBoxPlot(painter);
+                break;
+            case ChartType::ViolinPlot:
+                drawViolinPlot(painter);
+                break;
+            case ChartType::DensityPlot:
+                drawDensityPlot(painter);
+                break;
+            case ChartType::Heatmap:
+                drawHeatmap(painter);
+                break;
+            case ChartType::Spectrum:
+                drawSpectrum(painter);
+                break;
             default:
                 drawLineChart(painter);
                 break;
@@ -1070,11 +1998,18 @@ void PlotWidget::drawMainChart(QPainter& painter)
             case ChartType::AreaChart:
                 drawAreaChart(painter);
                 break;
+            case ChartType::Heatmap:
+                drawHeatmap(painter);
+                break;
+            case ChartType::Spectrum:
+                drawSpectrum(painter);
+                break;
         }
     }
     
-    // 绘制拟合线 (如果有)
-    if (hasFitting && (chartType == ChartType::Line || chartType == ChartType::Scatter)) {
+    // 绘制拟合线和峰值标记 (如果有)
+    bool showPeaks = !isMultiSeries && !peaks.empty() && peaksVersion == dataVersion;
+    if ((hasFitting || showPeaks) && !xData.empty() && (chartType == ChartType::Line || chartType == ChartType::Scatter)) {
         int margin = 80;
         QRect plotRect = rect().adjusted(margin, margin, -margin, -margin);
         
@@ -1097,49 +2032,186 @@ void PlotWidget::drawMainChart(QPainter& painter)
         yMax += yRange * 0.05;
         
         drawFittingLine(painter, plotRect, xMin, xMax, yMin, yMax);
+        if (hasFitting && !isMultiSeries) {
+            drawFitOutliers(painter, plotRect, xMin, xMax, yMin, yMax);
+        }
+        if (showPeaks) {
+            drawPeaks(painter, plotRect, xMin, xMax, yMin, yMax);
+        }
     }
 }
 
+void PlotWidget::drawPeaks(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
+{
+    auto toScreen = [&](double x, double y) {
+        return QPointF(plotRect.left() + (x - xMin) / (xMax - xMin) * plotRect.width(),
+                       plotRect.bottom() - (y - yMin) / (yMax - yMin) * plotRect.height());
+    };
+    
+    QColor peakColor(220, 53, 69);
+    painter.save();
+    painter.setClipRect(plotRect);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setFont(QFont("Microsoft YaHei", static_cast<int>(axisFontSize - 1)));
+    
+    // 峰很多时只给突起度最大的若干个标注数值，避免文字重叠
+    const size_t maxLabels = 10;
+    std::vector<double> prominences;
+    prominences.reserve(peaks.size());
+    for (const Peak& peak : peaks) {
+        prominences.push_back(peak.prominence);
+    }
+    double labelThreshold = -std::numeric_limits<double>::infinity();
+    if (prominences.size() > maxLabels) {
+        std::nth_element(prominences.begin(), prominences.begin() + (maxLabels - 1), prominences.end(), std::greater<double>());
+        labelThreshold = prominences[maxLabels - 1];
+    }
+    
+    for (const Peak& peak : peaks) {
+        QPointF top = toScreen(peak.position, peak.height);
+        
+        // 半高宽：在 widthHeight 处画一条横线
+        painter.setPen(QPen(peakColor, 1.5));
+        QPointF left = toScreen(peak.leftPosition, peak.widthHeight);
+        QPointF right = toScreen(peak.rightPosition, peak.widthHeight);
+        painter.drawLine(left, right);
+        
+        // 峰顶上方的倒三角
+        QPolygonF marker;
+        marker << QPointF(top.x(), top.y() - 4)
+               << QPointF(top.x() - 5, top.y() - 13)
+               << QPointF(top.x() + 5, top.y() - 13);
+        painter.setPen(QPen(peakColor.darker(130), 1));
+        painter.setBrush(peakColor);
+        painter.drawPolygon(marker);
+        
+        if (peak.prominence >= labelThreshold) {
+            painter.setPen(textColor);
+            painter.drawText(QPointF(top.x() + 7, top.y() - 10), QString::number(peak.position, 'g', 5));
+        }
+    }
+    
+    painter.restore();
+}
+
 void PlotWidget::drawFittingLine(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
 {
-    if (!hasFitting || fittingCoefficients.empty()) return;
+    if (!hasFitting || !fittingModel.isValid()) return;
     
+    if (!isMultiSeries) {
+        drawFittingBand(painter, plotRect, xMin, xMax, yMin, yMax);
+    }
+    painter.save();
+    painter.setClipRect(plotRect);
     painter.setPen(QPen(QColor(255, 0, 0), 3, Qt::DashLine));
+    drawFitCurve(painter, plotRect, xMin, xMax, yMin, yMax, fittingModel);
+    
+    // 分段回归的断点：竖直点划线，顶部标注位置
+    std::vector<double> breaks = fittingModel.breakpoints();
+    if (!breaks.empty()) {
+        painter.setPen(QPen(QColor(108, 117, 125), 1.5, Qt::DashDotLine));
+        painter.setFont(QFont("Microsoft YaHei", static_cast<int>(axisFontSize - 1)));
+        for (double breakpoint : breaks) {
+            if (breakpoint < xMin || breakpoint > xMax) continue;
+            double screenX = plotRect.left() + (breakpoint - xMin) / (xMax - xMin) * plotRect.width();
+            painter.drawLine(QPointF(screenX, plotRect.top()), QPointF(screenX, plotRect.bottom()));
+            painter.drawText(QPointF(screenX + 4, plotRect.top() + 14), QString::number(breakpoint, 'g', 5));
+        }
+    }
+    painter.restore();
+}
+
+// 置信带：上界从左到右、下界从右到左围成多边形，半透明填充在拟合曲线下层；非有限值处断开
+void PlotWidget::drawFittingBand(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
+{
+    if (fittingBandX.size() < 2) return;
     
-    int numPoints = 100;
-    QPointF prevPoint;
-    bool firstPoint = true;
+    auto toScreen = [&](double x, double y) {
+        double screenY = plotRect.bottom() - (y - yMin) / (yMax - yMin) * plotRect.height();
+        return QPointF(plotRect.left() + (x - xMin) / (xMax - xMin) * plotRect.width(),
+                       std::min(std::max(screenY, plotRect.top() - (double)plotRect.height()),
+                                plotRect.bottom() + (double)plotRect.height()));
+    };
     
-    for (int i = 0; i <= numPoints; ++i) {
-        double x = xMin + (xMax - xMin) * i / numPoints;
-        double y = 0.0;
-        
-        // 根据拟合类型计算y值
-        if (fittingDegree <= 2) {
-            // 多项式拟合
-            for (size_t j = 0; j < fittingCoefficients.size(); ++j) {
-                y += fittingCoefficients[j] * std::pow(x, j);
-            }
-        } else if (fittingDegree == 3 && fittingCoefficients.size() >= 4) {
-            // 正弦拟合: y = A*sin(B*x + C) + D
-            y = fittingCoefficients[0] * std::sin(fittingCoefficients[1] * x + fittingCoefficients[2]) + fittingCoefficients[3];
-        } else if (fittingDegree == 4 && fittingCoefficients.size() >= 3) {
-            // 高斯拟合: y = A*exp(-((x-B)/C)^2)
-            double arg = (x - fittingCoefficients[1]) / fittingCoefficients[2];
-            y = fittingCoefficients[0] * std::exp(-arg * arg);
+    painter.save();
+    painter.setClipRect(plotRect);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(255, 0, 0, 45));
+    size_t begin = 0;
+    for (size_t i = 0; i <= fittingBandX.size(); ++i) {
+        bool finite = i < fittingBandX.size() && std::isfinite(fittingBandLower[i]) && std::isfinite(fittingBandUpper[i]);
+        if (finite) continue;
+        if (i - begin >= 2) {
+            QPolygonF band;
+            for (size_t k = begin; k < i; ++k) band << toScreen(fittingBandX[k], fittingBandUpper[k]);
+            for (size_t k = i; k-- > begin;) band << toScreen(fittingBandX[k], fittingBandLower[k]);
+            painter.drawPolygon(band);
         }
-        
-        int screenX = plotRect.left() + (int)((x - xMin) / (xMax - xMin) * plotRect.width());
-        int screenY = plotRect.bottom() - (int)((y - yMin) / (yMax - yMin) * plotRect.height());
-        
-        QPointF currentPoint(screenX, screenY);
-        
-        if (!firstPoint && screenY >= plotRect.top() && screenY <= plotRect.bottom()) {
-            painter.drawLine(prevPoint, currentPoint);
+        begin = i + 1;
+    }
+    painter.restore();
+}
+
+void PlotWidget::drawSeriesFits(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
+{
+    if (seriesFits.empty() || seriesFitsVersion != dataVersion) return;
+    
+    painter.save();
+    painter.setClipRect(plotRect);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    for (const SeriesFit& fit : seriesFits) {
+        painter.setPen(QPen(colors[fit.seriesIndex % colors.size()].darker(150), 2, Qt::DashLine));
+        drawFitCurve(painter, plotRect, xMin, xMax, yMin, yMax, fit.model);
+    }
+    painter.restore();
+}
+
+// 稳健拟合的离群点：橙色空心圆加叉，内点保持原样
+void PlotWidget::drawFitOutliers(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax)
+{
+    if (fittingInliers.size() != xData.size() || yData.size() != xData.size()) return;
+    
+    QColor outlierColor(253, 126, 20);
+    painter.save();
+    painter.setClipRect(plotRect);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(outlierColor, 2));
+    painter.setBrush(Qt::NoBrush);
+    double radius = pointSize + 3;
+    for (size_t i = 0; i < xData.size(); ++i) {
+        if (fittingInliers[i]) continue;
+        QPointF center(plotRect.left() + (xData[i] - xMin) / (xMax - xMin) * plotRect.width(),
+                       plotRect.bottom() - (yData[i] - yMin) / (yMax - yMin) * plotRect.height());
+        painter.drawEllipse(center, radius, radius);
+        painter.drawLine(center + QPointF(-radius * 0.6, -radius * 0.6), center + QPointF(radius * 0.6, radius * 0.6));
+        painter.drawLine(center + QPointF(-radius * 0.6, radius * 0.6), center + QPointF(radius * 0.6, -radius * 0.6));
+    }
+    painter.restore();
+}
+
+// 用当前画笔画一条拟合曲线：采样点数随绘图区宽度和曲率自适应，无定义处断开
+void PlotWidget::drawFitCurve(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax,
+                              const FitModel& model)
+{
+    std::vector<double> xs, ys;
+    double pixelsPerY = plotRect.height() / (yMax - yMin);
+    model.sampleCurve(xMin, xMax, plotRect.width(), pixelsPerY, xs, ys);
+    
+    // 远离绘图区的点限制在上下各一个绘图区高度内，避免极大值使坐标溢出；超出部分被裁剪
+    double screenTop = plotRect.top() - plotRect.height();
+    double screenBottom = plotRect.bottom() + plotRect.height();
+    QPolygonF segment;
+    segment.reserve(static_cast<int>(xs.size()));
+    for (size_t i = 0; i <= xs.size(); ++i) {
+        if (i == xs.size() || !std::isfinite(ys[i])) {
+            if (segment.size() > 1) painter.drawPolyline(segment);
+            segment.clear();
+            continue;
         }
-        
-        prevPoint = currentPoint;
-        firstPoint = false;
+        double screenX = plotRect.left() + (xs[i] - xMin) / (xMax - xMin) * plotRect.width();
+        double screenY = plotRect.bottom() - (ys[i] - yMin) * pixelsPerY;
+        segment << QPointF(screenX, std::min(std::max(screenY, screenTop), screenBottom));
     }
 }
 
@@ -1191,6 +2263,10 @@ void PlotWidget::drawResidualChart(QPainter& painter, const QRect& chartRect)
         }
         
         QColor barColor = (residual > 0) ? QColor(100, 149, 237, 150) : QColor(220, 20, 60, 150);
+        // 稳健拟合的离群点用橙色
+        if (fittingInliers.size() == residuals.size() && !fittingInliers[i]) {
+            barColor = QColor(253, 126, 20, 200);
+        }
         painter.setBrush(barColor);
         painter.setPen(barColor.darker());
         painter.drawRect(x - barWidth/2, barY, barWidth, barHeight);
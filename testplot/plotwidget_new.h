@@ -19,6 +19,8 @@
 #include <QRect>
 #include <QPoint>
 #include <QPolygonF>
+#include <QImage>
+#include <QFutureWatcher>
 #include <vector>
 #include <map>
 #include <QString>
@@ -27,6 +29,17 @@
 #include <numeric>
 #include <cmath>
 #include <limits>
+#include "statistics_accumulator.h"
+#include "histogram_engine.h"
+#include "kde_engine.h"
+#include "box_summary.h"
+#include "line_decimation.h"
+#include "density_raster.h"
+#include "correlation_engine.h"
+#include "spectrum_engine.h"
+#include "peak_finder.h"
+#include "distribution_fit.h"
+#include "fit_model.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -41,7 +54,25 @@ enum class ChartType {
     BoxPlot,
     ViolinPlot,
     DensityPlot,
-    AreaChart
+    AreaChart,
+    Heatmap,
+    Spectrum
+};
+
+// 叠加在折线图上的派生曲线（如滑动窗口统计），与 xData 等长
+struct SeriesOverlay {
+    QString name;
+    size_t seriesIndex = 0;        // 所属系列，决定颜色
+    std::vector<double> values;    // 折线；lower 非空时为带状区域的上沿
+    std::vector<double> lower;     // 带状区域的下沿
+    bool filled = true;            // 带状区域填充半透明色，否则上下沿画虚线
+};
+
+// 多系列批量拟合中一条系列的拟合曲线
+struct SeriesFit {
+    QString name;                  // 图例文字
+    size_t seriesIndex = 0;        // 所属系列，决定颜色
+    FitModel model;
 };
 
 class PlotWidget : public QWidget
@@ -55,6 +86,7 @@ public:
     void setData(const std::vector<double>& data);
     void setData(const std::vector<std::vector<double>>& allData, int xCol, int yCol);
     void setMultiSeriesData(const std::vector<double>& x, const std::vector<std::vector<double>>& ySeries, const std::vector<QString>& seriesNames);
+    void appendData(const std::vector<double>& x, const std::vector<double>& y);
     void setLabels(const std::vector<QString>& labels);
     void clearData();
     void setChartType(ChartType type);
@@ -65,8 +97,22 @@ public:
     void setLineWidth(int width);
     void setPointSize(int size);
     void setFontSizes(double title, double label, double axis);
-    void setPolynomialFitting(int degree, const std::vector<double>& coefficients, const std::vector<double>& residuals, const QString& typeName = "多项式拟合");
+    void setHistogramBinSpec(const BinSpec& spec);
+    void setKdeBandwidthRule(BandwidthRule rule);
+    void setCorrelationMatrix(const CorrelationMatrix& matrix, const std::vector<QString>& names);
+    void setSpectrumSpec(const SpectrumSpec& spec);
+    void setScatterDensitySpec(const ScatterDensitySpec& spec);
+    void setOverlays(const std::vector<SeriesOverlay>& overlays);
+    void setPeaks(const std::vector<Peak>& peaks);
+    void setDistributionFits(const std::vector<DistributionFit>& fits);
+    // inliers 非空时（稳健拟合）在散点/折线图和残差图中标出离群点
+    void setFitting(const FitModel& model, const std::vector<double>& residuals, const QString& typeName = "多项式拟合",
+                    const std::vector<char>& inliers = std::vector<char>());
     void clearFitting();
+    // 拟合曲线的逐点置信带（bootstrap），画成曲线周围的半透明区域；设置新的拟合时清除
+    void setFittingBand(const std::vector<double>& x, const std::vector<double>& lower, const std::vector<double>& upper,
+                        const QString& label);
+    void setSeriesFits(const std::vector<SeriesFit>& fits);
 
 public slots:
     void resetView();
@@ -81,6 +127,7 @@ protected:
 
 private:
     void calculateStatistics();
+    void updateStatisticsText();
     void drawNoDataMessage(QPainter& painter);
     void drawTitle(QPainter& painter, const QRect& plotRect);
     void drawAxes(QPainter& painter, const QRect& plotRect);
@@ -94,13 +141,35 @@ private:
     void drawViolinPlot(QPainter& painter);
     void drawDensityPlot(QPainter& painter);
     void drawAreaChart(QPainter& painter);
+    void drawHeatmap(QPainter& painter);
+    void rebuildHeatmapImage();
+    void drawSpectrum(QPainter& painter);
+    void requestSpectrum();
     void drawAxisLabels(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax);
+    void drawValueAxisLabels(QPainter& painter, const QRect& plotRect, double yMin, double yMax);
+    void drawCategoryLabels(QPainter& painter, const QRect& plotRect, const std::vector<QString>& names);
     void drawLegend(QPainter& painter, const QRect& plotRect);
     void drawMultiSeriesLineChart(QPainter& painter);
     void drawMultiSeriesScatterChart(QPainter& painter);
+    bool useScatterDensity(size_t points) const;
+    bool drawScatterDensity(QPainter& painter, const QRect& plotRect, const std::vector<const std::vector<double>*>& series,
+                            double& xMin, double& xMax, double& yMin, double& yMax);
+    void drawOverlays(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax);
+    void drawPeaks(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax);
     void drawFittingLine(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax);
+    void drawFitCurve(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax,
+                      const FitModel& model);
+    void drawSeriesFits(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax);
+    void drawFitOutliers(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax);
+    void clearFittingBand();
+    void drawFittingBand(QPainter& painter, const QRect& plotRect, double xMin, double xMax, double yMin, double yMax);
     void drawResidualChart(QPainter& painter, const QRect& plotRect);
     void drawMainChart(QPainter& painter);
+    size_t distributionSeriesCount() const;
+    const std::vector<double>& distributionSeries(size_t index) const;
+    std::vector<QString> distributionSeriesNames() const;
+    const KdeResult& seriesDensity(size_t index);
+    const std::vector<BoxSummary>& seriesBoxSummaries();
 
 private:
     ChartType chartType;
@@ -133,6 +202,72 @@ private:
     double axisFontSize = 9.0;
     
     QMap<QString, QString> statistics;
+    StatisticsAccumulator yStatistics; // yData 的增量统计，追加数据时只累加新增部分
+    
+    // 数据版本号：任何数据变化都会递增，供各类缓存判断是否失效
+    uint64_t dataVersion = 0;
+    
+    // 直方图缓存
+    HistogramEngine histogramEngine;
+    BinSpec histogramBinSpec;
+    
+    // 核密度估计缓存（密度图、小提琴图共用）
+    KdeEngine kdeEngine;
+    KdeSpec kdeSpec;
+    BoxSummaryEngine boxSummaryEngine;
+    
+    // 折线图的 min/max 金字塔，按屏幕像素列抽取
+    LineDecimationEngine lineDecimationEngine;
+    
+    // 散点密度图：数据范围按数据版本缓存，上色后的图像再按 (缩放平移, 绘图区, 规格) 缓存
+    ScatterDensitySpec scatterDensitySpec;
+    struct DensityCache {
+        bool rangeValid = false;
+        uint64_t rangeVersion = 0;
+        double xMin = 0.0;
+        double xMax = 0.0;
+        double yMin = 0.0;
+        double yMax = 0.0;
+        bool imageValid = false;
+        uint64_t imageVersion = 0;
+        double zoom = 1.0;
+        QPointF pan;
+        QRect plotRect;
+        QImage image;
+        QRectF target;          // 图像在逻辑坐标中的位置，经缩放平移后与设备像素一一对应
+    };
+    DensityCache densityCache;
+    
+    // 热力图：相关矩阵由外部计算后传入，按像素写入 QImage 后整体缩放绘制
+    CorrelationMatrix correlationMatrix;
+    std::vector<QString> correlationNames;
+    QImage heatmapImage;
+    bool heatmapImageDirty = true;
+    
+    // 频谱：窗函数和 Welch 平均在后台线程计算，完成后按 (数据版本, 规格) 保存
+    SpectrumSpec spectrumSpec;
+    std::vector<SpectrumResult> spectra;    // 每个系列一条
+    uint64_t spectraVersion = 0;
+    SpectrumSpec spectraSpec;
+    bool spectraValid = false;
+    QFutureWatcher<std::vector<SpectrumResult>>* spectrumWatcher;
+    uint64_t pendingSpectrumVersion = 0;
+    SpectrumSpec pendingSpectrumSpec;
+    
+    // 折线图叠加曲线，由外部计算后传入
+    std::vector<SeriesOverlay> overlays;
+    
+    // 寻峰结果，只在设置时的数据版本上显示
+    std::vector<Peak> peaks;
+    uint64_t peaksVersion = 0;
+    
+    // 直方图上叠加的分布拟合曲线，同样绑定数据版本
+    std::vector<DistributionFit> distributionFits;
+    uint64_t distributionFitsVersion = 0;
+    
+    // 多系列批量拟合曲线，绑定数据版本
+    std::vector<SeriesFit> seriesFits;
+    uint64_t seriesFitsVersion = 0;
     
     // Zoom and pan variables
     double zoomFactor;
@@ -142,8 +277,12 @@ private:
     
     // Polynomial fitting variables
     bool hasFitting;
-    int fittingDegree;
-    std::vector<double> fittingCoefficients;
+    FitModel fittingModel;
+    std::vector<char> fittingInliers; // 稳健拟合的内点标记，与 xData 等长
+    std::vector<double> fittingBandX;  // 置信带，空表示没有
+    std::vector<double> fittingBandLower;
+    std::vector<double> fittingBandUpper;
+    QString fittingBandLabel;
     std::vector<double> residuals;
     bool showResidualChart;
     QString fittingTypeName; // 拟合类型名称，用于legend显示
@@ -0,0 +1,249 @@
+#include "polynomial_fit.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const size_t BlockRows = 256;
+// 每段数据各自累积一个 R 因子，段长固定，合并顺序只取决于段序号
+const size_t SegmentRows = 1 << 16;
+
+// (cols × cols) 上三角 R 因子，按行存储
+class TriangularAccumulator
+{
+public:
+    explicit TriangularAccumulator(size_t columns)
+        : cols(columns), r(columns * columns, 0.0) {}
+
+    // 把按列存储的 rows × cols 块 B 并入 R：对 [R; B] 逐列做 Householder 变换
+    // R 的第 j 列在对角线以下为 0，所以反射向量只有 R(j,j) 和 B 的第 j 列非零
+    void absorb(double* block, size_t rows)
+    {
+        for (size_t j = 0; j < cols; ++j) {
+            double* bj = block + j * rows;
+            double norm2 = 0.0;
+            for (size_t i = 0; i < rows; ++i) norm2 += bj[i] * bj[i];
+            if (norm2 == 0.0) continue;
+
+            double alpha = r[j * cols + j];
+            double beta = -std::copysign(std::sqrt(alpha * alpha + norm2), alpha);
+            double v0 = alpha - beta;
+            double scale = 2.0 / (v0 * v0 + norm2);
+
+            for (size_t k = j + 1; k < cols; ++k) {
+                double* bk = block + k * rows;
+                double w = v0 * r[j * cols + k];
+                for (size_t i = 0; i < rows; ++i) w += bj[i] * bk[i];
+                double f = scale * w;
+                r[j * cols + k] -= f * v0;
+                for (size_t i = 0; i < rows; ++i) bk[i] -= f * bj[i];
+            }
+            r[j * cols + j] = beta;
+        }
+    }
+
+    // 另一个 R 因子当作 cols 行的块并入
+    void merge(const TriangularAccumulator& other)
+    {
+        std::vector<double> block(cols * cols);
+        for (size_t i = 0; i < cols; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                block[j * cols + i] = other.r[i * cols + j];
+            }
+        }
+        absorb(block.data(), cols);
+    }
+
+    double at(size_t i, size_t j) const { return r[i * cols + j]; }
+
+private:
+    size_t cols;
+    std::vector<double> r;
+};
+
+// 按列填充一块的基函数值，最后一列为 y；有权重时每行乘以 sqrt(w)
+void fillBlock(const double* x, const double* y, const double* weights, size_t rows, int degree, PolynomialBasis basis,
+               double center, double inverseHalfRange, double* block)
+{
+    double* t = block + rows * std::min(1, degree);
+    for (size_t i = 0; i < rows; ++i) block[i] = 1.0;
+    if (degree >= 1) {
+        for (size_t i = 0; i < rows; ++i) t[i] = (x[i] - center) * inverseHalfRange;
+    }
+    for (int k = 2; k <= degree; ++k) {
+        double* current = block + k * rows;
+        const double* previous = block + (k - 1) * rows;
+        if (basis == PolynomialBasis::Chebyshev) {
+            const double* older = block + (k - 2) * rows;
+            for (size_t i = 0; i < rows; ++i) current[i] = 2.0 * t[i] * previous[i] - older[i];
+        } else {
+            for (size_t i = 0; i < rows; ++i) current[i] = t[i] * previous[i];
+        }
+    }
+    std::copy(y, y + rows, block + (degree + 1) * rows);
+    if (weights) {
+        for (size_t i = 0; i < rows; ++i) {
+            double scale = std::sqrt(weights[i]);
+            for (int k = 0; k <= degree + 1; ++k) block[k * rows + i] *= scale;
+        }
+    }
+}
+
+// Chebyshev 系数转换为幂次系数：T_{k+1} = 2t T_k - T_{k-1}
+std::vector<double> chebyshevToMonomial(const std::vector<double>& c)
+{
+    size_t m = c.size();
+    std::vector<double> result(m, 0.0);
+    std::vector<double> older(m, 0.0), previous(m, 0.0), current(m, 0.0);
+    older[0] = 1.0;
+    if (m > 0) result[0] += c[0];
+    if (m > 1) {
+        previous[1] = 1.0;
+        result[1] += c[1];
+    }
+    for (size_t k = 2; k < m; ++k) {
+        for (size_t p = 0; p < m; ++p) {
+            current[p] = (p > 0 ? 2.0 * previous[p - 1] : 0.0) - older[p];
+            result[p] += c[k] * current[p];
+        }
+        older.swap(previous);
+        previous.swap(current);
+    }
+    return result;
+}
+
+} // namespace
+
+double PolynomialFit::evaluate(double x) const
+{
+    if (!valid || coefficients.empty()) return 0.0;
+    double t = (x - center) / halfRange;
+    if (basis == PolynomialBasis::Chebyshev) {
+        // Clenshaw 递推
+        double b1 = 0.0, b2 = 0.0;
+        for (size_t k = coefficients.size(); k-- > 1;) {
+            double b0 = 2.0 * t * b1 - b2 + coefficients[k];
+            b2 = b1;
+            b1 = b0;
+        }
+        return t * b1 - b2 + coefficients[0];
+    }
+    double value = 0.0;
+    for (size_t k = coefficients.size(); k-- > 0;) {
+        value = value * t + coefficients[k];
+    }
+    return value;
+}
+
+void PolynomialFit::evaluate(const double* x, size_t count, double* values) const
+{
+    parallelForChunks(count, parallelChunkCount(count), [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) values[i] = evaluate(x[i]);
+    });
+}
+
+std::vector<double> PolynomialFit::scaledMonomialCoefficients() const
+{
+    return basis == PolynomialBasis::Chebyshev ? chebyshevToMonomial(coefficients) : coefficients;
+}
+
+std::vector<double> PolynomialFit::monomialCoefficients() const
+{
+    // Horner 形式展开 sum a_k ((x - center) / halfRange)^k
+    std::vector<double> a = scaledMonomialCoefficients();
+    if (a.empty()) return a;
+    double slope = 1.0 / halfRange;
+    double intercept = -center / halfRange;
+    std::vector<double> result(1, a.back());
+    for (size_t k = a.size() - 1; k-- > 0;) {
+        std::vector<double> next(result.size() + 1, 0.0);
+        for (size_t p = 0; p < result.size(); ++p) {
+            next[p] += result[p] * intercept;
+            next[p + 1] += result[p] * slope;
+        }
+        next[0] += a[k];
+        result.swap(next);
+    }
+    return result;
+}
+
+PolynomialFit PolynomialFitter::fit(const std::vector<double>& x, const std::vector<double>& y, int degree,
+                                    PolynomialBasis basis, FitProgress* progress)
+{
+    if (x.size() != y.size()) return PolynomialFit();
+    return fit(x.data(), y.data(), x.size(), degree, basis, progress);
+}
+
+PolynomialFit PolynomialFitter::fit(const double* x, const double* y, size_t count, int degree,
+                                    PolynomialBasis basis, FitProgress* progress, const double* weights)
+{
+    PolynomialFit result;
+    result.degree = degree;
+    result.basis = basis;
+    result.count = count;
+    if (degree < 0 || count <= static_cast<size_t>(degree)) return result;
+
+    size_t chunks = parallelChunkCount(count);
+
+    // 第一遍：x 的范围，用于映射到 [-1, 1]
+    std::vector<double> lows(chunks), highs(chunks);
+    parallelForChunks(count, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        auto range = std::minmax_element(x + begin, x + end);
+        lows[chunk] = *range.first;
+        highs[chunk] = *range.second;
+    });
+    double xMin = *std::min_element(lows.begin(), lows.end());
+    double xMax = *std::max_element(highs.begin(), highs.end());
+    if (!std::isfinite(xMin) || !std::isfinite(xMax)) return result;
+    if (xMax == xMin && degree > 0) return result;
+    result.center = 0.5 * (xMin + xMax);
+    result.halfRange = xMax > xMin ? 0.5 * (xMax - xMin) : 1.0;
+    double inverseHalfRange = 1.0 / result.halfRange;
+
+    // 第二遍：各段流式累积 R 因子，再按段序号合并
+    size_t cols = static_cast<size_t>(degree) + 2;
+    size_t segments = (count + SegmentRows - 1) / SegmentRows;
+    std::vector<TriangularAccumulator> partials(segments, TriangularAccumulator(cols));
+    std::atomic<size_t> finished(0);
+    parallelForEach(segments, [&](size_t segment) {
+        if (progress && progress->isCancelled()) return;
+        size_t begin = segment * SegmentRows;
+        size_t end = std::min(count, begin + SegmentRows);
+        std::vector<double> block(BlockRows * cols);
+        for (size_t start = begin; start < end; start += BlockRows) {
+            size_t rows = std::min(BlockRows, end - start);
+            fillBlock(x + start, y + start, weights ? weights + start : nullptr, rows, degree, basis,
+                      result.center, inverseHalfRange, block.data());
+            partials[segment].absorb(block.data(), rows);
+        }
+        if (progress) progress->fraction.store(static_cast<double>(++finished) / segments);
+    });
+    if (progress && progress->isCancelled()) return result;
+    for (size_t segment = 1; segment < segments; ++segment) {
+        partials[0].merge(partials[segment]);
+    }
+    const TriangularAccumulator& r = partials[0];
+
+    // 秩检查：对角元相对最大对角元过小视为奇异
+    size_t m = cols - 1;
+    double largest = 0.0;
+    for (size_t j = 0; j < m; ++j) largest = std::max(largest, std::abs(r.at(j, j)));
+    double threshold = largest * 1e-13 * std::sqrt(static_cast<double>(m));
+    for (size_t j = 0; j < m; ++j) {
+        if (!(std::abs(r.at(j, j)) > threshold)) return result;
+    }
+
+    // 回代 R c = Q^T y
+    result.coefficients.assign(m, 0.0);
+    for (size_t j = m; j-- > 0;) {
+        double value = r.at(j, m);
+        for (size_t k = j + 1; k < m; ++k) value -= r.at(j, k) * result.coefficients[k];
+        result.coefficients[j] = value / r.at(j, j);
+    }
+    result.residualSumOfSquares = r.at(m, m) * r.at(m, m);
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef POLYNOMIAL_FIT_H
+#define POLYNOMIAL_FIT_H
+
+#include <vector>
+#include <cstddef>
+#include "fit_progress.h"
+
+// 多项式基函数，自变量先线性映射到 t = (x - center) / halfRange ∈ [-1, 1]
+enum class PolynomialBasis {
+    Monomial,     // 1, t, t^2, ...
+    Chebyshev     // T0(t), T1(t), T2(t), ...（正交基，高次时条件数小得多）
+};
+
+struct PolynomialFit {
+    bool valid = false;                // 点数不足、x 全相同或设计矩阵秩亏时为 false
+    int degree = 0;
+    PolynomialBasis basis = PolynomialBasis::Chebyshev;
+    double center = 0.0;
+    double halfRange = 1.0;
+    std::vector<double> coefficients;  // 关于 t 的基函数系数
+    double residualSumOfSquares = 0.0; // 由 R 因子最后一个对角元直接得到
+    size_t count = 0;
+
+    double evaluate(double x) const;
+    // 关于 t 的幂次系数 a0 + a1 t + ...
+    std::vector<double> scaledMonomialCoefficients() const;
+    // 关于原始 x 的幂次系数；次数高且 |center| 远大于 halfRange 时会损失精度
+    std::vector<double> monomialCoefficients() const;
+    // 对一组点求值，分块并行
+    void evaluate(const double* x, size_t count, double* values) const;
+};
+
+// 最小二乘多项式拟合：按块流式构造 [基函数 | y] 的行，用 Householder 变换逐块并入
+// (degree + 2) 阶上三角 R 因子，内存 O(m^2)，不形成 n×m 设计矩阵也不形成正规方程
+// 数据按固定长度分段并行：每段各自累积 R，再按段序号合并，结果与线程数无关
+class PolynomialFitter
+{
+public:
+    // progress 非空时按已处理的段更新完成度；取消后返回 valid = false
+    static PolynomialFit fit(const std::vector<double>& x, const std::vector<double>& y, int degree,
+                             PolynomialBasis basis = PolynomialBasis::Chebyshev, FitProgress* progress = nullptr);
+    // weights 非空时做加权最小二乘（每行乘以 sqrt(w)，权为 0 的点不参与），residualSumOfSquares 为加权残差平方和
+    static PolynomialFit fit(const double* x, const double* y, size_t count, int degree,
+                             PolynomialBasis basis = PolynomialBasis::Chebyshev, FitProgress* progress = nullptr,
+                             const double* weights = nullptr);
+};
+
+#endif // POLYNOMIAL_FIT_H
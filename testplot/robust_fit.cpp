@@ -0,0 +1,279 @@
+#include "robust_fit.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+const double MadToSigma = 1.4826;
+
+// 原地求中位数（上中位数），会打乱 values
+double median(std::vector<double>& values)
+{
+    if (values.empty()) return 0.0;
+    auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+// SplitMix64：每个 RANSAC 假设用 (seed, 序号) 派生一条独立的流
+uint64_t nextRandom(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void computeResiduals(const PolynomialFit& fit, const std::vector<double>& x, const std::vector<double>& y,
+                      std::vector<double>& residuals)
+{
+    residuals.resize(x.size());
+    fit.evaluate(x.data(), x.size(), residuals.data());
+    for (size_t i = 0; i < x.size(); ++i) residuals[i] = y[i] - residuals[i];
+}
+
+double robustScale(const std::vector<double>& residuals)
+{
+    std::vector<double> magnitudes(residuals.size());
+    for (size_t i = 0; i < residuals.size(); ++i) magnitudes[i] = std::abs(residuals[i]);
+    return MadToSigma * median(magnitudes);
+}
+
+double largestChange(const std::vector<double>& a, const std::vector<double>& b)
+{
+    if (a.size() != b.size()) return std::numeric_limits<double>::infinity();
+    double change = 0.0, size = 1.0;
+    for (size_t k = 0; k < a.size(); ++k) {
+        change = std::max(change, std::abs(a[k] - b[k]));
+        size = std::max(size, std::abs(b[k]));
+    }
+    return change / size;
+}
+
+struct Hypothesis {
+    double cost = std::numeric_limits<double>::infinity();
+    size_t index = std::numeric_limits<size_t>::max();
+    PolynomialFit fit;
+
+    bool betterThan(const Hypothesis& other) const
+    {
+        return cost < other.cost || (cost == other.cost && index < other.index);
+    }
+};
+
+RobustFitResult fitRansac(const std::vector<double>& x, const std::vector<double>& y, int degree,
+                          const RobustFitOptions& options)
+{
+    RobustFitResult result;
+    FitProgress* progress = options.progress;
+    size_t n = x.size();
+    size_t sampleSize = static_cast<size_t>(degree) + 1;
+
+    double threshold = options.ransacThreshold;
+    if (!(threshold > 0.0)) threshold = 3.0 * RobustFitter::noiseScale(x, y);
+    if (!(threshold > 0.0)) {
+        double largest = 0.0;
+        for (double v : y) largest = std::max(largest, std::abs(v));
+        threshold = 1e-12 * std::max(1.0, largest);
+    }
+    double threshold2 = threshold * threshold;
+
+    // 评分用的等间隔子集
+    size_t stride = std::max<size_t>(1, n / std::max<size_t>(1, options.ransacScoringPoints));
+    std::vector<double> scoreX, scoreY;
+    for (size_t i = 0; i < n; i += stride) {
+        scoreX.push_back(x[i]);
+        scoreY.push_back(y[i]);
+    }
+
+    size_t hypotheses = static_cast<size_t>(std::max(1, options.ransacHypotheses));
+    size_t chunks = std::min<size_t>(hypotheses, workerThreadCount());
+    std::vector<Hypothesis> best(chunks);
+    std::atomic<size_t> finished(0);
+    parallelForChunks(hypotheses, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<size_t> sample(sampleSize);
+        std::vector<double> sampleX(sampleSize), sampleY(sampleSize);
+        for (size_t h = begin; h < end; ++h) {
+            if (progress && progress->isCancelled()) return;
+            uint64_t state = options.seed ^ ((h + 1) * 0xD1B54A32D192ED03ULL);
+            for (size_t k = 0; k < sampleSize; ++k) {
+                size_t index;
+                do {
+                    index = static_cast<size_t>(nextRandom(state) % n);
+                } while (std::find(sample.begin(), sample.begin() + k, index) != sample.begin() + k);
+                sample[k] = index;
+                sampleX[k] = x[index];
+                sampleY[k] = y[index];
+            }
+            PolynomialFit candidate = PolynomialFitter::fit(sampleX.data(), sampleY.data(), sampleSize, degree);
+            if (candidate.valid) {
+                // MSAC：残差平方截断在阈值处，比单纯计数更能区分内点数相同的假设
+                double cost = 0.0;
+                for (size_t i = 0; i < scoreX.size(); ++i) {
+                    double r = scoreY[i] - candidate.evaluate(scoreX[i]);
+                    cost += std::min(r * r, threshold2);
+                }
+                Hypothesis hypothesis;
+                hypothesis.cost = cost;
+                hypothesis.index = h;
+                if (hypothesis.betterThan(best[chunk])) {
+                    hypothesis.fit = std::move(candidate);
+                    best[chunk] = std::move(hypothesis);
+                }
+            }
+            size_t done = ++finished;
+            if (progress && done % 16 == 0) progress->fraction.store(static_cast<double>(done) / hypotheses);
+        }
+    });
+    if (progress && progress->isCancelled()) return result;
+
+    Hypothesis winner;
+    for (const Hypothesis& candidate : best) {
+        if (candidate.betterThan(winner)) winner = candidate;
+    }
+    if (!winner.fit.valid) return result;
+
+    // 用最优假设的内点做普通最小二乘，再按新的残差重新划分内点，共两轮
+    std::vector<double> residuals, weights(n);
+    PolynomialFit current = winner.fit;
+    for (int round = 0; round < 2; ++round) {
+        computeResiduals(current, x, y, residuals);
+        size_t inliers = 0;
+        for (size_t i = 0; i < n; ++i) {
+            weights[i] = std::abs(residuals[i]) <= threshold ? 1.0 : 0.0;
+            inliers += weights[i] > 0.0;
+        }
+        if (inliers <= sampleSize) break;
+        PolynomialFit refit = PolynomialFitter::fit(x.data(), y.data(), n, degree, PolynomialBasis::Chebyshev,
+                                                    progress, weights.data());
+        if (!refit.valid) break;
+        current = std::move(refit);
+    }
+
+    computeResiduals(current, x, y, residuals);
+    result.inliers.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        result.inliers[i] = std::abs(residuals[i]) <= threshold;
+        result.inlierCount += result.inliers[i];
+    }
+    result.fit = std::move(current);
+    result.scale = threshold / 3.0;
+    result.iterations = static_cast<int>(hypotheses);
+    return result;
+}
+
+RobustFitResult fitIrls(const std::vector<double>& x, const std::vector<double>& y, int degree,
+                        const RobustFitOptions& options)
+{
+    RobustFitResult result;
+    FitProgress* progress = options.progress;
+    size_t n = x.size();
+
+    PolynomialFit current = PolynomialFitter::fit(x.data(), y.data(), n, degree, PolynomialBasis::Chebyshev, progress);
+    if (!current.valid) return result;
+
+    std::vector<double> residuals, weights(n, 1.0);
+    double scale = 0.0;
+    // Tukey 的目标非凸，先用 Huber 得到稳定的起点，再固定尺度做双平方加权
+    bool tukey = options.method == RobustMethod::Tukey;
+    for (int phase = tukey ? 0 : 1; phase < 2; ++phase) {
+        bool biweight = tukey && phase == 1;
+        for (int iteration = 0; iteration < options.maxIterations; ++iteration) {
+            if (progress && progress->isCancelled()) return RobustFitResult();
+            computeResiduals(current, x, y, residuals);
+            if (!biweight || iteration == 0) scale = robustScale(residuals);
+            if (!(scale > 0.0)) break;   // 多数点被精确拟合
+
+            double objective = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                double u = residuals[i] / scale;
+                double a = std::abs(u);
+                if (biweight) {
+                    double v = u / options.tukeyC;
+                    weights[i] = a < options.tukeyC ? (1.0 - v * v) * (1.0 - v * v) : 0.0;
+                } else {
+                    weights[i] = a <= options.huberK ? 1.0 : options.huberK / a;
+                }
+                objective += weights[i] * residuals[i] * residuals[i];
+            }
+
+            PolynomialFit next = PolynomialFitter::fit(x.data(), y.data(), n, degree, PolynomialBasis::Chebyshev,
+                                                       progress, weights.data());
+            if (!next.valid) break;
+            double change = largestChange(next.coefficients, current.coefficients);
+            current = std::move(next);
+            ++result.iterations;
+            if (progress) {
+                progress->iteration.store(result.iterations);
+                progress->objective.store(objective);
+            }
+            if (change <= options.tolerance) break;
+        }
+    }
+
+    computeResiduals(current, x, y, residuals);
+    if (!tukey) scale = robustScale(residuals);
+    result.inliers.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        double a = scale > 0.0 ? std::abs(residuals[i]) / scale : 0.0;
+        result.inliers[i] = tukey ? a < options.tukeyC : a <= 2.5;
+        result.inlierCount += result.inliers[i];
+    }
+    result.fit = std::move(current);
+    result.scale = scale;
+    return result;
+}
+
+} // namespace
+
+RobustFitResult RobustFitter::fitPolynomial(const std::vector<double>& x, const std::vector<double>& y, int degree,
+                                            const RobustFitOptions& options)
+{
+    if (x.size() != y.size() || degree < 0 || x.size() <= static_cast<size_t>(degree) + 1) {
+        return RobustFitResult();
+    }
+    switch (options.method) {
+    case RobustMethod::Ransac:
+        return fitRansac(x, y, degree, options);
+    case RobustMethod::Huber:
+    case RobustMethod::Tukey:
+        return fitIrls(x, y, degree, options);
+    case RobustMethod::LeastSquares:
+        break;
+    }
+    RobustFitResult result;
+    result.fit = PolynomialFitter::fit(x, y, degree, PolynomialBasis::Chebyshev, options.progress);
+    return result;
+}
+
+const char* RobustFitter::methodName(RobustMethod method)
+{
+    switch (method) {
+    case RobustMethod::LeastSquares: return "最小二乘";
+    case RobustMethod::Ransac: return "RANSAC";
+    case RobustMethod::Huber: return "Huber";
+    case RobustMethod::Tukey: return "Tukey";
+    }
+    return "";
+}
+
+double RobustFitter::noiseScale(const std::vector<double>& x, const std::vector<double>& y)
+{
+    size_t n = std::min(x.size(), y.size());
+    if (n < 3) return 0.0;
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&x](size_t a, size_t b) { return x[a] < x[b]; });
+
+    std::vector<double> differences(n - 1);
+    for (size_t i = 0; i + 1 < n; ++i) differences[i] = y[order[i + 1]] - y[order[i]];
+    std::vector<double> copy = differences;
+    double center = median(copy);
+    for (double& d : differences) d = std::abs(d - center);
+    // 相邻差分的方差是噪声方差的两倍
+    return MadToSigma * median(differences) / std::sqrt(2.0);
+}
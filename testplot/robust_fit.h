@@ -0,0 +1,53 @@
+#ifndef ROBUST_FIT_H
+#define ROBUST_FIT_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "polynomial_fit.h"
+#include "fit_progress.h"
+
+// 抗离群点的多项式拟合
+enum class RobustMethod {
+    LeastSquares,   // 普通最小二乘
+    Ransac,         // 随机抽样一致：最小样本拟合假设，按阈值内的点数（MSAC 截断代价）选最优，再用内点重新拟合
+    Huber,          // 迭代加权最小二乘，Huber 权 min(1, k/|u|)
+    Tukey           // 迭代加权最小二乘，Tukey 双平方权 (1 - (u/c)^2)^2，|u| >= c 的点权为 0
+};
+
+struct RobustFitOptions {
+    RobustMethod method = RobustMethod::Huber;
+    int ransacHypotheses = 500;
+    size_t ransacScoringPoints = 20000;  // 评分只用等间隔抽取的这么多点，最终拟合用全部内点
+    double ransacThreshold = 0.0;        // 内点阈值（与 y 同单位），0 表示取 3 倍噪声尺度估计
+    double huberK = 1.345;
+    double tukeyC = 4.685;
+    int maxIterations = 50;
+    double tolerance = 1e-8;             // 相邻两次系数的相对变化小于它时停止
+    uint64_t seed = 20240601;
+    FitProgress* progress = nullptr;
+};
+
+struct RobustFitResult {
+    PolynomialFit fit;
+    std::vector<char> inliers;   // 与数据等长，1 为内点；最小二乘时为空
+    size_t inlierCount = 0;
+    double scale = 0.0;          // 残差的稳健尺度 1.4826 * MAD
+    int iterations = 0;          // IRLS 迭代次数或 RANSAC 假设数
+};
+
+// RANSAC 的每个假设用 (seed, 假设序号) 派生的独立随机流抽样，假设在各线程间静态分配，
+// 按 (得分, 序号) 选最优，结果与线程数无关
+// IRLS 从普通最小二乘开始，每轮用 1.4826 * MAD 重新估计尺度；Tukey 先用 Huber 收敛到稳定的起点
+// 离群点：RANSAC 为残差超过阈值，Huber 为 |u| > 2.5，Tukey 为权为 0
+class RobustFitter
+{
+public:
+    static RobustFitResult fitPolynomial(const std::vector<double>& x, const std::vector<double>& y, int degree,
+                                         const RobustFitOptions& options = RobustFitOptions());
+    static const char* methodName(RobustMethod method);
+    // 按 x 排序后相邻差分的 MAD 估计噪声标准差，对缓慢变化的趋势不敏感
+    static double noiseScale(const std::vector<double>& x, const std::vector<double>& y);
+};
+
+#endif // ROBUST_FIT_H
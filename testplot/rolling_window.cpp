@@ -0,0 +1,117 @@
+#include "rolling_window.h"
+#include <algorithm>
+#include <deque>
+#include <cmath>
+
+namespace {
+
+// 单调双端队列：队首始终是窗口内的最值下标，每个下标最多进出队一次
+template <typename Compare>
+std::vector<double> rollingExtreme(const std::vector<double>& data, size_t window, Compare keep)
+{
+    std::vector<double> result(data.size());
+    if (window == 0) window = 1;
+
+    std::deque<size_t> candidates;
+    for (size_t i = 0; i < data.size(); ++i) {
+        while (!candidates.empty() && !keep(data[candidates.back()], data[i])) {
+            candidates.pop_back();
+        }
+        candidates.push_back(i);
+        if (candidates.front() + window <= i) {
+            candidates.pop_front();
+        }
+        result[i] = data[candidates.front()];
+    }
+    return result;
+}
+
+// 同时给出滑动均值和 M2（离差平方和），新点加入、旧点移出都是 O(1)
+// 相比直接累加 sum 和 sum(x^2)，这种形式在均值远大于波动时不会发生灾难性抵消
+void rollingMoments(const std::vector<double>& data, size_t window,
+                    std::vector<double>* means, std::vector<double>* deviations)
+{
+    if (window == 0) window = 1;
+    size_t n = data.size();
+    if (means) means->resize(n);
+    if (deviations) deviations->resize(n);
+
+    // 先减去一个参考值（首个点），大偏移量的数据在更新 M2 时不损失有效位
+    double shift = n > 0 ? data[0] : 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double value = data[i] - shift;
+        if (i < window) {
+            ++count;
+            double delta = value - mean;
+            mean += delta / count;
+            m2 += delta * (value - mean);
+        } else {
+            // 窗口已满时新点直接替换最旧的点，点数不变；先删后加会在窗口为 1 时除以 0
+            double old = data[i - window] - shift;
+            double oldMean = mean;
+            mean += (value - old) / count;
+            m2 += (value - old) * (value - mean + old - oldMean);
+        }
+        m2 = std::max(m2, 0.0);
+
+        if (means) (*means)[i] = mean + shift;
+        if (deviations) (*deviations)[i] = (count > 1) ? std::sqrt(m2 / (count - 1)) : 0.0;
+    }
+}
+
+} // namespace
+
+std::vector<double> RollingWindowEngine::mean(const std::vector<double>& data, size_t window)
+{
+    std::vector<double> result;
+    rollingMoments(data, window, &result, nullptr);
+    return result;
+}
+
+std::vector<double> RollingWindowEngine::standardDeviation(const std::vector<double>& data, size_t window)
+{
+    std::vector<double> result;
+    rollingMoments(data, window, nullptr, &result);
+    return result;
+}
+
+std::vector<double> RollingWindowEngine::minimum(const std::vector<double>& data, size_t window)
+{
+    return rollingExtreme(data, window, [](double kept, double incoming) { return kept < incoming; });
+}
+
+std::vector<double> RollingWindowEngine::maximum(const std::vector<double>& data, size_t window)
+{
+    return rollingExtreme(data, window, [](double kept, double incoming) { return kept > incoming; });
+}
+
+std::vector<double> RollingWindowEngine::compute(const std::vector<double>& data, size_t window,
+                                                 RollingStatistic statistic)
+{
+    switch (statistic) {
+    case RollingStatistic::Mean:
+        return mean(data, window);
+    case RollingStatistic::StdDev:
+        return standardDeviation(data, window);
+    case RollingStatistic::Minimum:
+        return minimum(data, window);
+    case RollingStatistic::Maximum:
+        return maximum(data, window);
+    }
+    return std::vector<double>();
+}
+
+const std::vector<double>& RollingWindowEngine::series(int column, uint64_t version, const std::vector<double>& data,
+                                                       size_t window, RollingStatistic statistic)
+{
+    CacheEntry& entry = cache[std::make_pair(column, static_cast<int>(statistic))];
+    if (entry.version != version || entry.window != window || entry.values.size() != data.size()) {
+        entry.values = compute(data, window, statistic);
+        entry.version = version;
+        entry.window = window;
+    }
+    return entry.values;
+}
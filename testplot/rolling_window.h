@@ -0,0 +1,43 @@
+#ifndef ROLLING_WINDOW_H
+#define ROLLING_WINDOW_H
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// 滑动窗口统计量
+enum class RollingStatistic {
+    Mean,
+    StdDev,    // 样本标准差（n - 1）
+    Minimum,
+    Maximum
+};
+
+// 滑动窗口统计：窗口为 [i - window + 1, i]，开头不足一个窗口时按已有的点计算，输出与输入等长
+// 均值/标准差用增删式的滑动和（Welford 形式），最小/最大值用单调双端队列，每步均摊 O(1)
+class RollingWindowEngine
+{
+public:
+    static std::vector<double> mean(const std::vector<double>& data, size_t window);
+    static std::vector<double> standardDeviation(const std::vector<double>& data, size_t window);
+    static std::vector<double> minimum(const std::vector<double>& data, size_t window);
+    static std::vector<double> maximum(const std::vector<double>& data, size_t window);
+    static std::vector<double> compute(const std::vector<double>& data, size_t window, RollingStatistic statistic);
+
+    // 按 (列号, 统计量) 缓存，数据版本或窗口变化时重算
+    const std::vector<double>& series(int column, uint64_t version, const std::vector<double>& data,
+                                      size_t window, RollingStatistic statistic);
+    void clear() { cache.clear(); }
+
+private:
+    struct CacheEntry {
+        uint64_t version = 0;
+        size_t window = 0;
+        std::vector<double> values;
+    };
+    std::map<std::pair<int, int>, CacheEntry> cache;
+};
+
+#endif // ROLLING_WINDOW_H
@@ -0,0 +1,240 @@
+#include "segmented_fit.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const size_t MaxBlocks = 1000;
+const int MaxDegree = 3;
+const int RefineSweeps = 2;
+
+// 一段数据的充分统计量（关于 t 的幂次和）；y 已减去全体均值，Σy² 与 |z|² 的量级接近残差，
+// 前缀和相减和 RSS = Σy² - |z|² 的抵消都不依赖 long double 的额外精度（MSVC 上它就是 double）
+struct Moments {
+    long double power[2 * MaxDegree + 1] = {};   // Σ t^j
+    long double cross[MaxDegree + 1] = {};       // Σ t^j y
+    long double squares = 0.0L;                  // Σ y^2
+    size_t count = 0;
+
+    void add(double t, double y, int degree, long double sign = 1.0L)
+    {
+        long double tj = sign;
+        for (int j = 0; j <= 2 * degree; ++j) {
+            power[j] += tj;
+            if (j <= degree) cross[j] += tj * y;
+            tj *= t;
+        }
+        squares += sign * static_cast<long double>(y) * y;
+        if (sign > 0) ++count;
+        else --count;
+    }
+
+    Moments minus(const Moments& other, int degree) const
+    {
+        Moments result;
+        for (int j = 0; j <= 2 * degree; ++j) result.power[j] = power[j] - other.power[j];
+        for (int j = 0; j <= degree; ++j) result.cross[j] = cross[j] - other.cross[j];
+        result.squares = squares - other.squares;
+        result.count = count - other.count;
+        return result;
+    }
+};
+
+// 一段的最小二乘：解 (degree + 1) 阶正规方程（Cholesky），返回残差平方和；秩亏或点数不足时为无穷大
+double segmentCost(const Moments& m, int degree, size_t minPoints, std::vector<double>* coefficients = nullptr)
+{
+    if (m.count < minPoints) return std::numeric_limits<double>::infinity();
+    int p = degree + 1;
+    long double L[MaxDegree + 1][MaxDegree + 1] = {};
+    for (int a = 0; a < p; ++a) {
+        for (int b = 0; b <= a; ++b) {
+            long double value = m.power[a + b];
+            for (int k = 0; k < b; ++k) value -= L[a][k] * L[b][k];
+            if (a == b) {
+                if (!(value > 1e-15L * m.power[2 * a])) return std::numeric_limits<double>::infinity();
+                L[a][a] = std::sqrt(value);
+            } else {
+                L[a][b] = value / L[b][b];
+            }
+        }
+    }
+    long double z[MaxDegree + 1], b[MaxDegree + 1];
+    for (int a = 0; a < p; ++a) {
+        long double value = m.cross[a];
+        for (int k = 0; k < a; ++k) value -= L[a][k] * z[k];
+        z[a] = value / L[a][a];
+    }
+    for (int a = p; a-- > 0;) {
+        long double value = z[a];
+        for (int k = a + 1; k < p; ++k) value -= L[k][a] * b[k];
+        b[a] = value / L[a][a];
+    }
+    // RSS = Σy^2 - b^T X^T y = Σy^2 - |z|^2
+    long double rss = m.squares;
+    for (int a = 0; a < p; ++a) rss -= z[a] * z[a];
+    if (coefficients) {
+        coefficients->resize(p);
+        for (int a = 0; a < p; ++a) (*coefficients)[a] = static_cast<double>(b[a]);
+    }
+    return std::max(0.0, static_cast<double>(rss));
+}
+
+} // namespace
+
+double SegmentedFitResult::evaluate(double x) const
+{
+    if (!valid || coefficients.empty()) return std::numeric_limits<double>::quiet_NaN();
+    size_t segment = static_cast<size_t>(std::upper_bound(breakpoints.begin(), breakpoints.end(), x) - breakpoints.begin());
+    const std::vector<double>& c = coefficients[std::min(segment, coefficients.size() - 1)];
+    double t = (x - center) / halfRange;
+    double value = 0.0;
+    for (size_t k = c.size(); k-- > 0;) value = value * t + c[k];
+    return value;
+}
+
+SegmentedFitResult SegmentedRegression::fit(const std::vector<double>& x, const std::vector<double>& y, int breakpoints,
+                                            int degree, size_t minSegmentPoints, FitProgress* progress)
+{
+    SegmentedFitResult result;
+    degree = std::max(0, std::min(MaxDegree, degree));
+    breakpoints = std::max(0, breakpoints);
+    size_t minPoints = std::max(minSegmentPoints, static_cast<size_t>(degree) + 2);
+    size_t segments = static_cast<size_t>(breakpoints) + 1;
+
+    std::vector<std::pair<double, double>> points;
+    points.reserve(x.size());
+    for (size_t i = 0; i < x.size() && i < y.size(); ++i) {
+        if (std::isfinite(x[i]) && std::isfinite(y[i])) points.emplace_back(x[i], y[i]);
+    }
+    size_t n = points.size();
+    if (n < segments * minPoints) return result;
+    std::sort(points.begin(), points.end());
+
+    result.degree = degree;
+    result.center = 0.5 * (points.front().first + points.back().first);
+    result.halfRange = 0.5 * (points.back().first - points.front().first);
+    if (!(result.halfRange > 0.0)) return result;
+    // y 先减去均值（两遍求和），各段截距最后再加回
+    double yShift = 0.0;
+    for (const auto& point : points) yShift += point.second;
+    yShift /= n;
+    double correction = 0.0;
+    for (const auto& point : points) correction += point.second - yShift;
+    yShift += correction / n;
+    std::vector<double> sortedX(n), t(n), values(n);
+    for (size_t i = 0; i < n; ++i) {
+        sortedX[i] = points[i].first;
+        t[i] = (points[i].first - result.center) / result.halfRange;
+        values[i] = points[i].second - yShift;
+    }
+    points.clear();
+    points.shrink_to_fit();
+
+    // 等点数分块，块边界上的前缀和
+    size_t blocks = std::min(n, MaxBlocks);
+    std::vector<size_t> start(blocks + 1);
+    for (size_t b = 0; b <= blocks; ++b) start[b] = n / blocks * b + std::min(b, n % blocks);
+    std::vector<Moments> prefix(blocks + 1);
+    for (size_t b = 0; b < blocks; ++b) {
+        prefix[b + 1] = prefix[b];
+        for (size_t i = start[b]; i < start[b + 1]; ++i) prefix[b + 1].add(t[i], values[i], degree);
+    }
+    auto blockCost = [&](size_t from, size_t to) {
+        return segmentCost(prefix[to].minus(prefix[from], degree), degree, minPoints);
+    };
+
+    // D[s][i]：前 i 个块分成 s + 1 段的最小代价，choice 为最后一段的起始块
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<std::vector<double>> cost(segments, std::vector<double>(blocks + 1, infinity));
+    std::vector<std::vector<size_t>> choice(segments, std::vector<size_t>(blocks + 1, 0));
+    for (size_t i = 1; i <= blocks; ++i) cost[0][i] = blockCost(0, i);
+    for (size_t s = 1; s < segments; ++s) {
+        if (progress && progress->isCancelled()) return result;
+        const std::vector<double>& previous = cost[s - 1];
+        std::vector<double>& current = cost[s];
+        std::vector<size_t>& chosen = choice[s];
+        parallelForChunks(blocks + 1, parallelChunkCount(blocks + 1, 16), [&](size_t, size_t begin, size_t end) {
+            for (size_t i = std::max(begin, s + 1); i < end; ++i) {
+                double best = infinity;
+                size_t bestStart = 0;
+                for (size_t m = s; m < i; ++m) {
+                    if (previous[m] == infinity) continue;
+                    double candidate = previous[m] + blockCost(m, i);
+                    if (candidate < best) {
+                        best = candidate;
+                        bestStart = m;
+                    }
+                }
+                current[i] = best;
+                chosen[i] = bestStart;
+            }
+        });
+        if (progress) progress->fraction.store(0.8 * static_cast<double>(s) / segments);
+    }
+    if (!std::isfinite(cost[segments - 1][blocks])) return result;
+
+    // 回溯得到断点（点序号）：bounds[j] 为第 j 段的起点，bounds[segments] = n
+    std::vector<size_t> bounds(segments + 1);
+    bounds[segments] = n;
+    size_t block = blocks;
+    for (size_t s = segments; s-- > 1;) {
+        block = choice[s][block];
+        bounds[s] = start[block];
+    }
+    bounds[0] = 0;
+
+    // 逐点细化：每个断点在两侧各约一个块的范围内移动，相邻两段的统计量逐点增减
+    size_t window = n / blocks + 1;
+    for (int sweep = 0; sweep < RefineSweeps && blocks < n; ++sweep) {
+        for (size_t j = 1; j < segments; ++j) {
+            if (progress && progress->isCancelled()) return result;
+            size_t lo = std::max(bounds[j] > window ? bounds[j] - window : 0, bounds[j - 1] + minPoints);
+            size_t hi = std::min(bounds[j] + window, bounds[j + 1] - minPoints);
+            if (lo > hi) continue;
+            Moments left, right;
+            for (size_t i = bounds[j - 1]; i < lo; ++i) left.add(t[i], values[i], degree);
+            for (size_t i = lo; i < bounds[j + 1]; ++i) right.add(t[i], values[i], degree);
+            double best = infinity;
+            size_t bestPosition = bounds[j];
+            for (size_t position = lo; position <= hi; ++position) {
+                double candidate = segmentCost(left, degree, minPoints) + segmentCost(right, degree, minPoints);
+                if (candidate < best) {
+                    best = candidate;
+                    bestPosition = position;
+                }
+                if (position < hi) {
+                    left.add(t[position], values[position], degree);
+                    right.add(t[position], values[position], degree, -1.0L);
+                }
+            }
+            bounds[j] = bestPosition;
+        }
+    }
+
+    // 各段的系数由直接累加的统计量求出，残差平方和逐点计算，不用 Σy² - |z|²
+    result.coefficients.resize(segments);
+    result.residualSumOfSquares = 0.0;
+    for (size_t j = 0; j < segments; ++j) {
+        Moments moments;
+        for (size_t i = bounds[j]; i < bounds[j + 1]; ++i) moments.add(t[i], values[i], degree);
+        std::vector<double>& c = result.coefficients[j];
+        if (!std::isfinite(segmentCost(moments, degree, minPoints, &c))) return SegmentedFitResult();
+        for (size_t i = bounds[j]; i < bounds[j + 1]; ++i) {
+            double fitted = 0.0;
+            for (size_t k = c.size(); k-- > 0;) fitted = fitted * t[i] + c[k];
+            result.residualSumOfSquares += (values[i] - fitted) * (values[i] - fitted);
+        }
+        c[0] += yShift;
+        result.segmentSizes.push_back(bounds[j + 1] - bounds[j]);
+        if (j > 0) result.breakpoints.push_back(0.5 * (sortedX[bounds[j] - 1] + sortedX[bounds[j]]));
+    }
+    double parameters = static_cast<double>(segments * (degree + 1) + breakpoints);
+    result.bic = n * std::log(std::max(result.residualSumOfSquares, std::numeric_limits<double>::min()) / n)
+               + parameters * std::log(static_cast<double>(n));
+    result.valid = true;
+    if (progress) progress->fraction.store(1.0);
+    return result;
+}
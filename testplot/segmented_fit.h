@@ -0,0 +1,36 @@
+#ifndef SEGMENTED_FIT_H
+#define SEGMENTED_FIT_H
+
+#include <vector>
+#include <cstddef>
+#include "fit_progress.h"
+
+struct SegmentedFitResult {
+    bool valid = false;
+    int degree = 1;
+    double center = 0.0;                        // 各段多项式关于 t = (x - center) / halfRange
+    double halfRange = 1.0;
+    std::vector<double> breakpoints;            // 升序，k 个断点分成 k + 1 段
+    std::vector<std::vector<double>> coefficients; // 每段关于 t 的幂次系数 a0, a1, ...
+    std::vector<size_t> segmentSizes;           // 每段的点数
+    double residualSumOfSquares = 0.0;
+    double bic = 0.0;                           // n ln(RSS/n) + p ln n，p 含断点位置
+
+    double evaluate(double x) const;
+};
+
+// 分段多项式回归（各段独立，不要求在断点处连续）：x 排序后，在使总残差平方和最小的 k 个位置断开
+// 每段的代价由前缀和 Σt^j、Σt^j y、Σy^2 在 O(1) 内得到（解 degree + 1 阶正规方程），动态规划
+//   D[s][i] = min_m D[s-1][m] + cost(m, i)
+// 给出全局最优的分段；x 先按等点数分成不超过 1000 个块，断点先取在块边界上，
+// 同一层的各个 i 之间并行，O(k·M^2)；再在断点两侧各一个块内逐点移动做局部细化（两轮坐标下降），
+// 点数不超过 1000 时第一步就是逐点的精确最优
+class SegmentedRegression
+{
+public:
+    // degree 为 0..3；minSegmentPoints 小于 degree + 2 时按 degree + 2
+    static SegmentedFitResult fit(const std::vector<double>& x, const std::vector<double>& y, int breakpoints,
+                                  int degree = 1, size_t minSegmentPoints = 0, FitProgress* progress = nullptr);
+};
+
+#endif // SEGMENTED_FIT_H
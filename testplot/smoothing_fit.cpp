@@ -0,0 +1,435 @@
+#include "smoothing_fit.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// 按 x 排序的数据；样条把相邻的点合并为带权节点
+struct SortedData {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> w;        // 合并的点数
+    double withinSquares = 0.0;   // 合并时组内 y 的离差平方和，计入 RSS
+    double totalWeight = 0.0;
+};
+
+struct Group {
+    double count;
+    double meanX;
+    double meanY;
+    double squares;   // 组内 y 的离差平方和
+
+    void absorb(const Group& other)
+    {
+        double total = count + other.count;
+        double delta = other.meanY - meanY;
+        squares += other.squares + delta * delta * count * other.count / total;
+        meanX += (other.meanX - meanX) * other.count / total;
+        meanY += delta * other.count / total;
+        count = total;
+    }
+};
+
+// maxKnots > 0 时，均值间距小于 x 范围 / maxKnots 的相邻组合并（相同的 x 总会合并），
+// 节点数不超过约 maxKnots，且最小间距有下界，五对角方程组的条件数随之受控
+SortedData sortData(const std::vector<double>& x, const std::vector<double>& y, size_t maxKnots)
+{
+    std::vector<std::pair<double, double>> points;
+    points.reserve(x.size());
+    for (size_t i = 0; i < x.size() && i < y.size(); ++i) {
+        if (std::isfinite(x[i]) && std::isfinite(y[i])) points.emplace_back(x[i], y[i]);
+    }
+    std::sort(points.begin(), points.end());
+
+    SortedData data;
+    data.totalWeight = static_cast<double>(points.size());
+    if (maxKnots == 0) {
+        data.x.reserve(points.size());
+        data.y.reserve(points.size());
+        for (const auto& point : points) {
+            data.x.push_back(point.first);
+            data.y.push_back(point.second);
+        }
+        data.w.assign(points.size(), 1.0);
+        return data;
+    }
+
+    double tolerance = points.empty() ? 0.0 : (points.back().first - points.front().first) / maxKnots;
+    std::vector<Group> groups;
+    for (const auto& point : points) {
+        groups.push_back(Group{1.0, point.first, point.second, 0.0});
+        while (groups.size() >= 2) {
+            Group& previous = groups[groups.size() - 2];
+            const Group& last = groups.back();
+            if (last.meanX - previous.meanX >= tolerance && last.meanX != previous.meanX) break;
+            previous.absorb(last);
+            groups.pop_back();
+        }
+    }
+    for (const Group& group : groups) {
+        data.x.push_back(group.meanX);
+        data.y.push_back(group.meanY);
+        data.w.push_back(group.count);
+        data.withinSquares += group.squares;
+    }
+    return data;
+}
+
+// Reinsch 形式的平滑样条：未知量为内部节点 1..n-2 上的二阶导数 γ
+// Q 的第 j 列（节点 k = j + 1）在第 k-1, k, k+1 行为 a_k, b_k, c_k
+class ReinschSystem
+{
+public:
+    explicit ReinschSystem(const SortedData& data)
+        : data(data), n(data.x.size()), m(n - 2),
+          a(n, 0.0), b(n, 0.0), c(n, 0.0),
+          r0(m), r1(m, 0.0), q0(m), q1(m, 0.0), q2(m, 0.0), rhs(m)
+    {
+        std::vector<double> h(n - 1);
+        for (size_t i = 0; i + 1 < n; ++i) h[i] = data.x[i + 1] - data.x[i];
+        for (size_t k = 1; k + 1 < n; ++k) {
+            a[k] = 1.0 / h[k - 1];
+            c[k] = 1.0 / h[k];
+            b[k] = -a[k] - c[k];
+        }
+        const std::vector<double>& w = data.w;
+        const std::vector<double>& y = data.y;
+        for (size_t j = 0; j < m; ++j) {
+            size_t k = j + 1;
+            r0[j] = (h[k - 1] + h[k]) / 3.0;
+            if (j + 1 < m) r1[j] = h[k] / 6.0;
+            q0[j] = a[k] * a[k] / w[k - 1] + b[k] * b[k] / w[k] + c[k] * c[k] / w[k + 1];
+            if (j + 1 < m) q1[j] = b[k] * a[k + 1] / w[k] + c[k] * b[k + 1] / w[k + 1];
+            if (j + 2 < m) q2[j] = c[k] * a[k + 2] / w[k + 1];
+            rhs[j] = a[k] * y[k - 1] + b[k] * y[k] + c[k] * y[k + 1];
+        }
+    }
+
+    // λ 的相对尺度，使 λ = scale 时粗糙度项与拟合项量级相当
+    double lambdaScale() const
+    {
+        double traceR = 0.0, traceQ = 0.0;
+        for (size_t j = 0; j < m; ++j) {
+            traceR += r0[j];
+            traceQ += q0[j];
+        }
+        return traceQ > 0.0 ? traceR / traceQ : 1.0;
+    }
+
+    struct Solution {
+        bool valid = false;
+        std::vector<double> values;      // 节点上的拟合值
+        std::vector<double> gamma;       // 节点上的二阶导数，两端为 0
+        double rss = 0.0;
+        double degreesOfFreedom = 0.0;
+        double gcv = std::numeric_limits<double>::infinity();
+    };
+
+    Solution solve(double lambda, bool keepCurve) const
+    {
+        Solution solution;
+        // A = R + λ Q^T W^-1 Q 的带状 LDL^T：d 为对角，l1[i] = L(i+1, i)，l2[i] = L(i+2, i)
+        std::vector<double> d(m), l1(m, 0.0), l2(m, 0.0);
+        for (size_t i = 0; i < m; ++i) {
+            double value = r0[i] + lambda * q0[i];
+            if (i >= 1) value -= l1[i - 1] * l1[i - 1] * d[i - 1];
+            if (i >= 2) value -= l2[i - 2] * l2[i - 2] * d[i - 2];
+            if (!(value > 0.0)) return solution;
+            d[i] = value;
+            if (i + 1 < m) {
+                double off = r1[i] + lambda * q1[i];
+                if (i >= 1) off -= l2[i - 1] * l1[i - 1] * d[i - 1];
+                l1[i] = off / d[i];
+            }
+            if (i + 2 < m) l2[i] = lambda * q2[i] / d[i];
+        }
+
+        // L z = Q^T y，再 L^T γ = D^-1 z
+        std::vector<double> gamma(n, 0.0);
+        std::vector<double> z(m);
+        for (size_t i = 0; i < m; ++i) {
+            double value = rhs[i];
+            if (i >= 1) value -= l1[i - 1] * z[i - 1];
+            if (i >= 2) value -= l2[i - 2] * z[i - 2];
+            z[i] = value;
+        }
+        for (size_t i = m; i-- > 0;) {
+            double value = z[i] / d[i];
+            if (i + 1 < m) value -= l1[i] * gamma[i + 2];
+            if (i + 2 < m) value -= l2[i] * gamma[i + 3];
+            gamma[i + 1] = value;
+        }
+
+        // Hutchinson–de Hoog：逆矩阵 Σ 的带内元素 s0 = Σ(i,i), s1 = Σ(i,i+1), s2 = Σ(i,i+2)
+        std::vector<double> s0(m + 2, 0.0), s1(m + 2, 0.0), s2(m + 2, 0.0);
+        for (size_t i = m; i-- > 0;) {
+            s2[i] = -l1[i] * s1[i + 1] - l2[i] * s0[i + 2];
+            s1[i] = -l1[i] * s0[i + 1] - l2[i] * s1[i + 1];
+            s0[i] = 1.0 / d[i] - l1[i] * s1[i] - l2[i] * s2[i];
+        }
+        auto sigma = [&](size_t p, size_t q) {   // p, q 为节点号（内部节点 1..n-2）
+            if (p > q) std::swap(p, q);
+            size_t i = p - 1;
+            switch (q - p) {
+            case 0: return s0[i];
+            case 1: return s1[i];
+            case 2: return s2[i];
+            default: return 0.0;
+            }
+        };
+
+        std::vector<double> values(n);
+        double rss = data.withinSquares, leverageComplement = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            // Q 的第 i 行：节点 i-1, i, i+1 列上的 c_{i-1}, b_i, a_{i+1}（只取内部节点）
+            size_t columns[3];
+            double entries[3];
+            int count = 0;
+            if (i >= 2) { columns[count] = i - 1; entries[count++] = c[i - 1]; }
+            if (i >= 1 && i + 1 < n) { columns[count] = i; entries[count++] = b[i]; }
+            if (i + 2 < n) { columns[count] = i + 1; entries[count++] = a[i + 1]; }
+
+            double qGamma = 0.0, qSigmaQ = 0.0;
+            for (int p = 0; p < count; ++p) {
+                qGamma += entries[p] * gamma[columns[p]];
+                for (int q = 0; q < count; ++q) qSigmaQ += entries[p] * entries[q] * sigma(columns[p], columns[q]);
+            }
+            values[i] = data.y[i] - lambda * qGamma / data.w[i];
+            double r = data.y[i] - values[i];
+            rss += data.w[i] * r * r;
+            leverageComplement += lambda * qSigmaQ / data.w[i];
+        }
+
+        solution.valid = true;
+        solution.rss = rss;
+        solution.degreesOfFreedom = static_cast<double>(n) - leverageComplement;
+        double denominator = 1.0 - solution.degreesOfFreedom / data.totalWeight;
+        solution.gcv = denominator > 0.0 ? (rss / data.totalWeight) / (denominator * denominator)
+                                         : std::numeric_limits<double>::infinity();
+        if (keepCurve) {
+            solution.values = std::move(values);
+            solution.gamma = std::move(gamma);
+        }
+        return solution;
+    }
+
+private:
+    const SortedData& data;
+    size_t n, m;
+    std::vector<double> a, b, c;
+    std::vector<double> r0, r1;            // R 的对角和次对角
+    std::vector<double> q0, q1, q2;        // Q^T W^-1 Q 的三条带
+    std::vector<double> rhs;               // Q^T y
+};
+
+const size_t MaxKnots = 2000;
+const double GridStep = 0.25;      // log10(λ) 网格步长
+const int MaxBracketSteps = 40;
+
+} // namespace
+
+double SmoothCurve::evaluate(double x) const
+{
+    size_t n = knots.size();
+    if (n == 0) return std::numeric_limits<double>::quiet_NaN();
+    if (n == 1) return values[0];
+    bool cubic = secondDerivatives.size() == n;
+
+    if (x <= knots[0] || x >= knots[n - 1]) {
+        // 端点切线外推（自然样条两端二阶导数为 0）
+        bool left = x <= knots[0];
+        size_t i = left ? 0 : n - 2;
+        double h = knots[i + 1] - knots[i];
+        double slope = (values[i + 1] - values[i]) / h;
+        if (cubic) {
+            slope += left ? -h * (2.0 * secondDerivatives[i] + secondDerivatives[i + 1]) / 6.0
+                          : h * (secondDerivatives[i] + 2.0 * secondDerivatives[i + 1]) / 6.0;
+        }
+        size_t end = left ? 0 : n - 1;
+        return values[end] + slope * (x - knots[end]);
+    }
+
+    size_t i = static_cast<size_t>(std::upper_bound(knots.begin(), knots.end(), x) - knots.begin()) - 1;
+    double h = knots[i + 1] - knots[i];
+    double u = (x - knots[i]) / h;
+    double value = (1.0 - u) * values[i] + u * values[i + 1];
+    if (cubic) {
+        value -= h * h * u * (1.0 - u) / 6.0 *
+                 ((2.0 - u) * secondDerivatives[i] + (1.0 + u) * secondDerivatives[i + 1]);
+    }
+    return value;
+}
+
+void SmoothCurve::evaluate(const double* x, size_t count, double* out) const
+{
+    for (size_t i = 0; i < count; ++i) out[i] = evaluate(x[i]);
+}
+
+SmoothingSplineResult SmoothingSpline::fit(const std::vector<double>& x, const std::vector<double>& y,
+                                           double lambda, FitProgress* progress)
+{
+    SmoothingSplineResult result;
+    SortedData data = sortData(x, y, MaxKnots);
+    if (data.x.size() < 3) return result;
+    ReinschSystem system(data);
+
+    if (!(lambda > 0.0)) {
+        // 从相对尺度出发，以 10 倍为步向两侧扩展，直到接近插值（df > 0.95 n）和接近直线（df < 2.05）
+        double knotCount = static_cast<double>(data.x.size());
+        double center = std::log10(system.lambdaScale());
+        double logLow = center, logHigh = center;
+        for (int step = 0; step < MaxBracketSteps; ++step) {
+            ReinschSystem::Solution probe = system.solve(std::pow(10.0, logLow), false);
+            if (!probe.valid || probe.degreesOfFreedom > 0.95 * knotCount) break;
+            logLow -= 1.0;
+        }
+        for (int step = 0; step < MaxBracketSteps; ++step) {
+            ReinschSystem::Solution probe = system.solve(std::pow(10.0, logHigh), false);
+            if (!probe.valid || probe.degreesOfFreedom < 2.05) break;
+            logHigh += 1.0;
+        }
+        if (progress && progress->isCancelled()) return result;
+
+        // 区间内的对数网格上并行计算 GCV，取最小处再在相邻两格之间做黄金分割
+        size_t gridCount = static_cast<size_t>(std::round((logHigh - logLow) / GridStep)) + 1;
+        std::vector<double> scores(gridCount, std::numeric_limits<double>::infinity());
+        std::atomic<size_t> finished(0);
+        parallelForEach(gridCount, [&](size_t g) {
+            if (progress && progress->isCancelled()) return;
+            scores[g] = system.solve(std::pow(10.0, logLow + GridStep * static_cast<double>(g)), false).gcv;
+            if (progress) progress->fraction.store(0.8 * static_cast<double>(++finished) / gridCount);
+        });
+        if (progress && progress->isCancelled()) return result;
+
+        size_t best = static_cast<size_t>(std::min_element(scores.begin(), scores.end()) - scores.begin());
+        if (!std::isfinite(scores[best])) return result;
+        double bestLog = logLow + GridStep * static_cast<double>(best);
+        double low = bestLog - GridStep, high = bestLog + GridStep;
+        const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+        auto gcvAt = [&](double logLambda) { return system.solve(std::pow(10.0, logLambda), false).gcv; };
+        double c = high - ratio * (high - low), d = low + ratio * (high - low);
+        double fc = gcvAt(c), fd = gcvAt(d);
+        for (int iteration = 0; iteration < 30 && high - low > 1e-3; ++iteration) {
+            if (progress && progress->isCancelled()) return result;
+            if (fc < fd) {
+                high = d;
+                d = c;
+                fd = fc;
+                c = high - ratio * (high - low);
+                fc = gcvAt(c);
+            } else {
+                low = c;
+                c = d;
+                fc = fd;
+                d = low + ratio * (high - low);
+                fd = gcvAt(d);
+            }
+        }
+        lambda = std::pow(10.0, std::min(fc, fd) < scores[best] ? 0.5 * (low + high) : bestLog);
+    }
+
+    ReinschSystem::Solution solution = system.solve(lambda, true);
+    if (!solution.valid) return result;
+    if (progress) progress->fraction.store(1.0);
+
+    result.valid = true;
+    result.curve.knots = std::move(data.x);
+    result.curve.values = std::move(solution.values);
+    result.curve.secondDerivatives = std::move(solution.gamma);
+    result.lambda = lambda;
+    result.degreesOfFreedom = solution.degreesOfFreedom;
+    result.gcv = solution.gcv;
+    return result;
+}
+
+LoessResult Loess::fit(const std::vector<double>& x, const std::vector<double>& y, double span, int degree,
+                       size_t maxEvaluationPoints, FitProgress* progress)
+{
+    LoessResult result;
+    SortedData data = sortData(x, y, 0);
+    const std::vector<double>& xs = data.x;
+    const std::vector<double>& ys = data.y;
+    size_t n = xs.size();
+    degree = std::max(1, std::min(2, degree));
+    if (n < static_cast<size_t>(degree) + 2 || xs.front() == xs.back()) return result;
+
+    span = std::max(0.0, std::min(1.0, span));
+    size_t k = std::max<size_t>(static_cast<size_t>(degree) + 2, static_cast<size_t>(std::ceil(span * n)));
+    k = std::min(k, n);
+
+    // 评估点：不同的 x 不多时取全部，否则等距
+    std::vector<double> points(xs);
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    maxEvaluationPoints = std::max<size_t>(2, maxEvaluationPoints);
+    if (points.size() > maxEvaluationPoints) {
+        points.resize(maxEvaluationPoints);
+        for (size_t i = 0; i < maxEvaluationPoints; ++i) {
+            points[i] = xs.front() + (xs.back() - xs.front()) * static_cast<double>(i) / (maxEvaluationPoints - 1);
+        }
+    }
+
+    std::vector<double> fitted(points.size());
+    std::atomic<size_t> finished(0);
+    size_t chunks = parallelChunkCount(points.size(), 8);
+    parallelForChunks(points.size(), chunks, [&](size_t, size_t begin, size_t end) {
+        // 窗口 [lo, lo + k) 是离 x0 最近的 k 个点；x0 递增时 lo 只会右移
+        size_t lo = static_cast<size_t>(std::lower_bound(xs.begin(), xs.end(), points[begin]) - xs.begin());
+        lo = lo > k / 2 ? std::min(lo - k / 2, n - k) : 0;
+        while (lo > 0 && xs[lo + k - 1] - points[begin] > points[begin] - xs[lo - 1]) --lo;
+
+        for (size_t p = begin; p < end; ++p) {
+            if (progress && progress->isCancelled()) return;
+            double x0 = points[p];
+            while (lo + k < n && x0 - xs[lo] > xs[lo + k] - x0) ++lo;
+            double reach = std::max(x0 - xs[lo], xs[lo + k - 1] - x0);
+
+            // 局部坐标 u = (x - x0) / reach，三次权
+            double s[5] = {0.0, 0.0, 0.0, 0.0, 0.0}, t[3] = {0.0, 0.0, 0.0};
+            for (size_t i = lo; i < lo + k; ++i) {
+                double u = reach > 0.0 ? (xs[i] - x0) / reach : 0.0;
+                double a = 1.0 - std::abs(u) * std::abs(u) * std::abs(u);
+                double w = a > 0.0 ? a * a * a : 0.0;
+                double wu = w * u, wu2 = wu * u;
+                s[0] += w;
+                s[1] += wu;
+                s[2] += wu2;
+                t[0] += w * ys[i];
+                t[1] += wu * ys[i];
+                if (degree == 2) {
+                    s[3] += wu2 * u;
+                    s[4] += wu2 * u * u;
+                    t[2] += wu2 * ys[i];
+                }
+            }
+
+            double value = s[0] > 0.0 ? t[0] / s[0] : std::numeric_limits<double>::quiet_NaN();
+            if (degree == 1) {
+                double det = s[0] * s[2] - s[1] * s[1];
+                if (det > 1e-12 * s[0] * s[0]) value = (s[2] * t[0] - s[1] * t[1]) / det;
+            } else {
+                // 3×3 正规方程的截距（Cramer 法则）
+                double det = s[0] * (s[2] * s[4] - s[3] * s[3]) - s[1] * (s[1] * s[4] - s[3] * s[2])
+                           + s[2] * (s[1] * s[3] - s[2] * s[2]);
+                if (det > 1e-12 * s[0] * s[0] * s[0]) {
+                    value = (t[0] * (s[2] * s[4] - s[3] * s[3]) - s[1] * (t[1] * s[4] - s[3] * t[2])
+                             + s[2] * (t[1] * s[3] - s[2] * t[2])) / det;
+                }
+            }
+            fitted[p] = value;
+            size_t done = ++finished;
+            if (progress && done % 64 == 0) progress->fraction.store(static_cast<double>(done) / points.size());
+        }
+    });
+    if (progress && progress->isCancelled()) return result;
+
+    result.valid = true;
+    result.curve.knots = std::move(points);
+    result.curve.values = std::move(fitted);
+    result.span = span;
+    result.neighbours = k;
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef SMOOTHING_FIT_H
+#define SMOOTHING_FIT_H
+
+#include <vector>
+#include <cstddef>
+#include "fit_progress.h"
+
+// 非参数平滑曲线：按 x 升序的节点上的函数值和二阶导数，节点间为三次多项式
+// （自然三次样条的表示；二阶导数全为 0 时即折线），两端之外按端点切线线性外推
+struct SmoothCurve {
+    std::vector<double> knots;
+    std::vector<double> values;
+    std::vector<double> secondDerivatives;   // 空表示全为 0
+
+    double evaluate(double x) const;
+    void evaluate(const double* x, size_t count, double* out) const;
+};
+
+struct SmoothingSplineResult {
+    bool valid = false;
+    SmoothCurve curve;
+    double lambda = 0.0;            // 粗糙度惩罚系数
+    double degreesOfFreedom = 0.0;  // 等效自由度 tr(S)
+    double gcv = 0.0;
+};
+
+// 三次平滑样条：min Σ w_i (y_i - g(x_i))^2 + λ ∫ g''^2
+// x 排序后，间距小于 x 范围 1/2000 的相邻点合并为一个节点（取均值，权为点数），节点数不超过约 2000，
+// 百万点的数据也只在节点上求解，且节点间距有下界，方程组不会因近乎重合的 x 而病态
+// Reinsch 算法：(R + λ Q^T W^-1 Q) γ = Q^T y 为五对角对称正定方程组，带状 LDL^T 分解 O(n) 求解；
+// GCV 所需的 tr(S) 由 Hutchinson–de Hoog 递推得到逆矩阵的带内元素，同样 O(n)
+// λ 的搜索区间从相对尺度 tr(R) / tr(Q^T W^-1 Q) 向两侧扩展到接近插值和接近直线，
+// 区间内的对数网格上并行计算 GCV，再用黄金分割细化
+class SmoothingSpline
+{
+public:
+    // lambda <= 0 时由 GCV 选择
+    static SmoothingSplineResult fit(const std::vector<double>& x, const std::vector<double>& y,
+                                     double lambda = 0.0, FitProgress* progress = nullptr);
+};
+
+struct LoessResult {
+    bool valid = false;
+    SmoothCurve curve;              // 评估点上的拟合值，点间线性插值
+    double span = 0.0;
+    size_t neighbours = 0;          // 每个局部回归使用的点数
+};
+
+// LOESS：x 排序后，每个评估点取最近的 span * n 个点（排序数组上的连续窗口，随评估点单调滑动），
+// 三次权 (1 - |d/dmax|^3)^3 的局部加权多项式回归（1 次或 2 次）
+// 评估点不超过 maxEvaluationPoints：不同的 x 较少时就用全部 x，否则在 [xmin, xmax] 上等距取点再插值；
+// 评估点分块并行，每块先二分定位窗口再滑动
+class Loess
+{
+public:
+    static LoessResult fit(const std::vector<double>& x, const std::vector<double>& y, double span = 0.3,
+                           int degree = 1, size_t maxEvaluationPoints = 2000, FitProgress* progress = nullptr);
+};
+
+#endif // SMOOTHING_FIT_H
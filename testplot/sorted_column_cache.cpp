@@ -0,0 +1,79 @@
+#include "sorted_column_cache.h"
+#include "parallel_utils.h"
+#include <algorithm>
+
+std::vector<double> SortedColumnCache::parallelSort(std::vector<double> data)
+{
+    size_t n = data.size();
+    size_t chunks = parallelChunkCount(n, 1 << 16);
+    if (chunks <= 1) {
+        std::sort(data.begin(), data.end());
+        return data;
+    }
+
+    // 各块独立排序，记录块边界
+    std::vector<size_t> bounds(chunks + 1, n);
+    parallelForChunks(n, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        bounds[chunk] = begin;
+        std::sort(data.begin() + begin, data.begin() + end);
+    });
+
+    // 相邻的有序段两两归并到另一个缓冲区，每轮段数减半，各对之间并行
+    std::vector<double> buffer(n);
+    std::vector<double>* source = &data;
+    std::vector<double>* target = &buffer;
+    while (bounds.size() > 2) {
+        size_t runs = bounds.size() - 1;
+        size_t pairs = (runs + 1) / 2;
+        parallelForEach(pairs, [&](size_t pair) {
+            size_t begin = bounds[2 * pair];
+            size_t mid = bounds[std::min(2 * pair + 1, runs)];
+            size_t end = bounds[std::min(2 * pair + 2, runs)];
+            std::merge(source->begin() + begin, source->begin() + mid,
+                       source->begin() + mid, source->begin() + end,
+                       target->begin() + begin);
+        });
+
+        std::vector<size_t> merged;
+        merged.reserve(pairs + 1);
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (merged.back() != n) merged.push_back(n);
+        bounds.swap(merged);
+        std::swap(source, target);
+    }
+    return std::move(*source);
+}
+
+SortedColumn SortedColumnCache::sorted(int column, uint64_t version, const std::vector<double>& data)
+{
+    SortedColumn cached = lookup(column, version);
+    if (cached && cached->size() == data.size()) return cached;
+
+    SortedColumn values = std::make_shared<const std::vector<double>>(parallelSort(data));
+    insert(column, version, values);
+    return values;
+}
+
+SortedColumn SortedColumnCache::lookup(int column, uint64_t version) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(column);
+    if (it == cache.end() || it->second.version != version) return SortedColumn();
+    return it->second.values;
+}
+
+void SortedColumnCache::insert(int column, uint64_t version, SortedColumn values)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    CacheEntry& entry = cache[column];
+    entry.version = version;
+    entry.values = std::move(values);
+}
+
+void SortedColumnCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.clear();
+}
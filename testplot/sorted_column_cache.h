@@ -0,0 +1,38 @@
+#ifndef SORTED_COLUMN_CACHE_H
+#define SORTED_COLUMN_CACHE_H
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+typedef std::shared_ptr<const std::vector<double>> SortedColumn;
+
+// 排序后的列缓存：分布拟合、拟合优度检验、双样本检验等都需要有序数据，
+// 每列每个数据版本只排序一次。结果以 shared_ptr 共享，后台任务可以在缓存被替换后继续安全使用。
+// 查询和写入有互斥锁保护，可以在工作线程中调用；排序本身在锁外进行。
+class SortedColumnCache
+{
+public:
+    // 分块并行排序后逐轮两两归并，结果与 std::sort 相同
+    static std::vector<double> parallelSort(std::vector<double> data);
+
+    // 命中时返回缓存，否则排序并写入缓存
+    SortedColumn sorted(int column, uint64_t version, const std::vector<double>& data);
+    // 只查询，不排序；未命中返回空指针
+    SortedColumn lookup(int column, uint64_t version) const;
+    void insert(int column, uint64_t version, SortedColumn values);
+    void clear();
+
+private:
+    struct CacheEntry {
+        uint64_t version = 0;
+        SortedColumn values;
+    };
+    mutable std::mutex mutex;
+    std::map<int, CacheEntry> cache;
+};
+
+#endif // SORTED_COLUMN_CACHE_H
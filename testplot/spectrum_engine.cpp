@@ -0,0 +1,164 @@
+#include "spectrum_engine.h"
+#include "fft.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <numeric>
+#include <complex>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+std::vector<double> SpectrumEngine::window(WindowFunction type, size_t length)
+{
+    std::vector<double> w(length, 1.0);
+    if (length < 2) return w;
+
+    // 周期形式（分母为 N），适合谱估计
+    for (size_t i = 0; i < length; ++i) {
+        double phase = 2.0 * M_PI * i / length;
+        switch (type) {
+        case WindowFunction::Hann:
+            w[i] = 0.5 - 0.5 * std::cos(phase);
+            break;
+        case WindowFunction::Hamming:
+            w[i] = 0.54 - 0.46 * std::cos(phase);
+            break;
+        case WindowFunction::Blackman:
+            w[i] = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+            break;
+        case WindowFunction::Rectangular:
+            break;
+        }
+    }
+    return w;
+}
+
+std::vector<double> SpectrumEngine::uniformSamples(const std::vector<double>& x, const std::vector<double>& y,
+                                                   double* spacing)
+{
+    size_t n = std::min(x.size(), y.size());
+    if (spacing) *spacing = 1.0;
+    if (n < 2) return std::vector<double>(y.begin(), y.begin() + n);
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (!std::is_sorted(x.begin(), x.begin() + n)) {
+        std::stable_sort(order.begin(), order.end(), [&x](size_t a, size_t b) { return x[a] < x[b]; });
+    }
+
+    double first = x[order.front()];
+    double span = x[order.back()] - first;
+    if (!(span > 0.0)) {
+        std::vector<double> samples(n);
+        for (size_t i = 0; i < n; ++i) samples[i] = y[order[i]];
+        return samples;
+    }
+
+    double dt = span / (n - 1);
+    if (spacing) *spacing = dt;
+
+    bool uniform = true;
+    for (size_t i = 0; i < n && uniform; ++i) {
+        uniform = std::abs(x[order[i]] - (first + i * dt)) <= 1e-6 * span;
+    }
+
+    std::vector<double> samples(n);
+    if (uniform) {
+        for (size_t i = 0; i < n; ++i) samples[i] = y[order[i]];
+        return samples;
+    }
+
+    // 非等间距：在等间距网格上线性插值
+    size_t j = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double t = first + i * dt;
+        while (j + 2 < n && x[order[j + 1]] < t) ++j;
+        double x0 = x[order[j]], x1 = x[order[j + 1]];
+        double y0 = y[order[j]], y1 = y[order[j + 1]];
+        samples[i] = (x1 > x0) ? y0 + (y1 - y0) * (t - x0) / (x1 - x0) : y0;
+    }
+    return samples;
+}
+
+SpectrumResult SpectrumEngine::compute(const std::vector<double>& x, const std::vector<double>& y,
+                                       const SpectrumSpec& spec)
+{
+    SpectrumResult result;
+    double dt = 1.0;
+    std::vector<double> samples = uniformSamples(x, y, &dt);
+    size_t n = samples.size();
+    if (n < 4) return result;
+
+    size_t segmentLength = (spec.segmentLength > 0) ? std::min<size_t>(spec.segmentLength, n) : n;
+    segmentLength = std::max<size_t>(segmentLength, 4);
+    size_t step = std::max<size_t>(1, segmentLength / 2);
+    size_t segments = 1 + (n - segmentLength) / step;
+    size_t bins = segmentLength / 2 + 1;
+
+    std::vector<double> w = window(spec.window, segmentLength);
+    double windowPower = 0.0;
+    for (double v : w) windowPower += v * v;
+    double fs = 1.0 / dt;
+
+    // 每个线程负责连续的若干段，局部累加后按块序号合并，结果与线程数无关
+    size_t chunks = std::min<size_t>(segments, workerThreadCount());
+    std::vector<std::vector<double>> partial(chunks, std::vector<double>(bins, 0.0));
+    parallelForChunks(segments, chunks, [&](size_t chunk, size_t begin, size_t end) {
+        std::vector<std::complex<double>> buffer(segmentLength);
+        std::vector<double>& power = partial[chunk];
+        for (size_t s = begin; s < end; ++s) {
+            const double* segment = samples.data() + s * step;
+            // 去掉段内均值，避免直流泄漏淹没低频
+            double mean = std::accumulate(segment, segment + segmentLength, 0.0) / segmentLength;
+            for (size_t i = 0; i < segmentLength; ++i) {
+                buffer[i] = std::complex<double>((segment[i] - mean) * w[i], 0.0);
+            }
+            fft(buffer);
+            for (size_t k = 0; k < bins; ++k) {
+                power[k] += std::norm(buffer[k]);
+            }
+        }
+    });
+
+    result.frequency.resize(bins);
+    result.power.assign(bins, 0.0);
+    for (const auto& power : partial) {
+        for (size_t k = 0; k < bins; ++k) {
+            result.power[k] += power[k];
+        }
+    }
+
+    // 单边谱：除直流和（偶数长度时的）奈奎斯特频点外乘 2
+    double scale = 1.0 / (fs * windowPower * segments);
+    for (size_t k = 0; k < bins; ++k) {
+        bool interior = k > 0 && !(segmentLength % 2 == 0 && k == bins - 1);
+        result.power[k] *= scale * (interior ? 2.0 : 1.0);
+        result.frequency[k] = k * fs / segmentLength;
+    }
+    result.sampleSpacing = dt;
+    result.segments = segments;
+
+    // 主峰：跳过直流，对相邻三个频点做抛物线插值
+    if (bins > 2) {
+        size_t peak = std::max_element(result.power.begin() + 1, result.power.end()) - result.power.begin();
+        double offset = 0.0;
+        if (peak + 1 < bins) {
+            double a = result.power[peak - 1], b = result.power[peak], c = result.power[peak + 1];
+            double denom = a - 2.0 * b + c;
+            if (denom < 0.0) offset = std::max(-0.5, std::min(0.5, 0.5 * (a - c) / denom));
+        }
+        result.peakFrequency = (peak + offset) * fs / segmentLength;
+        result.peakPower = result.power[peak];
+    }
+    return result;
+}
+
+double SpectrumEngine::dominantFrequency(const std::vector<double>& x, const std::vector<double>& y)
+{
+    SpectrumSpec spec;
+    spec.window = WindowFunction::Hann;
+    spec.segmentLength = 0;
+    return compute(x, y, spec).peakFrequency;
+}
@@ -0,0 +1,53 @@
+#ifndef SPECTRUM_ENGINE_H
+#define SPECTRUM_ENGINE_H
+
+#include <vector>
+#include <cstddef>
+
+// 频谱分析使用的窗函数
+enum class WindowFunction {
+    Rectangular,
+    Hann,
+    Hamming,
+    Blackman
+};
+
+struct SpectrumSpec {
+    WindowFunction window = WindowFunction::Hann;
+    int segmentLength = 0;   // 0 表示整段周期图；>0 时按 Welch 方法分段（50% 重叠）平均
+
+    bool operator==(const SpectrumSpec& other) const {
+        return window == other.window && segmentLength == other.segmentLength;
+    }
+    bool operator!=(const SpectrumSpec& other) const { return !(*this == other); }
+};
+
+struct SpectrumResult {
+    std::vector<double> frequency;   // 每个 X 单位内的周期数
+    std::vector<double> power;       // 单边功率谱密度
+    double sampleSpacing = 1.0;      // 等间距化之后的采样间隔
+    double peakFrequency = 0.0;      // 除直流外的最大峰，经抛物线插值细化
+    double peakPower = 0.0;
+    size_t segments = 0;
+
+    bool isEmpty() const { return frequency.empty(); }
+};
+
+// 周期图 / Welch 功率谱：任意段长直接做 FFT（非 2 的幂走 Bluestein），各段并行计算
+class SpectrumEngine
+{
+public:
+    static std::vector<double> window(WindowFunction type, size_t length);
+
+    // 把 (x, y) 整理为按 x 等间距的序列：乱序时先排序，间距不均匀时线性插值
+    static std::vector<double> uniformSamples(const std::vector<double>& x, const std::vector<double>& y,
+                                              double* spacing);
+
+    static SpectrumResult compute(const std::vector<double>& x, const std::vector<double>& y,
+                                  const SpectrumSpec& spec);
+
+    // 主频（每个 X 单位内的周期数），数据不足时返回 0
+    static double dominantFrequency(const std::vector<double>& x, const std::vector<double>& y);
+};
+
+#endif // SPECTRUM_ENGINE_H
@@ -0,0 +1,235 @@
+#include "statistics_accumulator.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+QuantileSketch::QuantileSketch(double compression, size_t exactCapacity)
+    : compression(std::max(20.0, compression)), exactCapacity(exactCapacity)
+{
+}
+
+void QuantileSketch::add(double value, double weight)
+{
+    if (!std::isfinite(value) || weight <= 0.0) return;
+
+    buffer.push_back({value, weight});
+    bufferWeight += weight;
+
+    // 缓冲区满时批量并入，摊还后每个样本 O(log b)
+    size_t bufferLimit = std::max(exactCapacity, static_cast<size_t>(compression * 5));
+    if (buffer.size() >= bufferLimit) {
+        flush();
+    }
+}
+
+void QuantileSketch::append(const double* values, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        add(values[i]);
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    other.flush();
+    for (const Centroid& c : other.centroids) {
+        buffer.push_back(c);
+        bufferWeight += c.weight;
+    }
+    compressed = compressed || other.compressed;
+    flush();
+}
+
+void QuantileSketch::clear()
+{
+    centroids.clear();
+    buffer.clear();
+    totalWeight = 0.0;
+    bufferWeight = 0.0;
+    compressed = false;
+}
+
+bool QuantileSketch::isExact() const
+{
+    flush();
+    return !compressed;
+}
+
+void QuantileSketch::flush() const
+{
+    if (buffer.empty()) return;
+
+    std::sort(buffer.begin(), buffer.end(), [](const Centroid& a, const Centroid& b) {
+        return a.mean < b.mean;
+    });
+
+    std::vector<Centroid> merged;
+    merged.reserve(centroids.size() + buffer.size());
+    std::merge(centroids.begin(), centroids.end(), buffer.begin(), buffer.end(),
+               std::back_inserter(merged), [](const Centroid& a, const Centroid& b) {
+                   return a.mean < b.mean;
+               });
+
+    centroids.swap(merged);
+    totalWeight += bufferWeight;
+    buffer.clear();
+    bufferWeight = 0.0;
+
+    if (compressed || totalWeight > static_cast<double>(exactCapacity)) {
+        compress();
+    }
+}
+
+void QuantileSketch::compress() const
+{
+    if (centroids.size() <= 1) return;
+
+    // k1 尺度函数：两端质心更小，尾部分位数更精确
+    auto scale = [this](double q) {
+        return compression / (2.0 * M_PI) * std::asin(2.0 * q - 1.0);
+    };
+    auto inverseScale = [this](double k) {
+        return (std::sin(k * 2.0 * M_PI / compression) + 1.0) / 2.0;
+    };
+
+    std::vector<Centroid> result;
+    result.reserve(static_cast<size_t>(compression) * 2);
+
+    Centroid current = centroids[0];
+    double weightSoFar = 0.0;
+    double qLimit = inverseScale(scale(0.0) + 1.0);
+
+    for (size_t i = 1; i < centroids.size(); ++i) {
+        const Centroid& next = centroids[i];
+        double q = (weightSoFar + current.weight + next.weight) / totalWeight;
+        if (q <= qLimit) {
+            double w = current.weight + next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / w;
+            current.weight = w;
+        } else {
+            weightSoFar += current.weight;
+            result.push_back(current);
+            qLimit = inverseScale(scale(weightSoFar / totalWeight) + 1.0);
+            current = next;
+        }
+    }
+    result.push_back(current);
+
+    centroids.swap(result);
+    compressed = true;
+}
+
+double QuantileSketch::quantile(double p) const
+{
+    flush();
+    if (centroids.empty()) return std::numeric_limits<double>::quiet_NaN();
+
+    p = std::min(1.0, std::max(0.0, p));
+    if (centroids.size() == 1) return centroids[0].mean;
+
+    if (!compressed) {
+        // 精确模式：与排序后线性插值（R type 7）一致
+        double h = (centroids.size() - 1) * p;
+        size_t lo = static_cast<size_t>(std::floor(h));
+        size_t hi = std::min(lo + 1, centroids.size() - 1);
+        return centroids[lo].mean + (h - lo) * (centroids[hi].mean - centroids[lo].mean);
+    }
+
+    // 压缩模式：在相邻质心中心之间插值
+    double target = p * totalWeight;
+    double cumulative = 0.0;
+    double firstCenter = centroids[0].weight / 2.0;
+    if (target <= firstCenter) {
+        return centroids[0].mean;
+    }
+
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+        double left = cumulative + centroids[i].weight / 2.0;
+        double right = cumulative + centroids[i].weight + centroids[i + 1].weight / 2.0;
+        if (target <= right) {
+            double t = (right > left) ? (target - left) / (right - left) : 0.0;
+            return centroids[i].mean + t * (centroids[i + 1].mean - centroids[i].mean);
+        }
+        cumulative += centroids[i].weight;
+    }
+    return centroids.back().mean;
+}
+
+void StatisticsAccumulator::append(const double* values, size_t count)
+{
+    // 非有限值（NaN/±Inf）一律跳过：计数、均值、方差、极值与分位数草图（它同样丢弃非有限值）看到的是同一批数据
+    // 先对新批次做两遍扫描得到局部均值和 M2，再用 Chan 公式合并
+    size_t batchCount = 0;
+    double batchSum = 0.0;
+    double batchMin = std::numeric_limits<double>::infinity();
+    double batchMax = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(values[i])) continue;
+        ++batchCount;
+        batchSum += values[i];
+        batchMin = std::min(batchMin, values[i]);
+        batchMax = std::max(batchMax, values[i]);
+    }
+    if (batchCount == 0) return;
+
+    double batchMean = batchSum / batchCount;
+    double batchM2 = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(values[i])) continue;
+        double d = values[i] - batchMean;
+        batchM2 += d * d;
+    }
+
+    size_t newCount = n + batchCount;
+    double delta = batchMean - meanValue;
+    meanValue += delta * batchCount / newCount;
+    m2 += batchM2 + delta * delta * (static_cast<double>(n) * batchCount / newCount);
+    total += batchSum;
+    minValue = std::min(minValue, batchMin);
+    maxValue = std::max(maxValue, batchMax);
+    n = newCount;
+
+    quantiles.append(values, count);
+}
+
+void StatisticsAccumulator::merge(const StatisticsAccumulator& other)
+{
+    if (other.n == 0) return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+
+    size_t newCount = n + other.n;
+    double delta = other.meanValue - meanValue;
+    meanValue += delta * other.n / newCount;
+    m2 += other.m2 + delta * delta * (static_cast<double>(n) * other.n / newCount);
+    total += other.total;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    n = newCount;
+
+    quantiles.merge(other.quantiles);
+}
+
+void StatisticsAccumulator::clear()
+{
+    *this = StatisticsAccumulator();
+}
+
+double StatisticsAccumulator::stddev() const
+{
+    return std::sqrt(variance());
+}
+
+double StatisticsAccumulator::quantile(double p) const
+{
+    if (n == 0) return std::numeric_limits<double>::quiet_NaN();
+    // 两端用精确的极值，压缩后的首尾质心可能已合并了多个样本
+    if (p <= 0.0) return minValue;
+    if (p >= 1.0) return maxValue;
+    return std::min(maxValue, std::max(minValue, quantiles.quantile(p)));
+}
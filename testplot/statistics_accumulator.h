@@ -0,0 +1,84 @@
+#ifndef STATISTICS_ACCUMULATOR_H
+#define STATISTICS_ACCUMULATOR_H
+
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+// 可合并的分位数草图（简化的 merging t-digest）
+// 数据量不超过 exactCapacity 时保存全部样本，分位数与排序结果完全一致；
+// 超过之后压缩为带权质心，内存为 O(compression)。
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(double compression = 200.0, size_t exactCapacity = 4096);
+
+    void add(double value, double weight = 1.0);
+    void append(const double* values, size_t count);
+    void merge(const QuantileSketch& other);
+    void clear();
+
+    double quantile(double p) const;
+    double count() const { return totalWeight + bufferWeight; }
+    bool isExact() const;
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    void flush() const;
+    void compress() const;
+
+    double compression;
+    size_t exactCapacity;
+
+    // 查询时需要整理缓冲区，逻辑上保持 const
+    mutable std::vector<Centroid> centroids;
+    mutable std::vector<Centroid> buffer;
+    mutable double totalWeight = 0.0;
+    mutable double bufferWeight = 0.0;
+    mutable bool compressed = false;
+};
+
+// 增量统计累加器：追加 k 个新数据的代价为 O(k)，两个累加器可以 O(1) 合并（分位数草图除外）
+// 非有限值（NaN/±Inf）不计入任何统计量，count() 为有限值个数
+// 均值/方差使用 Welford + Chan 合并公式，数值上比“先求和再平方”稳定
+class StatisticsAccumulator
+{
+public:
+    StatisticsAccumulator() = default;
+
+    void append(const double* values, size_t count);
+    void append(const std::vector<double>& values) { append(values.data(), values.size()); }
+    void append(double value) { append(&value, 1); }
+    void merge(const StatisticsAccumulator& other);
+    void clear();
+
+    size_t count() const { return n; }
+    bool isEmpty() const { return n == 0; }
+    double sum() const { return total; }
+    double mean() const { return meanValue; }
+    double variance() const { return n > 0 ? m2 / n : 0.0; }         // 总体方差，与原实现保持一致
+    double sampleVariance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+    double stddev() const;
+    double min() const { return minValue; }
+    double max() const { return maxValue; }
+    double range() const { return n > 0 ? maxValue - minValue : 0.0; }
+
+    double quantile(double p) const;
+    double median() const { return quantile(0.5); }
+    const QuantileSketch& sketch() const { return quantiles; }
+
+private:
+    size_t n = 0;
+    double total = 0.0;
+    double meanValue = 0.0;
+    double m2 = 0.0;
+    double minValue = std::numeric_limits<double>::infinity();
+    double maxValue = -std::numeric_limits<double>::infinity();
+    QuantileSketch quantiles;
+};
+
+#endif // STATISTICS_ACCUMULATOR_H
@@ -0,0 +1,255 @@
+#include "bootstrap_fit.h"
+#include "levenberg_marquardt.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// 直线的闭式最小二乘，重拟合的参考实现
+FitModel lineFit(const std::vector<double>& x, const std::vector<double>& y)
+{
+    size_t n = x.size();
+    double mx = 0.0, my = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= n;
+    my /= n;
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sxx += (x[i] - mx) * (x[i] - mx);
+        sxy += (x[i] - mx) * (y[i] - my);
+    }
+    if (!(sxx > 0.0)) return FitModel();
+    double slope = sxy / sxx;
+    return FitModel(1, {my - slope * mx, slope});
+}
+
+// y = 1 + 2x + N(0, σ²)，x 在 [0, 10] 上等距
+void makeLine(size_t n, double sigma, unsigned seed, std::vector<double>& x, std::vector<double>& y)
+{
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> noise(0.0, sigma);
+    x.resize(n);
+    y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 10.0 * i / (n - 1);
+        y[i] = 1.0 + 2.0 * x[i] + noise(rng);
+    }
+}
+
+bool sameResult(const BootstrapResult& a, const BootstrapResult& b)
+{
+    return a.valid == b.valid && a.replicates == b.replicates && a.failures == b.failures &&
+           a.parameterLower == b.parameterLower && a.parameterUpper == b.parameterUpper &&
+           a.parameterStdDev == b.parameterStdDev && a.bandX == b.bandX && a.bandLower == b.bandLower &&
+           a.bandUpper == b.bandUpper;
+}
+
+// 固定种子时结果逐位可复现，与线程数无关；换种子结果改变
+void testDeterminism()
+{
+    std::vector<double> x, y;
+    makeLine(200, 0.5, 1, x, y);
+    FitModel fitted = lineFit(x, y);
+    for (BootstrapMethod method : {BootstrapMethod::Residuals, BootstrapMethod::Pairs}) {
+        BootstrapOptions options;
+        options.method = method;
+        options.replicates = 301;
+        workerThreadLimit().store(1);
+        BootstrapResult reference = Bootstrap::run(x, y, fitted, lineFit, options);
+        CHECK(reference.valid && reference.replicates == 301 && reference.failures == 0);
+        CHECK(sameResult(reference, Bootstrap::run(x, y, fitted, lineFit, options)));
+        for (unsigned limit : {2u, 3u, 8u, 0u}) {
+            workerThreadLimit().store(limit);
+            bool same = sameResult(reference, Bootstrap::run(x, y, fitted, lineFit, options));
+            if (!same) std::printf("  %s: differs with %u threads\n", Bootstrap::methodName(method), limit);
+            CHECK(same);
+        }
+        workerThreadLimit().store(0);
+
+        options.seed += 1;
+        BootstrapResult other = Bootstrap::run(x, y, fitted, lineFit, options);
+        CHECK(other.valid && other.parameterLower != reference.parameterLower);
+    }
+}
+
+// 区间包含真值，标准差与解析标准误相符，置信带包含原拟合曲线；
+// 多组独立数据上 95% 区间的覆盖率接近名义值
+void testCoverage()
+{
+    const size_t n = 100;
+    const double sigma = 0.5;
+    std::vector<double> x, y;
+    makeLine(n, sigma, 5, x, y);
+    double mx = 5.0, sxx = 0.0;
+    for (double v : x) sxx += (v - mx) * (v - mx);
+    double slopeError = sigma / std::sqrt(sxx);
+
+    FitModel fitted = lineFit(x, y);
+    for (BootstrapMethod method : {BootstrapMethod::Residuals, BootstrapMethod::Pairs}) {
+        BootstrapOptions options;
+        options.method = method;
+        options.replicates = 2000;
+        BootstrapResult result = Bootstrap::run(x, y, fitted, lineFit, options);
+        CHECK(result.valid);
+        if (!result.valid) continue;
+        CHECK(result.parameterLower[0] < 1.0 && 1.0 < result.parameterUpper[0]);
+        CHECK(result.parameterLower[1] < 2.0 && 2.0 < result.parameterUpper[1]);
+        double ratio = result.parameterStdDev[1] / slopeError;
+        if (!(ratio > 0.85 && ratio < 1.15)) std::printf("  %s: slope SD / SE = %g\n",
+                                                        Bootstrap::methodName(method), ratio);
+        CHECK(ratio > 0.85 && ratio < 1.15);
+
+        CHECK(result.bandX.size() == options.bandPoints);
+        CHECK(result.bandX.front() == 0.0 && result.bandX.back() == 10.0);
+        bool inside = true;
+        std::vector<double> curve = fitted.evaluate(result.bandX);
+        for (size_t j = 0; j < result.bandX.size(); ++j) {
+            inside = inside && result.bandLower[j] < curve[j] && curve[j] < result.bandUpper[j];
+        }
+        CHECK(inside);
+    }
+
+    const int datasets = 200;
+    int intercepts = 0, slopes = 0;
+    for (int d = 0; d < datasets; ++d) {
+        makeLine(n, sigma, 100 + d, x, y);
+        BootstrapOptions options;
+        options.replicates = 400;
+        options.seed = 7 + d;
+        BootstrapResult result = Bootstrap::run(x, y, lineFit(x, y), lineFit, options);
+        if (!result.valid) continue;
+        intercepts += result.parameterLower[0] < 1.0 && 1.0 < result.parameterUpper[0];
+        slopes += result.parameterLower[1] < 2.0 && 2.0 < result.parameterUpper[1];
+    }
+    if (!(intercepts >= 180 && intercepts <= 198 && slopes >= 180 && slopes <= 198)) {
+        std::printf("  coverage: intercept %d, slope %d of %d\n", intercepts, slopes, datasets);
+    }
+    CHECK(intercepts >= 180 && intercepts <= 198);
+    CHECK(slopes >= 180 && slopes <= 198);
+}
+
+// 重拟合失败的次数单独计数，区间只由成功的重拟合给出
+void testFailedRefits()
+{
+    std::vector<double> x, y;
+    makeLine(50, 0.5, 3, x, y);
+    FitModel fitted = lineFit(x, y);
+    BootstrapRefit flaky = [&fitted](const std::vector<double>& sx, const std::vector<double>& sy) {
+        return sy[0] > fitted.evaluate(sx)[0] ? FitModel() : lineFit(sx, sy);
+    };
+    BootstrapOptions options;
+    options.replicates = 200;
+    BootstrapResult result = Bootstrap::run(x, y, fitted, flaky, options);
+    CHECK(result.valid);
+    CHECK(result.failures > 50 && result.replicates > 50);
+    CHECK(result.replicates + result.failures == 200);
+
+    BootstrapRefit never = [](const std::vector<double>&, const std::vector<double>&) { return FitModel(); };
+    result = Bootstrap::run(x, y, fitted, never, options);
+    CHECK(!result.valid && result.failures == 200);
+
+    options.replicates = 1;
+    CHECK(!Bootstrap::run(x, y, fitted, lineFit, options).valid);
+    options.replicates = 100;
+    CHECK(!Bootstrap::run({0.0, 1.0}, {1.0, 3.0}, fitted, lineFit, options).valid);
+    CHECK(!Bootstrap::run(x, y, FitModel(), lineFit, options).valid);
+}
+
+void testNearestEquivalentAngle()
+{
+    CHECK_CLOSE(nearestEquivalentAngle(-3.1, 3.1), 2.0 * M_PI - 3.1, 1e-15);
+    CHECK_CLOSE(nearestEquivalentAngle(3.1, -3.1), 3.1 - 2.0 * M_PI, 1e-15);
+    CHECK(nearestEquivalentAngle(0.4, 0.5) == 0.4);
+    CHECK_CLOSE(nearestEquivalentAngle(7.0, 0.5), 7.0 - 2.0 * M_PI, 1e-15);
+    CHECK_CLOSE(nearestEquivalentAngle(-20.0, 1.0), -20.0 + 6.0 * M_PI, 1e-14);
+}
+
+// 正弦重拟合：与界面的正弦拟合一样，振幅取正、相位归到 (-π, π]；align 时再与原相位对齐
+BootstrapRefit sineRefit(const FitModel& fitted, bool align)
+{
+    return [&fitted, align](const std::vector<double>& x, const std::vector<double>& y) {
+        LevenbergMarquardtResult fit = LevenbergMarquardt::fit(x, y, NonlinearModel(sineModel), fitted.coefficients());
+        if (!fit.converged()) return FitModel();
+        std::vector<double> p = fit.parameters;
+        if (p[0] < 0.0) {
+            p[0] = -p[0];
+            p[2] += M_PI;
+        }
+        p[2] = std::remainder(p[2], 2.0 * M_PI);
+        if (align) p[2] = nearestEquivalentAngle(p[2], fitted.coefficients()[2]);
+        return FitModel(3, p);
+    };
+}
+
+// 真实相位 3.12 靠近 π：重拟合的相位一部分越过 π 被归到 -π 附近。
+// 对齐前相位区间被拉成几乎整个圆周，对齐后区间很窄、以原相位为中心并包含真值
+void testSinePhaseWrap()
+{
+    const double truth[4] = {2.0, 1.3, 3.12, 0.5};
+    std::mt19937_64 rng(4);
+    std::normal_distribution<double> noise(0.0, 0.4);
+    std::vector<double> x(200), y(200);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = 10.0 * i / (x.size() - 1);
+        y[i] = sineModel(x[i], truth, nullptr) + noise(rng);
+    }
+    LevenbergMarquardtResult original = LevenbergMarquardt::fit(x, y, NonlinearModel(sineModel),
+                                                                {1.8, 1.28, 3.0, 0.4});
+    CHECK(original.converged());
+    std::vector<double> p = original.parameters;
+    p[2] = std::remainder(p[2], 2.0 * M_PI);
+    FitModel fitted(3, p);
+
+    BootstrapOptions options;
+    options.replicates = 500;
+    for (BootstrapMethod method : {BootstrapMethod::Residuals, BootstrapMethod::Pairs}) {
+        options.method = method;
+        const char* name = Bootstrap::methodName(method);
+        BootstrapResult wrapped = Bootstrap::run(x, y, fitted, sineRefit(fitted, false), options);
+        CHECK(wrapped.valid);
+        if (!(wrapped.parameterUpper[2] - wrapped.parameterLower[2] > M_PI)) {
+            std::printf("  %s: unaligned phases do not wrap, interval [%g, %g]\n", name, wrapped.parameterLower[2],
+                        wrapped.parameterUpper[2]);
+        }
+        CHECK(wrapped.parameterUpper[2] - wrapped.parameterLower[2] > M_PI);
+
+        BootstrapResult result = Bootstrap::run(x, y, fitted, sineRefit(fitted, true), options);
+        CHECK(result.valid && result.failures == 0);
+        double lower = result.parameterLower[2], upper = result.parameterUpper[2];
+        if (!(upper - lower < 0.5 && lower < p[2] && p[2] < upper && lower < truth[2] && truth[2] < upper)) {
+            std::printf("  %s: phase interval [%g, %g], fitted %g\n", name, lower, upper, p[2]);
+        }
+        CHECK(upper - lower < 0.5);
+        CHECK(upper > M_PI);
+        CHECK(lower < p[2] && p[2] < upper);
+        CHECK(lower < truth[2] && truth[2] < upper);
+        CHECK(result.parameterStdDev[2] < 0.2);
+        // 其余参数不受相位对齐影响
+        for (size_t k : {0u, 1u, 3u}) {
+            CHECK(result.parameterLower[k] == wrapped.parameterLower[k]);
+            CHECK(result.parameterLower[k] < truth[k] && truth[k] < result.parameterUpper[k]);
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testDeterminism();
+    testCoverage();
+    testFailedRefits();
+    testNearestEquivalentAngle();
+    testSinePhaseWrap();
+    return testResult("bootstrap_fit_test");
+}
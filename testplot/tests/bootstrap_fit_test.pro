@@ -0,0 +1,11 @@
+include(tests.pri)
+TARGET = bootstrap_fit_test
+
+SOURCES += bootstrap_fit_test.cpp \
+           ../bootstrap_fit.cpp \
+           ../fit_model.cpp \
+           ../model_expression.cpp \
+           ../smoothing_fit.cpp \
+           ../levenberg_marquardt.cpp
+HEADERS += ../bootstrap_fit.h ../fit_model.h ../model_expression.h ../smoothing_fit.h \
+           ../levenberg_marquardt.h ../fit_progress.h ../parallel_utils.h
@@ -0,0 +1,111 @@
+#include "box_summary.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 全排序后 R type 7 分位数
+double sortedQuantile(const std::vector<double>& sorted, double p)
+{
+    double h = (sorted.size() - 1) * p;
+    size_t lo = static_cast<size_t>(std::floor(h));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (h - lo) * (sorted[hi] - sorted[lo]);
+}
+
+bool matchesSorted(const std::vector<double>& data)
+{
+    BoxSummary summary = BoxSummaryEngine::compute(data);
+    std::vector<double> sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+    double q1 = sortedQuantile(sorted, 0.25), median = sortedQuantile(sorted, 0.5), q3 = sortedQuantile(sorted, 0.75);
+    double lowerFence = q1 - 1.5 * (q3 - q1), upperFence = q3 + 1.5 * (q3 - q1);
+    double lowerWhisker = q1, upperWhisker = q3;
+    std::vector<double> outliers;
+    for (double v : data) {
+        if (v < lowerFence || v > upperFence) {
+            outliers.push_back(v);
+        } else {
+            lowerWhisker = std::min(lowerWhisker, v);
+            upperWhisker = std::max(upperWhisker, v);
+        }
+    }
+    return summary.count == data.size() && summary.q1 == q1 && summary.median == median && summary.q3 == q3
+        && summary.minValue == sorted.front() && summary.maxValue == sorted.back()
+        && summary.lowerWhisker == lowerWhisker && summary.upperWhisker == upperWhisker && summary.outliers == outliers;
+}
+
+void testSmall()
+{
+    // n < 4 和手算的例子
+    BoxSummary one = BoxSummaryEngine::compute({7.0});
+    CHECK(one.q1 == 7.0 && one.median == 7.0 && one.q3 == 7.0 && one.outliers.empty());
+    BoxSummary two = BoxSummaryEngine::compute({4.0, 2.0});
+    CHECK(two.q1 == 2.5 && two.median == 3.0 && two.q3 == 3.5);
+    BoxSummary three = BoxSummaryEngine::compute({3.0, 1.0, 2.0});
+    CHECK(three.q1 == 1.5 && three.median == 2.0 && three.q3 == 2.5);
+    CHECK(three.lowerWhisker == 1.0 && three.upperWhisker == 3.0);
+
+    // 1..8 与一个离群点 100：Q1 = 3，Q3 = 7，上栅栏 13，上须线停在 8
+    BoxSummary outlier = BoxSummaryEngine::compute({5, 100, 1, 7, 3, 2, 8, 6, 4});
+    CHECK(outlier.q1 == 3.0 && outlier.median == 5.0 && outlier.q3 == 7.0);
+    CHECK(outlier.upperWhisker == 8.0 && outlier.lowerWhisker == 1.0);
+    CHECK((outlier.outliers == std::vector<double>{100.0}));
+    CHECK(outlier.maxValue == 100.0);
+
+    CHECK(BoxSummaryEngine::compute(std::vector<double>()).isEmpty());
+}
+
+void testAgainstSorted()
+{
+    // 奇偶 n、大量重复值和重尾数据都与全排序的结果逐位相同
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::student_t_distribution<double> heavy(1.5);
+    bool allMatch = true;
+    for (size_t n = 1; n <= 64; ++n) {
+        for (int trial = 0; trial < 20; ++trial) {
+            std::vector<double> data(n);
+            for (double& v : data) {
+                switch (trial % 3) {
+                case 0: v = normal(rng); break;
+                case 1: v = std::floor(normal(rng) * 2.0); break;
+                default: v = heavy(rng); break;
+                }
+            }
+            if (!matchesSorted(data)) {
+                std::printf("  mismatch for n = %zu, trial %d\n", n, trial);
+                allMatch = false;
+            }
+        }
+    }
+    CHECK(allMatch);
+
+    std::vector<double> large(100001);
+    for (double& v : large) v = heavy(rng);
+    CHECK(matchesSorted(large));
+}
+
+void testEngineCache()
+{
+    std::vector<double> a = {1, 2, 3, 4}, b = {10, 20};
+    BoxSummaryEngine engine;
+    const std::vector<BoxSummary>& first = engine.summaries(1, {&a, &b});
+    CHECK(first.size() == 2 && first[0].median == 2.5 && first[1].median == 15.0);
+    a.push_back(100.0);
+    CHECK(engine.summaries(1, {&a, &b})[0].count == 4);
+    CHECK(engine.summaries(2, {&a, &b})[0].count == 5);
+}
+
+} // namespace
+
+int main()
+{
+    testSmall();
+    testAgainstSorted();
+    testEngineCache();
+    return testResult("box_summary_test");
+}
@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = box_summary_test
+
+SOURCES += box_summary_test.cpp \
+           ../box_summary.cpp
+HEADERS += ../box_summary.h ../parallel_utils.h
@@ -0,0 +1,144 @@
+#include "correlation_engine.h"
+#include "test_check.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 逐对直接计算的 O(p²n) 参考：两遍求均值和协方差
+std::vector<double> directCovariance(const std::vector<std::vector<double>>& columns, size_t n)
+{
+    size_t m = columns.size();
+    std::vector<double> means(m, 0.0), covariance(m * m, 0.0);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t r = 0; r < n; ++r) means[i] += columns[i][r];
+        means[i] /= n;
+    }
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            double sum = 0.0;
+            for (size_t r = 0; r < n; ++r) sum += (columns[i][r] - means[i]) * (columns[j][r] - means[j]);
+            covariance[i * m + j] = sum / (n - 1);
+        }
+    }
+    return covariance;
+}
+
+// 秩 = 比它小的个数 + (与它相等的个数 + 1) / 2
+std::vector<double> directRanks(const std::vector<double>& data, size_t n)
+{
+    std::vector<double> ranks(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t less = 0, equal = 0;
+        for (size_t j = 0; j < n; ++j) {
+            if (data[j] < data[i]) ++less;
+            if (data[j] == data[i]) ++equal;
+        }
+        ranks[i] = less + (equal + 1) * 0.5;
+    }
+    return ranks;
+}
+
+std::vector<const std::vector<double>*> pointers(const std::vector<std::vector<double>>& columns)
+{
+    std::vector<const std::vector<double>*> result;
+    for (const std::vector<double>& column : columns) result.push_back(&column);
+    return result;
+}
+
+void checkMatrix(const CorrelationMatrix& matrix, const std::vector<std::vector<double>>& reference, size_t n)
+{
+    size_t m = reference.size();
+    std::vector<double> covariance = directCovariance(reference, n);
+    CHECK(matrix.size == m && matrix.sampleCount == n);
+    double covarianceError = 0.0, correlationError = 0.0;
+    bool nanMatches = true, symmetric = true;
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            double vi = covariance[i * m + i], vj = covariance[j * m + j];
+            covarianceError = std::fmax(covarianceError, std::fabs(matrix.covariance[i * m + j] - covariance[i * m + j])
+                                                             / std::sqrt(std::fmax(vi * vj, 1e-300)));
+            double a = matrix.at(i, j), b = matrix.at(j, i);
+            symmetric = symmetric && (a == b || (std::isnan(a) && std::isnan(b)));
+            if (vi == 0.0 || vj == 0.0) {
+                nanMatches = nanMatches && std::isnan(matrix.at(i, j));
+                continue;
+            }
+            double r = covariance[i * m + j] / std::sqrt(vi * vj);
+            correlationError = std::fmax(correlationError, std::fabs(matrix.at(i, j) - r));
+        }
+    }
+    CHECK(covarianceError < 1e-12);
+    CHECK(correlationError < 1e-12);
+    CHECK(nanMatches);
+    CHECK(symmetric);
+}
+
+void testPearson()
+{
+    // 37 列跨两个列块，1100 行跨三个行块（都不是整块），第 5 列为常数
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    size_t m = 37, n = 1100;
+    std::vector<std::vector<double>> columns(m, std::vector<double>(n));
+    for (size_t r = 0; r < n; ++r) {
+        double common = normal(rng);
+        for (size_t i = 0; i < m; ++i) columns[i][r] = 100.0 * i + (i % 4) * common + normal(rng);
+        columns[5][r] = 3.0;
+    }
+    columns[36].push_back(1.0);   // 较长的列只取前 n 行
+
+    CorrelationMatrix matrix = CorrelationEngine::compute(pointers(columns), CorrelationMethod::Pearson);
+    checkMatrix(matrix, columns, n);
+    CHECK(matrix.at(0, 0) == 1.0);
+    CHECK(std::isnan(matrix.at(5, 5)));
+}
+
+void testSpearman()
+{
+    // 手算：x 的秩 {1, 2.5, 2.5, 4}，y 的秩 {1, 3, 2, 4}，r = 4.5 / sqrt(4.5 · 5)
+    std::vector<double> x = {1.0, 2.0, 2.0, 3.0}, y = {10.0, 30.0, 20.0, 40.0};
+    CHECK((CorrelationEngine::rankTransform(x, 4) == std::vector<double>{1.0, 2.5, 2.5, 4.0}));
+    CorrelationMatrix small = CorrelationEngine::compute({&x, &y}, CorrelationMethod::Spearman);
+    CHECK_CLOSE(small.at(0, 1), 4.5 / std::sqrt(22.5), 1e-15);
+
+    // 大量并列值（取整后的数据），单调变换不改变秩相关
+    std::mt19937_64 rng(2);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    size_t m = 35, n = 600;
+    std::vector<std::vector<double>> columns(m, std::vector<double>(n)), ranks(m);
+    for (size_t r = 0; r < n; ++r) {
+        double common = normal(rng);
+        for (size_t i = 0; i < m; ++i) columns[i][r] = std::round(2.0 * ((i % 3) * common + normal(rng)));
+    }
+    for (size_t r = 0; r < n; ++r) columns[1][r] = std::exp(columns[0][r]);
+    for (size_t i = 0; i < m; ++i) {
+        ranks[i] = directRanks(columns[i], n);
+        CHECK(CorrelationEngine::rankTransform(columns[i], n) == ranks[i]);
+    }
+    CorrelationMatrix matrix = CorrelationEngine::compute(pointers(columns), CorrelationMethod::Spearman);
+    checkMatrix(matrix, ranks, n);
+    CHECK_CLOSE(matrix.at(0, 1), 1.0, 1e-15);
+}
+
+void testCache()
+{
+    std::vector<double> a = {1, 2, 3}, b = {3, 1, 2};
+    CorrelationEngine engine;
+    CHECK_CLOSE(engine.matrix({1, 1}, {&a, &b}, CorrelationMethod::Pearson).at(0, 1), -0.5, 1e-15);
+    b = {1, 2, 3};
+    CHECK_CLOSE(engine.matrix({1, 1}, {&a, &b}, CorrelationMethod::Pearson).at(0, 1), -0.5, 1e-15);
+    CHECK_CLOSE(engine.matrix({1, 2}, {&a, &b}, CorrelationMethod::Pearson).at(0, 1), 1.0, 1e-15);
+    CHECK(CorrelationEngine::compute({}, CorrelationMethod::Pearson).isEmpty());
+}
+
+} // namespace
+
+int main()
+{
+    testPearson();
+    testSpearman();
+    testCache();
+    return testResult("correlation_engine_test");
+}
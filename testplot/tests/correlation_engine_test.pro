@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = correlation_engine_test
+
+SOURCES += correlation_engine_test.cpp \
+           ../correlation_engine.cpp
+HEADERS += ../correlation_engine.h ../parallel_utils.h
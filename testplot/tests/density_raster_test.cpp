@@ -0,0 +1,135 @@
+#include "density_raster.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+// 逐点计数的参考：x ∈ [xMin, xMax)、y ∈ (yMin, yMax]，第 0 行对应 y 的上界
+std::vector<uint32_t> directCounts(const std::vector<double>& x, const std::vector<double>& y, int width, int height,
+                                   double xMin, double xMax, double yMin, double yMax)
+{
+    std::vector<uint32_t> counts(static_cast<size_t>(width) * height, 0);
+    for (size_t i = 0; i < x.size(); ++i) {
+        double column = (x[i] - xMin) * (width / (xMax - xMin));
+        double row = (yMax - y[i]) * (height / (yMax - yMin));
+        if (!(column >= 0.0 && column < width && row >= 0.0 && row < height)) continue;
+        ++counts[static_cast<size_t>(row) * width + static_cast<size_t>(column)];
+    }
+    return counts;
+}
+
+void testSmallGrid()
+{
+    std::vector<double> x = {0.0, 0.5, 0.99, 1.0, 0.2, NaN}, y = {1.0, 0.5, 0.01, 0.5, NaN, 0.3};
+    DensityGrid grid = DensityRasterizer::accumulate(x, y, 2, 2, 0.0, 1.0, 0.0, 1.0);
+    CHECK(grid.width == 2 && grid.height == 2);
+    // (0, 1) 在左上，(0.5, 0.5) 与 (0.99, 0.01) 在右下；x = 1 在范围外，NaN 被跳过
+    CHECK((grid.counts == std::vector<uint32_t>{1, 0, 0, 2}));
+    CHECK(grid.inside == 3);
+    CHECK(grid.maxCount == 2);
+
+    CHECK(DensityRasterizer::accumulate(x, y, 0, 2, 0.0, 1.0, 0.0, 1.0).isEmpty());
+    CHECK(DensityRasterizer::accumulate(x, y, 2, 2, 1.0, 1.0, 0.0, 1.0).isEmpty());
+
+    double xMin, xMax, yMin, yMax;
+    std::vector<double> other = {2.0, -3.0, 0.0, NaN, 0.0, 0.0};
+    CHECK(DensityRasterizer::dataRange(x, {&y, &other}, xMin, xMax, yMin, yMax));
+    CHECK(xMin == 0.0 && xMax == 1.0 && yMin == -3.0 && yMax == 2.0);
+    std::vector<double> allNaN(x.size(), NaN);
+    CHECK(!DensityRasterizer::dataRange(x, {&allNaN}, xMin, xMax, yMin, yMax));
+}
+
+void testAgainstDirect()
+{
+    // 多块并行计数后合并，与逐点计数完全相同，且与线程数无关
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    size_t n = 3000000;
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = normal(rng);
+        y[i] = 0.5 * x[i] + normal(rng) * (i % 3 ? 0.2 : 1.0);
+    }
+    x[5] = NaN;
+    y[7] = std::numeric_limits<double>::infinity();
+
+    double xMin, xMax, yMin, yMax;
+    CHECK(DensityRasterizer::dataRange(x, {&y}, xMin, xMax, yMin, yMax));
+    std::vector<uint32_t> expected = directCounts(x, y, 640, 400, -2.0, 2.5, -1.5, 1.0);
+
+    workerThreadLimit().store(1);
+    DensityGrid single = DensityRasterizer::accumulate(x, y, 640, 400, -2.0, 2.5, -1.5, 1.0);
+    workerThreadLimit().store(4);
+    DensityGrid parallel = DensityRasterizer::accumulate(x, y, 640, 400, -2.0, 2.5, -1.5, 1.0);
+    workerThreadLimit().store(0);
+
+    CHECK(single.counts == expected);
+    CHECK(parallel.counts == expected);
+    size_t inside = 0;
+    uint32_t maxCount = 0;
+    for (uint32_t c : expected) {
+        inside += c;
+        maxCount = std::max(maxCount, c);
+    }
+    CHECK(parallel.inside == inside);
+    CHECK(parallel.maxCount == maxCount);
+}
+
+void testShading()
+{
+    // 空像素为 0，非空为 1..255；两种色阶都保持计数的顺序
+    std::vector<uint32_t> counts = {0, 1, 2, 3, 10, 100, 1000, 1000, 5000, 0};
+    for (DensityScale scale : {DensityScale::Log, DensityScale::EqualHistogram}) {
+        std::vector<uint8_t> levels = DensityRasterizer::shade(counts, 5000, scale);
+        CHECK(levels.size() == counts.size());
+        bool monotone = true, zeroEmpty = true;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            zeroEmpty = zeroEmpty && (counts[i] == 0) == (levels[i] == 0);
+            for (size_t j = 0; j < counts.size(); ++j) {
+                if (counts[i] < counts[j]) monotone = monotone && levels[i] <= levels[j];
+            }
+        }
+        CHECK(zeroEmpty);
+        CHECK(monotone);
+        CHECK(levels[1] == 1);          // 最小计数对应色阶 1
+        CHECK(levels[8] == 255);        // 最大计数对应 255
+    }
+
+    // 对数色阶：log(c) / log(max) 线性映射到 1..255
+    std::vector<uint8_t> logLevels = DensityRasterizer::shade(counts, 5000, DensityScale::Log);
+    CHECK(logLevels[5] == 1 + std::lround(254.0 * std::log(100.0) / std::log(5000.0)));
+
+    // 直方图均衡：各色阶的像素数大致相同
+    std::mt19937_64 rng(2);
+    std::exponential_distribution<double> skewed(0.001);
+    std::vector<uint32_t> many(100000);
+    uint32_t maxCount = 0;
+    for (uint32_t& c : many) {
+        c = 1 + static_cast<uint32_t>(skewed(rng));
+        maxCount = std::max(maxCount, c);
+    }
+    std::vector<uint8_t> equalized = DensityRasterizer::shade(many, maxCount, DensityScale::EqualHistogram);
+    std::vector<size_t> quarters(4, 0);
+    for (uint8_t level : equalized) ++quarters[(level - 1) * 4 / 255];
+    for (size_t q : quarters) CHECK(q > 20000 && q < 30000);
+
+    CHECK(DensityRasterizer::shade(std::vector<uint32_t>(5, 0), 0, DensityScale::Log) == std::vector<uint8_t>(5, 0));
+    CHECK((DensityRasterizer::shade({0, 1, 1}, 1, DensityScale::EqualHistogram) == std::vector<uint8_t>{0, 255, 255}));
+}
+
+} // namespace
+
+int main()
+{
+    testSmallGrid();
+    testAgainstDirect();
+    testShading();
+    return testResult("density_raster_test");
+}
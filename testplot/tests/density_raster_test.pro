@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = density_raster_test
+
+SOURCES += density_raster_test.cpp \
+           ../density_raster.cpp
+HEADERS += ../density_raster.h ../parallel_utils.h
@@ -0,0 +1,158 @@
+#include "distribution_fit.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+template <typename Distribution>
+std::vector<double> sortedSample(Distribution distribution, size_t n, unsigned seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<double> data(n);
+    for (double& v : data) v = distribution(rng);
+    std::sort(data.begin(), data.end());
+    return data;
+}
+
+double directLogLikelihood(const std::vector<double>& data, const DistributionFit& fit)
+{
+    double sum = 0.0;
+    for (double v : data) sum += std::log(fit.pdf(v));
+    return sum;
+}
+
+// KS：逐点比较经验分布函数的两侧；AD：按首尾配对的原始公式
+void checkGoodnessOfFit(const std::vector<double>& data, const DistributionFit& fit)
+{
+    size_t n = data.size();
+    double d = 0.0, sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double f = fit.cdf(data[i]);
+        d = std::max(d, std::max((i + 1.0) / n - f, f - static_cast<double>(i) / n));
+        sum += (2.0 * i + 1.0) * (std::log(f) + std::log(1.0 - fit.cdf(data[n - 1 - i])));
+    }
+    CHECK_CLOSE(fit.ksStatistic, d, 1e-14);
+    CHECK_CLOSE(DistributionFitter::kolmogorovSmirnov(data, fit), d, 1e-14);
+    CHECK_CLOSE(fit.adStatistic, -static_cast<double>(n) - sum / n, 1e-9);
+    CHECK_CLOSE(DistributionFitter::andersonDarling(data, fit), fit.adStatistic, 1e-14);
+}
+
+void testRecovery()
+{
+    // n = 20000 时极大似然估计的标准误约为参数的 1%，容差取 4 倍标准误
+    const size_t n = 20000;
+    std::vector<double> normal = sortedSample(std::normal_distribution<double>(3.0, 2.0), n, 1);
+    DistributionFit fit = DistributionFitter::fit(normal, DistributionType::Normal);
+    CHECK(fit.valid && fit.sampleCount == n);
+    CHECK(std::fabs(fit.parameters[0] - 3.0) < 4.0 * 2.0 / std::sqrt(n));
+    CHECK(std::fabs(fit.parameters[1] - 2.0) < 4.0 * 2.0 / std::sqrt(2.0 * n));
+    CHECK_CLOSE(fit.logLikelihood, directLogLikelihood(normal, fit), 1e-10);
+    checkGoodnessOfFit(normal, fit);
+    CHECK(fit.ksPValue > 0.01);
+
+    std::vector<double> logNormal = sortedSample(std::lognormal_distribution<double>(1.0, 0.5), n, 2);
+    fit = DistributionFitter::fit(logNormal, DistributionType::LogNormal);
+    CHECK(fit.valid);
+    CHECK(std::fabs(fit.parameters[0] - 1.0) < 4.0 * 0.5 / std::sqrt(n));
+    CHECK(std::fabs(fit.parameters[1] - 0.5) < 4.0 * 0.5 / std::sqrt(2.0 * n));
+    CHECK_CLOSE(fit.logLikelihood, directLogLikelihood(logNormal, fit), 1e-10);
+    checkGoodnessOfFit(logNormal, fit);
+
+    std::vector<double> exponential = sortedSample(std::exponential_distribution<double>(0.25), n, 3);
+    fit = DistributionFitter::fit(exponential, DistributionType::Exponential);
+    CHECK(fit.valid);
+    CHECK(std::fabs(fit.parameters[0] - 0.25) < 4.0 * 0.25 / std::sqrt(n));
+    CHECK_CLOSE(fit.logLikelihood, directLogLikelihood(exponential, fit), 1e-10);
+    checkGoodnessOfFit(exponential, fit);
+
+    // 指数数据用正态拟合：KS 检验应明确拒绝
+    fit = DistributionFitter::fit(exponential, DistributionType::Normal);
+    CHECK(fit.valid && fit.ksPValue < 1e-6);
+}
+
+void testWeibull()
+{
+    // 形状从很小到很大，尺度跨越多个数量级
+    const double shapes[] = {0.4, 1.0, 1.7, 8.0};
+    const double scales[] = {1e-3, 1.0, 3.0, 1e6};
+    unsigned seed = 10;
+    for (double k : shapes) {
+        for (double lambda : scales) {
+            std::vector<double> data = sortedSample(std::weibull_distribution<double>(k, lambda), 20000, seed++);
+            DistributionFit fit = DistributionFitter::fit(data, DistributionType::Weibull);
+            CHECK(fit.valid);
+            if (!fit.valid) continue;
+            double kHat = fit.parameters[0], lambdaHat = fit.parameters[1];
+            // 标准误约为 0.8 k / sqrt(n) 和 1.1 lambda / (k sqrt(n))
+            CHECK(std::fabs(kHat - k) < 4.0 * 0.8 * k / std::sqrt(20000.0));
+            CHECK(std::fabs(lambdaHat / lambda - 1.0) < 4.0 * 1.1 / (k * std::sqrt(20000.0)));
+
+            // 似然方程在估计值处成立：sum x^k ln x / sum x^k - 1/k - mean(ln x) = 0，lambda^k = mean(x^k)
+            double s0 = 0.0, s1 = 0.0, meanLog = 0.0;
+            for (double v : data) {
+                double w = std::pow(v / lambdaHat, kHat);
+                s0 += w;
+                s1 += w * std::log(v / lambdaHat);
+                meanLog += std::log(v / lambdaHat);
+            }
+            meanLog /= data.size();
+            CHECK(std::fabs(s1 / s0 - 1.0 / kHat - meanLog) < 1e-9 / kHat);
+            CHECK_CLOSE(s0 / data.size(), 1.0, 1e-9);
+            CHECK_CLOSE(fit.logLikelihood, directLogLikelihood(data, fit), 1e-9);
+            checkGoodnessOfFit(data, fit);
+        }
+    }
+}
+
+void testSupport()
+{
+    std::vector<double> withZero = {0.0, 1.0, 2.0, 3.0};
+    CHECK(!DistributionFitter::fit(withZero, DistributionType::LogNormal).valid);
+    CHECK(!DistributionFitter::fit(withZero, DistributionType::Weibull).valid);
+    CHECK(DistributionFitter::fit(withZero, DistributionType::Exponential).valid);
+    std::vector<double> negative = {-1.0, 1.0, 2.0};
+    CHECK(!DistributionFitter::fit(negative, DistributionType::Exponential).valid);
+    CHECK(!DistributionFitter::fit(std::vector<double>(5, 2.0), DistributionType::Normal).valid);
+    CHECK(!DistributionFitter::fit(std::vector<double>{1.0}, DistributionType::Normal).valid);
+
+    std::vector<DistributionFit> fits = DistributionFitter::fitAll(withZero);
+    CHECK(fits.size() == 4 && fits[0].type == DistributionType::Normal && fits[3].type == DistributionType::Weibull);
+    CHECK(fits[0].valid && !fits[1].valid && fits[2].valid && !fits[3].valid);
+}
+
+void testKolmogorovPValue()
+{
+    // 渐近 Kolmogorov 分布的上尾概率 Q(lambda)：常用的临界值表
+    // n 取很大时 Stephens 修正 (sqrt(n) + 0.12 + 0.11 / sqrt(n)) d 趋于 sqrt(n) d
+    auto q = [](double lambda) {
+        double n = 1e12, root = std::sqrt(n);
+        return DistributionFitter::kolmogorovPValue(lambda / (root + 0.12 + 0.11 / root), n);
+    };
+    CHECK_CLOSE(q(0.5), 0.9639452436648751, 1e-9);
+    CHECK_CLOSE(q(1.0), 0.2699996716735449, 1e-9);
+    CHECK_CLOSE(q(1.2239), 0.10, 2e-4);
+    CHECK_CLOSE(q(1.3581), 0.05, 2e-4);
+    CHECK_CLOSE(q(1.6276), 0.01, 2e-4);
+    CHECK_CLOSE(q(1.9495), 0.001, 2e-4);
+    CHECK(q(0.1) == 1.0);
+    CHECK(q(10.0) >= 0.0 && q(10.0) < 1e-80);
+
+    // 小样本修正：n = 10、d = 0.41 时 lambda = (sqrt 10 + 0.12 + 0.11 / sqrt 10) · 0.41
+    double lambda = (std::sqrt(10.0) + 0.12 + 0.11 / std::sqrt(10.0)) * 0.41;
+    CHECK_CLOSE(DistributionFitter::kolmogorovPValue(0.41, 10.0), q(lambda), 1e-12);
+    CHECK(DistributionFitter::kolmogorovPValue(0.3, 0.0) == 1.0);
+}
+
+} // namespace
+
+int main()
+{
+    testRecovery();
+    testWeibull();
+    testSupport();
+    testKolmogorovPValue();
+    return testResult("distribution_fit_test");
+}
@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = distribution_fit_test
+
+SOURCES += distribution_fit_test.cpp \
+           ../distribution_fit.cpp
+HEADERS += ../distribution_fit.h ../parallel_utils.h
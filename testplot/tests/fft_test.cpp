@@ -0,0 +1,178 @@
+#include "fft.h"
+#include "test_check.h"
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+typedef std::vector<std::complex<double>> ComplexVector;
+
+// 直接按定义计算的 DFT；k·j 先对 n 取模，参考值本身不因相位过大而失去精度
+ComplexVector naiveDft(const ComplexVector& data, bool inverse)
+{
+    size_t n = data.size();
+    double sign = inverse ? 1.0 : -1.0;
+    ComplexVector result(n);
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> sum(0.0, 0.0);
+        for (size_t j = 0; j < n; ++j) {
+            unsigned long long kj = (static_cast<unsigned long long>(k) * j) % n;
+            sum += data[j] * std::polar(1.0, sign * 2.0 * M_PI * static_cast<double>(kj) / n);
+        }
+        result[k] = inverse ? sum / static_cast<double>(n) : sum;
+    }
+    return result;
+}
+
+ComplexVector randomSignal(size_t n, std::mt19937_64& rng)
+{
+    std::normal_distribution<double> normal(0.0, 1.0);
+    ComplexVector data(n);
+    for (auto& value : data) value = std::complex<double>(normal(rng), normal(rng));
+    return data;
+}
+
+// 最大误差相对于信号的均方根幅度
+double relativeError(const ComplexVector& actual, const ComplexVector& expected)
+{
+    double maxError = 0.0, energy = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        maxError = std::fmax(maxError, std::abs(actual[i] - expected[i]));
+        energy += std::norm(expected[i]);
+    }
+    double rms = std::sqrt(energy / expected.size());
+    return rms > 0.0 ? maxError / rms : maxError;
+}
+
+void testAgainstDft()
+{
+    // 2 的幂走基 2，其余（含素数和 2 的幂加一）走 Bluestein
+    std::mt19937_64 rng(1);
+    const size_t lengths[] = {2, 3, 4, 5, 6, 7, 8, 12, 16, 17, 31, 64, 97, 100, 127, 128, 255, 256, 257,
+                              360, 509, 1000, 1024, 1025, 2048, 4099};
+    for (size_t n : lengths) {
+        ComplexVector signal = randomSignal(n, rng);
+        for (bool inverse : {false, true}) {
+            ComplexVector transformed = signal;
+            fft(transformed, inverse);
+            double error = relativeError(transformed, naiveDft(signal, inverse));
+            if (!(error < 1e-11)) std::printf("  n = %zu, inverse = %d, error = %g\n", n, inverse, error);
+            CHECK(error < 1e-11);
+        }
+    }
+}
+
+void testRoundTrip()
+{
+    std::mt19937_64 rng(2);
+    const size_t lengths[] = {1, 2, 3, 1000, 4096, 10007, 65537, 100000};
+    for (size_t n : lengths) {
+        ComplexVector signal = randomSignal(n, rng);
+        ComplexVector transformed = signal;
+        fft(transformed);
+        fft(transformed, true);
+        CHECK(relativeError(transformed, signal) < 1e-12);
+    }
+}
+
+void testKnownSpectra()
+{
+    // 整数频率的余弦只在 ±f 处有 n/2，长度取素数以覆盖 Bluestein
+    const size_t n = 1009;
+    const size_t f = 37;
+    ComplexVector data(n);
+    for (size_t j = 0; j < n; ++j) {
+        data[j] = std::cos(2.0 * M_PI * static_cast<double>((f * j) % n) / n);
+    }
+    fft(data);
+    for (size_t k = 0; k < n; ++k) {
+        double expected = (k == f || k == n - f) ? n / 2.0 : 0.0;
+        CHECK_CLOSE(data[k].real(), expected, 1e-9);
+        CHECK_CLOSE(data[k].imag(), 0.0, 1e-9);
+    }
+
+    // 单位脉冲的频谱处处为 1
+    ComplexVector impulse(600);
+    impulse[0] = 1.0;
+    fft(impulse);
+    double maxError = 0.0;
+    for (const auto& value : impulse) maxError = std::fmax(maxError, std::abs(value - 1.0));
+    CHECK(maxError < 1e-12);
+}
+
+void testParseval()
+{
+    std::mt19937_64 rng(3);
+    for (size_t n : {999, 1024, 30011}) {
+        ComplexVector signal = randomSignal(n, rng);
+        double timeEnergy = 0.0;
+        for (const auto& value : signal) timeEnergy += std::norm(value);
+        fft(signal);
+        double frequencyEnergy = 0.0;
+        for (const auto& value : signal) frequencyEnergy += std::norm(value);
+        CHECK_CLOSE(frequencyEnergy / n, timeEnergy, 1e-11);
+    }
+}
+
+void testConvolve()
+{
+    std::mt19937_64 rng(4);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    const size_t sizes[][2] = {{1, 1}, {1, 7}, {5, 3}, {64, 64}, {100, 17}, {1000, 333}};
+    for (const auto& size : sizes) {
+        std::vector<double> a(size[0]), b(size[1]);
+        for (double& v : a) v = normal(rng);
+        for (double& v : b) v = normal(rng);
+        std::vector<double> result = fftConvolve(a, b);
+        CHECK(result.size() == a.size() + b.size() - 1);
+        if (result.size() != a.size() + b.size() - 1) continue;
+        double scale = 0.0;
+        for (double v : a) scale += std::fabs(v);
+        for (double v : b) scale += std::fabs(v);
+        double maxError = 0.0;
+        for (size_t k = 0; k < result.size(); ++k) {
+            double direct = 0.0;
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (k >= i && k - i < b.size()) direct += a[i] * b[k - i];
+            }
+            maxError = std::fmax(maxError, std::fabs(result[k] - direct));
+        }
+        CHECK(maxError < 1e-12 * scale * scale);
+    }
+    CHECK(fftConvolve(std::vector<double>(), std::vector<double>{1.0}).empty());
+
+    // 量级相差很大的两个序列（KDE 中的分箱计数与归一化的核）：误差只应与两者量级之积相称
+    std::vector<double> counts(4000), kernel(101);
+    for (double& v : counts) v = std::fabs(normal(rng)) * 1e4;
+    for (size_t j = 0; j < kernel.size(); ++j) kernel[j] = 1e-7 * std::exp(-0.001 * (j - 50.0) * (j - 50.0));
+    std::vector<double> smoothed = fftConvolve(counts, kernel);
+    double countScale = 0.0, kernelScale = 0.0, maxError = 0.0;
+    for (double v : counts) countScale += v;
+    for (double v : kernel) kernelScale += v;
+    for (size_t k = 0; k < smoothed.size(); ++k) {
+        double direct = 0.0;
+        for (size_t j = 0; j < kernel.size(); ++j) {
+            if (k >= j && k - j < counts.size()) direct += counts[k - j] * kernel[j];
+        }
+        maxError = std::fmax(maxError, std::fabs(smoothed[k] - direct));
+    }
+    CHECK(maxError < 1e-13 * countScale * kernelScale);
+}
+
+} // namespace
+
+int main()
+{
+    testAgainstDft();
+    testRoundTrip();
+    testKnownSpectra();
+    testParseval();
+    testConvolve();
+    return testResult("fft_test");
+}
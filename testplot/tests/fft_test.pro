@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = fft_test
+
+SOURCES += fft_test.cpp \
+           ../fft.cpp
+HEADERS += ../fft.h
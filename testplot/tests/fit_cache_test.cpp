@@ -0,0 +1,84 @@
+#include "fit_cache.h"
+#include "test_check.h"
+#include <string>
+
+namespace {
+
+FitCacheKey key(int x, int y, uint64_t version, const std::string& model)
+{
+    FitCacheKey k;
+    k.xColumn = x;
+    k.yColumn = y;
+    k.xVersion = version;
+    k.yVersion = version;
+    k.model = model;
+    return k;
+}
+
+void testFindAndReplace()
+{
+    FitResultCache<int> cache(4);
+    CHECK(cache.find(key(0, 1, 1, "linear")) == nullptr);
+    cache.insert(key(0, 1, 1, "linear"), 10);
+    cache.insert(key(0, 1, 1, "poly:3"), 20);
+    const FitResultCache<int>::Entry* hit = cache.find(key(0, 1, 1, "linear"));
+    CHECK(hit && hit->value == 10);
+    // 数据版本不同不命中
+    CHECK(cache.find(key(0, 1, 2, "linear")) == nullptr);
+
+    // 同键插入替换旧值，条目数不变
+    cache.insert(key(0, 1, 1, "linear"), 11);
+    CHECK(cache.size() == 2);
+    hit = cache.find(key(0, 1, 1, "linear"));
+    CHECK(hit && hit->value == 11);
+
+    cache.clear();
+    CHECK(cache.size() == 0 && cache.find(key(0, 1, 1, "linear")) == nullptr);
+}
+
+void testLatest()
+{
+    FitResultCache<int> cache(8);
+    cache.insert(key(0, 1, 1, "linear"), 1);
+    cache.insert(key(0, 1, 1, "poly:3"), 2);
+    cache.insert(key(0, 2, 1, "linear"), 3);
+    const FitResultCache<int>::Entry* last = cache.latest(0, 1, 1, 1);
+    CHECK(last && last->value == 2);
+    // find 把条目移到最前，latest 随之改变
+    cache.find(key(0, 1, 1, "linear"));
+    last = cache.latest(0, 1, 1, 1);
+    CHECK(last && last->value == 1);
+    CHECK(cache.entries().front().value == 1);
+    CHECK(cache.latest(0, 1, 2, 2) == nullptr);
+    CHECK(cache.latest(1, 0, 1, 1) == nullptr);
+}
+
+void testEviction()
+{
+    // 超出容量时淘汰最久未用的条目
+    FitResultCache<int> cache(3);
+    cache.insert(key(0, 1, 1, "a"), 1);
+    cache.insert(key(0, 1, 1, "b"), 2);
+    cache.insert(key(0, 1, 1, "c"), 3);
+    cache.find(key(0, 1, 1, "a"));
+    cache.insert(key(0, 1, 1, "d"), 4);
+    CHECK(cache.size() == 3);
+    CHECK(cache.find(key(0, 1, 1, "b")) == nullptr);
+    CHECK(cache.find(key(0, 1, 1, "a")) != nullptr);
+    CHECK(cache.find(key(0, 1, 1, "c")) != nullptr);
+    CHECK(cache.find(key(0, 1, 1, "d")) != nullptr);
+
+    int order[3], i = 0;
+    for (const FitResultCache<int>::Entry& entry : cache.entries()) order[i++] = entry.value;
+    CHECK(order[0] == 4 && order[1] == 3 && order[2] == 1);
+}
+
+} // namespace
+
+int main()
+{
+    testFindAndReplace();
+    testLatest();
+    testEviction();
+    return testResult("fit_cache_test");
+}
@@ -0,0 +1,5 @@
+include(tests.pri)
+TARGET = fit_cache_test
+
+SOURCES += fit_cache_test.cpp
+HEADERS += ../fit_cache.h
@@ -0,0 +1,277 @@
+#include "fit_model.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::function<double(double)> Reference;
+
+std::vector<double> grid(size_t count, double lo, double hi)
+{
+    std::vector<double> x(count);
+    for (size_t i = 0; i < count; ++i) x[i] = lo + (hi - lo) * i / (count - 1);
+    return x;
+}
+
+// 整段求值（点数不是 256 的倍数，且足以分成多个并行块）与逐点公式对比，不同线程数的结果逐位相同
+void checkSpan(const char* name, const FitModel& model, const Reference& reference, double tolerance)
+{
+    CHECK(model.isValid());
+    std::vector<double> x = grid(200003, -4.0, 4.0);
+    workerThreadLimit().store(1);
+    std::vector<double> serial = model.evaluate(x);
+    workerThreadLimit().store(4);
+    std::vector<double> parallel = model.evaluate(x);
+    workerThreadLimit().store(0);
+
+    double maxError = 0.0;
+    bool identical = true;
+    for (size_t i = 0; i < x.size(); ++i) {
+        double expected = reference(x[i]);
+        maxError = std::fmax(maxError, std::fabs(serial[i] - expected) / std::fmax(1.0, std::fabs(expected)));
+        if (serial[i] != parallel[i]) identical = false;
+    }
+    if (!(maxError <= tolerance)) std::printf("  %s: max error %g\n", name, maxError);
+    CHECK(maxError <= tolerance);
+    CHECK(identical);
+}
+
+void testSpanEvaluation()
+{
+    std::vector<double> poly = {1.0, -2.0, 0.5, 0.25};
+    checkSpan("polynomial", FitModel(1, poly),
+              [&](double x) { return poly[0] + poly[1] * x + poly[2] * x * x + poly[3] * x * x * x; }, 1e-14);
+
+    std::vector<double> sine = {2.0, 3.0, 0.5, -1.0};
+    checkSpan("sine", FitModel(3, sine), [&](double x) { return sineModel(x, sine.data(), nullptr); }, 1e-14);
+
+    std::vector<double> gauss = {3.0, 0.2, 0.7};
+    checkSpan("gaussian", FitModel(4, gauss), [&](double x) { return gaussianModel(x, gauss.data(), nullptr); },
+              1e-13);
+
+    // 高次多项式关于 t = (x - 1.5) / 2
+    checkSpan("scaled polynomial", FitModel(5, {1.5, 2.0, 1.0, -1.0, 0.5, 2.0}), [](double x) {
+        double t = (x - 1.5) / 2.0;
+        return 1.0 - t + 0.5 * t * t + 2.0 * t * t * t;
+    }, 1e-14);
+
+    std::string error;
+    std::shared_ptr<const ModelExpression> expression = ModelExpression::compile("a*exp(-b*x) + c", &error);
+    CHECK(expression != nullptr);
+    if (expression) {
+        checkSpan("formula", FitModel(6, {2.0, 0.3, -1.0}, expression),
+                  [](double x) { return 2.0 * std::exp(-0.3 * x) - 1.0; }, 1e-14);
+        // 参数个数不符的公式模型无效
+        CHECK(!FitModel(6, {2.0, 0.3}, expression).isValid());
+    }
+
+    std::shared_ptr<SmoothCurve> curve = std::make_shared<SmoothCurve>();
+    curve->knots = {-3.0, -1.0, 0.0, 2.0, 3.5};
+    curve->values = {1.0, -0.5, 0.25, 2.0, 1.0};
+    curve->secondDerivatives = {0.0, 1.5, -2.0, 0.5, 0.0};
+    checkSpan("spline", FitModel(7, {1e-3, 4.0, 0.1}, nullptr, curve),
+              [&](double x) { return curve->evaluate(x); }, 0.0);
+
+    // 二次分段，断点 -1 和 1.5；落在断点上的 x 属于右侧的段
+    std::vector<double> piecewise = {0.5, 2.0, 2.0, -1.0, 1.5,
+                                     1.0, 2.0, 0.5,
+                                     -1.0, 0.5, 3.0,
+                                     4.0, -1.0, 0.0};
+    checkSpan("piecewise", FitModel(9, piecewise), [&](double x) {
+        size_t segment = x < -1.0 ? 0 : x < 1.5 ? 1 : 2;
+        const double* c = piecewise.data() + 5 + 3 * segment;
+        double t = (x - 0.5) / 2.0;
+        return c[0] + c[1] * t + c[2] * t * t;
+    }, 1e-14);
+    CHECK(FitModel(9, piecewise).breakpoints() == std::vector<double>({-1.0, 1.5}));
+    CHECK(FitModel(5, {0.0, 1.0, 1.0}).breakpoints().empty());
+
+    // 无效模型整段为 NaN
+    std::vector<double> values = FitModel(5, {0.0, 0.0, 1.0}).evaluate(grid(300, 0.0, 1.0));
+    bool allNaN = true;
+    for (double v : values) allNaN = allNaN && std::isnan(v);
+    CHECK(allNaN);
+    CHECK(!FitModel(9, {0.0, 1.0, 1.5, 0.0, 1.0}).isValid());   // 次数不是整数
+    CHECK(!FitModel(9, {0.0, 1.0, 1.0, 0.5, 0.0, 1.0}).isValid()); // 系数个数与断点数不符
+}
+
+// 正弦、高斯的解析 Jacobian 与中心差分对比
+void checkGradient(const char* name, double (*model)(double, const double*, double*), std::vector<double> p)
+{
+    double maxError = 0.0;
+    std::vector<double> gradient(p.size());
+    for (double x : grid(41, -3.0, 3.0)) {
+        double value = model(x, p.data(), gradient.data());
+        CHECK(value == model(x, p.data(), nullptr));
+        for (size_t k = 0; k < p.size(); ++k) {
+            double h = 1e-6 * std::fmax(1.0, std::fabs(p[k]));
+            std::vector<double> up = p, down = p;
+            up[k] += h;
+            down[k] -= h;
+            double numeric = (model(x, up.data(), nullptr) - model(x, down.data(), nullptr)) / (2.0 * h);
+            maxError = std::fmax(maxError, std::fabs(gradient[k] - numeric) / std::fmax(1.0, std::fabs(numeric)));
+        }
+    }
+    if (!(maxError < 1e-7)) std::printf("  %s: gradient error %g\n", name, maxError);
+    CHECK(maxError < 1e-7);
+}
+
+void testGradients()
+{
+    checkGradient("sine", sineModel, {1.7, 2.3, -0.4, 0.6});
+    checkGradient("gaussian", gaussianModel, {2.5, 0.3, 0.8});
+}
+
+// 采样的基本性质：两端为区间端点、x 递增、点数不超过宽度的 4 倍、y 与逐点求值一致
+void checkSamples(const FitModel& model, double xMin, double xMax, double pixelWidth,
+                  const std::vector<double>& xs, const std::vector<double>& ys)
+{
+    CHECK(!xs.empty() && xs.size() == ys.size());
+    if (xs.empty() || xs.size() != ys.size()) return;
+    CHECK(xs.front() == xMin && xs.back() == xMax);
+    CHECK(xs.size() <= static_cast<size_t>(pixelWidth * 4.0));
+    bool increasing = true;
+    for (size_t i = 1; i < xs.size(); ++i) increasing = increasing && xs[i] > xs[i - 1];
+    CHECK(increasing);
+    std::vector<double> expected = model.evaluate(xs);
+    bool same = true;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        same = same && (ys[i] == expected[i] || (std::isnan(ys[i]) && std::isnan(expected[i])));
+    }
+    CHECK(same);
+}
+
+size_t countIn(const std::vector<double>& xs, double lo, double hi)
+{
+    size_t count = 0;
+    for (double x : xs) count += x >= lo && x <= hi;
+    return count;
+}
+
+void testSharpFeatureRefinement()
+{
+    // 宽 0.05 的窄峰位于 [-5, 5] 的 800 像素中，初始约 8 像素一个点只能采到峰上一两个点
+    const double center = 0.33, width = 0.05, xMin = -5.0, xMax = 5.0, pixelWidth = 800.0, pixelsPerY = 400.0;
+    FitModel model(4, {1.0, center, width});
+    std::vector<double> xs, ys;
+    model.sampleCurve(xMin, xMax, pixelWidth, pixelsPerY, xs, ys);
+    checkSamples(model, xMin, xMax, pixelWidth, xs, ys);
+
+    size_t nearPeak = countIn(xs, center - 3.0 * width, center + 3.0 * width);
+    size_t farAway = countIn(xs, -4.0, -4.0 + 6.0 * width);
+    if (!(nearPeak > 8 * farAway)) std::printf("  near peak %zu, far away %zu\n", nearPeak, farAway);
+    CHECK(nearPeak > 8 * farAway);
+    CHECK(xs.size() < static_cast<size_t>(pixelWidth * 4.0));
+
+    // 细化结束后，每个区间要么中点偏离弦不超过 0.5 像素，要么已不足半个像素
+    double minSpacing = 0.5 * (xMax - xMin) / pixelWidth;
+    std::vector<double> midX;
+    for (size_t i = 0; i + 1 < xs.size(); ++i) midX.push_back(0.5 * (xs[i] + xs[i + 1]));
+    std::vector<double> midY = model.evaluate(midX);
+    size_t coarse = 0;
+    for (size_t i = 0; i + 1 < xs.size(); ++i) {
+        double deviation = std::fabs(midY[i] - 0.5 * (ys[i] + ys[i + 1])) * pixelsPerY;
+        if (deviation > 0.5 && xs[i + 1] - xs[i] > minSpacing) ++coarse;
+    }
+    if (coarse) std::printf("  %zu intervals left unrefined\n", coarse);
+    CHECK(coarse == 0);
+
+    // 平坦的曲线不细化，只保留初始的均匀采样
+    model = FitModel(1, {2.0, 0.5});
+    model.sampleCurve(xMin, xMax, pixelWidth, pixelsPerY, xs, ys);
+    checkSamples(model, xMin, xMax, pixelWidth, xs, ys);
+    CHECK(xs.size() == 101);
+
+    // 剧烈振荡时二分止于半个像素，点数不超过宽度的 2 倍
+    model = FitModel(3, {1.0, 1000.0, 0.0, 0.0});
+    model.sampleCurve(0.0, 10.0, 200.0, 100.0, xs, ys);
+    checkSamples(model, 0.0, 10.0, 200.0, xs, ys);
+    CHECK(xs.size() > 26 && xs.size() <= 401);
+}
+
+void testDomainBoundary()
+{
+    // sqrt 在 x < 0.37 处无定义：采样在边界两侧继续二分，断开处与边界相距不超过半个像素
+    std::string error;
+    std::shared_ptr<const ModelExpression> expression = ModelExpression::compile("a*sqrt(x - b)", &error);
+    CHECK(expression != nullptr);
+    if (!expression) return;
+    const double boundary = 0.37, pixelWidth = 400.0;
+    FitModel model(6, {1.0, boundary}, expression);
+    std::vector<double> xs, ys;
+    model.sampleCurve(-1.0, 1.0, pixelWidth, 100.0, xs, ys);
+    checkSamples(model, -1.0, 1.0, pixelWidth, xs, ys);
+
+    double lastUndefined = -std::numeric_limits<double>::infinity();
+    double firstDefined = std::numeric_limits<double>::infinity();
+    bool consistent = true;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (std::isnan(ys[i])) lastUndefined = std::fmax(lastUndefined, xs[i]);
+        else firstDefined = std::fmin(firstDefined, xs[i]);
+        consistent = consistent && (std::isnan(ys[i]) == (xs[i] < boundary));
+    }
+    CHECK(consistent);
+    CHECK(lastUndefined < boundary && firstDefined >= boundary);
+    double minSpacing = 0.5 * 2.0 / pixelWidth;
+    if (!(firstDefined - lastUndefined <= minSpacing)) {
+        std::printf("  break spans [%g, %g]\n", lastUndefined, firstDefined);
+    }
+    CHECK(firstDefined - lastUndefined <= minSpacing);
+}
+
+void testPiecewiseBreaks()
+{
+    // 一次分段 y = t（x < 0.537）、y = 5（x >= 0.537）：断点处插入一个 NaN 使曲线断开
+    const double breakX = 0.537;
+    FitModel model(9, {0.0, 1.0, 1.0, breakX, 0.0, 1.0, 5.0, 0.0});
+    CHECK(model.isValid());
+    std::vector<double> xs, ys;
+    model.sampleCurve(-1.0, 1.0, 160.0, 50.0, xs, ys);
+    CHECK(xs.size() == ys.size());
+    size_t nanCount = 0, nanIndex = 0;
+    for (size_t i = 0; i < ys.size(); ++i) {
+        if (std::isnan(ys[i])) {
+            ++nanCount;
+            nanIndex = i;
+        }
+    }
+    CHECK(nanCount == 1);
+    if (nanCount != 1) return;
+    CHECK(xs[nanIndex] == breakX);
+    CHECK(nanIndex > 0 && nanIndex + 1 < xs.size());
+    CHECK(xs[nanIndex - 1] < breakX && xs[nanIndex + 1] >= breakX);
+    CHECK(ys[nanIndex - 1] == xs[nanIndex - 1] && ys[nanIndex + 1] == 5.0);
+
+    // 去掉 NaN 后其余采样与逐点求值一致
+    std::vector<double> restX, restY;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        if (i == nanIndex) continue;
+        restX.push_back(xs[i]);
+        restY.push_back(ys[i]);
+    }
+    checkSamples(model, -1.0, 1.0, 160.0, restX, restY);
+
+    // 断点在采样范围之外时不插入 NaN
+    model.sampleCurve(-1.0, 0.5, 160.0, 50.0, xs, ys);
+    bool anyNaN = false;
+    for (double y : ys) anyNaN = anyNaN || std::isnan(y);
+    CHECK(!anyNaN);
+}
+
+} // namespace
+
+int main()
+{
+    testSpanEvaluation();
+    testGradients();
+    testSharpFeatureRefinement();
+    testDomainBoundary();
+    testPiecewiseBreaks();
+    return testResult("fit_model_test");
+}
@@ -0,0 +1,8 @@
+include(tests.pri)
+TARGET = fit_model_test
+
+SOURCES += fit_model_test.cpp \
+           ../fit_model.cpp \
+           ../model_expression.cpp \
+           ../smoothing_fit.cpp
+HEADERS += ../fit_model.h ../model_expression.h ../smoothing_fit.h ../fit_progress.h ../parallel_utils.h
@@ -0,0 +1,164 @@
+#include "histogram_engine.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 排序后 R type 7 分位数
+double sortedQuantile(const std::vector<double>& sorted, double p)
+{
+    double h = (sorted.size() - 1) * p;
+    size_t lo = static_cast<size_t>(std::floor(h));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (h - lo) * (sorted[hi] - sorted[lo]);
+}
+
+// 逐点分箱的参考：[min, max] 等分，等于 max 的值落在最后一箱
+std::vector<size_t> directCounts(const std::vector<double>& data, double minValue, double maxValue, int bins)
+{
+    std::vector<size_t> counts(bins, 0);
+    double width = (maxValue - minValue) / bins;
+    for (double v : data) {
+        if (!(v >= minValue && v <= maxValue)) continue;
+        int bin = static_cast<int>((v - minValue) / width);
+        ++counts[std::min(bin, bins - 1)];
+    }
+    return counts;
+}
+
+void testBinRules()
+{
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(5.0, 2.0);
+    std::vector<double> data(1000);
+    for (double& v : data) v = normal(rng);
+    StatisticsAccumulator stats;
+    stats.append(data);
+    std::vector<double> sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+    double range = sorted.back() - sorted.front();
+
+    BinSpec spec;
+    spec.rule = BinRule::Sturges;
+    CHECK(HistogramEngine::binCountFor(spec, stats) == 11);        // ceil(log2 1000) + 1
+    spec.rule = BinRule::SquareRoot;
+    CHECK(HistogramEngine::binCountFor(spec, stats) == 32);        // ceil(sqrt 1000)
+
+    double mean = 0.0, m2 = 0.0;
+    for (double v : data) mean += v;
+    mean /= data.size();
+    for (double v : data) m2 += (v - mean) * (v - mean);
+    double scottWidth = 3.49 * std::sqrt(m2 / (data.size() - 1)) / std::cbrt(1000.0);
+    spec.rule = BinRule::Scott;
+    CHECK(HistogramEngine::binCountFor(spec, stats) == static_cast<int>(std::ceil(range / scottWidth)));
+
+    double iqr = sortedQuantile(sorted, 0.75) - sortedQuantile(sorted, 0.25);
+    spec.rule = BinRule::FreedmanDiaconis;
+    CHECK(HistogramEngine::binCountFor(spec, stats) == static_cast<int>(std::ceil(range / (2.0 * iqr / 10.0))));
+
+    spec.rule = BinRule::Fixed;
+    spec.binCount = 7;
+    CHECK(HistogramEngine::binCountFor(spec, stats) == 7);
+    spec.binCount = 100000;
+    CHECK(HistogramEngine::binCountFor(spec, stats) == HistogramEngine::MaxBins);
+    spec.binCount = 0;
+    CHECK(HistogramEngine::binCountFor(spec, stats) == 11);       // 无效箱数退回 Sturges
+
+    // IQR 为 0 时 FD 退回 Scott
+    std::vector<double> repeated(100, 1.0);
+    repeated[0] = 0.0;
+    repeated[99] = 3.0;
+    StatisticsAccumulator repeatedStats;
+    repeatedStats.append(repeated);
+    spec.rule = BinRule::FreedmanDiaconis;
+    int fdBins = HistogramEngine::binCountFor(spec, repeatedStats);
+    spec.rule = BinRule::Scott;
+    CHECK(fdBins == HistogramEngine::binCountFor(spec, repeatedStats));
+
+    StatisticsAccumulator empty;
+    CHECK(HistogramEngine::binCountFor(spec, empty) == 1);
+}
+
+void testEdgeBins()
+{
+    // 0..10 分 5 箱，宽 2：等于最大值的 10 落在最后一箱
+    std::vector<double> data;
+    for (int i = 0; i <= 10; ++i) data.push_back(i);
+    data.push_back(std::numeric_limits<double>::quiet_NaN());
+    BinSpec spec;
+    spec.rule = BinRule::Fixed;
+    spec.binCount = 5;
+    HistogramResult result = HistogramEngine::compute(data, spec);
+    CHECK(result.minValue == 0.0 && result.maxValue == 10.0);
+    CHECK_CLOSE(result.binWidth, 2.0, 1e-15);
+    CHECK((result.counts == std::vector<size_t>{2, 2, 2, 2, 3}));
+    CHECK(result.total == 11 && result.maxCount == 3);
+
+    // 所有值相同：单箱，宽度 1
+    result = HistogramEngine::compute(std::vector<double>(5, 4.0), spec);
+    CHECK(result.counts.size() == 1 && result.counts[0] == 5);
+    CHECK(result.minValue == 3.5 && result.maxValue == 4.5);
+
+    CHECK(HistogramEngine::compute(std::vector<double>(), spec).isEmpty());
+}
+
+void testChunkedCounts()
+{
+    // 多块计数合并后与逐点分箱相同，且与线程数无关
+    std::mt19937_64 rng(2);
+    std::lognormal_distribution<double> skewed(0.0, 1.0);
+    std::vector<double> data(1000000);
+    for (double& v : data) v = skewed(rng);
+    data[123] = *std::max_element(data.begin(), data.end());
+    BinSpec spec;
+    spec.rule = BinRule::Fixed;
+    spec.binCount = 97;
+
+    workerThreadLimit().store(1);
+    HistogramResult single = HistogramEngine::compute(data, spec);
+    workerThreadLimit().store(7);
+    HistogramResult parallel = HistogramEngine::compute(data, spec);
+    workerThreadLimit().store(0);
+
+    std::vector<size_t> expected = directCounts(data, single.minValue, single.maxValue, 97);
+    CHECK(single.counts == expected);
+    CHECK(parallel.counts == expected);
+    CHECK(parallel.total == data.size());
+    CHECK(parallel.maxCount == *std::max_element(expected.begin(), expected.end()));
+}
+
+void testCache()
+{
+    std::vector<double> data = {1.0, 2.0, 2.5, 4.0};
+    HistogramEngine engine;
+    BinSpec spec;
+    spec.rule = BinRule::Fixed;
+    spec.binCount = 3;
+    const HistogramResult* first = &engine.histogram(1, data, spec);
+    CHECK(first->counts.size() == 3);
+
+    // 同版本同规格直接复用（即使数据被改动也不重算）
+    std::vector<double> changed = {1.0, 2.0};
+    CHECK(engine.histogram(1, changed, spec).total == 4);
+    CHECK(engine.histogram(2, changed, spec).total == 2);
+    spec.binCount = 2;
+    CHECK(engine.histogram(2, changed, spec).counts.size() == 2);
+    engine.clear();
+    CHECK(engine.histogram(2, data, spec).total == 4);
+}
+
+} // namespace
+
+int main()
+{
+    testBinRules();
+    testEdgeBins();
+    testChunkedCounts();
+    testCache();
+    return testResult("histogram_engine_test");
+}
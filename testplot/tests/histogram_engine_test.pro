@@ -0,0 +1,7 @@
+include(tests.pri)
+TARGET = histogram_engine_test
+
+SOURCES += histogram_engine_test.cpp \
+           ../histogram_engine.cpp \
+           ../statistics_accumulator.cpp
+HEADERS += ../histogram_engine.h ../statistics_accumulator.h ../parallel_utils.h
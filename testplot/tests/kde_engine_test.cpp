@@ -0,0 +1,120 @@
+#include "kde_engine.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// 逐点求和的 O(n·m) 参考密度
+double directDensity(const std::vector<double>& data, double x, double h)
+{
+    double sum = 0.0;
+    for (double v : data) {
+        double u = (x - v) / h;
+        sum += std::exp(-0.5 * u * u);
+    }
+    return sum / (data.size() * h * std::sqrt(2.0 * M_PI));
+}
+
+double trapezoid(const KdeResult& result)
+{
+    double integral = 0.0;
+    for (size_t k = 1; k < result.grid.size(); ++k) {
+        integral += 0.5 * (result.density[k] + result.density[k - 1]) * (result.grid[k] - result.grid[k - 1]);
+    }
+    return integral;
+}
+
+void checkAgainstDirect(const std::vector<double>& data, const KdeSpec& spec)
+{
+    KdeResult result = KdeEngine::compute(data, spec);
+    CHECK(result.grid.size() == 512 && result.density.size() == 512);
+    CHECK_CLOSE(trapezoid(result), 1.0, 1e-3);
+
+    // 线性分箱（误差 O(δ²)）和 ±4h 截断的误差相对于峰值密度很小
+    double maxError = 0.0;
+    for (size_t k = 0; k < result.grid.size(); ++k) {
+        maxError = std::max(maxError, std::fabs(result.density[k] - directDensity(data, result.grid[k], result.bandwidth)));
+    }
+    CHECK(maxError <= 2e-4 * result.maxDensity);
+    CHECK(result.maxDensity == *std::max_element(result.density.begin(), result.density.end()));
+}
+
+void testBandwidth()
+{
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(0.0, 3.0);
+    std::vector<double> data(1000);
+    for (double& v : data) v = normal(rng);
+    StatisticsAccumulator stats;
+    stats.append(data);
+    double sigma = std::sqrt(stats.sampleVariance());
+    double factor = std::pow(1000.0, -0.2);
+    CHECK_CLOSE(KdeEngine::bandwidthFor(BandwidthRule::Scott, stats), 1.06 * sigma * factor, 1e-12);
+    double iqr = stats.quantile(0.75) - stats.quantile(0.25);
+    CHECK_CLOSE(KdeEngine::bandwidthFor(BandwidthRule::Silverman, stats), 0.9 * std::min(sigma, iqr / 1.34) * factor,
+                1e-12);
+
+    // 常数数据给出与量级相称的正带宽
+    StatisticsAccumulator constant;
+    constant.append(std::vector<double>(10, 500.0));
+    CHECK_CLOSE(KdeEngine::bandwidthFor(BandwidthRule::Scott, constant), 0.5, 1e-12);
+}
+
+void testDensity()
+{
+    std::mt19937_64 rng(2);
+    std::normal_distribution<double> normal(10.0, 2.0);
+    std::vector<double> data(2000);
+    for (double& v : data) v = normal(rng);
+    KdeSpec spec;
+    checkAgainstDirect(data, spec);
+
+    // 双峰、Scott 带宽，网格点数取 2 的幂
+    std::vector<double> bimodal(3000);
+    for (size_t i = 0; i < bimodal.size(); ++i) bimodal[i] = (i % 3 ? -4.0 : 6.0) + normal(rng) - 10.0;
+    spec.rule = BandwidthRule::Scott;
+    spec.gridSize = 300;
+    checkAgainstDirect(bimodal, spec);
+
+    CHECK(KdeEngine::compute(std::vector<double>(), spec).isEmpty());
+}
+
+void testChunking()
+{
+    // 每个线程独立分箱后合并，与单线程结果只差舍入
+    std::mt19937_64 rng(3);
+    std::exponential_distribution<double> skewed(0.5);
+    std::vector<double> data(500000);
+    for (double& v : data) v = skewed(rng);
+    KdeSpec spec;
+    workerThreadLimit().store(1);
+    KdeResult single = KdeEngine::compute(data, spec);
+    workerThreadLimit().store(6);
+    KdeResult parallel = KdeEngine::compute(data, spec);
+    workerThreadLimit().store(0);
+    double maxDifference = 0.0;
+    for (size_t k = 0; k < single.density.size(); ++k) {
+        maxDifference = std::max(maxDifference, std::fabs(single.density[k] - parallel.density[k]));
+    }
+    CHECK(single.grid == parallel.grid);
+    CHECK(maxDifference <= 1e-12 * single.maxDensity);
+    CHECK_CLOSE(trapezoid(parallel), 1.0, 1e-3);
+}
+
+} // namespace
+
+int main()
+{
+    testBandwidth();
+    testDensity();
+    testChunking();
+    return testResult("kde_engine_test");
+}
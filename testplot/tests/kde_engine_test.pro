@@ -0,0 +1,8 @@
+include(tests.pri)
+TARGET = kde_engine_test
+
+SOURCES += kde_engine_test.cpp \
+           ../kde_engine.cpp \
+           ../fft.cpp \
+           ../statistics_accumulator.cpp
+HEADERS += ../kde_engine.h ../fft.h ../statistics_accumulator.h ../parallel_utils.h
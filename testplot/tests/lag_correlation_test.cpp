@@ -0,0 +1,155 @@
+#include "lag_correlation.h"
+#include "test_check.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// 直接按定义求和：r[k] = sum_t (x_t - mean x)(y_{t+k} - mean y)，circular 时下标按 n 取模
+double directLagSum(const std::vector<double>& x, const std::vector<double>& y, long long lag, bool circular)
+{
+    long long n = static_cast<long long>(x.size());
+    double meanX = 0.0, meanY = 0.0;
+    for (long long t = 0; t < n; ++t) {
+        meanX += x[t];
+        meanY += y[t];
+    }
+    meanX /= n;
+    meanY /= n;
+    double sum = 0.0;
+    for (long long t = 0; t < n; ++t) {
+        long long s = t + lag;
+        if (circular) {
+            s = ((s % n) + n) % n;
+        } else if (s < 0 || s >= n) {
+            continue;
+        }
+        sum += (x[t] - meanX) * (y[s] - meanY);
+    }
+    return sum;
+}
+
+double energy(const std::vector<double>& x)
+{
+    double mean = 0.0, sum = 0.0;
+    for (double v : x) mean += v;
+    mean /= x.size();
+    for (double v : x) sum += (v - mean) * (v - mean);
+    return sum;
+}
+
+// 各归一化方式下逐个滞后与直接求和对比，误差相对于 sqrt(Ex · Ey)
+void checkAgainstDirect(const std::vector<double>& x, const std::vector<double>& y, int maxLag, bool zeroPad)
+{
+    size_t n = x.size();
+    double scale = std::sqrt(energy(x) * energy(y));
+    for (LagNormalization normalization : {LagNormalization::None, LagNormalization::Biased,
+                                           LagNormalization::Unbiased, LagNormalization::Coefficient}) {
+        LagCorrelationSpec spec;
+        spec.maxLag = maxLag;
+        spec.zeroPad = zeroPad;
+        spec.normalization = normalization;
+        LagCorrelationResult result = LagCorrelation::crossCorrelation(x, y, spec);
+        size_t expectedLag = maxLag > 0 ? std::min<size_t>(maxLag, n - 1) : n - 1;
+        CHECK(result.lags.size() == 2 * expectedLag + 1 && result.values.size() == result.lags.size());
+        double maxError = 0.0;
+        for (size_t i = 0; i < result.lags.size(); ++i) {
+            long long lag = static_cast<long long>(i) - static_cast<long long>(expectedLag);
+            double expected = directLagSum(x, y, lag, !zeroPad), unit = scale;
+            switch (normalization) {
+            case LagNormalization::None: break;
+            case LagNormalization::Biased: expected /= n; unit /= n; break;
+            case LagNormalization::Unbiased: {
+                double divisor = zeroPad ? static_cast<double>(n - std::llabs(lag)) : static_cast<double>(n);
+                expected /= divisor;
+                unit /= divisor;
+                break;
+            }
+            case LagNormalization::Coefficient: expected /= scale; unit = 1.0; break;
+            }
+            maxError = std::fmax(maxError, std::fabs(result.values[i] - expected) / unit);
+            CHECK(result.lags[i] == static_cast<double>(lag));
+        }
+        if (!(maxError < 1e-12)) std::printf("  n = %zu, zeroPad = %d: max error %g\n", n, zeroPad, maxError);
+        CHECK(maxError < 1e-12);
+    }
+}
+
+void testAgainstDirect()
+{
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t n : {2, 3, 64, 100, 257, 1000}) {
+        std::vector<double> x(n), y(n);
+        for (size_t t = 0; t < n; ++t) {
+            x[t] = 5.0 + normal(rng);
+            y[t] = -2.0 + 0.5 * x[t] + normal(rng);
+        }
+        checkAgainstDirect(x, y, 0, true);
+        checkAgainstDirect(x, y, 0, false);
+        checkAgainstDirect(x, y, static_cast<int>(n / 3) + 1, true);
+    }
+
+    // 两列量级相差很大（如电压与电流）时归一化后的结果不受影响
+    std::vector<double> large(500), small(500);
+    for (size_t t = 0; t < large.size(); ++t) {
+        large[t] = 1e6 * normal(rng);
+        small[t] = 1e-4 * normal(rng) + 1e-10 * large[t];
+    }
+    checkAgainstDirect(large, small, 50, true);
+    checkAgainstDirect(small, large, 50, false);
+}
+
+void testLagSign()
+{
+    // y 比 x 晚 d 个采样（y_t = x_{t-d}），峰值出现在滞后 +d
+    std::mt19937_64 rng(2);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    size_t n = 400, d = 17;
+    std::vector<double> x(n), y(n, 0.0);
+    for (double& v : x) v = normal(rng);
+    for (size_t t = d; t < n; ++t) y[t] = x[t - d];
+    LagCorrelationSpec spec;
+    spec.maxLag = 50;
+    LagCorrelationResult result = LagCorrelation::crossCorrelation(x, y, spec);
+    CHECK(result.peakLag == static_cast<double>(d));
+    CHECK(result.peakValue > 0.9);
+    result = LagCorrelation::crossCorrelation(y, x, spec);
+    CHECK(result.peakLag == -static_cast<double>(d));
+}
+
+void testAutoCorrelation()
+{
+    // 周期 25 的正弦加噪声：零滞后为 1，主峰在 25
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> normal(0.0, 0.2);
+    std::vector<double> x(1000);
+    for (size_t t = 0; t < x.size(); ++t) x[t] = std::sin(2.0 * M_PI * t / 25.0) + normal(rng);
+    LagCorrelationSpec spec;
+    spec.maxLag = 60;
+    LagCorrelationResult result = LagCorrelation::autoCorrelation(x, spec);
+    CHECK_CLOSE(result.values[60], 1.0, 1e-12);
+    CHECK(result.peakLag == 25.0);
+    bool symmetric = true;
+    for (size_t i = 0; i < 60; ++i) symmetric = symmetric && std::fabs(result.values[i] - result.values[120 - i]) < 1e-12;
+    CHECK(symmetric);
+    checkAgainstDirect(x, x, 60, true);
+
+    CHECK(LagCorrelation::autoCorrelation(std::vector<double>{1.0}, spec).isEmpty());
+}
+
+} // namespace
+
+int main()
+{
+    testAgainstDirect();
+    testLagSign();
+    testAutoCorrelation();
+    return testResult("lag_correlation_test");
+}
@@ -0,0 +1,7 @@
+include(tests.pri)
+TARGET = lag_correlation_test
+
+SOURCES += lag_correlation_test.cpp \
+           ../lag_correlation.cpp \
+           ../fft.cpp
+HEADERS += ../lag_correlation.h ../fft.h
@@ -0,0 +1,215 @@
+#include "levenberg_marquardt.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 直线模型 p0 + p1 x：LM 的解和标准误应与普通最小二乘的闭式解一致
+void testLinearModel()
+{
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> noise(0.0, 0.5);
+    std::vector<double> x(500), y(500);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = 0.02 * i;
+        y[i] = 1.5 + 0.8 * x[i] + noise(rng);
+    }
+
+    double n = static_cast<double>(x.size());
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sx += x[i];
+        sy += y[i];
+        sxx += x[i] * x[i];
+        sxy += x[i] * y[i];
+    }
+    double det = n * sxx - sx * sx;
+    double slope = (n * sxy - sx * sy) / det;
+    double intercept = (sy - slope * sx) / n;
+    double ssr = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        double r = y[i] - intercept - slope * x[i];
+        ssr += r * r;
+    }
+    double s2 = ssr / (n - 2.0);
+
+    NonlinearModel line = [](double xi, const double* p, double* gradient) {
+        if (gradient) {
+            gradient[0] = 1.0;
+            gradient[1] = xi;
+        }
+        return p[0] + p[1] * xi;
+    };
+    LevenbergMarquardtResult result = LevenbergMarquardt::fit(x, y, line, {0.0, 0.0});
+    CHECK(result.converged());
+    CHECK(result.parameters.size() == 2 && result.standardErrors.size() == 2);
+    if (result.parameters.size() != 2 || result.standardErrors.size() != 2) return;
+    CHECK_CLOSE(result.parameters[0], intercept, 1e-8);
+    CHECK_CLOSE(result.parameters[1], slope, 1e-8);
+    CHECK_CLOSE(result.sumOfSquares, ssr, 1e-10);
+    CHECK_CLOSE(result.standardErrors[0], std::sqrt(s2 * sxx / det), 1e-6);
+    CHECK_CLOSE(result.standardErrors[1], std::sqrt(s2 * n / det), 1e-6);
+}
+
+// Rosenbrock 函数写成两个残差：r0 = 10 (p1 - p0²)，r1 = 1 - p0，最小值在 (1, 1)
+void testRosenbrock()
+{
+    NonlinearModel model = [](double xi, const double* p, double* gradient) {
+        if (xi == 0.0) {
+            if (gradient) {
+                gradient[0] = -20.0 * p[0];
+                gradient[1] = 10.0;
+            }
+            return 10.0 * (p[1] - p[0] * p[0]);
+        }
+        if (gradient) {
+            gradient[0] = 1.0;
+            gradient[1] = 0.0;
+        }
+        return p[0];
+    };
+    // y - f：第一项 0 - 10 (p1 - p0²)，第二项 1 - p0
+    LevenbergMarquardtResult result = LevenbergMarquardt::fit({0.0, 1.0}, {0.0, 1.0}, model, {-1.2, 1.0});
+    CHECK(result.converged());
+    CHECK_CLOSE(result.parameters[0], 1.0, 1e-6);
+    CHECK_CLOSE(result.parameters[1], 1.0, 1e-6);
+    CHECK(result.sumOfSquares < 1e-16);
+}
+
+// 高斯峰 a exp(-(x - b)² / (2 c²)) + d，噪声下参数应落在真值附近几个标准误之内
+NonlinearBlockModel gaussianBlock()
+{
+    return [](const double* x, size_t count, const double* p, double* values, double* jacobian) {
+        for (size_t i = 0; i < count; ++i) {
+            double u = (x[i] - p[1]) / p[2];
+            double e = std::exp(-0.5 * u * u);
+            values[i] = p[0] * e + p[3];
+            if (jacobian) {
+                jacobian[i] = e;
+                jacobian[count + i] = p[0] * e * u / p[2];
+                jacobian[2 * count + i] = p[0] * e * u * u / p[2];
+                jacobian[3 * count + i] = 1.0;
+            }
+        }
+    };
+}
+
+void testGaussian()
+{
+    const double truth[] = {5.0, 2.0, 0.7, 1.0};
+    std::mt19937_64 rng(2);
+    std::normal_distribution<double> noise(0.0, 0.05);
+    std::vector<double> x(2000), y(2000);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = -3.0 + 10.0 * i / x.size();
+        double u = (x[i] - truth[1]) / truth[2];
+        y[i] = truth[0] * std::exp(-0.5 * u * u) + truth[3] + noise(rng);
+    }
+    LevenbergMarquardtResult result = LevenbergMarquardt::fit(x, y, gaussianBlock(), {3.0, 1.5, 1.2, 0.0});
+    CHECK(result.converged());
+    CHECK(result.standardErrors.size() == 4);
+    for (size_t k = 0; k < 4 && k < result.standardErrors.size(); ++k) {
+        CHECK(std::fabs(result.parameters[k] - truth[k]) < 5.0 * result.standardErrors[k]);
+    }
+    // 残差平方和接近 n σ²
+    CHECK(std::fabs(result.sumOfSquares / (x.size() * 0.05 * 0.05) - 1.0) < 0.1);
+
+    std::vector<double> residuals = LevenbergMarquardt::residuals(x, y, gaussianBlock(), result.parameters);
+    double ssr = 0.0;
+    for (double r : residuals) ssr += r * r;
+    CHECK_CLOSE(ssr, result.sumOfSquares, 1e-10);
+}
+
+// 逐点模型和块模型、1 个和 4 个线程的结果逐位相同
+void testDeterminism()
+{
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> noise(0.0, 0.1);
+    size_t n = 200000;
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 5.0 * i / n;
+        y[i] = 2.0 * std::exp(-0.7 * x[i]) + 0.3 + noise(rng);
+    }
+    NonlinearModel decay = [](double xi, const double* p, double* gradient) {
+        double e = std::exp(-p[1] * xi);
+        if (gradient) {
+            gradient[0] = e;
+            gradient[1] = -p[0] * xi * e;
+            gradient[2] = 1.0;
+        }
+        return p[0] * e + p[2];
+    };
+    NonlinearBlockModel decayBlock = [&decay](const double* xs, size_t count, const double* p, double* values,
+                                              double* jacobian) {
+        double gradient[3];
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = decay(xs[i], p, jacobian ? gradient : nullptr);
+            if (jacobian) {
+                for (size_t k = 0; k < 3; ++k) jacobian[k * count + i] = gradient[k];
+            }
+        }
+    };
+
+    workerThreadLimit().store(1);
+    LevenbergMarquardtResult single = LevenbergMarquardt::fit(x, y, decay, {1.0, 1.0, 0.0});
+    workerThreadLimit().store(4);
+    LevenbergMarquardtResult parallel = LevenbergMarquardt::fit(x, y, decay, {1.0, 1.0, 0.0});
+    LevenbergMarquardtResult block = LevenbergMarquardt::fit(x, y, decayBlock, {1.0, 1.0, 0.0});
+    workerThreadLimit().store(0);
+
+    CHECK(single.converged());
+    CHECK(single.parameters == parallel.parameters);
+    CHECK(single.sumOfSquares == parallel.sumOfSquares);
+    CHECK(single.iterations == parallel.iterations);
+    CHECK(block.parameters == parallel.parameters);
+    CHECK_CLOSE(parallel.parameters[0], 2.0, 0.01);
+    CHECK_CLOSE(parallel.parameters[1], 0.7, 0.01);
+    CHECK_CLOSE(parallel.parameters[2], 0.3, 0.01);
+}
+
+void testFailureModes()
+{
+    NonlinearModel line = [](double xi, const double* p, double* gradient) {
+        if (gradient) {
+            gradient[0] = 1.0;
+            gradient[1] = xi;
+        }
+        return p[0] + p[1] * xi;
+    };
+    std::vector<double> x = {0.0, 1.0, 2.0, 3.0}, y = {1.0, 3.0, 5.0, 7.0};
+
+    // 初值处残差非有限
+    LevenbergMarquardtResult nanStart = LevenbergMarquardt::fit(x, y, line, {std::nan(""), 0.0});
+    CHECK(nanStart.status == LevenbergMarquardtStatus::Failed);
+
+    FitProgress progress;
+    progress.cancel();
+    LevenbergMarquardtOptions options;
+    options.progress = &progress;
+    LevenbergMarquardtResult cancelled = LevenbergMarquardt::fit(x, y, line, {0.0, 0.0}, options);
+    CHECK(cancelled.status == LevenbergMarquardtStatus::Cancelled);
+    CHECK(!cancelled.converged());
+
+    // 恰好可解的数据：残差为 0，不应因 SSR = 0 得到 NaN 标准误
+    LevenbergMarquardtResult exact = LevenbergMarquardt::fit(x, y, line, {0.0, 0.0});
+    CHECK(exact.converged());
+    CHECK_CLOSE(exact.parameters[0], 1.0, 1e-10);
+    CHECK_CLOSE(exact.parameters[1], 2.0, 1e-10);
+    for (double se : exact.standardErrors) CHECK(std::isfinite(se));
+}
+
+} // namespace
+
+int main()
+{
+    testLinearModel();
+    testRosenbrock();
+    testGaussian();
+    testDeterminism();
+    testFailureModes();
+    return testResult("levenberg_marquardt_test");
+}
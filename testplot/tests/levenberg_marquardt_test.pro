@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = levenberg_marquardt_test
+
+SOURCES += levenberg_marquardt_test.cpp \
+           ../levenberg_marquardt.cpp
+HEADERS += ../levenberg_marquardt.h ../fit_progress.h ../parallel_utils.h
@@ -0,0 +1,186 @@
+#include "line_decimation.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+// 任意下标区间的最值与逐点扫描一致；NaN 只在区间内全为 NaN 时被选中
+void testExtremes()
+{
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    bool inRange = true, minMatches = true, maxMatches = true;
+    for (int trial = 0; trial < 200; ++trial) {
+        size_t n = 1 + rng() % 5000;
+        std::vector<double> x(n), y(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = 0.5 * i;
+            y[i] = rng() % 97 == 0 ? NaN : normal(rng);
+        }
+        // 偶尔整段为 NaN
+        if (trial % 10 == 0 && n > 40) std::fill(y.begin() + 10, y.begin() + 40, NaN);
+        LinePyramid pyramid = LineDecimationEngine::build(x, y);
+        CHECK(pyramid.sorted && pyramid.count == n);
+
+        for (int query = 0; query < 200; ++query) {
+            size_t begin = rng() % n, end = rng() % n;
+            if (begin > end) std::swap(begin, end);
+            ++end;
+            size_t minAt, maxAt;
+            pyramid.extremes(y, begin, end, minAt, maxAt);
+            inRange = inRange && minAt >= begin && minAt < end && maxAt >= begin && maxAt < end;
+            double low = std::numeric_limits<double>::infinity(), high = -low;
+            bool any = false;
+            for (size_t i = begin; i < end; ++i) {
+                if (std::isnan(y[i])) continue;
+                any = true;
+                low = std::min(low, y[i]);
+                high = std::max(high, y[i]);
+            }
+            if (any) {
+                minMatches = minMatches && y[minAt] == low;
+                maxMatches = maxMatches && y[maxAt] == high;
+            } else {
+                minMatches = minMatches && std::isnan(y[minAt]);
+                maxMatches = maxMatches && std::isnan(y[maxAt]);
+            }
+        }
+    }
+    CHECK(inRange);
+    CHECK(minMatches);
+    CHECK(maxMatches);
+}
+
+void testBuildSummary()
+{
+    std::vector<double> x = {0.0, 1.0, 2.0, 3.0, 4.0}, y = {3.0, NaN, -1.0, 7.0, 2.0};
+    LinePyramid pyramid = LineDecimationEngine::build(x, y);
+    CHECK(pyramid.sorted && pyramid.hasRange);
+    CHECK(pyramid.xMin == 0.0 && pyramid.xMax == 4.0);
+    CHECK(pyramid.yMin == -1.0 && pyramid.yMax == 7.0);
+
+    // x 乱序或含 NaN 时不能按像素列抽取
+    CHECK(!LineDecimationEngine::build({0.0, 2.0, 1.0}, {1.0, 2.0, 3.0}).sorted);
+    CHECK(!LineDecimationEngine::build({0.0, NaN, 1.0}, {1.0, 2.0, 3.0}).sorted);
+    CHECK(!LineDecimationEngine::build({NaN, 1.0, 2.0}, {1.0, 2.0, 3.0}).sorted);
+    CHECK(LineDecimationEngine::decimate(LineDecimationEngine::build({0.0, 2.0, 1.0}, {1.0, 2.0, 3.0}),
+                                         {0.0, 2.0, 1.0}, {1.0, 2.0, 3.0}, 0.0, 2.0, 10).empty());
+    CHECK(!LineDecimationEngine::build({1.0}, {NaN}).hasRange);
+    CHECK(LineDecimationEngine::build(std::vector<double>(), std::vector<double>()).count == 0);
+
+    // 块内并行构建的结果与线程数无关
+    std::mt19937_64 rng(2);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> bigX(1000000), bigY(1000000);
+    for (size_t i = 0; i < bigX.size(); ++i) {
+        bigX[i] = static_cast<double>(i);
+        bigY[i] = normal(rng);
+    }
+    workerThreadLimit().store(1);
+    LinePyramid single = LineDecimationEngine::build(bigX, bigY);
+    workerThreadLimit().store(4);
+    LinePyramid parallel = LineDecimationEngine::build(bigX, bigY);
+    workerThreadLimit().store(0);
+    CHECK(single.minIndex == parallel.minIndex && single.maxIndex == parallel.maxIndex);
+    CHECK(single.yMin == parallel.yMin && single.yMax == parallel.yMax);
+}
+
+// M4：每个像素列保留的点的 y 范围等于该列全部点的 y 范围，首末点都在，下标升序无重复
+void checkDecimation(const std::vector<double>& x, const std::vector<double>& y, double viewMin, double viewMax,
+                     int columns)
+{
+    LinePyramid pyramid = LineDecimationEngine::build(x, y);
+    std::vector<size_t> kept = LineDecimationEngine::decimate(pyramid, x, y, viewMin, viewMax, columns);
+    CHECK(!kept.empty());
+    CHECK(std::adjacent_find(kept.begin(), kept.end(), [](size_t a, size_t b) { return a >= b; }) == kept.end());
+    CHECK(kept.size() <= 4 * static_cast<size_t>(columns) + 2);
+
+    // 视窗两侧各保留一个相邻点，连线延伸到边界
+    size_t first = std::lower_bound(x.begin(), x.end(), viewMin) - x.begin();
+    size_t last = std::upper_bound(x.begin(), x.end(), viewMax) - x.begin();
+    if (first > 0) CHECK(std::find(kept.begin(), kept.end(), first - 1) != kept.end());
+    if (last < x.size()) CHECK(std::find(kept.begin(), kept.end(), last) != kept.end());
+
+    double width = (viewMax - viewMin) / columns;
+    bool envelopes = true, endpoints = true;
+    size_t begin = first;
+    for (int c = 0; c < columns; ++c) {
+        size_t end = c + 1 < columns
+                   ? std::lower_bound(x.begin() + begin, x.begin() + last, viewMin + (c + 1) * width) - x.begin()
+                   : last;
+        if (end > begin) {
+            double low = std::numeric_limits<double>::infinity(), high = -low;
+            for (size_t i = begin; i < end; ++i) {
+                low = std::min(low, y[i]);
+                high = std::max(high, y[i]);
+            }
+            double keptLow = std::numeric_limits<double>::infinity(), keptHigh = -keptLow;
+            auto from = std::lower_bound(kept.begin(), kept.end(), begin);
+            auto to = std::lower_bound(kept.begin(), kept.end(), end);
+            for (auto it = from; it != to; ++it) {
+                keptLow = std::min(keptLow, y[*it]);
+                keptHigh = std::max(keptHigh, y[*it]);
+            }
+            envelopes = envelopes && keptLow == low && keptHigh == high;
+            endpoints = endpoints && from != to && *from == begin && *(to - 1) == end - 1;
+        }
+        begin = end;
+    }
+    CHECK(envelopes);
+    CHECK(endpoints);
+}
+
+void testDecimation()
+{
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    size_t n = 2000000;
+    std::vector<double> x(n), y(n);
+    double walk = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<double>(i) + 0.25 * (rng() % 4);   // 非等距
+        walk += normal(rng);
+        y[i] = walk;
+    }
+    checkDecimation(x, y, x.front(), x.back(), 1600);           // 全景
+    checkDecimation(x, y, 123456.0, 135000.0, 800);             // 放大
+    checkDecimation(x, y, 500000.0, 500900.0, 1600);            // 列数多于点数，逐点保留
+    checkDecimation(x, y, -1000.0, 1000.0, 37);                 // 视窗超出左端
+
+    // 点数少时原样保留
+    std::vector<double> smallX = {0.0, 1.0, 2.0}, smallY = {1.0, 0.0, 1.0};
+    std::vector<size_t> all = LineDecimationEngine::decimate(LineDecimationEngine::build(smallX, smallY), smallX, smallY,
+                                                             0.0, 2.0, 100);
+    CHECK((all == std::vector<size_t>{0, 1, 2}));
+}
+
+void testCache()
+{
+    LineDecimationEngine engine;
+    std::vector<double> x = {0.0, 1.0, 2.0, 3.0}, y = {1.0, 5.0, 2.0, 0.0};
+    CHECK(engine.pyramid(1, x, y).yMax == 5.0);
+    y[1] = 9.0;
+    CHECK(engine.pyramid(1, x, y).yMax == 5.0);   // 同一版本命中缓存
+    CHECK(engine.pyramid(2, x, y).yMax == 9.0);
+    x.push_back(4.0);
+    y.push_back(10.0);
+    CHECK(engine.pyramid(2, x, y).yMax == 10.0);  // 点数变化时重建
+}
+
+} // namespace
+
+int main()
+{
+    testExtremes();
+    testBuildSummary();
+    testDecimation();
+    testCache();
+    return testResult("line_decimation_test");
+}
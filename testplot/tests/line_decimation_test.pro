@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = line_decimation_test
+
+SOURCES += line_decimation_test.cpp \
+           ../line_decimation.cpp
+HEADERS += ../line_decimation.h ../parallel_utils.h
@@ -0,0 +1,168 @@
+#include "model_expression.h"
+#include "test_check.h"
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+typedef std::function<double(double, const std::vector<double>&)> Reference;
+
+std::vector<double> grid(size_t count, double lo, double hi)
+{
+    std::vector<double> x(count);
+    for (size_t i = 0; i < count; ++i) x[i] = lo + (hi - lo) * i / (count - 1);
+    return x;
+}
+
+// 编译后的求值（跨多个 256 点的块且最后一块不满）与直接写出的 C++ 表达式逐点对比
+void checkValues(const std::string& text, const std::vector<double>& parameters, const Reference& reference,
+                 double lo = -2.0, double hi = 2.0)
+{
+    std::string error;
+    std::shared_ptr<const ModelExpression> expression = ModelExpression::compile(text, &error);
+    if (!expression) std::printf("  %s: %s\n", text.c_str(), error.c_str());
+    CHECK(expression != nullptr);
+    if (!expression) return;
+    CHECK(expression->parameterCount() == parameters.size());
+
+    std::vector<double> x = grid(1000, lo, hi), values(x.size()), dualValues(x.size());
+    expression->evaluate(x.data(), x.size(), parameters.data(), values.data());
+    expression->evaluateWithJacobian(x.data(), x.size(), parameters.data(), dualValues.data(), nullptr);
+    double maxError = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        double expected = reference(x[i], parameters);
+        maxError = std::fmax(maxError, std::fabs(values[i] - expected) / std::fmax(1.0, std::fabs(expected)));
+        maxError = std::fmax(maxError, std::fabs(dualValues[i] - values[i]) / std::fmax(1.0, std::fabs(expected)));
+    }
+    if (!(maxError < 1e-14)) std::printf("  %s: max error %g\n", text.c_str(), maxError);
+    CHECK(maxError < 1e-14);
+}
+
+void testPrecedence()
+{
+    typedef const std::vector<double>& P;
+    checkValues("a + 2 + 3*4 - 6/3/2", {0.5}, [](double, P p) { return p[0] + 2.0 + 12.0 - 1.0; });
+    checkValues("a - 2^3^2", {1.0}, [](double, P p) { return p[0] - 512.0; });       // ^ 右结合
+    checkValues("-x^2 + a", {1.0}, [](double x, P p) { return -(x * x) + p[0]; });   // -x^2 = -(x^2)
+    checkValues("a*-x", {3.0}, [](double x, P p) { return p[0] * -x; });
+    checkValues("a - -x", {3.0}, [](double x, P p) { return p[0] + x; });
+    checkValues("2^-a*x", {2.0}, [](double x, P p) { return std::pow(2.0, -p[0]) * x; });
+    checkValues("(a + x)*(a - x)/b", {1.5, 4.0}, [](double x, P p) { return (p[0] + x) * (p[0] - x) / p[1]; });
+    checkValues("y = a*x + b", {2.0, -1.0}, [](double x, P p) { return p[0] * x + p[1]; });
+    checkValues("a*x/b*c", {2.0, 4.0, 3.0}, [](double x, P p) { return p[0] * x / p[1] * p[2]; });
+    checkValues("+a*(((x)))", {0.5}, [](double x, P p) { return p[0] * x; });
+    checkValues("a*1e-3*x + 2.5e2 + .5", {7.0}, [](double x, P p) { return p[0] * 1e-3 * x + 250.5; });
+    checkValues("a*pi*X", {1.0}, [](double x, P p) { return p[0] * M_PI * x; });
+
+    // 参数按出现顺序编号，重复出现的是同一个参数
+    std::string error;
+    std::shared_ptr<const ModelExpression> expression = ModelExpression::compile("b*x + a + b_2*b", &error);
+    CHECK(expression && (expression->parameterNames() == std::vector<std::string>{"b", "a", "b_2"}));
+}
+
+void testFunctions()
+{
+    typedef const std::vector<double>& P;
+    checkValues("a*sin(x) + cos(b*x) + tan(x/2)", {1.5, 2.0},
+                [](double x, P p) { return p[0] * std::sin(x) + std::cos(p[1] * x) + std::tan(x / 2.0); });
+    checkValues("asin(x/a) + acos(x/a) * atan(a*x)", {2.5},
+                [](double x, P p) { return std::asin(x / p[0]) + std::acos(x / p[0]) * std::atan(p[0] * x); });
+    checkValues("sinh(a*x) - cosh(x) + tanh(x*a)", {0.7},
+                [](double x, P p) { return std::sinh(p[0] * x) - std::cosh(x) + std::tanh(x * p[0]); });
+    checkValues("a*exp(-b*x) + ln(x) - log(c*x) + log10(x)", {2.0, 0.5, 3.0},
+                [](double x, P p) {
+                    return p[0] * std::exp(-p[1] * x) + std::log(x) - std::log(p[2] * x) + std::log10(x);
+                }, 0.1, 5.0);
+    checkValues("sqrt(abs(a*x)) + abs(x - a)", {0.3},
+                [](double x, P p) { return std::sqrt(std::fabs(p[0] * x)) + std::fabs(x - p[0]); });
+    checkValues("pow(x, a) + pow(a, 2) + x^2.5", {1.7},
+                [](double x, P p) { return std::pow(x, p[0]) + p[0] * p[0] + std::pow(x, 2.5); }, 0.1, 3.0);
+    checkValues("a*exp(-((x - b)/c)^2/2)", {3.0, 0.5, 0.8},
+                [](double x, P p) { return p[0] * std::exp(-std::pow((x - p[1]) / p[2], 2.0) / 2.0); });
+}
+
+void testErrors()
+{
+    const char* malformed[] = {
+        "", "   ", "a*", "(a + x", "a + )", "a x", "a $ x", "foo(x)*a", "pow(a)", "pow(a, x", "sin(a",
+        "sin(a, x)", "2*x + 1", "y = ", "a + b + c + d + e + f + g + h + i"};
+    for (const char* text : malformed) {
+        std::string error;
+        std::shared_ptr<const ModelExpression> expression = ModelExpression::compile(text, &error);
+        if (expression || error.empty()) std::printf("  accepted malformed formula \"%s\"\n", text);
+        CHECK(!expression && !error.empty());
+    }
+
+    std::string error;
+    ModelExpression::compile("(a + x", &error);
+    CHECK(error == "缺少右括号");
+    ModelExpression::compile("foo(x)*a", &error);
+    CHECK(error == "未知函数 foo");
+    ModelExpression::compile("a $ x", &error);
+    CHECK(error == "无法识别的字符 '$'");
+    ModelExpression::compile("2*x + 1", &error);
+    CHECK(error == "公式中没有待拟合的参数");
+    ModelExpression::compile("a*", &error);
+    CHECK(error == "公式不完整");
+    CHECK(ModelExpression::compile("a + b + c + d + e + f + g + h", nullptr) != nullptr);
+    CHECK(ModelExpression::compile("a +", nullptr) == nullptr);
+}
+
+// 自动微分的 Jacobian 与中心差分对比
+void checkGradient(const std::string& text, const std::vector<double>& parameters, double lo, double hi)
+{
+    std::shared_ptr<const ModelExpression> expression = ModelExpression::compile(text, nullptr);
+    CHECK(expression != nullptr);
+    if (!expression) return;
+    size_t m = parameters.size();
+    std::vector<double> x = grid(300, lo, hi), values(x.size()), jacobian(m * x.size());
+    expression->evaluateWithJacobian(x.data(), x.size(), parameters.data(), values.data(), jacobian.data());
+
+    double maxError = 0.0;
+    for (size_t k = 0; k < m; ++k) {
+        std::vector<double> plus = parameters, minus = parameters, up(x.size()), down(x.size());
+        double h = 1e-6 * std::fmax(1.0, std::fabs(parameters[k]));
+        plus[k] += h;
+        minus[k] -= h;
+        expression->evaluate(x.data(), x.size(), plus.data(), up.data());
+        expression->evaluate(x.data(), x.size(), minus.data(), down.data());
+        for (size_t i = 0; i < x.size(); ++i) {
+            double numeric = (up[i] - down[i]) / (2.0 * h);
+            double analytic = jacobian[k * x.size() + i];
+            maxError = std::fmax(maxError, std::fabs(analytic - numeric) / std::fmax(1.0, std::fabs(numeric)));
+        }
+    }
+    if (!(maxError < 1e-6)) std::printf("  %s: gradient error %g\n", text.c_str(), maxError);
+    CHECK(maxError < 1e-6);
+}
+
+void testGradients()
+{
+    checkGradient("a*exp(-b*x) + c", {2.0, 0.7, -1.0}, 0.0, 5.0);
+    checkGradient("a*sin(b*x + c) + d", {1.5, 2.0, 0.3, 0.1}, -3.0, 3.0);
+    checkGradient("a*exp(-((x - b)/c)^2/2)", {3.0, 0.5, 0.8}, -2.0, 3.0);
+    checkGradient("x^a + b^x + pow(c, 2)*x", {1.3, 1.8, 0.9}, 0.1, 3.0);
+    checkGradient("tan(a*x) + asin(b*x) + acos(x/c) + atan(a*b*x)", {0.3, 0.4, 2.5}, -1.5, 1.5);
+    checkGradient("sinh(a*x)/cosh(b) + tanh(c*x)", {0.5, 1.2, 2.0}, -2.0, 2.0);
+    checkGradient("ln(a*x) + log10(b + x) + sqrt(c*x) + abs(a - x)", {1.5, 2.0, 3.0}, 0.2, 4.0);
+    checkGradient("-a/(1 + b*x^2) - -c*x", {2.0, 0.5, 0.25}, -3.0, 3.0);
+    checkGradient("a + b*x + c*x^2 + d*x^3 + e*x^4 + f*x^5 + g*x^6 + h*x^7", {1, -1, 0.5, 0.3, -0.2, 0.1, 0.05, -0.01},
+                  -1.5, 1.5);
+}
+
+} // namespace
+
+int main()
+{
+    testPrecedence();
+    testFunctions();
+    testErrors();
+    testGradients();
+    return testResult("model_expression_test");
+}
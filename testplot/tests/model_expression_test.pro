@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = model_expression_test
+
+SOURCES += model_expression_test.cpp \
+           ../model_expression.cpp
+HEADERS += ../model_expression.h
@@ -0,0 +1,129 @@
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 每个块恰好执行一次，块边界连续覆盖 [0, count)
+void testChunkCoverage()
+{
+    for (size_t count : {1, 2, 7, 1000, 100003}) {
+        for (size_t chunks : {1, 2, 3, 8, 64}) {
+            std::vector<std::atomic<int>> visits(count);
+            for (auto& v : visits) v.store(0);
+            std::vector<size_t> begins(chunks, 0), ends(chunks, 0);
+            std::atomic<size_t> calls(0);
+            parallelForChunks(count, chunks, [&](size_t chunk, size_t begin, size_t end) {
+                ++calls;
+                begins[chunk] = begin;
+                ends[chunk] = end;
+                for (size_t i = begin; i < end; ++i) ++visits[i];
+            });
+            size_t used = std::min(chunks, count);
+            CHECK(calls.load() == used);
+            bool contiguous = begins[0] == 0 && ends[used - 1] == count;
+            for (size_t c = 1; c < used; ++c) contiguous = contiguous && begins[c] == ends[c - 1];
+            CHECK(contiguous);
+            bool once = true;
+            for (const auto& v : visits) once = once && v.load() == 1;
+            CHECK(once);
+        }
+    }
+    size_t calls = 0;
+    parallelForChunks(0, 4, [&](size_t, size_t, size_t) { ++calls; });
+    parallelForChunks(10, 0, [&](size_t, size_t, size_t) { ++calls; });
+    CHECK(calls == 0);
+}
+
+// 按块求和再按块序号归约：与线程数无关，重复执行逐位相同
+double blockSum(const std::vector<double>& data, size_t chunks)
+{
+    std::vector<double> partial(chunks, 0.0);
+    parallelForChunks(data.size(), chunks, [&](size_t chunk, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) partial[chunk] += data[i];
+    });
+    return std::accumulate(partial.begin(), partial.end(), 0.0);
+}
+
+void testDeterministicReduction()
+{
+    std::vector<double> data(1000000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = std::sin(0.001 * i) * 1e6 + 1.0 / (i + 1);
+    double first = blockSum(data, 8);
+    bool same = true;
+    for (int repeat = 0; repeat < 20; ++repeat) same = same && blockSum(data, 8) == first;
+    CHECK(same);
+}
+
+// 嵌套调用在外层块所在的线程上串行执行，结果与不嵌套时相同
+void testNesting()
+{
+    const size_t outer = 16, inner = 5000;
+    std::vector<double> results(outer, 0.0);
+    std::vector<std::thread::id> outerThreads(outer);
+    std::atomic<bool> innerOnOuterThread(true);
+    parallelForEach(outer, [&](size_t task) {
+        outerThreads[task] = std::this_thread::get_id();
+        std::vector<double> partial(8, 0.0);
+        parallelForChunks(inner, 8, [&](size_t chunk, size_t begin, size_t end) {
+            if (std::this_thread::get_id() != outerThreads[task]) innerOnOuterThread = false;
+            for (size_t i = begin; i < end; ++i) partial[chunk] += static_cast<double>(task * inner + i);
+        });
+        results[task] = std::accumulate(partial.begin(), partial.end(), 0.0);
+    });
+    CHECK(innerOnOuterThread.load());
+    bool correct = true;
+    for (size_t task = 0; task < outer; ++task) {
+        double expected = static_cast<double>(task * inner) * inner + inner * (inner - 1) / 2.0;
+        correct = correct && results[task] == expected;
+    }
+    CHECK(correct);
+    CHECK(!ParallelThreadPool::insideParallelRegion());
+}
+
+// 多个外部线程同时发起并行循环（如界面同时运行拟合和直方图计算），各自的结果互不干扰
+void testConcurrentCallers()
+{
+    std::vector<double> data(200000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<double>(i % 1000);
+    double expected = blockSum(data, 4);
+    std::atomic<bool> allSame(true);
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; ++t) {
+        callers.emplace_back([&]() {
+            for (int repeat = 0; repeat < 200; ++repeat) {
+                if (blockSum(data, 4) != expected) allSame = false;
+            }
+        });
+    }
+    for (std::thread& caller : callers) caller.join();
+    CHECK(allSame.load());
+}
+
+void testThreadLimit()
+{
+    workerThreadLimit().store(3);
+    CHECK(workerThreadCount() == 3);
+    CHECK(parallelChunkCount(10) == 1);
+    CHECK(parallelChunkCount(1000000) == 3);
+    CHECK(parallelChunkCount(1000000, 500000) == 2);
+    workerThreadLimit().store(0);
+    CHECK(workerThreadCount() >= 1);
+    CHECK(parallelChunkCount(0) == 0);
+}
+
+} // namespace
+
+int main()
+{
+    testChunkCoverage();
+    testDeterministicReduction();
+    testNesting();
+    testConcurrentCallers();
+    testThreadLimit();
+    return testResult("parallel_utils_test");
+}
@@ -0,0 +1,5 @@
+include(tests.pri)
+TARGET = parallel_utils_test
+
+SOURCES += parallel_utils_test.cpp
+HEADERS += ../parallel_utils.h
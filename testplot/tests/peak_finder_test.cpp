@@ -0,0 +1,214 @@
+#include "peak_finder.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 按 scipy.signal 的定义逐点扫描的参考实现：局部极大值（平台取中点）、逐峰向两侧扫描求突起度和宽度
+std::vector<size_t> directMaxima(const std::vector<double>& y)
+{
+    std::vector<size_t> maxima;
+    size_t last = y.size() - 1;
+    for (size_t i = 1; i < last; ++i) {
+        if (!(y[i - 1] < y[i])) continue;
+        size_t ahead = i + 1;
+        while (ahead < last && y[ahead] == y[i]) ++ahead;
+        if (y[ahead] < y[i]) {
+            maxima.push_back((i + ahead - 1) / 2);
+            i = ahead;
+        }
+    }
+    return maxima;
+}
+
+// 最小间隔：按高度从高到低（同高时下标大的优先）保留，去掉其间隔内的其他峰
+std::vector<size_t> directDistance(const std::vector<double>& y, const std::vector<size_t>& maxima, size_t distance)
+{
+    std::vector<size_t> order = maxima;
+    std::sort(order.begin(), order.end(), [&y](size_t a, size_t b) {
+        return y[a] > y[b] || (y[a] == y[b] && a > b);
+    });
+    std::vector<size_t> kept, removed;
+    for (size_t p : order) {
+        if (std::find(removed.begin(), removed.end(), p) != removed.end()) continue;
+        kept.push_back(p);
+        for (size_t q : maxima) {
+            if (q != p && (q > p ? q - p : p - q) < distance) removed.push_back(q);
+        }
+    }
+    std::sort(kept.begin(), kept.end());
+    return kept;
+}
+
+std::vector<Peak> directPeaks(const std::vector<double>& y, const PeakSpec& spec)
+{
+    std::vector<Peak> peaks;
+    std::vector<size_t> candidates = directMaxima(y);
+    if (spec.minDistance > 1) candidates = directDistance(y, candidates, spec.minDistance);
+    for (size_t p : candidates) {
+        Peak peak;
+        peak.index = p;
+        peak.height = y[p];
+
+        // 向两侧走到第一个严格更高的点为止，途经的最小值（相等时取离峰更近的）即谷底
+        double leftMin = y[p], rightMin = y[p];
+        peak.leftBase = peak.rightBase = p;
+        for (size_t i = p + 1; i-- > 0 && y[i] <= y[p];) {
+            if (y[i] < leftMin) {
+                leftMin = y[i];
+                peak.leftBase = i;
+            }
+        }
+        for (size_t i = p; i < y.size() && y[i] <= y[p]; ++i) {
+            if (y[i] < rightMin) {
+                rightMin = y[i];
+                peak.rightBase = i;
+            }
+        }
+        peak.prominence = y[p] - std::max(leftMin, rightMin);
+        if (peak.prominence < spec.minProminence) continue;
+
+        double h = y[p] - peak.prominence * spec.relHeight;
+        peak.widthHeight = h;
+        size_t i = p;
+        while (i > peak.leftBase && h < y[i]) --i;
+        double leftIp = static_cast<double>(i);
+        if (y[i] < h) leftIp += (h - y[i]) / (y[i + 1] - y[i]);
+        i = p;
+        while (i < peak.rightBase && h < y[i]) ++i;
+        double rightIp = static_cast<double>(i);
+        if (y[i] < h) rightIp -= (h - y[i]) / (y[i - 1] - y[i]);
+        peak.widthSamples = rightIp - leftIp;
+        if (peak.widthSamples < spec.minWidth) continue;
+
+        peak.position = static_cast<double>(p);
+        peak.leftPosition = leftIp;
+        peak.rightPosition = rightIp;
+        peaks.push_back(peak);
+    }
+    return peaks;
+}
+
+bool samePeaks(const std::vector<Peak>& actual, const std::vector<Peak>& expected)
+{
+    if (actual.size() != expected.size()) return false;
+    for (size_t i = 0; i < actual.size(); ++i) {
+        const Peak& a = actual[i];
+        const Peak& e = expected[i];
+        if (a.index != e.index || a.leftBase != e.leftBase || a.rightBase != e.rightBase || a.height != e.height
+            || a.prominence != e.prominence || a.widthHeight != e.widthHeight
+            || std::fabs(a.leftPosition - e.leftPosition) > 1e-9 || std::fabs(a.rightPosition - e.rightPosition) > 1e-9
+            || std::fabs(a.widthSamples - e.widthSamples) > 1e-9 || a.position != e.position) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void compareRandom(int kind, size_t trials)
+{
+    std::mt19937_64 rng(10 + kind);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_int_distribution<int> level(0, 5);
+    bool allMatch = true;
+    for (size_t trial = 0; trial < trials; ++trial) {
+        size_t n = 3 + rng() % 3000;
+        std::vector<double> y(n);
+        double walk = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            switch (kind) {
+            case 0: y[i] = normal(rng); break;                    // 白噪声：峰很多
+            case 1: walk += normal(rng); y[i] = walk; break;       // 随机游走：谷底常在很远处，跨越多个块
+            default: y[i] = level(rng); break;                     // 少数几个整数值：大量平台和相等的谷底
+            }
+        }
+        if (kind == 2) {
+            // 拉长平台
+            for (size_t i = 1; i < n; ++i) {
+                if (rng() % 3) y[i] = y[i - 1];
+            }
+        }
+        PeakSpec spec;
+        spec.minDistance = rng() % 4 == 0 ? 1 : 2 + rng() % 40;
+        spec.minProminence = (trial % 3 == 0) ? 0.0 : 0.5 * (rng() % 4);
+        spec.minWidth = (trial % 4 == 0) ? 2.0 : 0.0;
+        spec.relHeight = (trial % 5 == 0) ? 1.0 : 0.5;
+        if (!samePeaks(PeakFinder::find(std::vector<double>(), y, spec), directPeaks(y, spec))) {
+            std::printf("  mismatch: kind %d, trial %zu, n = %zu\n", kind, trial, n);
+            allMatch = false;
+        }
+    }
+    CHECK(allMatch);
+}
+
+void testHandComputed()
+{
+    // 峰在 2（平台 2..3 取 2）和 6；2 的谷底为 0 和 4，6 两侧没有更高的点，谷底为两端
+    std::vector<double> y = {0, 1, 3, 3, 1, 2, 5, 2, 0};
+    std::vector<Peak> peaks = PeakFinder::find(std::vector<double>(), y, PeakSpec());
+    CHECK(peaks.size() == 2);
+    if (peaks.size() == 2) {
+        CHECK(peaks[0].index == 2 && peaks[0].leftBase == 0 && peaks[0].rightBase == 4);
+        CHECK(peaks[0].prominence == 2.0);
+        CHECK(peaks[1].index == 6 && peaks[1].leftBase == 0 && peaks[1].rightBase == 8);
+        CHECK(peaks[1].prominence == 5.0);
+        // 半高 2.5：左交点在 5 与 6 之间 1/6 处，右交点在 6 与 7 之间 5/6 处
+        CHECK(peaks[1].widthHeight == 2.5);
+        CHECK_CLOSE(peaks[1].leftPosition, 5.0 + 1.0 / 6.0, 1e-15);
+        CHECK_CLOSE(peaks[1].rightPosition, 6.0 + 5.0 / 6.0, 1e-15);
+    }
+
+    // 带 x 时位置按 x 线性插值
+    std::vector<double> x = {0, 10, 20, 30, 40, 50, 60, 70, 80};
+    peaks = PeakFinder::find(x, y, PeakSpec());
+    CHECK(peaks.size() == 2 && peaks[1].position == 60.0);
+    if (peaks.size() == 2) CHECK_CLOSE(peaks[1].width(), 50.0 / 3.0, 1e-13);
+
+    // 端点不算峰，结尾处的平台不算峰
+    CHECK(PeakFinder::find(std::vector<double>(), {5, 1, 5}, PeakSpec()).empty());
+    CHECK(PeakFinder::find(std::vector<double>(), {0, 1, 2, 2}, PeakSpec()).empty());
+    CHECK(PeakFinder::find(std::vector<double>(), {1, 2}, PeakSpec()).empty());
+}
+
+void testDistanceTies()
+{
+    // 高峰优先：4 和 7 间隔 3 < 5，保留较高的 7；同高的 13 和 16 保留下标大的 16
+    std::vector<double> y(20, 0.0);
+    y[4] = 2.0;
+    y[7] = 3.0;
+    y[13] = 1.0;
+    y[16] = 1.0;
+    PeakSpec spec;
+    spec.minDistance = 5;
+    std::vector<Peak> peaks = PeakFinder::find(std::vector<double>(), y, spec);
+    CHECK(peaks.size() == 2 && peaks[0].index == 7 && peaks[1].index == 16);
+
+    // 间隔恰好等于 minDistance 时两者都保留
+    spec.minDistance = 3;
+    peaks = PeakFinder::find(std::vector<double>(), y, spec);
+    CHECK(peaks.size() == 4);
+
+    // 被去掉的峰不再去掉别的峰：7 去掉 10，而 10 与 13 的冲突不算数
+    std::vector<double> chain(18, 0.0);
+    chain[7] = 3.0;
+    chain[10] = 2.0;
+    chain[13] = 1.0;
+    spec.minDistance = 4;
+    peaks = PeakFinder::find(std::vector<double>(), chain, spec);
+    CHECK(peaks.size() == 2 && peaks[0].index == 7 && peaks[1].index == 13);
+}
+
+} // namespace
+
+int main()
+{
+    testHandComputed();
+    testDistanceTies();
+    compareRandom(0, 300);
+    compareRandom(1, 300);
+    compareRandom(2, 300);
+    return testResult("peak_finder_test");
+}
@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = peak_finder_test
+
+SOURCES += peak_finder_test.cpp \
+           ../peak_finder.cpp
+HEADERS += ../peak_finder.h
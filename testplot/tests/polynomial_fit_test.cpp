@@ -0,0 +1,191 @@
+#include "polynomial_fit.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 参考解：在同一映射 t = (x - center) / halfRange 上按 Chebyshev 基构造设计矩阵，
+// 用带再正交化的修正 Gram-Schmidt 求最小二乘拟合值，与流式 Householder QR 的实现完全独立
+std::vector<double> referenceFittedValues(const std::vector<double>& x, const std::vector<double>& y, int degree)
+{
+    size_t n = x.size();
+    size_t m = static_cast<size_t>(degree) + 1;
+    double xMin = *std::min_element(x.begin(), x.end());
+    double xMax = *std::max_element(x.begin(), x.end());
+    double center = 0.5 * (xMin + xMax), halfRange = 0.5 * (xMax - xMin);
+
+    std::vector<std::vector<double>> q(m, std::vector<double>(n));
+    for (size_t i = 0; i < n; ++i) {
+        double t = (x[i] - center) / halfRange;
+        q[0][i] = 1.0;
+        if (m > 1) q[1][i] = t;
+        for (size_t k = 2; k < m; ++k) q[k][i] = 2.0 * t * q[k - 1][i] - q[k - 2][i];
+    }
+    for (size_t k = 0; k < m; ++k) {
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t j = 0; j < k; ++j) {
+                double dot = 0.0;
+                for (size_t i = 0; i < n; ++i) dot += q[j][i] * q[k][i];
+                for (size_t i = 0; i < n; ++i) q[k][i] -= dot * q[j][i];
+            }
+        }
+        double norm = 0.0;
+        for (size_t i = 0; i < n; ++i) norm += q[k][i] * q[k][i];
+        norm = std::sqrt(norm);
+        for (size_t i = 0; i < n; ++i) q[k][i] /= norm;
+    }
+
+    std::vector<double> fitted(n, 0.0);
+    for (size_t k = 0; k < m; ++k) {
+        double dot = 0.0;
+        for (size_t i = 0; i < n; ++i) dot += q[k][i] * y[i];
+        for (size_t i = 0; i < n; ++i) fitted[i] += dot * q[k][i];
+    }
+    return fitted;
+}
+
+double residualSumOfSquares(const PolynomialFit& fit, const std::vector<double>& x, const std::vector<double>& y)
+{
+    double rss = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        double r = y[i] - fit.evaluate(x[i]);
+        rss += r * r;
+    }
+    return rss;
+}
+
+void testExactPolynomial()
+{
+    // 无噪声的三次多项式：系数应原样恢复，残差为 0
+    const double truth[] = {2.0, -3.0, 0.5, 0.25};
+    std::vector<double> x, y;
+    for (int i = 0; i <= 200; ++i) {
+        double xi = -5.0 + 0.05 * i;
+        x.push_back(xi);
+        y.push_back(truth[0] + xi * (truth[1] + xi * (truth[2] + xi * truth[3])));
+    }
+    for (PolynomialBasis basis : {PolynomialBasis::Chebyshev, PolynomialBasis::Monomial}) {
+        PolynomialFit fit = PolynomialFitter::fit(x, y, 3, basis);
+        CHECK(fit.valid);
+        std::vector<double> coefficients = fit.monomialCoefficients();
+        CHECK(coefficients.size() == 4);
+        for (size_t k = 0; k < coefficients.size() && k < 4; ++k) CHECK_CLOSE(coefficients[k], truth[k], 1e-10);
+        CHECK(fit.residualSumOfSquares < 1e-18);
+        CHECK_CLOSE(fit.evaluate(1.2345), truth[0] + 1.2345 * (truth[1] + 1.2345 * (truth[2] + 1.2345 * truth[3])),
+                    1e-12);
+    }
+}
+
+void testAgainstReference()
+{
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> uniform(-2.0, 3.0);
+    std::normal_distribution<double> noise(0.0, 0.1);
+    std::vector<double> x(5000), y(5000);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = uniform(rng);
+        y[i] = std::sin(2.0 * x[i]) + 1.0 / (1.0 + x[i] * x[i]) + noise(rng);
+    }
+    for (int degree : {0, 1, 2, 5, 10, 20}) {
+        PolynomialFit fit = PolynomialFitter::fit(x, y, degree);
+        CHECK(fit.valid);
+        std::vector<double> expected = referenceFittedValues(x, y, degree);
+        double maxError = 0.0;
+        for (size_t i = 0; i < x.size(); ++i) maxError = std::fmax(maxError, std::fabs(fit.evaluate(x[i]) - expected[i]));
+        if (!(maxError < 1e-9)) std::printf("  degree %d: max fitted-value error %g\n", degree, maxError);
+        CHECK(maxError < 1e-9);
+        // 由 R 因子得到的 RSS 与逐点计算一致
+        CHECK_CLOSE(fit.residualSumOfSquares, residualSumOfSquares(fit, x, y), 1e-9);
+    }
+}
+
+void testLargeDataDeterminism()
+{
+    // 超过一段（65536 行）时各段分别累积再合并；结果不应随线程数变化
+    std::mt19937_64 rng(2);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    size_t n = 300000;
+    std::vector<double> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 1e6 + static_cast<double>(i) / n;   // 大偏移、窄范围
+        double t = static_cast<double>(i) / n;
+        y[i] = 3.0 - 2.0 * t + 4.0 * t * t + noise(rng);
+    }
+
+    workerThreadLimit().store(1);
+    PolynomialFit single = PolynomialFitter::fit(x, y, 8);
+    workerThreadLimit().store(4);
+    PolynomialFit parallel = PolynomialFitter::fit(x, y, 8);
+    workerThreadLimit().store(0);
+
+    CHECK(single.valid && parallel.valid);
+    CHECK(single.coefficients == parallel.coefficients);
+    CHECK(single.residualSumOfSquares == parallel.residualSumOfSquares);
+    CHECK_CLOSE(parallel.residualSumOfSquares, residualSumOfSquares(parallel, x, y), 1e-8);
+    // 噪声方差为 1，RSS/n 应接近 1
+    CHECK(std::fabs(parallel.residualSumOfSquares / n - 1.0) < 0.02);
+
+    std::vector<double> values(n);
+    parallel.evaluate(x.data(), n, values.data());
+    bool same = true;
+    for (size_t i = 0; i < n; i += 997) same = same && values[i] == parallel.evaluate(x[i]);
+    CHECK(same);
+}
+
+void testWeights()
+{
+    // 权为 0 的点不参与：结果与只用其余点的拟合相同
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> noise(0.0, 0.2);
+    std::vector<double> x, y, weights, keptX, keptY;
+    for (int i = 0; i < 400; ++i) {
+        double xi = 0.01 * i;
+        double yi = 1.0 + xi - 0.3 * xi * xi + noise(rng);
+        bool outlier = i % 17 == 0;
+        if (outlier) yi += 50.0;
+        x.push_back(xi);
+        y.push_back(yi);
+        weights.push_back(outlier ? 0.0 : 1.0);
+        if (!outlier) {
+            keptX.push_back(xi);
+            keptY.push_back(yi);
+        }
+    }
+    PolynomialFit weighted = PolynomialFitter::fit(x.data(), y.data(), x.size(), 2, PolynomialBasis::Chebyshev,
+                                                   nullptr, weights.data());
+    PolynomialFit subset = PolynomialFitter::fit(keptX, keptY, 2);
+    CHECK(weighted.valid && subset.valid);
+    for (double xi : {0.0, 1.0, 2.5, 3.99}) CHECK_CLOSE(weighted.evaluate(xi), subset.evaluate(xi), 1e-10);
+    CHECK_CLOSE(weighted.residualSumOfSquares, subset.residualSumOfSquares, 1e-9);
+}
+
+void testInvalidInput()
+{
+    std::vector<double> x = {1.0, 2.0, 3.0}, y = {1.0, 4.0, 9.0};
+    CHECK(!PolynomialFitter::fit(x, y, 3).valid);                 // 点数不超过次数
+    CHECK(PolynomialFitter::fit(x, y, 2).valid);
+    CHECK(!PolynomialFitter::fit(std::vector<double>{2.0, 2.0, 2.0}, y, 1).valid);   // x 全相同
+    CHECK(!PolynomialFitter::fit(x, std::vector<double>{1.0, 2.0}, 1).valid);        // 长度不一致
+
+    FitProgress progress;
+    progress.cancel();
+    std::vector<double> longX(1000), longY(1000);
+    for (size_t i = 0; i < longX.size(); ++i) longX[i] = longY[i] = static_cast<double>(i);
+    CHECK(!PolynomialFitter::fit(longX, longY, 1, PolynomialBasis::Chebyshev, &progress).valid);
+}
+
+} // namespace
+
+int main()
+{
+    testExactPolynomial();
+    testAgainstReference();
+    testLargeDataDeterminism();
+    testWeights();
+    testInvalidInput();
+    return testResult("polynomial_fit_test");
+}
@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = polynomial_fit_test
+
+SOURCES += polynomial_fit_test.cpp \
+           ../polynomial_fit.cpp
+HEADERS += ../polynomial_fit.h ../fit_progress.h ../parallel_utils.h
@@ -0,0 +1,203 @@
+#include "robust_fit.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double Truth[3] = {1.0, -2.0, 0.5};
+
+double truth(double x)
+{
+    return Truth[0] + Truth[1] * x + Truth[2] * x * x;
+}
+
+struct Sample {
+    std::vector<double> x, y;
+    std::vector<char> outlier;
+};
+
+// y = 1 - 2x + 0.5x² 加 σ = sigma 的噪声，其中 fraction 比例的点向上偏离 5..30（单侧，普通最小二乘会被明显拉偏）
+Sample makeSample(size_t n, double fraction, unsigned seed, double sigma = 0.1)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> position(-3.0, 3.0), unit(0.0, 1.0), offset(5.0, 30.0);
+    std::normal_distribution<double> noise(0.0, sigma);
+    Sample sample;
+    sample.x.resize(n);
+    sample.y.resize(n);
+    sample.outlier.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        sample.x[i] = position(rng);
+        sample.y[i] = truth(sample.x[i]) + noise(rng);
+        sample.outlier[i] = unit(rng) < fraction;
+        if (sample.outlier[i]) sample.y[i] += offset(rng);
+    }
+    return sample;
+}
+
+// 拟合曲线在 [-3, 3] 上与真实曲线的最大偏差
+double curveError(const PolynomialFit& fit)
+{
+    double error = 0.0;
+    for (int i = 0; i <= 600; ++i) {
+        double x = -3.0 + 0.01 * i;
+        error = std::fmax(error, std::fabs(fit.evaluate(x) - truth(x)));
+    }
+    return error;
+}
+
+void checkRecovery(RobustMethod method, const Sample& sample, double tolerance, double threshold = 0.0)
+{
+    RobustFitOptions options;
+    options.method = method;
+    options.ransacThreshold = threshold;
+    RobustFitResult result = RobustFitter::fitPolynomial(sample.x, sample.y, 2, options);
+    const char* name = RobustFitter::methodName(method);
+    CHECK(result.fit.valid);
+    if (!result.fit.valid) return;
+    double error = curveError(result.fit);
+    if (!(error < tolerance)) std::printf("  %s: curve error %g\n", name, error);
+    CHECK(error < tolerance);
+
+    // 离群点全部判为外点，真正的内点几乎全部保留
+    CHECK(result.inliers.size() == sample.x.size());
+    size_t missedOutliers = 0, lostInliers = 0, trueInliers = 0;
+    for (size_t i = 0; i < sample.x.size(); ++i) {
+        if (sample.outlier[i]) {
+            missedOutliers += result.inliers[i] != 0;
+        } else {
+            ++trueInliers;
+            lostInliers += result.inliers[i] == 0;
+        }
+    }
+    if (missedOutliers || lostInliers * 50 > trueInliers) {
+        std::printf("  %s: %zu outliers kept, %zu of %zu inliers dropped\n", name, missedOutliers, lostInliers,
+                    trueInliers);
+    }
+    CHECK(missedOutliers == 0);
+    CHECK(lostInliers * 50 <= trueInliers);
+    CHECK(result.inlierCount == trueInliers - lostInliers);
+    CHECK(result.scale > 0.05 && result.scale < 0.3);
+}
+
+void testOutlierRecovery()
+{
+    Sample sample = makeSample(4000, 0.2, 7);
+
+    // 普通最小二乘被单侧离群点整体抬高
+    RobustFitOptions options;
+    options.method = RobustMethod::LeastSquares;
+    RobustFitResult plain = RobustFitter::fitPolynomial(sample.x, sample.y, 2, options);
+    CHECK(plain.fit.valid && plain.inliers.empty());
+    CHECK(curveError(plain.fit) > 2.0);
+
+    checkRecovery(RobustMethod::Ransac, sample, 0.03);
+    checkRecovery(RobustMethod::Tukey, sample, 0.03);
+    // Huber 对离群点的权只衰减到 k/|u|，单侧离群点留下约一个噪声标准差以内的偏差
+    checkRecovery(RobustMethod::Huber, sample, 0.1);
+
+    // 给定内点阈值时 RANSAC 能承受过半的离群点（此时相邻差分的噪声估计已被离群点主导，不能自动取阈值）
+    checkRecovery(RobustMethod::Ransac, makeSample(4000, 0.55, 11), 0.03, 0.3);
+}
+
+void testNoiseScale()
+{
+    Sample clean = makeSample(20000, 0.0, 3);
+    double scale = RobustFitter::noiseScale(clean.x, clean.y);
+    if (!(std::fabs(scale - 0.1) < 0.005)) std::printf("  noise scale %g\n", scale);
+    CHECK(std::fabs(scale - 0.1) < 0.005);
+    CHECK(RobustFitter::noiseScale({1.0, 2.0}, {1.0, 2.0}) == 0.0);
+}
+
+bool sameResult(const RobustFitResult& a, const RobustFitResult& b)
+{
+    return a.fit.valid == b.fit.valid && a.fit.coefficients == b.fit.coefficients && a.inliers == b.inliers &&
+           a.inlierCount == b.inlierCount && a.scale == b.scale && a.iterations == b.iterations;
+}
+
+void checkSameForAllLimits(const char* name, const Sample& sample, const RobustFitOptions& options)
+{
+    const unsigned limits[] = {2, 3, 8, 0};
+    workerThreadLimit().store(1);
+    RobustFitResult reference = RobustFitter::fitPolynomial(sample.x, sample.y, 2, options);
+    CHECK(reference.fit.valid);
+    CHECK(sameResult(reference, RobustFitter::fitPolynomial(sample.x, sample.y, 2, options)));
+    for (unsigned limit : limits) {
+        workerThreadLimit().store(limit);
+        bool same = sameResult(reference, RobustFitter::fitPolynomial(sample.x, sample.y, 2, options));
+        if (!same) std::printf("  %s, n = %zu: differs with %u threads\n", name, sample.x.size(), limit);
+        CHECK(same);
+    }
+    workerThreadLimit().store(0);
+}
+
+// 固定种子时结果与线程数无关：数据量小于和大于并行分块阈值各一组
+void testThreadIndependence()
+{
+    const size_t sizes[] = {4000, 150000};
+    const RobustMethod methods[] = {RobustMethod::Ransac, RobustMethod::Huber, RobustMethod::Tukey};
+    for (size_t n : sizes) {
+        Sample sample = makeSample(n, 0.3, 5);
+        for (RobustMethod method : methods) {
+            RobustFitOptions options;
+            options.method = method;
+            options.ransacHypotheses = 97;
+            checkSameForAllLimits(RobustFitter::methodName(method), sample, options);
+        }
+    }
+
+    // 阈值远小于噪声且假设不多时，两轮重拟合收敛不到同一组内点，结果取决于选中的假设，
+    // 能看出各假设的随机流是否随分块变化
+    RobustFitOptions narrow;
+    narrow.method = RobustMethod::Ransac;
+    narrow.ransacHypotheses = 16;
+    narrow.ransacThreshold = 0.3;
+    checkSameForAllLimits("narrow RANSAC", makeSample(4000, 0.3, 5, 1.0), narrow);
+
+    // 换种子后 RANSAC 抽到不同的假设，但仍收敛到同一条曲线
+    Sample sample = makeSample(4000, 0.3, 5);
+    RobustFitOptions options;
+    options.method = RobustMethod::Ransac;
+    for (uint64_t seed : {1ULL, 2ULL, 12345ULL}) {
+        options.seed = seed;
+        RobustFitResult result = RobustFitter::fitPolynomial(sample.x, sample.y, 2, options);
+        CHECK(result.fit.valid && curveError(result.fit) < 0.03);
+    }
+}
+
+void testDegenerateInput()
+{
+    RobustFitResult result = RobustFitter::fitPolynomial({0.0, 1.0, 2.0}, {1.0, 2.0, 3.0}, 2);
+    CHECK(!result.fit.valid);
+    result = RobustFitter::fitPolynomial({0.0, 1.0, 2.0}, {1.0, 2.0}, 1);
+    CHECK(!result.fit.valid);
+
+    // 点全部精确落在直线上时尺度为 0，仍给出精确解
+    std::vector<double> x, y;
+    for (int i = 0; i < 50; ++i) {
+        x.push_back(i);
+        y.push_back(2.0 * i - 1.0);
+    }
+    RobustFitOptions options;
+    for (RobustMethod method : {RobustMethod::Ransac, RobustMethod::Huber, RobustMethod::Tukey}) {
+        options.method = method;
+        result = RobustFitter::fitPolynomial(x, y, 1, options);
+        CHECK(result.fit.valid);
+        if (result.fit.valid) CHECK_CLOSE(result.fit.evaluate(20.5), 40.0, 1e-9);
+        CHECK(result.inlierCount == x.size());
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testOutlierRecovery();
+    testNoiseScale();
+    testThreadIndependence();
+    testDegenerateInput();
+    return testResult("robust_fit_test");
+}
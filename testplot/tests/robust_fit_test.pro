@@ -0,0 +1,7 @@
+include(tests.pri)
+TARGET = robust_fit_test
+
+SOURCES += robust_fit_test.cpp \
+           ../robust_fit.cpp \
+           ../polynomial_fit.cpp
+HEADERS += ../robust_fit.h ../polynomial_fit.h ../fit_progress.h ../parallel_utils.h
@@ -0,0 +1,131 @@
+#include "rolling_window.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 逐个窗口直接计算的参考值：窗口为 [i - window + 1, i]，开头不足一个窗口时取已有的点
+struct WindowStats {
+    double mean;
+    double stddev;
+    double min;
+    double max;
+};
+
+WindowStats directWindow(const std::vector<double>& data, size_t i, size_t window)
+{
+    size_t begin = i + 1 >= window ? i + 1 - window : 0;
+    size_t count = i + 1 - begin;
+    double sum = 0.0;
+    for (size_t j = begin; j <= i; ++j) sum += data[j];
+    double mean = sum / count;
+    double m2 = 0.0;
+    for (size_t j = begin; j <= i; ++j) m2 += (data[j] - mean) * (data[j] - mean);
+    WindowStats stats;
+    stats.mean = mean;
+    stats.stddev = count > 1 ? std::sqrt(m2 / (count - 1)) : 0.0;
+    stats.min = *std::min_element(data.begin() + begin, data.begin() + i + 1);
+    stats.max = *std::max_element(data.begin() + begin, data.begin() + i + 1);
+    return stats;
+}
+
+void checkAgainstDirect(const std::vector<double>& data, size_t window, double scale)
+{
+    std::vector<double> means = RollingWindowEngine::mean(data, window);
+    std::vector<double> deviations = RollingWindowEngine::standardDeviation(data, window);
+    std::vector<double> minima = RollingWindowEngine::minimum(data, window);
+    std::vector<double> maxima = RollingWindowEngine::maximum(data, window);
+    CHECK(means.size() == data.size() && deviations.size() == data.size());
+    CHECK(minima.size() == data.size() && maxima.size() == data.size());
+
+    // 窗口为 0 按 1 处理
+    size_t effective = std::max<size_t>(1, window);
+    double meanError = 0.0, deviationError = 0.0;
+    bool extremesMatch = true;
+    for (size_t i = 0; i < data.size(); ++i) {
+        WindowStats expected = directWindow(data, i, effective);
+        meanError = std::fmax(meanError, std::fabs(means[i] - expected.mean));
+        deviationError = std::fmax(deviationError, std::fabs(deviations[i] - expected.stddev));
+        extremesMatch = extremesMatch && minima[i] == expected.min && maxima[i] == expected.max;
+    }
+    // 均值误差相对于数据的量级（参考值自身的求和也有舍入），标准差误差相对于波动幅度 scale
+    double magnitude = 1.0;
+    for (double v : data) magnitude = std::fmax(magnitude, std::fabs(v));
+    if (!(meanError <= 1e-12 * magnitude && deviationError <= 1e-7 * scale)) {
+        std::printf("  window = %zu: mean error %g, stddev error %g\n", window, meanError, deviationError);
+    }
+    CHECK(meanError <= 1e-12 * magnitude);
+    CHECK(deviationError <= 1e-7 * scale);
+    CHECK(extremesMatch);
+}
+
+void testSmallWindows()
+{
+    // 窗口为 1 时输出即数据、标准差为 0（先删后加的实现在这里会除以 0 得到 NaN）
+    const std::vector<double> data = {1, 2, 3, 4, 5};
+    for (size_t window : {0, 1}) {
+        std::vector<double> means = RollingWindowEngine::mean(data, window);
+        std::vector<double> deviations = RollingWindowEngine::standardDeviation(data, window);
+        for (size_t i = 0; i < data.size(); ++i) {
+            CHECK(means[i] == data[i]);
+            CHECK(deviations[i] == 0.0);
+        }
+    }
+
+    std::vector<double> pairs = RollingWindowEngine::mean(data, 2);
+    const double expected[] = {1.0, 1.5, 2.5, 3.5, 4.5};
+    for (size_t i = 0; i < data.size(); ++i) CHECK_CLOSE(pairs[i], expected[i], 1e-15);
+
+    CHECK(RollingWindowEngine::mean(std::vector<double>(), 3).empty());
+    CHECK(RollingWindowEngine::maximum(std::vector<double>(), 3).empty());
+}
+
+void testRandomData()
+{
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> data(3000);
+    for (double& v : data) v = normal(rng);
+    for (size_t window : {0, 1, 2, 3, 7, 50, 499, 2999, 3000, 5000}) {
+        checkAgainstDirect(data, window, 1.0);
+    }
+
+    // 大偏移量加缓慢漂移：均值远大于波动时 M2 不应发生抵消
+    std::vector<double> offset(data.size());
+    for (size_t i = 0; i < data.size(); ++i) offset[i] = 1e8 + 0.01 * i + data[i];
+    for (size_t window : {1, 2, 10, 200}) {
+        checkAgainstDirect(offset, window, 10.0);
+    }
+
+    // 有重复值时单调队列仍应给出正确的最值
+    std::vector<double> steps(1000);
+    for (size_t i = 0; i < steps.size(); ++i) steps[i] = static_cast<double>((i * 7919) % 13);
+    checkAgainstDirect(steps, 5, 10.0);
+}
+
+void testCache()
+{
+    RollingWindowEngine engine;
+    std::vector<double> data = {4, 1, 3, 2, 5};
+    const std::vector<double>& first = engine.series(0, 1, data, 2, RollingStatistic::Maximum);
+    CHECK(first == RollingWindowEngine::maximum(data, 2));
+
+    // 版本或窗口变化时重算
+    data[2] = 9;
+    CHECK(engine.series(0, 2, data, 2, RollingStatistic::Maximum) == RollingWindowEngine::maximum(data, 2));
+    CHECK(engine.series(0, 2, data, 3, RollingStatistic::Maximum) == RollingWindowEngine::maximum(data, 3));
+    CHECK(engine.series(0, 2, data, 3, RollingStatistic::Minimum) == RollingWindowEngine::minimum(data, 3));
+}
+
+} // namespace
+
+int main()
+{
+    testSmallWindows();
+    testRandomData();
+    testCache();
+    return testResult("rolling_window_test");
+}
@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = rolling_window_test
+
+SOURCES += rolling_window_test.cpp \
+           ../rolling_window.cpp
+HEADERS += ../rolling_window.h
@@ -0,0 +1,209 @@
+#include "segmented_fit.h"
+#include "parallel_utils.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 一段点的最小二乘残差平方和：段内 x 映射到 [-1, 1] 后用修正 Gram-Schmidt 正交化，与前缀和正规方程的实现无关
+double segmentRss(const std::vector<double>& x, const std::vector<double>& y, size_t begin, size_t end, int degree)
+{
+    size_t n = end - begin, m = static_cast<size_t>(degree) + 1;
+    double center = 0.5 * (x[begin] + x[end - 1]), half = 0.5 * (x[end - 1] - x[begin]);
+    std::vector<std::vector<double>> q(m, std::vector<double>(n));
+    for (size_t i = 0; i < n; ++i) {
+        double t = half > 0.0 ? (x[begin + i] - center) / half : 0.0;
+        double power = 1.0;
+        for (size_t k = 0; k < m; ++k, power *= t) q[k][i] = power;
+    }
+    std::vector<double> residual(y.begin() + begin, y.begin() + end);
+    for (size_t k = 0; k < m; ++k) {
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t j = 0; j < k; ++j) {
+                double dot = 0.0;
+                for (size_t i = 0; i < n; ++i) dot += q[j][i] * q[k][i];
+                for (size_t i = 0; i < n; ++i) q[k][i] -= dot * q[j][i];
+            }
+        }
+        double norm = 0.0;
+        for (size_t i = 0; i < n; ++i) norm += q[k][i] * q[k][i];
+        norm = std::sqrt(norm);
+        for (size_t i = 0; i < n; ++i) q[k][i] /= norm;
+        for (int pass = 0; pass < 2; ++pass) {
+            double dot = 0.0;
+            for (size_t i = 0; i < n; ++i) dot += q[k][i] * residual[i];
+            for (size_t i = 0; i < n; ++i) residual[i] -= dot * q[k][i];
+        }
+    }
+    double rss = 0.0;
+    for (double r : residual) rss += r * r;
+    return rss;
+}
+
+// 枚举全部 1 个或 2 个断点的位置，返回最优分段的各段点数和总 RSS
+double bruteForce(const std::vector<double>& x, const std::vector<double>& y, int breakpoints, int degree,
+                  size_t minPoints, std::vector<size_t>& sizes)
+{
+    size_t n = x.size();
+    double best = std::numeric_limits<double>::infinity();
+    if (breakpoints == 1) {
+        for (size_t a = minPoints; a + minPoints <= n; ++a) {
+            double rss = segmentRss(x, y, 0, a, degree) + segmentRss(x, y, a, n, degree);
+            if (rss < best) {
+                best = rss;
+                sizes = {a, n - a};
+            }
+        }
+    } else {
+        for (size_t a = minPoints; a + 2 * minPoints <= n; ++a) {
+            double first = segmentRss(x, y, 0, a, degree);
+            for (size_t b = a + minPoints; b + minPoints <= n; ++b) {
+                double rss = first + segmentRss(x, y, a, b, degree) + segmentRss(x, y, b, n, degree);
+                if (rss < best) {
+                    best = rss;
+                    sizes = {a, b - a, n - b};
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void testAgainstBruteForce()
+{
+    // 点数不超过块数上限时动态规划是逐点精确的
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> noise(0.0, 0.3);
+    std::vector<double> x(90), y(90);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = 0.5 * i + 0.1 * std::sin(static_cast<double>(i));
+        double base = i < 30 ? 0.2 * x[i] : i < 65 ? 8.0 - 0.3 * x[i] + 0.01 * x[i] * x[i] : 1.0 + 0.1 * x[i];
+        y[i] = base + noise(rng);
+    }
+    for (int breakpoints : {1, 2}) {
+        for (int degree : {0, 1, 2, 3}) {
+            size_t minPoints = static_cast<size_t>(degree) + 2;
+            std::vector<size_t> sizes;
+            double best = bruteForce(x, y, breakpoints, degree, minPoints, sizes);
+            SegmentedFitResult result = SegmentedRegression::fit(x, y, breakpoints, degree);
+            CHECK(result.valid);
+            CHECK_CLOSE(result.residualSumOfSquares, best, 1e-9);
+            CHECK(result.segmentSizes == sizes);
+            CHECK(result.breakpoints.size() == static_cast<size_t>(breakpoints));
+
+            // 断点位于相邻两段之间的中点，evaluate 在每段内给出该段的多项式
+            size_t boundary = 0;
+            for (size_t j = 0; j + 1 < sizes.size() && j < result.breakpoints.size(); ++j) {
+                boundary += sizes[j];
+                CHECK_CLOSE(result.breakpoints[j], 0.5 * (x[boundary - 1] + x[boundary]), 1e-15);
+            }
+            double rss = 0.0;
+            for (size_t i = 0; i < x.size(); ++i) rss += (y[i] - result.evaluate(x[i])) * (y[i] - result.evaluate(x[i]));
+            CHECK_CLOSE(rss, result.residualSumOfSquares, 1e-9);
+        }
+    }
+
+    // 每段点数下限
+    std::vector<size_t> sizes;
+    double best = bruteForce(x, y, 2, 1, 25, sizes);
+    SegmentedFitResult constrained = SegmentedRegression::fit(x, y, 2, 1, 25);
+    CHECK(constrained.valid);
+    CHECK_CLOSE(constrained.residualSumOfSquares, best, 1e-9);
+    CHECK(constrained.segmentSizes == sizes);
+}
+
+void testExactPieces()
+{
+    // 无噪声的分段三次：断点和各段多项式精确恢复，输入顺序无关
+    std::vector<double> x, y;
+    for (int i = 0; i < 3000; ++i) {
+        double xi = 0.01 * i;
+        double yi = xi < 10.0 ? 1.0 + xi - 0.1 * xi * xi : xi < 21.0 ? -5.0 + 0.02 * xi * xi * xi / 10.0 : 40.0 - xi;
+        x.push_back(xi);
+        y.push_back(yi);
+    }
+    std::mt19937_64 rng(2);
+    std::vector<size_t> order(x.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<double> shuffledX, shuffledY;
+    for (size_t i : order) {
+        shuffledX.push_back(x[i]);
+        shuffledY.push_back(y[i]);
+    }
+
+    SegmentedFitResult result = SegmentedRegression::fit(shuffledX, shuffledY, 2, 3);
+    CHECK(result.valid);
+    CHECK(result.residualSumOfSquares < 1e-12);
+    CHECK(result.breakpoints.size() == 2);
+    if (result.breakpoints.size() == 2) {
+        CHECK_CLOSE(result.breakpoints[0], 9.995, 1e-12);
+        CHECK_CLOSE(result.breakpoints[1], 20.995, 1e-12);
+    }
+    for (double xi : {0.0, 5.5, 12.0, 20.5, 25.0, 29.99}) CHECK_CLOSE(result.evaluate(xi), y[static_cast<size_t>(std::lround(xi * 100))], 1e-8);
+}
+
+void testLargeOffset()
+{
+    // 2×10^5 点、y 偏移 10^8：先分块再逐点细化，断点落在真实位置，RSS 接近噪声本身的平方和
+    size_t n = 200000;
+    std::vector<double> x(n), y(n);
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    double noiseRss = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<double>(i);
+        double base = i < 60000 ? 0.001 * i : i < 130000 ? 200.0 - 0.002 * (i - 60000.0) : 50.0 + 0.0005 * (i - 130000.0);
+        double e = noise(rng);
+        noiseRss += e * e;
+        y[i] = 1e8 + base + e;
+    }
+
+    workerThreadLimit().store(1);
+    SegmentedFitResult single = SegmentedRegression::fit(x, y, 2, 1);
+    workerThreadLimit().store(4);
+    SegmentedFitResult result = SegmentedRegression::fit(x, y, 2, 1);
+    workerThreadLimit().store(0);
+
+    CHECK(result.valid);
+    CHECK(result.breakpoints.size() == 2);
+    if (result.breakpoints.size() != 2) return;
+    CHECK(std::fabs(result.breakpoints[0] - 59999.5) <= 2.0);
+    CHECK(std::fabs(result.breakpoints[1] - 129999.5) <= 2.0);
+    CHECK(result.residualSumOfSquares <= noiseRss);
+    CHECK(result.residualSumOfSquares > 0.999 * noiseRss);
+    CHECK_CLOSE(result.evaluate(10000.0), 1e8 + 10.0, 1e-9);
+    CHECK_CLOSE(result.evaluate(100000.0), 1e8 + 120.0, 1e-9);
+    CHECK(single.breakpoints == result.breakpoints);
+    CHECK(single.residualSumOfSquares == result.residualSumOfSquares);
+}
+
+void testInvalidInput()
+{
+    std::vector<double> x = {1, 2, 3, 4, 5, 6}, y = {1, 2, 3, 4, 5, 6};
+    CHECK(!SegmentedRegression::fit(x, y, 2, 1).valid);            // 3 段 × 每段至少 3 点 > 6
+    CHECK(SegmentedRegression::fit(x, y, 1, 1).valid);
+    CHECK(!SegmentedRegression::fit(std::vector<double>(10, 1.0), std::vector<double>(10, 2.0), 1, 0).valid);
+    CHECK(SegmentedRegression::fit(x, y, 0, 1).breakpoints.empty());
+
+    FitProgress progress;
+    progress.cancel();
+    std::vector<double> longX(5000), longY(5000);
+    for (size_t i = 0; i < longX.size(); ++i) longX[i] = longY[i] = static_cast<double>(i);
+    CHECK(!SegmentedRegression::fit(longX, longY, 2, 1, 0, &progress).valid);
+}
+
+} // namespace
+
+int main()
+{
+    testAgainstBruteForce();
+    testExactPieces();
+    testLargeOffset();
+    testInvalidInput();
+    return testResult("segmented_fit_test");
+}
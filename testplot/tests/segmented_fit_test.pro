@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = segmented_fit_test
+
+SOURCES += segmented_fit_test.cpp \
+           ../segmented_fit.cpp
+HEADERS += ../segmented_fit.h ../fit_progress.h ../parallel_utils.h
@@ -0,0 +1,265 @@
+#include "smoothing_fit.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+typedef std::vector<std::vector<double>> Matrix;
+
+// 部分主元 Gauss 消元解 A X = B（B 可有多列），只用于小规模的稠密参考解
+Matrix solveDense(Matrix a, Matrix b)
+{
+    size_t n = a.size(), columns = b[0].size();
+    for (size_t k = 0; k < n; ++k) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < n; ++i) {
+            if (std::fabs(a[i][k]) > std::fabs(a[pivot][k])) pivot = i;
+        }
+        std::swap(a[k], a[pivot]);
+        std::swap(b[k], b[pivot]);
+        for (size_t i = k + 1; i < n; ++i) {
+            double f = a[i][k] / a[k][k];
+            for (size_t j = k; j < n; ++j) a[i][j] -= f * a[k][j];
+            for (size_t j = 0; j < columns; ++j) b[i][j] -= f * b[k][j];
+        }
+    }
+    for (size_t k = n; k-- > 0;) {
+        for (size_t j = 0; j < columns; ++j) {
+            double value = b[k][j];
+            for (size_t i = k + 1; i < n; ++i) value -= a[k][i] * b[i][j];
+            b[k][j] = value / a[k][k];
+        }
+    }
+    return b;
+}
+
+// 稠密参考解（Green & Silverman 的记号，单位权）：g = (I + λ Q R^-1 Q^T)^-1 y，tr(S) = tr((I + λK)^-1)，
+// γ = R^-1 Q^T g 为节点上的二阶导数
+struct DenseSpline {
+    std::vector<double> values;
+    std::vector<double> gamma;
+    double degreesOfFreedom = 0.0;
+    double gcv = 0.0;
+
+    DenseSpline(const std::vector<double>& x, const std::vector<double>& y, double lambda)
+    {
+        size_t n = x.size(), m = n - 2;
+        std::vector<double> h(n - 1);
+        for (size_t i = 0; i + 1 < n; ++i) h[i] = x[i + 1] - x[i];
+        Matrix q(n, std::vector<double>(m, 0.0)), r(m, std::vector<double>(m, 0.0));
+        for (size_t j = 0; j < m; ++j) {
+            q[j][j] = 1.0 / h[j];
+            q[j + 1][j] = -1.0 / h[j] - 1.0 / h[j + 1];
+            q[j + 2][j] = 1.0 / h[j + 1];
+            r[j][j] = (h[j] + h[j + 1]) / 3.0;
+            if (j + 1 < m) r[j][j + 1] = r[j + 1][j] = h[j + 1] / 6.0;
+        }
+        Matrix qt(m, std::vector<double>(n));
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < m; ++j) qt[j][i] = q[i][j];
+        }
+        Matrix z = solveDense(r, qt);   // R^-1 Q^T
+        Matrix a(n, std::vector<double>(n, 0.0)), identity(n, std::vector<double>(n, 0.0));
+        for (size_t i = 0; i < n; ++i) {
+            identity[i][i] = 1.0;
+            for (size_t j = 0; j < n; ++j) {
+                double k = 0.0;
+                for (size_t p = 0; p < m; ++p) k += q[i][p] * z[p][j];
+                a[i][j] = (i == j ? 1.0 : 0.0) + lambda * k;
+            }
+        }
+        Matrix s = solveDense(a, identity);
+        values.assign(n, 0.0);
+        double rss = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) values[i] += s[i][j] * y[j];
+            degreesOfFreedom += s[i][i];
+            rss += (y[i] - values[i]) * (y[i] - values[i]);
+        }
+        double denominator = 1.0 - degreesOfFreedom / n;
+        gcv = (rss / n) / (denominator * denominator);
+
+        gamma.assign(m, 0.0);
+        for (size_t p = 0; p < m; ++p) {
+            for (size_t i = 0; i < n; ++i) gamma[p] += z[p][i] * values[i];
+        }
+    }
+};
+
+void sampleData(size_t n, unsigned seed, double sigma, std::vector<double>& x, std::vector<double>& y)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> jitter(0.0, 0.6);
+    std::normal_distribution<double> noise(0.0, sigma);
+    x.resize(n);
+    y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = 0.1 * (i + jitter(rng));     // 间距不均匀但远大于合并阈值
+        y[i] = std::sin(x[i]) + 0.3 * x[i] + noise(rng);
+    }
+}
+
+void testFixedLambdaAgainstDense()
+{
+    std::vector<double> x, y;
+    sampleData(40, 1, 0.2, x, y);
+    for (double lambda : {1e-4, 1e-2, 1.0, 100.0}) {
+        SmoothingSplineResult result = SmoothingSpline::fit(x, y, lambda);
+        DenseSpline dense(x, y, lambda);
+        CHECK(result.valid);
+        CHECK(result.curve.knots == x);
+        if (!result.valid || result.curve.values.size() != x.size()) continue;
+        for (size_t i = 0; i < x.size(); ++i) CHECK_CLOSE(result.curve.values[i], dense.values[i], 1e-9);
+        CHECK_CLOSE(result.degreesOfFreedom, dense.degreesOfFreedom, 1e-8);
+        CHECK_CLOSE(result.gcv, dense.gcv, 1e-8);
+        // 自然样条：两端二阶导数为 0，内部与 R^-1 Q^T g 一致
+        const std::vector<double>& second = result.curve.secondDerivatives;
+        CHECK(second.size() == x.size());
+        if (second.size() != x.size()) continue;
+        CHECK(second.front() == 0.0 && second.back() == 0.0);
+        for (size_t j = 0; j < dense.gamma.size(); ++j) CHECK_CLOSE(second[j + 1], dense.gamma[j], 1e-7);
+    }
+}
+
+void testGcvSelection()
+{
+    std::vector<double> x, y;
+    sampleData(60, 2, 0.3, x, y);
+    SmoothingSplineResult result = SmoothingSpline::fit(x, y);
+    CHECK(result.valid);
+    CHECK(result.lambda > 0.0);
+    CHECK(result.degreesOfFreedom > 2.0 && result.degreesOfFreedom < 60.0);
+
+    // 选出的 λ 不劣于稠密参考在细网格上的最小 GCV
+    double best = std::numeric_limits<double>::infinity();
+    for (double logLambda = -6.0; logLambda <= 4.0; logLambda += 0.05) {
+        best = std::min(best, DenseSpline(x, y, std::pow(10.0, logLambda)).gcv);
+    }
+    CHECK(result.gcv <= best * (1.0 + 1e-6));
+    CHECK_CLOSE(result.gcv, DenseSpline(x, y, result.lambda).gcv, 1e-8);
+}
+
+void testLimits()
+{
+    std::vector<double> x, y;
+    sampleData(30, 3, 0.5, x, y);
+
+    // λ → 0 时插值，λ → ∞ 时为最小二乘直线
+    SmoothingSplineResult interpolating = SmoothingSpline::fit(x, y, 1e-12);
+    CHECK(interpolating.valid);
+    for (size_t i = 0; i < x.size(); ++i) CHECK_CLOSE(interpolating.curve.values[i], y[i], 1e-6);
+    CHECK_CLOSE(interpolating.degreesOfFreedom, 30.0, 1e-6);
+
+    SmoothingSplineResult straight = SmoothingSpline::fit(x, y, 1e12);
+    double n = static_cast<double>(x.size()), sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sx += x[i];
+        sy += y[i];
+        sxx += x[i] * x[i];
+        sxy += x[i] * y[i];
+    }
+    double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    double intercept = (sy - slope * sx) / n;
+    CHECK(straight.valid);
+    for (size_t i = 0; i < x.size(); ++i) CHECK_CLOSE(straight.curve.values[i], intercept + slope * x[i], 1e-6);
+    CHECK_CLOSE(straight.degreesOfFreedom, 2.0, 1e-6);
+
+    // 直线数据对任何 λ 都原样复现，两端外推也是同一条直线
+    std::vector<double> line(x.size());
+    for (size_t i = 0; i < x.size(); ++i) line[i] = 2.0 - 0.5 * x[i];
+    SmoothingSplineResult exact = SmoothingSpline::fit(x, line, 1.0);
+    for (double xi : {-1.0, 0.37, 1.5, 2.9, 5.0}) CHECK_CLOSE(exact.curve.evaluate(xi), 2.0 - 0.5 * xi, 1e-10);
+
+    CHECK(!SmoothingSpline::fit({1.0, 2.0}, {1.0, 2.0}).valid);
+    CHECK(!SmoothingSpline::fit({1.0, 1.0, 1.0, 1.0}, {1.0, 2.0, 3.0, 4.0}).valid);
+}
+
+void testLargeData()
+{
+    // 10^5 个点合并成不超过约 2000 个节点，GCV 平滑后接近真实曲线
+    std::mt19937_64 rng(4);
+    std::uniform_real_distribution<double> uniform(0.0, 10.0);
+    std::normal_distribution<double> noise(0.0, 0.5);
+    std::vector<double> x(100000), y(100000);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = uniform(rng);
+        y[i] = std::sin(x[i]) + noise(rng);
+    }
+    SmoothingSplineResult result = SmoothingSpline::fit(x, y);
+    CHECK(result.valid);
+    CHECK(result.curve.knots.size() <= 2001);
+    double maxError = 0.0;
+    for (double xi = 0.5; xi <= 9.5; xi += 0.01) maxError = std::fmax(maxError, std::fabs(result.curve.evaluate(xi) - std::sin(xi)));
+    CHECK(maxError < 0.05);
+}
+
+// LOESS 参考：每个评估点直接取距离最近的 k 个点，三次权的加权最小二乘直线/抛物线在 x0 处的值
+double directLoess(const std::vector<double>& x, const std::vector<double>& y, double x0, size_t k, int degree)
+{
+    std::vector<std::pair<double, size_t>> distances;
+    for (size_t i = 0; i < x.size(); ++i) distances.emplace_back(std::fabs(x[i] - x0), i);
+    std::sort(distances.begin(), distances.end());
+    double reach = distances[k - 1].first;
+    size_t m = static_cast<size_t>(degree) + 1;
+    Matrix normal(m, std::vector<double>(m, 0.0)), rhs(m, std::vector<double>(1, 0.0));
+    for (size_t p = 0; p < k; ++p) {
+        size_t i = distances[p].second;
+        double u = (x[i] - x0) / reach;
+        double a = 1.0 - std::fabs(u * u * u);
+        double w = a > 0.0 ? a * a * a : 0.0;
+        double powers[3] = {1.0, u, u * u};
+        for (size_t r = 0; r < m; ++r) {
+            rhs[r][0] += w * powers[r] * y[i];
+            for (size_t c = 0; c < m; ++c) normal[r][c] += w * powers[r] * powers[c];
+        }
+    }
+    return solveDense(normal, rhs)[0][0];
+}
+
+void testLoess()
+{
+    std::vector<double> x, y;
+    sampleData(300, 5, 0.2, x, y);
+    std::mt19937_64 rng(6);
+    std::shuffle(x.begin(), x.end(), rng);   // 输入顺序无关
+    for (size_t i = 0; i < x.size(); ++i) y[i] = std::sin(x[i]) + 0.3 * x[i] + 0.05 * std::cos(37.0 * x[i]);
+
+    for (int degree : {1, 2}) {
+        for (double span : {0.05, 0.3, 1.0}) {
+            LoessResult result = Loess::fit(x, y, span, degree);
+            CHECK(result.valid);
+            CHECK(result.curve.knots.size() == x.size());
+            if (!result.valid || result.curve.knots.size() != x.size()) continue;
+            double maxError = 0.0;
+            for (size_t p = 0; p < result.curve.knots.size(); ++p) {
+                double expected = directLoess(x, y, result.curve.knots[p], result.neighbours, degree);
+                maxError = std::fmax(maxError, std::fabs(result.curve.values[p] - expected));
+            }
+            if (!(maxError < 1e-9)) std::printf("  degree %d, span %g: max error %g\n", degree, span, maxError);
+            CHECK(maxError < 1e-9);
+        }
+    }
+
+    // 评估点超过上限时在范围内等距取点
+    LoessResult coarse = Loess::fit(x, y, 0.3, 1, 50);
+    CHECK(coarse.valid && coarse.curve.knots.size() == 50);
+    for (size_t p = 0; p < coarse.curve.knots.size() && coarse.valid; p += 7) {
+        CHECK_CLOSE(coarse.curve.values[p], directLoess(x, y, coarse.curve.knots[p], coarse.neighbours, 1), 1e-9);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testFixedLambdaAgainstDense();
+    testGcvSelection();
+    testLimits();
+    testLargeData();
+    testLoess();
+    return testResult("smoothing_fit_test");
+}
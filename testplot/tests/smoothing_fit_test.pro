@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = smoothing_fit_test
+
+SOURCES += smoothing_fit_test.cpp \
+           ../smoothing_fit.cpp
+HEADERS += ../smoothing_fit.h ../fit_progress.h ../parallel_utils.h
@@ -0,0 +1,224 @@
+#include "statistics_accumulator.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 逐批追加/合并的结果与一次性批量计算（两遍均值方差、排序后 R type 7 分位数）对比
+struct BatchStats {
+    double mean = 0.0;
+    double variance = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    std::vector<double> sorted;
+
+    explicit BatchStats(const std::vector<double>& data)
+    {
+        for (double v : data) {
+            if (std::isfinite(v)) sorted.push_back(v);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        // 第二遍用残差和修正均值，不依赖 long double 的额外精度（MSVC 上它就是 double）
+        double sum = 0.0;
+        for (double v : sorted) sum += v;
+        mean = sum / sorted.size();
+        double correction = 0.0;
+        for (double v : sorted) correction += v - mean;
+        mean += correction / sorted.size();
+        double m2 = 0.0;
+        for (double v : sorted) m2 += (v - mean) * (v - mean);
+        variance = m2 / sorted.size();
+        min = sorted.front();
+        max = sorted.back();
+    }
+
+    double quantile(double p) const
+    {
+        double h = (sorted.size() - 1) * p;
+        size_t lo = static_cast<size_t>(std::floor(h));
+        size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted[lo] + (h - lo) * (sorted[hi] - sorted[lo]);
+    }
+
+    // value 在排序数据中的经验累积比例，用来衡量近似分位数的秩误差
+    double rank(double value) const
+    {
+        return static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), value) - sorted.begin())
+             / sorted.size();
+    }
+};
+
+const double Probabilities[] = {0.0, 0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0};
+
+void checkMoments(const StatisticsAccumulator& acc, const BatchStats& batch)
+{
+    CHECK(acc.count() == batch.sorted.size());
+    CHECK_CLOSE(acc.mean(), batch.mean, 1e-12);
+    CHECK_CLOSE(acc.variance(), batch.variance, 1e-10);
+    CHECK(acc.min() == batch.min);
+    CHECK(acc.max() == batch.max);
+}
+
+void checkExact(const StatisticsAccumulator& acc, const BatchStats& batch)
+{
+    checkMoments(acc, batch);
+    CHECK(acc.sketch().isExact());
+    for (double p : Probabilities) {
+        CHECK_CLOSE(acc.quantile(p), batch.quantile(p), 1e-14);
+    }
+}
+
+void checkApproximate(const StatisticsAccumulator& acc, const BatchStats& batch, double rankTolerance)
+{
+    checkMoments(acc, batch);
+    CHECK(!acc.sketch().isExact());
+    CHECK(acc.quantile(0.0) == batch.min);
+    CHECK(acc.quantile(1.0) == batch.max);
+    for (double p : Probabilities) {
+        double q = acc.quantile(p);
+        CHECK(q >= batch.min && q <= batch.max);
+        CHECK(std::fabs(batch.rank(q) - p) <= rankTolerance);
+    }
+}
+
+std::vector<double> randomData(size_t n, unsigned seed)
+{
+    std::mt19937_64 rng(seed);
+    std::lognormal_distribution<double> skewed(0.0, 1.0);
+    std::normal_distribution<double> normal(10.0, 3.0);
+    std::vector<double> data(n);
+    for (size_t i = 0; i < n; ++i) {
+        data[i] = (i % 3 == 0) ? skewed(rng) : normal(rng);
+    }
+    return data;
+}
+
+// 不等长的分批追加
+StatisticsAccumulator appendInBatches(const std::vector<double>& data, size_t first, size_t last)
+{
+    StatisticsAccumulator acc;
+    size_t batch = 1;
+    for (size_t i = first; i < last;) {
+        size_t take = std::min(batch, last - i);
+        acc.append(data.data() + i, take);
+        i += take;
+        batch = batch * 3 % 997 + 1;
+    }
+    return acc;
+}
+
+void testNonFiniteValues()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    StatisticsAccumulator acc;
+    acc.append(std::vector<double>{nan, 1.0, 2.0, 3.0});
+    CHECK(acc.count() == 3);
+    CHECK(acc.sum() == 6.0);
+    CHECK(acc.mean() == 2.0);
+    CHECK_CLOSE(acc.variance(), 2.0 / 3.0, 1e-15);
+    CHECK(acc.min() == 1.0);
+    CHECK(acc.max() == 3.0);
+    CHECK(acc.median() == 2.0);
+    CHECK(acc.sketch().count() == 3.0);
+
+    acc.append(std::vector<double>{inf, -inf, 4.0, nan});
+    CHECK(acc.count() == 4);
+    CHECK(acc.mean() == 2.5);
+    CHECK(acc.max() == 4.0);
+    CHECK(acc.sketch().count() == 4.0);
+
+    StatisticsAccumulator empty;
+    empty.append(std::vector<double>{nan, inf});
+    CHECK(empty.isEmpty());
+    CHECK(empty.sum() == 0.0);
+    CHECK(std::isnan(empty.median()));
+    acc.merge(empty);
+    CHECK(acc.count() == 4);
+}
+
+void testExactMode()
+{
+    std::vector<double> data = randomData(4000, 1);
+    BatchStats batch(data);
+
+    StatisticsAccumulator whole;
+    whole.append(data);
+    checkExact(whole, batch);
+    checkExact(appendInBatches(data, 0, data.size()), batch);
+
+    StatisticsAccumulator single;
+    for (double v : data) single.append(v);
+    checkExact(single, batch);
+
+    StatisticsAccumulator left = appendInBatches(data, 0, 1234);
+    StatisticsAccumulator right = appendInBatches(data, 1234, data.size());
+    left.merge(right);
+    checkExact(left, batch);
+}
+
+void testSketchSwitch()
+{
+    // 恰好 4096 个样本仍为精确模式，第 4097 个起压缩为质心
+    std::vector<double> data = randomData(4097, 2);
+    std::vector<double> head(data.begin(), data.begin() + 4096);
+
+    StatisticsAccumulator acc;
+    acc.append(head);
+    checkExact(acc, BatchStats(head));
+    acc.append(data.back());
+    checkApproximate(acc, BatchStats(data), 0.005);
+}
+
+void testApproximateMode()
+{
+    std::vector<double> data = randomData(200000, 3);
+    BatchStats batch(data);
+
+    StatisticsAccumulator whole;
+    whole.append(data);
+    checkApproximate(whole, batch, 0.005);
+    checkApproximate(appendInBatches(data, 0, data.size()), batch, 0.005);
+
+    // 一边精确、一边已压缩，以及两边都已压缩的合并
+    StatisticsAccumulator small = appendInBatches(data, 0, 3000);
+    StatisticsAccumulator large = appendInBatches(data, 3000, data.size());
+    small.merge(large);
+    checkApproximate(small, batch, 0.005);
+
+    std::vector<StatisticsAccumulator> parts;
+    for (size_t i = 0; i < 8; ++i) {
+        parts.push_back(appendInBatches(data, data.size() * i / 8, data.size() * (i + 1) / 8));
+    }
+    StatisticsAccumulator merged;
+    for (const StatisticsAccumulator& part : parts) merged.merge(part);
+    checkApproximate(merged, batch, 0.005);
+}
+
+void testLargeOffset()
+{
+    // 均值远大于离散程度时方差仍应准确（Welford/Chan 合并不做“平方和减平方”）
+    std::vector<double> data = randomData(50000, 4);
+    for (double& v : data) v += 1e9;
+    BatchStats batch(data);
+    StatisticsAccumulator acc = appendInBatches(data, 0, data.size());
+    CHECK_CLOSE(acc.mean(), batch.mean, 1e-15);
+    CHECK_CLOSE(acc.variance(), batch.variance, 1e-6);
+}
+
+} // namespace
+
+int main()
+{
+    testNonFiniteValues();
+    testExactMode();
+    testSketchSwitch();
+    testApproximateMode();
+    testLargeOffset();
+    return testResult("statistics_accumulator_test");
+}
@@ -0,0 +1,6 @@
+include(tests.pri)
+TARGET = statistics_accumulator_test
+
+SOURCES += statistics_accumulator_test.cpp \
+           ../statistics_accumulator.cpp
+HEADERS += ../statistics_accumulator.h
@@ -0,0 +1,48 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <cmath>
+#include <cstdio>
+
+// 数值引擎测试用的最小断言：失败时打印位置并计数，main 以失败数作为退出码（0 为通过）
+// 不依赖 Qt 和测试框架，g++/MSVC 直接编译即可运行
+
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline void testCheck(bool ok, const char* expression, const char* file, int line)
+{
+    if (ok) return;
+    std::printf("%s:%d: FAILED: %s\n", file, line, expression);
+    ++testFailures();
+}
+
+// |actual - expected| <= tolerance · max(1, |expected|)，两者同为 NaN 也算相等
+inline void testClose(double actual, double expected, double tolerance, const char* expression, const char* file,
+                      int line)
+{
+    bool ok = (std::isnan(actual) && std::isnan(expected))
+           || std::fabs(actual - expected) <= tolerance * std::fmax(1.0, std::fabs(expected));
+    if (ok) return;
+    std::printf("%s:%d: FAILED: %s (actual %.17g, expected %.17g)\n", file, line, expression, actual, expected);
+    ++testFailures();
+}
+
+inline int testResult(const char* name)
+{
+    if (testFailures() == 0) {
+        std::printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    std::printf("%s: %d check(s) failed\n", name, testFailures());
+    return 1;
+}
+
+#define CHECK(cond) testCheck((cond), #cond, __FILE__, __LINE__)
+#define CHECK_CLOSE(actual, expected, tolerance) \
+    testClose((actual), (expected), (tolerance), #actual " ~ " #expected, __FILE__, __LINE__)
+
+#endif // TEST_CHECK_H
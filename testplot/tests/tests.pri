@@ -0,0 +1,9 @@
+# 数值引擎测试的公共设置：纯 C++ 控制台程序，不链接 Qt
+# make check 依次运行各测试（CONFIG += testcase），任一失败则返回非零
+TEMPLATE = app
+CONFIG += console c++17 testcase
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += $$PWD/..
+DEPENDPATH += $$PWD/..
+HEADERS += $$PWD/test_check.h
@@ -0,0 +1,26 @@
+# 数值引擎的独立测试：在本目录执行 qmake && make check（MSVC 下为 nmake check）
+TEMPLATE = subdirs
+
+SUBDIRS += statistics_accumulator_test.pro \
+           fft_test.pro \
+           rolling_window_test.pro \
+           polynomial_fit_test.pro \
+           levenberg_marquardt_test.pro \
+           parallel_utils_test.pro \
+           smoothing_fit_test.pro \
+           segmented_fit_test.pro \
+           line_decimation_test.pro \
+           density_raster_test.pro \
+           fit_cache_test.pro \
+           histogram_engine_test.pro \
+           kde_engine_test.pro \
+           box_summary_test.pro \
+           correlation_engine_test.pro \
+           lag_correlation_test.pro \
+           peak_finder_test.pro \
+           distribution_fit_test.pro \
+           two_sample_tests_test.pro \
+           model_expression_test.pro \
+           fit_model_test.pro \
+           robust_fit_test.pro \
+           bootstrap_fit_test.pro
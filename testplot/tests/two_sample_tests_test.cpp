@@ -0,0 +1,141 @@
+#include "two_sample_tests.h"
+#include "distribution_fit.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<double> sortedSample(std::mt19937_64& rng, size_t n, double shift, bool integers)
+{
+    std::normal_distribution<double> normal(shift, 3.0);
+    std::vector<double> data(n);
+    for (double& v : data) v = integers ? std::round(normal(rng)) : normal(rng);
+    std::sort(data.begin(), data.end());
+    return data;
+}
+
+// U 逐对比较（相等计 1/2），结校正项由各值的出现次数直接求得，KS 距离在每个不同的值处比较
+void checkRanksAgainstDirect(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double u = 0.0;
+    for (double x : a) {
+        for (double y : b) u += x > y ? 1.0 : (x == y ? 0.5 : 0.0);
+    }
+    std::map<double, size_t> ties;
+    for (double v : a) ++ties[v];
+    for (double v : b) ++ties[v];
+    double nA = static_cast<double>(a.size()), nB = static_cast<double>(b.size()), total = nA + nB;
+    double tieTerm = 0.0, gap = 0.0;
+    for (const auto& entry : ties) {
+        double t = static_cast<double>(entry.second);
+        tieTerm += t * t * t - t;
+        double fA = (std::upper_bound(a.begin(), a.end(), entry.first) - a.begin()) / nA;
+        double fB = (std::upper_bound(b.begin(), b.end(), entry.first) - b.begin()) / nB;
+        gap = std::max(gap, std::fabs(fA - fB));
+    }
+    double variance = nA * nB / 12.0 * ((total + 1.0) - tieTerm / (total * (total - 1.0)));
+    double deviation = u - nA * nB / 2.0;
+    double z = std::copysign(std::max(0.0, std::fabs(deviation) - 0.5), deviation) / std::sqrt(variance);
+
+    TwoSampleResult result = TwoSampleTests::compare(a, b);
+    CHECK(result.valid);
+    CHECK(result.mannWhitneyU == u);
+    CHECK_CLOSE(result.mannWhitneyZ, z, 1e-12);
+    CHECK_CLOSE(result.mannWhitneyP, std::erfc(std::fabs(z) / std::sqrt(2.0)), 1e-12);
+    CHECK(result.ksStatistic == gap);
+    CHECK(result.ksPValue == DistributionFitter::kolmogorovPValue(gap, nA * nB / total));
+}
+
+void testWelch()
+{
+    // A = 1..5，B = 2, 4, ..., 12：t 与 df 按 Welch–Satterthwaite 公式手算，p 由 t 密度数值积分得到
+    std::vector<double> a = {1, 2, 3, 4, 5}, b = {2, 4, 6, 8, 10, 12};
+    TwoSampleResult result = TwoSampleTests::compare(a, b);
+    CHECK(result.valid && result.countA == 5 && result.countB == 6);
+    CHECK(result.meanA == 3.0 && result.meanB == 7.0);
+    CHECK_CLOSE(result.welchT, -2.3763541031440183, 1e-13);
+    CHECK_CLOSE(result.welchDf, 6.9722557297949335, 1e-13);
+    CHECK_CLOSE(result.welchP, 0.04928433820676259, 1e-9);
+
+    // 两组都是常数
+    result = TwoSampleTests::compare({2, 2, 2}, {3, 3});
+    CHECK(std::isinf(result.welchT) && result.welchT < 0.0 && result.welchP == 0.0);
+    result = TwoSampleTests::compare({2, 2, 2}, {2, 2});
+    CHECK(result.welchT == 0.0 && result.welchP == 1.0);
+
+    CHECK(!TwoSampleTests::compare({1.0}, {1.0, 2.0}).valid);
+}
+
+void testStudentP()
+{
+    // df = 1（Cauchy）与 df = 2 有闭式解，其余为数值积分的参考值
+    const double pi = 3.14159265358979323846;
+    for (double t : {0.3, 1.0, 7.0}) {
+        CHECK_CLOSE(TwoSampleTests::studentTwoSidedP(t, 1.0), 1.0 - 2.0 / pi * std::atan(t), 1e-12);
+        CHECK_CLOSE(TwoSampleTests::studentTwoSidedP(-t, 2.0), 1.0 - t / std::sqrt(2.0 + t * t), 1e-12);
+    }
+    CHECK_CLOSE(TwoSampleTests::studentTwoSidedP(2.228138852, 10.0), 0.05, 1e-9);
+    CHECK_CLOSE(TwoSampleTests::studentTwoSidedP(0.5, 3.5), 0.6468504393225567, 1e-9);
+    CHECK_CLOSE(TwoSampleTests::studentTwoSidedP(4.0, 25.3), 0.0004867177618664842, 1e-6);
+    CHECK(TwoSampleTests::studentTwoSidedP(0.0, 5.0) == 1.0);
+    CHECK(TwoSampleTests::studentTwoSidedP(1.0, 0.0) == 1.0);
+}
+
+void testRanks()
+{
+    // 手算：A = {1, 2, 2, 3}，B = {2, 3, 4}；U_A = 0 + 0.5 + 0.5 + 1.5 = 2.5，结 {2, 2, 2} 与 {3, 3}
+    std::vector<double> a = {1, 2, 2, 3}, b = {2, 3, 4};
+    TwoSampleResult result = TwoSampleTests::compare(a, b);
+    CHECK(result.mannWhitneyU == 2.5);
+    CHECK_CLOSE(result.ksStatistic, 5.0 / 12.0, 1e-15);   // x = 2 处 F_A = 3/4，F_B = 1/3
+    checkRanksAgainstDirect(a, b);
+
+    std::mt19937_64 rng(1);
+    for (int trial = 0; trial < 40; ++trial) {
+        size_t nA = 2 + rng() % 300, nB = 2 + rng() % 300;
+        bool integers = trial % 2 == 0;
+        std::vector<double> x = sortedSample(rng, nA, 0.0, integers);
+        std::vector<double> y = sortedSample(rng, nB, trial % 4 < 2 ? 0.0 : 1.5, integers);
+        checkRanksAgainstDirect(x, y);
+    }
+}
+
+void testChunking()
+{
+    // 大量结跨越切分点：任意段数的结果都与单段逐位相同
+    std::mt19937_64 rng(2);
+    std::vector<double> a = sortedSample(rng, 20000, 0.0, true), b = sortedSample(rng, 15000, 0.5, true);
+    std::vector<double> constant(5000, 1.0), mixed = {0.0, 1.0, 1.0, 2.0};
+    const std::pair<const std::vector<double>*, const std::vector<double>*> pairs[] = {
+        {&a, &b}, {&b, &a}, {&constant, &a}, {&constant, &mixed}};
+    bool identical = true;
+    for (const auto& pair : pairs) {
+        TwoSampleResult serial = TwoSampleTests::compare(*pair.first, *pair.second, 1);
+        for (size_t chunks : {2, 3, 7, 16, 64, 1000}) {
+            TwoSampleResult split = TwoSampleTests::compare(*pair.first, *pair.second, chunks);
+            identical = identical && split.mannWhitneyU == serial.mannWhitneyU
+                     && split.mannWhitneyZ == serial.mannWhitneyZ && split.ksStatistic == serial.ksStatistic
+                     && split.welchT == serial.welchT;
+        }
+    }
+    CHECK(identical);
+    checkRanksAgainstDirect(constant, mixed);
+
+    std::vector<TwoSampleResult> batch = TwoSampleTests::compareBatch({&a, &constant}, {&b, &mixed});
+    CHECK(batch.size() == 2 && batch[0].mannWhitneyU == TwoSampleTests::compare(a, b, 1).mannWhitneyU);
+}
+
+} // namespace
+
+int main()
+{
+    testWelch();
+    testStudentP();
+    testRanks();
+    testChunking();
+    return testResult("two_sample_tests_test");
+}
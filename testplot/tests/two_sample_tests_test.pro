@@ -0,0 +1,7 @@
+include(tests.pri)
+TARGET = two_sample_tests_test
+
+SOURCES += two_sample_tests_test.cpp \
+           ../two_sample_tests.cpp \
+           ../distribution_fit.cpp
+HEADERS += ../two_sample_tests.h ../distribution_fit.h ../parallel_utils.h
@@ -0,0 +1,226 @@
+#include "two_sample_tests.h"
+#include "distribution_fit.h"
+#include "parallel_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 连分式求不完全 Beta 函数（Lentz 算法）
+double betaContinuedFraction(double a, double b, double x)
+{
+    const double tiny = 1e-300;
+    const double eps = 1e-15;
+    double qab = a + b, qap = a + 1.0, qam = a - 1.0;
+    double c = 1.0;
+    double d = 1.0 - qab * x / qap;
+    if (std::abs(d) < tiny) d = tiny;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= 300; ++m) {
+        int m2 = 2 * m;
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + aa * d;
+        if (std::abs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c;
+        if (std::abs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        h *= d * c;
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + aa * d;
+        if (std::abs(d) < tiny) d = tiny;
+        c = 1.0 + aa / c;
+        if (std::abs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::abs(delta - 1.0) < eps) break;
+    }
+    return h;
+}
+
+// 正则化不完全 Beta 函数 I_x(a, b)
+double regularizedBeta(double a, double b, double x)
+{
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double logFront = std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log1p(-x);
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        return std::exp(logFront) * betaContinuedFraction(a, b, x) / a;
+    }
+    return 1.0 - std::exp(logFront) * betaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+void meanAndVariance(const std::vector<double>& data, double* mean, double* variance)
+{
+    double m = 0.0;
+    for (double v : data) m += v;
+    m /= data.size();
+    double ss = 0.0;
+    for (double v : data) ss += (v - m) * (v - m);
+    *mean = m;
+    *variance = data.size() > 1 ? ss / (data.size() - 1) : 0.0;
+}
+
+// 归并后的第 k 个元素（从 0 计）：merge path 上二分 A 贡献的元素个数
+double mergedElement(const std::vector<double>& a, const std::vector<double>& b, size_t k)
+{
+    size_t lo = k > b.size() ? k - b.size() : 0;
+    size_t hi = std::min(k, a.size());
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (a[mid] < b[k - mid - 1]) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t i = lo, j = k - lo;
+    if (i >= a.size()) return b[j];
+    if (j >= b.size()) return a[i];
+    return std::min(a[i], b[j]);
+}
+
+struct MergeSegment {
+    size_t beginA, endA, beginB, endB;
+};
+
+struct MergeSummary {
+    double rankSumA = 0.0;
+    double tieTerm = 0.0;   // sum(t^3 - t)
+    double maxGap = 0.0;    // max |F_A - F_B|
+};
+
+// 一段归并：按值分组，每组的平均秩累加到 A 的秩和，组结束处比较两个经验分布函数
+MergeSummary mergeSegment(const std::vector<double>& a, const std::vector<double>& b, const MergeSegment& segment)
+{
+    MergeSummary summary;
+    double nA = static_cast<double>(a.size());
+    double nB = static_cast<double>(b.size());
+    size_t i = segment.beginA, j = segment.beginB;
+    double rank = static_cast<double>(i + j);
+    while (i < segment.endA || j < segment.endB) {
+        double value;
+        if (i >= segment.endA) value = b[j];
+        else if (j >= segment.endB) value = a[i];
+        else value = std::min(a[i], b[j]);
+
+        size_t startA = i, startB = j;
+        while (i < segment.endA && a[i] == value) ++i;
+        while (j < segment.endB && b[j] == value) ++j;
+        double countA = static_cast<double>(i - startA);
+        double tied = static_cast<double>((i - startA) + (j - startB));
+
+        summary.rankSumA += countA * (rank + (tied + 1.0) / 2.0);
+        summary.tieTerm += tied * tied * tied - tied;
+        rank += tied;
+        summary.maxGap = std::max(summary.maxGap, std::abs(i / nA - j / nB));
+    }
+    return summary;
+}
+
+} // namespace
+
+double TwoSampleTests::studentTwoSidedP(double t, double df)
+{
+    if (std::isnan(t) || !(df > 0.0)) return 1.0;
+    if (std::isinf(t)) return 0.0;
+    return regularizedBeta(0.5 * df, 0.5, df / (df + t * t));
+}
+
+TwoSampleResult TwoSampleTests::compare(const std::vector<double>& a, const std::vector<double>& b, size_t chunks)
+{
+    TwoSampleResult result;
+    result.countA = a.size();
+    result.countB = b.size();
+    if (a.size() < 2 || b.size() < 2) return result;
+
+    double nA = static_cast<double>(a.size());
+    double nB = static_cast<double>(b.size());
+    double total = nA + nB;
+
+    // Welch t
+    double varA = 0.0, varB = 0.0;
+    meanAndVariance(a, &result.meanA, &varA);
+    meanAndVariance(b, &result.meanB, &varB);
+    double seA = varA / nA, seB = varB / nB;
+    double se = seA + seB;
+    double diff = result.meanA - result.meanB;
+    if (se > 0.0) {
+        result.welchT = diff / std::sqrt(se);
+        result.welchDf = se * se / (seA * seA / (nA - 1.0) + seB * seB / (nB - 1.0));
+        result.welchP = studentTwoSidedP(result.welchT, result.welchDf);
+    } else {
+        // 两组都是常数：均值相同则无差异，否则差异确定
+        result.welchT = diff == 0.0 ? 0.0 : std::copysign(std::numeric_limits<double>::infinity(), diff);
+        result.welchDf = total - 2.0;
+        result.welchP = diff == 0.0 ? 1.0 : 0.0;
+    }
+
+    // 在值的边界处切分归并序列，各段并行处理后按段序号归约
+    size_t merged = a.size() + b.size();
+    if (chunks == 0) chunks = parallelChunkCount(merged);
+    std::vector<MergeSegment> segments;
+    size_t previousA = 0, previousB = 0;
+    for (size_t c = 1; c <= chunks; ++c) {
+        size_t splitA = a.size(), splitB = b.size();
+        if (c < chunks) {
+            double value = mergedElement(a, b, merged / chunks * c);
+            splitA = std::lower_bound(a.begin(), a.end(), value) - a.begin();
+            splitB = std::lower_bound(b.begin(), b.end(), value) - b.begin();
+        }
+        if (splitA + splitB > previousA + previousB) {
+            segments.push_back({previousA, splitA, previousB, splitB});
+            previousA = splitA;
+            previousB = splitB;
+        }
+    }
+
+    std::vector<MergeSummary> summaries(segments.size());
+    parallelForEach(segments.size(), [&](size_t s) {
+        summaries[s] = mergeSegment(a, b, segments[s]);
+    });
+
+    double rankSumA = 0.0, tieTerm = 0.0, maxGap = 0.0;
+    for (const MergeSummary& summary : summaries) {
+        rankSumA += summary.rankSumA;
+        tieTerm += summary.tieTerm;
+        maxGap = std::max(maxGap, summary.maxGap);
+    }
+
+    // Mann–Whitney U
+    result.mannWhitneyU = rankSumA - nA * (nA + 1.0) / 2.0;
+    double meanU = nA * nB / 2.0;
+    double varianceU = nA * nB / 12.0 * ((total + 1.0) - tieTerm / (total * (total - 1.0)));
+    if (varianceU > 0.0) {
+        double deviation = result.mannWhitneyU - meanU;
+        double corrected = std::max(0.0, std::abs(deviation) - 0.5);
+        result.mannWhitneyZ = std::copysign(corrected, deviation) / std::sqrt(varianceU);
+        result.mannWhitneyP = std::erfc(std::abs(result.mannWhitneyZ) / std::sqrt(2.0));
+    }
+
+    // 两样本 KS：有效样本量 nA*nB/(nA+nB)
+    result.ksStatistic = maxGap;
+    result.ksPValue = DistributionFitter::kolmogorovPValue(maxGap, nA * nB / total);
+
+    result.valid = true;
+    return result;
+}
+
+std::vector<TwoSampleResult> TwoSampleTests::compareBatch(const std::vector<const std::vector<double>*>& sortedA,
+                                                          const std::vector<const std::vector<double>*>& sortedB)
+{
+    size_t pairs = std::min(sortedA.size(), sortedB.size());
+    std::vector<TwoSampleResult> results(pairs);
+    if (pairs >= workerThreadCount()) {
+        parallelForEach(pairs, [&](size_t p) {
+            results[p] = compare(*sortedA[p], *sortedB[p], 1);
+        });
+    } else {
+        for (size_t p = 0; p < pairs; ++p) {
+            results[p] = compare(*sortedA[p], *sortedB[p]);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,47 @@
+#ifndef TWO_SAMPLE_TESTS_H
+#define TWO_SAMPLE_TESTS_H
+
+#include <vector>
+#include <cstddef>
+
+struct TwoSampleResult {
+    size_t countA = 0;
+    size_t countB = 0;
+    double meanA = 0.0;
+    double meanB = 0.0;
+
+    // Welch t 检验（不假设方差相等）
+    double welchT = 0.0;
+    double welchDf = 0.0;
+    double welchP = 1.0;
+
+    // Mann–Whitney U（正态近似，含结校正和连续性校正）
+    double mannWhitneyU = 0.0;     // 样本 A 的 U
+    double mannWhitneyZ = 0.0;
+    double mannWhitneyP = 1.0;
+
+    // 两样本 Kolmogorov–Smirnov
+    double ksStatistic = 0.0;
+    double ksPValue = 1.0;
+
+    bool valid = false;            // 任一样本少于 2 个点时为 false
+};
+
+// 两样本检验，输入为升序数据（见 SortedColumnCache），所有 p 值为双侧
+// 秩和与 KS 距离在同一次归并中得到：按 merge path 在值的边界处把归并结果切成若干段并行处理，
+// 同值的结不会被切开，每段的起始秩和经验分布函数值由切分点直接给出
+class TwoSampleTests
+{
+public:
+    static TwoSampleResult compare(const std::vector<double>& sortedA, const std::vector<double>& sortedB,
+                                   size_t chunks = 0);
+
+    // 多对并行：对数多于线程数时按对分配，否则每对内部并行
+    static std::vector<TwoSampleResult> compareBatch(const std::vector<const std::vector<double>*>& sortedA,
+                                                     const std::vector<const std::vector<double>*>& sortedB);
+
+    // Student t 分布的双侧 p 值 P(|T| > |t|)
+    static double studentTwoSidedP(double t, double df);
+};
+
+#endif // TWO_SAMPLE_TESTS_H
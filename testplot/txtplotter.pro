@@ -1,10 +1,28 @@
-QT += core widgets network 
+QT += core widgets network concurrent 
 CONFIG += c++17 qt 
 TARGET = txtplotter 
 TEMPLATE = app 
 
-SOURCES += main.cpp deepseek_dialog.cpp mainwindow.cpp plotwidget_new.cpp
-HEADERS += deepseek_dialog.h mainwindow.h plotwidget_new.h
+SOURCES += main.cpp deepseek_dialog.cpp mainwindow.cpp plotwidget_new.cpp \
+           statistics_accumulator.cpp column_store.cpp histogram_engine.cpp \
+           fft.cpp kde_engine.cpp box_summary.cpp correlation_engine.cpp \
+           spectrum_engine.cpp \
+           lag_correlation.cpp rolling_window.cpp peak_finder.cpp \
+           sorted_column_cache.cpp distribution_fit.cpp \
+           two_sample_tests.cpp polynomial_fit.cpp \
+           levenberg_marquardt.cpp model_expression.cpp \
+           fitting_benchmark.cpp fit_model.cpp robust_fit.cpp smoothing_fit.cpp \
+           bootstrap_fit.cpp segmented_fit.cpp line_decimation.cpp density_raster.cpp
+HEADERS += deepseek_dialog.h mainwindow.h plotwidget_new.h \
+           statistics_accumulator.h column_store.h parallel_utils.h histogram_engine.h \
+           fft.h kde_engine.h box_summary.h correlation_engine.h \
+           spectrum_engine.h \
+           lag_correlation.h rolling_window.h peak_finder.h \
+           sorted_column_cache.h distribution_fit.h \
+           two_sample_tests.h polynomial_fit.h \
+           levenberg_marquardt.h model_expression.h \
+           fitting_benchmark.h fit_progress.h fit_model.h robust_fit.h smoothing_fit.h \
+           bootstrap_fit.h segmented_fit.h fit_cache.h line_decimation.h density_raster.h
 
 # win32:RC_ICONS = app.ico 
 